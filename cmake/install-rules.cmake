@@ -1,4 +1,5 @@
-install(TARGETS JEngine-Reformed_exe RUNTIME COMPONENT JEngine-Reformed_Runtime)
+install(TARGETS JEngine-Reformed_exe JEngine-Reformed_texture_tool
+        RUNTIME COMPONENT JEngine-Reformed_Runtime)
 
 if(PROJECT_IS_TOP_LEVEL)
   include(CPack)
@@ -25,3 +25,10 @@ if(NOT PROJECT_IS_TOP_LEVEL)
     set(warning_guard SYSTEM)
   endif()
 endif()
+
+# ---- Optional renderer backends ----
+
+# The Vulkan backend needs the Vulkan SDK (or the loader and headers from the
+# system) and pulls glslang to compile the engine's GLSL to SPIR-V
+option(JEngine-Reformed_ENABLE_VULKAN "Build the headless Vulkan renderer backend"
+       OFF)
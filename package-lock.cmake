@@ -18,11 +18,27 @@ cpmaddpackage("gh:Dav1dde/glad#v2.0.4")
 cpmaddpackage("gh:g-truc/glm#0.9.9.8")
 cpmaddpackage("gh:JesusKrists/tracy#master")
 cpmaddpackage("gh:catchorg/Catch2#v3.3.2")
+cpmaddpackage("gh:martinus/nanobench#v4.3.11")
+cpmaddpackage(
+  NAME
+  stb
+  GITHUB_REPOSITORY
+  nothings/stb
+  GIT_TAG
+  5736b15f7ea0ffb08dd38af21067c314d6a3aae9
+  DOWNLOAD_ONLY
+  YES)
 
 add_subdirectory(${glad_SOURCE_DIR}/cmake)
-glad_add_library(glad STATIC API gl:core=4.5)
+glad_add_library(
+  glad STATIC API gl:core=4.5 EXTENSIONS GL_EXT_texture_compression_s3tc
+  GL_EXT_texture_sRGB)
 add_library(glad::glad ALIAS glad)
 
+add_library(stb INTERFACE)
+target_include_directories(stb INTERFACE ${stb_SOURCE_DIR})
+add_library(stb::stb ALIAS stb)
+
 disable_static_analysis(spdlog)
 disable_static_analysis(SDL2)
 disable_static_analysis(SDL2-static)
@@ -32,3 +48,20 @@ disable_static_analysis(glm)
 disable_static_analysis(TracyClient)
 disable_static_analysis(Catch2)
 disable_static_analysis(Catch2WithMain)
+disable_static_analysis(nanobench)
+
+if(JEngine-Reformed_ENABLE_VULKAN)
+  cpmaddpackage(
+    NAME
+    glslang
+    GITHUB_REPOSITORY
+    KhronosGroup/glslang
+    GIT_TAG
+    14.0.0
+    OPTIONS
+    "ENABLE_OPT OFF"
+    "ENABLE_GLSLANG_BINARIES OFF"
+    "GLSLANG_TESTS OFF"
+    "ENABLE_HLSL OFF"
+    "SKIP_GLSLANG_INSTALL ON")
+endif()
@@ -1,11 +1,22 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <span>
+#include <utility>
+
 #include "Assert.hpp"
 #include "Base.hpp"
 #include "Events.hpp"
+#include "FramePacer.hpp"
+#include "Graphics/DynamicResolution.hpp"
 #include "Graphics/Renderer.hpp"
+#include "Graphics/ResourceTracker.hpp"
+#include "Graphics/Texture.hpp"
+#include "MPSCQueue.hpp"
 #include "Platform.hpp"
 #include "Sound/ImpulseAudio.hpp"
+#include "Time.hpp"
 #include "Types.hpp"
 
 namespace JE
@@ -36,11 +47,17 @@ namespace JE
       public:
         static constexpr auto MAINWINDOW_DEFAULT_TITLE = "JEngine-Reformed Application";
         static constexpr auto DEFAULT_CLEAR_COLOR = RGBA{255u, 0u, 255u, 255u};
+        static constexpr std::size_t POSTED_EVENT_CAPACITY = 4096;
+        static constexpr std::size_t DEFAULT_MAX_POSTED_EVENTS_PER_FRAME = 1024;
+
+        using FixedUpdateFunction = std::function<void(double)>;
+        /// Submits the draws of one window, called between Renderer::Begin and Renderer::End
+        using WindowRenderFunction = std::function<void(IWindow&, JE::Renderer&)>;
 
         // cppcheck-suppress unusedFunction
         inline void ProcessEvent(IEvent& event) override
         {
-            LogEvent(event);
+            LogEvent(event.Type());
 
             m_HotkeyRegister.ProcessEvent(event);
 
@@ -59,43 +76,160 @@ namespace JE
                 });
         }
 
+        /// Same handling as the IEvent overload with a single visit, the processors get the typed event
+        inline void ProcessEvent(Event& event)
+        {
+            LogEvent(EventTypeOf(event));
+
+            EventDispatcher::Visit(event,
+                                   EventHandlers{[this]([[maybe_unused]] const QuitEvent& evnt)
+                                                 {
+                                                     m_Running = false;
+                                                     return true;
+                                                 },
+                                                 [this](const KeyDownEvent& evnt)
+                                                 {
+                                                     m_HotkeyRegister.Handle(evnt);
+                                                     return m_InputController.Handle(evnt);
+                                                 },
+                                                 [this](const KeyUpEvent& evnt)
+                                                 { return m_InputController.Handle(evnt); },
+                                                 [this](const MouseMoveEvent& evnt)
+                                                 { return m_InputController.Handle(evnt); }});
+        }
+
         inline void ProcessEvents()
         {
             ASSERT(m_Initialized);
 
             m_InputController.NewFrame();
-            while (EnginePlatform().PollEvents(*this)) {
+
+            std::size_t count = 0;
+            do {
+                count = EnginePlatform().PollEvents(m_EventBatch);
+                for (auto& event : std::span{m_EventBatch}.first(count)) {
+                    ProcessEvent(event);
+                }
+                m_EventsProcessed += count;
+            } while (count == m_EventBatch.size());
+
+            // Events posted past the limit wait for the next frame, busy producers can't stall the loop
+            Event posted;
+            for (std::size_t i = 0; i < m_MaxPostedEventsPerFrame && m_PostedEvents.TryPop(posted); ++i) {
+                ProcessEvent(posted);
                 ++m_EventsProcessed;
             }
+
+            m_InputController.Publish();
         }
 
+        /// Safe from any thread, the event is processed by the next ProcessEvents after the platform events. False if
+        /// the queue is full
+        inline auto PostEvent(Event event) -> bool { return m_PostedEvents.TryPush(std::move(event)); }
+        inline void SetMaxPostedEventsPerFrame(std::size_t count) { m_MaxPostedEventsPerFrame = count; }
+
         inline void Loop(std::int64_t loop_count = -1)
         {
             ASSERT(m_Initialized);
 
             m_Running = true;
+            m_LastFrameTime = PerformanceClock::now();
             while (m_LoopCount != loop_count && m_Running) {
-                ProcessEvents();
+                m_FramePacer.BeginFrame();
+                ResourceTracker().BeginFrame();
 
-                m_Renderer.Begin(m_MainWindow, {1.0f, 0, 0, 1});
-                m_Renderer.DrawQuad({0, 0, 1.0f, 1.0f}, m_InputController.MousePos(), {0, 0, 0}, {1, 1, 1});
-                m_Renderer.End();
+                ProcessEvents();
+                FixedUpdate(PerformanceClock::now());
+
+                if (m_TextureUploader) {
+                    m_TextureUploader->Process();
+                }
+
+                // All windows are rendered in one pass and presented together at the end of the frame
+                static constexpr auto CLEAR_COLOR = RGBA{1.0f, 0, 0, 1};
+                for (std::size_t window = 0; window < m_Windows.size(); ++window) {
+                    IRenderTarget* target = m_Windows[window];
+                    const bool SCALED = window == 0 && m_DynamicResolution;
+                    if (SCALED) {
+                        m_DynamicResolution->BeginFrame(m_MainWindow->Size(), m_FramePacer.WorkTime());
+                        target = m_DynamicResolution.get();
+                    }
+
+                    m_Renderer.Begin(target, CLEAR_COLOR);
+                    m_WindowRenderFunctions[window](*m_Windows[window], m_Renderer);
+                    m_Renderer.End();
+
+                    if (SCALED) {
+                        m_DynamicResolution->Upscale(m_Renderer, *m_MainWindow, CLEAR_COLOR);
+                    }
+                }
 
                 m_Renderer.ProcessCommandQueue();
 
-                m_MainWindow->GraphicsContext().SwapBuffers();
+                m_FramePacer.EndFrame();
+
+                SwapWindows(m_Windows);
+                RendererAPI().EndFrame();
 
                 ++m_LoopCount;
             }
 
             // Flush the last processed event
-            const UnknownEvent DUMMY;
-            LogEvent(DUMMY);
+            LogEvent(IEvent::EventType::UNKNOWN);
         }
 
         inline auto MainWindow() -> IWindow& { return *m_MainWindow; }
+        /// The main window comes first, followed by the viewport windows in creation order
+        inline auto Windows() const -> std::span<IWindow* const> { return m_Windows; }
+
+        /// Additional window rendered every frame after the main window, nullptr if it couldn't be created
+        inline auto CreateViewportWindow(std::string_view title,
+                                         WindowRenderFunction render,
+                                         const Size2D& size = IWindow::DEFAULT_WINDOW_SIZE) -> IWindow*
+        {
+            ASSERT(m_Initialized);
+
+            auto* window = CreateWindow(title, size);
+            if (!window->Created()) {
+                EngineLogger()->error("Failed to create viewport window ({})", title);
+                return nullptr;
+            }
+
+            m_Windows.push_back(window);
+            m_WindowRenderFunctions.push_back(std::move(render));
+            return window;
+        }
         inline auto Renderer() -> JE::Renderer& { return m_Renderer; }
         inline auto InputController() -> JE::InputController& { return m_InputController; }
+        inline auto HotkeyRegister() -> JE::HotkeyRegister& { return m_HotkeyRegister; }
+        inline auto FramePacer() -> JE::FramePacer& { return m_FramePacer; }
+        inline auto FixedTimestep() -> JE::FixedTimestep& { return m_FixedTimestep; }
+
+        /// Renders the main window's scene at a resolution that follows the measured GPU time and upscales it before
+        /// the swap, std::nullopt renders at the window's resolution again
+        inline void SetDynamicResolution(const std::optional<DynamicResolutionSettings>& settings)
+        {
+            if (!settings) {
+                m_DynamicResolution.reset();
+            } else if (m_DynamicResolution) {
+                m_DynamicResolution->SetSettings(*settings);
+            } else {
+                m_DynamicResolution = CreateScope<JE::DynamicResolution>(*settings);
+            }
+        }
+        inline auto DynamicResolution() -> JE::DynamicResolution* { return m_DynamicResolution.get(); }
+
+        /// Streamed texture uploads queued here are processed once per frame within the uploader's frame budget
+        inline auto TextureUploader() -> ITextureUploader&
+        {
+            if (!m_TextureUploader) {
+                m_TextureUploader = CreateTextureUploader();
+            }
+            return *m_TextureUploader;
+        }
+
+        /// Called with the fixed delta time in seconds for every simulation step
+        inline void SetFixedUpdate(FixedUpdateFunction update) { m_FixedUpdate = std::move(update); }
 
         inline auto LoopCount() const -> std::int64_t { return m_LoopCount; }
         inline auto Running() const -> bool { return m_Running; }
@@ -117,6 +251,11 @@ namespace JE
                 return;
             }
 
+            m_Windows.push_back(m_MainWindow);
+            m_WindowRenderFunctions.emplace_back(
+                [this]([[maybe_unused]] IWindow& window, JE::Renderer& renderer)
+                { renderer.DrawQuad({0, 0, 1.0f, 1.0f}, m_InputController.MousePos(), {0, 0, 0}, {1, 1, 1}); });
+
             ImpulseAudio::TestStuff();
 
             m_HotkeyRegister.RegisterAction(KeyCode::F1,
@@ -132,14 +271,27 @@ namespace JE
             m_Initialized = true;
         }
 
-        static inline void LogEvent(const IEvent& event)
+        inline void FixedUpdate(PerformanceClock::time_point frame_time)
+        {
+            m_FixedTimestep.Advance(frame_time - m_LastFrameTime);
+            m_LastFrameTime = frame_time;
+
+            while (m_FixedTimestep.Step()) {
+                if (m_FixedUpdate) {
+                    m_FixedUpdate(m_FixedTimestep.DeltaTime());
+                }
+            }
+
+            m_Renderer.SetInterpolationAlpha(static_cast<float>(m_FixedTimestep.Alpha()));
+        }
+
+        static inline void LogEvent(IEvent::EventType type)
         {
             static IEvent::EventType s_LastEventType = IEvent::EventType::UNKNOWN;
             static std::uint32_t s_EventCounter = 0;
 
-            if (event.Type() == s_LastEventType) {
+            if (type == s_LastEventType) {
                 s_EventCounter++;
-                s_LastEventType = event.Type();
                 return;
             }
 
@@ -155,17 +307,28 @@ namespace JE
             }
 
             s_EventCounter = 1;
-            s_LastEventType = event.Type();
+            s_LastEventType = type;
         }
 
         IWindow* m_MainWindow = nullptr;
+        Vector<IWindow*> m_Windows;
+        Vector<WindowRenderFunction> m_WindowRenderFunctions;
         JE::Renderer m_Renderer;
         JE::InputController m_InputController;
         JE::HotkeyRegister m_HotkeyRegister;
+        JE::FramePacer m_FramePacer;
+        JE::FixedTimestep m_FixedTimestep;
+        FixedUpdateFunction m_FixedUpdate;
+        Scope<ITextureUploader> m_TextureUploader;
+        Scope<JE::DynamicResolution> m_DynamicResolution;
+        PerformanceClock::time_point m_LastFrameTime;
 
         std::int64_t m_LoopCount = 0;
         bool m_Running = false;
         std::uint64_t m_EventsProcessed = 0;
+        std::array<Event, IPlatform::EVENT_BATCH_SIZE> m_EventBatch;
+        MPSCQueue<Event> m_PostedEvents{POSTED_EVENT_CAPACITY};
+        std::size_t m_MaxPostedEventsPerFrame = DEFAULT_MAX_POSTED_EVENTS_PER_FRAME;
 
         bool m_Initialized = false;
     };
@@ -177,5 +340,10 @@ namespace JE
     }
 
     inline auto Input() -> InputController& { return Application().InputController(); }
+    /// Can be called from any thread, e.g. by asset loaders to notify the main loop
+    inline auto PostEvent(Event event) -> bool { return Application().PostEvent(std::move(event)); }
+
+    /// Input of the last processed frame, unlike Input() it can be read from any thread
+    inline auto InputState() -> InputSnapshot { return Application().InputController().PublishedSnapshot(); }
 
 }  // namespace JE
\ No newline at end of file
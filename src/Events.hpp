@@ -1,13 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <string_view>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <variant>
 
 #include "Base.hpp"
 #include "Logger.hpp"
+#include "SeqLock.hpp"
 #include "Types.hpp"
 
 namespace JE
@@ -570,15 +578,11 @@ namespace JE
       public:
         friend class EventDispatcher;
 
-        IEvent(const IEvent& other) = delete;
-        IEvent(IEvent&& other) = delete;
-        auto operator=(const IEvent& other) -> IEvent& = delete;
-        auto operator=(IEvent&& other) -> IEvent& = delete;
-
         enum class EventCategory
         {
             UNKNOWN,
             APP,
+            WINDOW,
             KEYBOARD,
             MOUSE
         };
@@ -587,9 +591,15 @@ namespace JE
         {
             UNKNOWN,
             QUIT,
+            WINDOW_RESIZE,
+            WINDOW_CLOSE,
             KEY_DOWN,
             KEY_UP,
-            MOUSE_MOVE
+            TEXT_INPUT,
+            MOUSE_MOVE,
+            MOUSE_BUTTON_DOWN,
+            MOUSE_BUTTON_UP,
+            MOUSE_WHEEL
         };
 
         IEvent() = default;
@@ -600,6 +610,13 @@ namespace JE
 
         inline auto Handled() const -> bool { return m_Handled; }
 
+      protected:
+        /// Only the final event types can be copied, they are held by value in Event
+        IEvent(const IEvent& other) = default;
+        IEvent(IEvent&& other) = default;
+        auto operator=(const IEvent& other) -> IEvent& = default;
+        auto operator=(IEvent&& other) -> IEvent& = default;
+
       private:
         inline void SetEventHandled() { m_Handled = true; }
 
@@ -611,10 +628,17 @@ namespace JE
         switch (type) {
             case IEvent::EventType::QUIT:
                 return IEvent::EventCategory::APP;
+            case IEvent::EventType::WINDOW_RESIZE:
+            case IEvent::EventType::WINDOW_CLOSE:
+                return IEvent::EventCategory::WINDOW;
             case IEvent::EventType::KEY_DOWN:
             case IEvent::EventType::KEY_UP:
+            case IEvent::EventType::TEXT_INPUT:
                 return IEvent::EventCategory::KEYBOARD;
             case IEvent::EventType::MOUSE_MOVE:
+            case IEvent::EventType::MOUSE_BUTTON_DOWN:
+            case IEvent::EventType::MOUSE_BUTTON_UP:
+            case IEvent::EventType::MOUSE_WHEEL:
                 return IEvent::EventCategory::MOUSE;
 
             case IEvent::EventType::UNKNOWN:
@@ -628,6 +652,8 @@ namespace JE
         switch (category) {
             case IEvent::EventCategory::APP:
                 return "APP";
+            case IEvent::EventCategory::WINDOW:
+                return "WINDOW";
             case IEvent::EventCategory::KEYBOARD:
                 return "KEYBOARD";
             case IEvent::EventCategory::MOUSE:
@@ -643,12 +669,24 @@ namespace JE
         switch (type) {
             case IEvent::EventType::QUIT:
                 return "QUIT";
+            case IEvent::EventType::WINDOW_RESIZE:
+                return "WINDOW_RESIZE";
+            case IEvent::EventType::WINDOW_CLOSE:
+                return "WINDOW_CLOSE";
             case IEvent::EventType::KEY_DOWN:
                 return "KEY_DOWN";
             case IEvent::EventType::KEY_UP:
                 return "KEY_UP";
+            case IEvent::EventType::TEXT_INPUT:
+                return "TEXT_INPUT";
             case IEvent::EventType::MOUSE_MOVE:
                 return "MOUSE_MOTION";
+            case IEvent::EventType::MOUSE_BUTTON_DOWN:
+                return "MOUSE_BUTTON_DOWN";
+            case IEvent::EventType::MOUSE_BUTTON_UP:
+                return "MOUSE_BUTTON_UP";
+            case IEvent::EventType::MOUSE_WHEEL:
+                return "MOUSE_WHEEL";
 
             default:
                 return "UNKNOWN";
@@ -669,34 +707,6 @@ namespace JE
         virtual void ProcessEvent(IEvent& event) = 0;
     };
 
-    class EventDispatcher
-    {
-      public:
-        explicit EventDispatcher(IEvent& event)
-            : m_Event(event)
-        {
-        }
-
-        template<typename EventType, typename Func>
-        inline auto Dispatch(Func func) -> bool
-        {
-            static_assert(std::is_base_of_v<IEvent, EventType>, "Events have to derive from IEvent");
-
-            if (m_Event.Handled() || EventType::StaticType() != m_Event.Type()) {
-                return false;
-            }
-
-            if (func(static_cast<EventType&>(m_Event))) {
-                m_Event.SetEventHandled();
-            }
-
-            return true;
-        }
-
-      private:
-        IEvent& m_Event;  // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
-    };
-
     class UnknownEvent final : public IEvent
     {
       public:
@@ -719,6 +729,38 @@ namespace JE
         static constexpr auto StaticType() -> EventType { return EventType::QUIT; }
     };
 
+    /// The size of a window changed, in window coordinates which are larger than pixels on high DPI displays
+    class WindowResizeEvent final : public IEvent
+    {
+      public:
+        explicit WindowResizeEvent(const Size2D& size)
+            : m_Size(size)
+        {
+        }
+
+        inline auto Category() const -> EventCategory override { return EventCategory::WINDOW; }
+        inline auto Type() const -> EventType override { return EventType::WINDOW_RESIZE; }
+
+        static constexpr auto StaticType() -> EventType { return EventType::WINDOW_RESIZE; }
+
+        inline auto Size() const -> const Size2D& { return m_Size; }
+
+      private:
+        Size2D m_Size;
+    };
+
+    /// The close button of a window was pressed, closing the last window also sends a QuitEvent
+    class WindowCloseEvent final : public IEvent
+    {
+      public:
+        using IEvent::IEvent;
+
+        inline auto Category() const -> EventCategory override { return EventCategory::WINDOW; }
+        inline auto Type() const -> EventType override { return EventType::WINDOW_CLOSE; }
+
+        static constexpr auto StaticType() -> EventType { return EventType::WINDOW_CLOSE; }
+    };
+
     class KeyDownEvent final : public IEvent
     {
       public:
@@ -763,6 +805,41 @@ namespace JE
         bool m_Pressed;
     };
 
+    /// UTF-8 text typed by the user, unlike key events it takes the layout and input methods into account
+    class TextInputEvent final : public IEvent
+    {
+      public:
+        /// Longer text is split over several events
+        static constexpr std::size_t MAX_TEXT_SIZE = 32;
+
+        explicit TextInputEvent(std::string_view text)
+        {
+            m_Size = std::min(text.size(), MAX_TEXT_SIZE);
+            std::copy_n(text.begin(), m_Size, m_Text.begin());
+        }
+
+        inline auto Category() const -> EventCategory override { return EventCategory::KEYBOARD; }
+        inline auto Type() const -> EventType override { return EventType::TEXT_INPUT; }
+
+        static constexpr auto StaticType() -> EventType { return EventType::TEXT_INPUT; }
+
+        inline auto Text() const -> std::string_view { return {m_Text.data(), m_Size}; }
+
+      private:
+        std::array<char, MAX_TEXT_SIZE> m_Text{};
+        std::size_t m_Size = 0;
+    };
+
+    /// Values match the SDL button indices
+    enum class MouseButton : std::uint8_t
+    {
+        LEFT = 1,
+        MIDDLE = 2,
+        RIGHT = 3,
+        X1 = 4,
+        X2 = 5
+    };
+
     class MouseMoveEvent final : public IEvent
     {
       public:
@@ -786,73 +863,278 @@ namespace JE
         glm::vec2 m_RelativePosition;
     };
 
-    class InputController : public IEventProcessor
+    class MouseButtonDownEvent final : public IEvent
     {
       public:
-        inline void NewFrame()
+        MouseButtonDownEvent(MouseButton button, const glm::vec2& position)
+            : m_Button(button)
+            , m_Position(position)
         {
-            m_MouseFrameMotion = {0, 0};
-            m_PreviousKeyMap = m_KeyMap;
         }
 
-        inline void ProcessEvent(IEvent& event) override
+        inline auto Category() const -> EventCategory override { return EventCategory::MOUSE; }
+        inline auto Type() const -> EventType override { return EventType::MOUSE_BUTTON_DOWN; }
+
+        static constexpr auto StaticType() -> EventType { return EventType::MOUSE_BUTTON_DOWN; }
+
+        inline auto Button() const -> MouseButton { return m_Button; }
+        inline auto Position() const -> const glm::vec2& { return m_Position; }
+
+      private:
+        MouseButton m_Button;
+        glm::vec2 m_Position;
+    };
+
+    class MouseButtonUpEvent final : public IEvent
+    {
+      public:
+        MouseButtonUpEvent(MouseButton button, const glm::vec2& position)
+            : m_Button(button)
+            , m_Position(position)
         {
-            EventDispatcher dispatcher{event};
-            dispatcher.Dispatch<KeyDownEvent>(
-                [this](const KeyDownEvent& evnt)
-                {
-                    m_KeyMap[evnt.Code()] = evnt.Pressed();
-                    return true;
-                });
-            dispatcher.Dispatch<KeyUpEvent>(
-                [this](const KeyUpEvent& evnt)
-                {
-                    m_KeyMap[evnt.Code()] = evnt.Pressed();
-                    return true;
-                });
+        }
+
+        inline auto Category() const -> EventCategory override { return EventCategory::MOUSE; }
+        inline auto Type() const -> EventType override { return EventType::MOUSE_BUTTON_UP; }
+
+        static constexpr auto StaticType() -> EventType { return EventType::MOUSE_BUTTON_UP; }
+
+        inline auto Button() const -> MouseButton { return m_Button; }
+        inline auto Position() const -> const glm::vec2& { return m_Position; }
 
-            dispatcher.Dispatch<MouseMoveEvent>(
-                [this](const MouseMoveEvent& evnt)
-                {
-                    m_MouseFrameMotion.x += evnt.Motion().x;  // NOLINT
-                    m_MouseFrameMotion.y += evnt.Motion().y;  // NOLINT
+      private:
+        MouseButton m_Button;
+        glm::vec2 m_Position;
+    };
+
+    /// Positive Y scrolls away from the user, positive X to the right
+    class MouseWheelEvent final : public IEvent
+    {
+      public:
+        explicit MouseWheelEvent(const glm::vec2& scroll)
+            : m_Scroll(scroll)
+        {
+        }
+
+        inline auto Category() const -> EventCategory override { return EventCategory::MOUSE; }
+        inline auto Type() const -> EventType override { return EventType::MOUSE_WHEEL; }
 
-                    m_MousePosition = evnt.Position();
+        static constexpr auto StaticType() -> EventType { return EventType::MOUSE_WHEEL; }
 
+        inline auto Scroll() const -> const glm::vec2& { return m_Scroll; }
+
+      private:
+        glm::vec2 m_Scroll;
+    };
+
+    /// Value representation of every engine event, processed without virtual calls through EventDispatcher::Visit
+    using Event = std::variant<UnknownEvent,
+                               QuitEvent,
+                               WindowResizeEvent,
+                               WindowCloseEvent,
+                               KeyDownEvent,
+                               KeyUpEvent,
+                               TextInputEvent,
+                               MouseMoveEvent,
+                               MouseButtonDownEvent,
+                               MouseButtonUpEvent,
+                               MouseWheelEvent>;
+
+    /// Combines lambdas into one visitor, e.g. EventHandlers{[](KeyDownEvent&) { ... }, [](QuitEvent&) { ... }}
+    template<typename... Handlers>
+    struct EventHandlers : Handlers...
+    {
+        using Handlers::operator()...;
+    };
+
+    inline auto EventTypeOf(const Event& event) -> IEvent::EventType
+    {
+        return std::visit([](const auto& evnt) { return std::remove_cvref_t<decltype(evnt)>::StaticType(); }, event);
+    }
+
+    class EventDispatcher
+    {
+      public:
+        explicit EventDispatcher(IEvent& event)
+            : m_Event(event)
+        {
+        }
+
+        template<typename EventType, typename Func>
+        inline auto Dispatch(Func func) -> bool
+        {
+            static_assert(std::is_base_of_v<IEvent, EventType>, "Events have to derive from IEvent");
+
+            if (m_Event.Handled() || EventType::StaticType() != m_Event.Type()) {
+                return false;
+            }
+
+            if (func(static_cast<EventType&>(m_Event))) {
+                m_Event.SetEventHandled();
+            }
+
+            return true;
+        }
+
+        /// Calls the overload of visitor taking the held event type, resolved at compile time so dispatching costs
+        /// about as much as a switch. Returns false for handled events and event types visitor has no overload for
+        template<typename Visitor>
+        static auto Visit(Event& event, Visitor&& visitor) -> bool;
+
+      private:
+        IEvent& m_Event;  // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+    };
+
+    template<typename Visitor>
+    inline auto EventDispatcher::Visit(Event& event, Visitor&& visitor) -> bool
+    {
+        return std::visit(
+            [&visitor](auto& evnt)
+            {
+                using EventType = std::remove_cvref_t<decltype(evnt)>;
+                if constexpr (std::is_invocable_r_v<bool, Visitor&, EventType&>) {
+                    if (evnt.Handled()) {
+                        return false;
+                    }
+                    if (visitor(evnt)) {
+                        evnt.SetEventHandled();
+                    }
                     return true;
-                });
+                } else {
+                    return false;
+                }
+            },
+            event);
+    }
+
+    inline constexpr std::size_t CHARACTER_KEY_COUNT = 128;
+    inline constexpr std::size_t KEY_INDEX_COUNT =
+        CHARACTER_KEY_COUNT + static_cast<std::size_t>(ScanCode::NUM_SCANCODES);
+    inline constexpr std::size_t INVALID_KEY_INDEX = KEY_INDEX_COUNT;
+
+    /// Dense index of a key into the key state bitsets. Character keys keep their value, keys without a character
+    /// follow indexed by their ScanCode. Characters outside of ASCII (non US layouts) have no index
+    constexpr auto KeyIndex(KeyCode key) -> std::size_t
+    {
+        const auto VALUE = static_cast<std::uint32_t>(key);
+        if ((VALUE & SCANCODE_MASK) != 0u) {
+            const auto SCAN_CODE = static_cast<std::size_t>(VALUE & ~SCANCODE_MASK);
+            return SCAN_CODE < static_cast<std::size_t>(ScanCode::NUM_SCANCODES) ? CHARACTER_KEY_COUNT + SCAN_CODE
+                                                                                  : INVALID_KEY_INDEX;
         }
 
+        return VALUE < CHARACTER_KEY_COUNT ? VALUE : INVALID_KEY_INDEX;
+    }
+
+    /// State of the keyboard and the mouse for one frame
+    struct InputSnapshot
+    {
+        std::bitset<KEY_INDEX_COUNT> Keys;
+        glm::vec2 MousePosition{0.f};
+        glm::vec2 MouseFrameMotion{0.f};
+        /// Number of published snapshots up to this one, 0 before the first publish
+        std::uint64_t Frame = 0;
+
         inline auto KeyPressed(KeyCode key) const -> bool
         {
-            auto iter = m_KeyMap.find(key);
-            if (iter != std::end(m_KeyMap)) {
-                return iter->second;
-            }
+            const auto INDEX = KeyIndex(key);
+            return INDEX != INVALID_KEY_INDEX && Keys.test(INDEX);
+        }
+    };
 
-            return false;
+    class InputController : public IEventProcessor
+    {
+      public:
+        /// The snapshots swap roles, the new current one starts out with the keys and position of the previous frame
+        inline void NewFrame()
+        {
+            std::swap(m_Current, m_Previous);
+            m_Current->Keys = m_Previous->Keys;
+            m_Current->MousePosition = m_Previous->MousePosition;
+            m_Current->MouseFrameMotion = {0, 0};
+        }
+
+        inline void ProcessEvent(IEvent& event) override
+        {
+            EventDispatcher dispatcher{event};
+            dispatcher.Dispatch<KeyDownEvent>([this](const KeyDownEvent& evnt) { return Handle(evnt); });
+            dispatcher.Dispatch<KeyUpEvent>([this](const KeyUpEvent& evnt) { return Handle(evnt); });
+            dispatcher.Dispatch<MouseMoveEvent>([this](const MouseMoveEvent& evnt) { return Handle(evnt); });
+        }
+
+        /// Typed handlers for visitors of Event, ProcessEvent forwards to them as well
+        inline auto Handle(const KeyDownEvent& event) -> bool
+        {
+            SetKey(event.Code(), event.Pressed());
+            return true;
         }
 
+        inline auto Handle(const KeyUpEvent& event) -> bool
+        {
+            SetKey(event.Code(), event.Pressed());
+            return true;
+        }
+
+        inline auto Handle(const MouseMoveEvent& event) -> bool
+        {
+            m_Current->MouseFrameMotion += event.Motion();
+            m_Current->MousePosition = event.Position();
+            return true;
+        }
+
+        inline auto KeyPressed(KeyCode key) const -> bool { return m_Current->KeyPressed(key); }
+
         inline auto KeyReleased(KeyCode key) const -> bool { return !KeyPressed(key); }
 
+        /// Pressed this frame and released the frame before
         inline auto KeyPressedOnce(KeyCode key) const -> bool
         {
-            auto iter = m_KeyMap.find(key);
-            auto iter2 = m_PreviousKeyMap.find(key);
-            return iter != std::end(m_KeyMap) && iter2 == std::end(m_PreviousKeyMap);
+            return m_Current->KeyPressed(key) && !m_Previous->KeyPressed(key);
+        }
+
+        /// Released this frame and pressed the frame before
+        inline auto KeyReleasedOnce(KeyCode key) const -> bool
+        {
+            return !m_Current->KeyPressed(key) && m_Previous->KeyPressed(key);
         }
 
-        inline auto KeyReleasedOnce(KeyCode key) const -> bool { return !KeyPressedOnce(key); }
+        inline auto MousePos() const -> const glm::vec2& { return m_Current->MousePosition; }
+        inline auto MouseFrameMotion() const -> const glm::vec2& { return m_Current->MouseFrameMotion; }
 
-        inline auto MousePos() const -> const glm::vec2& { return m_MousePosition; }
-        inline auto MouseFrameMotion() const -> const glm::vec2& { return m_MouseFrameMotion; }
+        inline auto Snapshot() const -> const InputSnapshot& { return *m_Current; }
+        inline auto PreviousSnapshot() const -> const InputSnapshot& { return *m_Previous; }
+
+        /// Publishes a copy of the current snapshot, called by the thread processing the events once they were all
+        /// handled
+        inline void Publish()
+        {
+            InputSnapshot snapshot = *m_Current;
+            snapshot.Frame = ++m_PublishedFrame;
+            m_Published.Store(snapshot);
+        }
+
+        /// Copies the latest published snapshot, safe from any thread without locking
+        /// \returns false if a publish overlapped the copy, snapshot is left unchanged then
+        inline auto TryReadSnapshot(InputSnapshot& snapshot) const -> bool { return m_Published.TryLoad(snapshot); }
+
+        /// Copy of the latest published snapshot, safe from any thread, retries while a publish overlaps the copy
+        inline auto PublishedSnapshot() const -> InputSnapshot { return m_Published.Load(); }
 
       private:
-        std::unordered_map<KeyCode, bool> m_KeyMap;
-        std::unordered_map<KeyCode, bool> m_PreviousKeyMap;
+        inline void SetKey(KeyCode key, bool pressed)
+        {
+            const auto INDEX = KeyIndex(key);
+            if (INDEX != INVALID_KEY_INDEX) {
+                m_Current->Keys.set(INDEX, pressed);
+            }
+        }
+
+        std::array<InputSnapshot, 2> m_Snapshots{};
+        InputSnapshot* m_Current = &m_Snapshots[0];
+        InputSnapshot* m_Previous = &m_Snapshots[1];
 
-        glm::vec2 m_MouseFrameMotion;
-        glm::vec2 m_MousePosition;
+        std::uint64_t m_PublishedFrame = 0;
+        SeqLock<InputSnapshot> m_Published;
     };
 
     class HotkeyRegister : public IEventProcessor
@@ -891,17 +1173,19 @@ namespace JE
         inline void ProcessEvent(IEvent& event) override
         {
             EventDispatcher dispatcher{event};
-            dispatcher.Dispatch<KeyDownEvent>(
-                [this](const KeyDownEvent& evnt)
-                {
-                    auto iter = m_ActionMap.find(evnt.Code());
-                    if (iter != std::end(m_ActionMap)) {
-                        iter->second.Action(iter->second.Toggle);
-                        iter->second.Toggle = !iter->second.Toggle;
-                    }
+            dispatcher.Dispatch<KeyDownEvent>([this](const KeyDownEvent& evnt) { return Handle(evnt); });
+        }
 
-                    return false;
-                });
+        /// Hotkeys never handle the event, the key still reaches the InputController
+        inline auto Handle(const KeyDownEvent& event) -> bool
+        {
+            auto iter = m_ActionMap.find(event.Code());
+            if (iter != std::end(m_ActionMap)) {
+                iter->second.Action(iter->second.Toggle);
+                iter->second.Toggle = !iter->second.Toggle;
+            }
+
+            return false;
         }
 
       private:
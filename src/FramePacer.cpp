@@ -0,0 +1,162 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "Assert.hpp"
+#include "Graphics/IRendererAPI.hpp"
+#include "Logger.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+        using Seconds = std::chrono::duration<double>;
+
+        constexpr auto SLEEP_QUANTUM = std::chrono::milliseconds{1};
+        constexpr auto INITIAL_SLEEP_ESTIMATE = 0.005;
+        constexpr auto SLEEP_ESTIMATE_DEVIATIONS = 1.0;
+
+        // Running estimate of how long a SLEEP_QUANTUM sleep actually takes on this system (Welford's algorithm)
+        struct SleepEstimator
+        {
+            double Estimate = INITIAL_SLEEP_ESTIMATE;
+            double Mean = INITIAL_SLEEP_ESTIMATE;
+            double M2 = 0;
+            std::uint64_t Count = 1;
+
+            inline void AddSample(double observed)
+            {
+                ++Count;
+                const auto DELTA = observed - Mean;
+                Mean += DELTA / static_cast<double>(Count);
+                M2 += DELTA * (observed - Mean);
+
+                const auto STDDEV = std::sqrt(M2 / static_cast<double>(Count - 1));
+                Estimate = Mean + STDDEV * SLEEP_ESTIMATE_DEVIATIONS;
+            }
+        };
+
+        thread_local SleepEstimator g_SleepEstimator;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+    }  // namespace
+
+    FramePacer::~FramePacer() { ReleaseFences(); }
+
+    void FramePacer::SleepUntil(Clock::time_point deadline)
+    {
+        auto remaining = Seconds{deadline - Clock::now()}.count();
+        while (remaining > g_SleepEstimator.Estimate) {
+            const auto SLEEP_START = Clock::now();
+            std::this_thread::sleep_for(SLEEP_QUANTUM);
+            const auto SLEEP_END = Clock::now();
+
+            g_SleepEstimator.AddSample(Seconds{SLEEP_END - SLEEP_START}.count());
+            remaining = Seconds{deadline - SLEEP_END}.count();
+        }
+
+        while (Clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    }
+
+    void FramePacer::SetSettings(const FramePacingSettings& settings)
+    {
+        ASSERT(settings.MaxFramesInFlight <= MAX_FRAMES_IN_FLIGHT_LIMIT);
+
+        ReleaseFences();
+
+        m_Settings = settings;
+        m_Settings.MaxFramesInFlight = std::min(m_Settings.MaxFramesInFlight, MAX_FRAMES_IN_FLIGHT_LIMIT);
+        m_Scheduled = false;
+
+        EngineLogger()->debug("Frame pacing - target frame rate: {} | low latency: {} | max frames in flight: {}",
+                              m_Settings.TargetFrameRate,
+                              m_Settings.LowLatency,
+                              m_Settings.MaxFramesInFlight);
+    }
+
+    void FramePacer::BeginFrame()
+    {
+        // The previous frame has been presented, with vsync SwapBuffers blocks until the vertical blank
+        const auto FRAME_BOUNDARY = Clock::now();
+
+        WaitForFrameInFlight();
+
+        if (m_Settings.TargetFrameRate != FramePacingSettings::UNLIMITED_FRAME_RATE) {
+            const auto FRAME_PERIOD = std::chrono::duration_cast<Clock::duration>(
+                Seconds{1.0 / static_cast<double>(m_Settings.TargetFrameRate)});
+
+            m_NextPresentTime += FRAME_PERIOD;
+            if (!m_Scheduled || m_NextPresentTime < FRAME_BOUNDARY) {
+                // Missed the schedule (or got blocked on vsync) - resynchronize instead of bursting to catch up
+                m_NextPresentTime = FRAME_BOUNDARY + FRAME_PERIOD;
+                m_Scheduled = true;
+            }
+
+            auto wake_time = m_NextPresentTime - FRAME_PERIOD;
+            if (m_Settings.LowLatency) {
+                wake_time = m_NextPresentTime - m_PredictedWorkTime - LOW_LATENCY_SAFETY_MARGIN;
+            }
+
+            SleepUntil(wake_time);
+        }
+
+        // The first frame has no previous one, its frame time would be measured from the clock's epoch
+        const auto FRAME_START = Clock::now();
+        m_FrameTime = m_FrameStarted ? FRAME_START - m_FrameStartTime : Clock::duration::zero();
+        m_FrameStartTime = FRAME_START;
+        m_FrameStarted = true;
+    }
+
+    void FramePacer::EndFrame()
+    {
+        m_WorkTime = Clock::now() - m_FrameStartTime;
+        m_PredictedWorkTime = std::chrono::duration_cast<Clock::duration>(
+            Seconds{m_PredictedWorkTime} * (1.0 - WORK_TIME_SMOOTHING) + Seconds{m_WorkTime} * WORK_TIME_SMOOTHING);
+
+        if (m_Settings.MaxFramesInFlight == 0) {
+            RendererAPI().Finish();
+        } else {
+            auto& fence = m_FrameFences[m_FrameIndex % m_Settings.MaxFramesInFlight];
+            ASSERT(fence == 0);
+            fence = RendererAPI().InsertFence();
+        }
+
+        ++m_FrameIndex;
+    }
+
+    void FramePacer::WaitForFrameInFlight()
+    {
+        if (m_Settings.MaxFramesInFlight == 0) {
+            return;
+        }
+
+        // The fence in this slot was inserted MaxFramesInFlight frames ago
+        auto& fence = m_FrameFences[m_FrameIndex % m_Settings.MaxFramesInFlight];
+        if (fence == 0) {
+            return;
+        }
+
+        if (!RendererAPI().WaitFence(fence, FENCE_TIMEOUT_NS)) {
+            EngineLogger()->warn("Timed out waiting for frame {} to finish on the GPU",
+                                 m_FrameIndex - m_Settings.MaxFramesInFlight);
+        }
+
+        RendererAPI().DeleteFence(fence);
+        fence = 0;
+    }
+
+    void FramePacer::ReleaseFences()
+    {
+        for (auto& fence : m_FrameFences) {
+            if (fence != 0) {
+                RendererAPI().DeleteFence(fence);
+                fence = 0;
+            }
+        }
+    }
+
+}  // namespace JE
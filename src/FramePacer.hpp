@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "Graphics/IRendererAPI.hpp"
+#include "Time.hpp"
+
+namespace JE
+{
+
+    struct FramePacingSettings
+    {
+        static constexpr std::uint32_t UNLIMITED_FRAME_RATE = 0;
+        static constexpr std::uint32_t DEFAULT_MAX_FRAMES_IN_FLIGHT = 2;
+
+        /// Frames per second the loop is limited to, UNLIMITED_FRAME_RATE disables the limiter
+        std::uint32_t TargetFrameRate = UNLIMITED_FRAME_RATE;
+        /// Delay input sampling and simulation until just before the predicted present
+        bool LowLatency = false;
+        /// How many frames the CPU may run ahead of the GPU, 0 waits for the GPU every frame
+        std::uint32_t MaxFramesInFlight = DEFAULT_MAX_FRAMES_IN_FLIGHT;
+    };
+
+    class FramePacer
+    {
+      public:
+        using Clock = PerformanceClock;
+
+        static constexpr std::uint32_t MAX_FRAMES_IN_FLIGHT_LIMIT = 4;
+        static constexpr std::uint64_t FENCE_TIMEOUT_NS = 1'000'000'000;
+        static constexpr auto LOW_LATENCY_SAFETY_MARGIN = std::chrono::microseconds{1000};
+        static constexpr auto WORK_TIME_SMOOTHING = 0.1;
+
+        FramePacer(const FramePacer& other) = delete;
+        FramePacer(FramePacer&& other) = delete;
+        auto operator=(const FramePacer& other) -> FramePacer& = delete;
+        auto operator=(FramePacer&& other) -> FramePacer& = delete;
+
+        FramePacer() = default;
+        ~FramePacer();
+
+        void SetSettings(const FramePacingSettings& settings);
+        inline auto Settings() const -> const FramePacingSettings& { return m_Settings; }
+
+        /// Waits for the GPU to fall within the frames in flight limit and for the frame limiter deadline
+        void BeginFrame();
+        /// Has to be called after the frame is submitted and before the buffers are swapped
+        void EndFrame();
+
+        inline auto FrameTime() const -> Clock::duration { return m_FrameTime; }
+        inline auto WorkTime() const -> Clock::duration { return m_WorkTime; }
+        inline auto PredictedWorkTime() const -> Clock::duration { return m_PredictedWorkTime; }
+
+        /// Sleeps until the deadline, spinning for the last stretch the OS scheduler can't hit accurately
+        static void SleepUntil(Clock::time_point deadline);
+
+      private:
+        void WaitForFrameInFlight();
+        void ReleaseFences();
+
+        FramePacingSettings m_Settings;
+
+        std::array<IRendererAPI::FenceID, MAX_FRAMES_IN_FLIGHT_LIMIT> m_FrameFences{};
+        std::uint64_t m_FrameIndex = 0;
+
+        bool m_Scheduled = false;
+        Clock::time_point m_NextPresentTime;
+        bool m_FrameStarted = false;
+        Clock::time_point m_FrameStartTime;
+
+        Clock::duration m_FrameTime{};
+        Clock::duration m_WorkTime{};
+        Clock::duration m_PredictedWorkTime{};
+    };
+
+}  // namespace JE
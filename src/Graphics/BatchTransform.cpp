@@ -0,0 +1,359 @@
+#include <array>
+#include <cmath>
+
+#include "BatchTransform.hpp"
+
+#include "Assert.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+        static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "Quad corners are stored as tightly packed floats");
+        static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "Matrices are stored as tightly packed floats");
+
+        // Unit quad corners in the same order as CreateQuadMesh
+        constexpr std::array<glm::vec2, TransformBatch::QUAD_CORNER_COUNT> QUAD_CORNERS = {
+            glm::vec2{-0.5f, 0.5f}, glm::vec2{-0.5f, -0.5f}, glm::vec2{0.5f, -0.5f}, glm::vec2{0.5f, 0.5f}};
+
+        void BuildTransformsScalar(const TransformBatch& transforms, std::span<glm::mat4> matrices, std::size_t first)
+        {
+            for (std::size_t i = first; i < transforms.Size(); ++i) {
+                const auto SIN = std::sin(transforms.Rotation()[i]);
+                const auto COS = std::cos(transforms.Rotation()[i]);
+                const auto SCALE_X = transforms.ScaleX()[i];
+                const auto SCALE_Y = transforms.ScaleY()[i];
+
+                auto& matrix = matrices[i];
+                matrix[0] = {COS * SCALE_X, SIN * SCALE_X, 0.f, 0.f};
+                matrix[1] = {-SIN * SCALE_Y, COS * SCALE_Y, 0.f, 0.f};
+                matrix[2] = {0.f, 0.f, transforms.ScaleZ()[i], 0.f};
+                matrix[3] = {transforms.PositionX()[i], transforms.PositionY()[i], transforms.PositionZ()[i], 1.f};
+            }
+        }
+
+        void BuildQuadCornersScalar(const TransformBatch& transforms, std::span<glm::vec3> corners, std::size_t first)
+        {
+            for (std::size_t i = first; i < transforms.Size(); ++i) {
+                const auto SIN = std::sin(transforms.Rotation()[i]);
+                const auto COS = std::cos(transforms.Rotation()[i]);
+
+                for (std::size_t corner = 0; corner < TransformBatch::QUAD_CORNER_COUNT; ++corner) {
+                    const auto LOCAL_X = QUAD_CORNERS[corner].x * transforms.ScaleX()[i];
+                    const auto LOCAL_Y = QUAD_CORNERS[corner].y * transforms.ScaleY()[i];
+
+                    corners[i * TransformBatch::QUAD_CORNER_COUNT + corner] = {
+                        transforms.PositionX()[i] + COS * LOCAL_X - SIN * LOCAL_Y,
+                        transforms.PositionY()[i] + SIN * LOCAL_X + COS * LOCAL_Y,
+                        transforms.PositionZ()[i]};
+                }
+            }
+        }
+
+#if JE_SIMD_X86
+        // Cody-Waite split of pi/2 and minimax polynomials on [-pi/4, pi/4] (Cephes sinf/cosf)
+        constexpr float TWO_OVER_PI = 0.636619772367581343f;
+        constexpr float PI_OVER_TWO_1 = 1.5703125f;
+        constexpr float PI_OVER_TWO_2 = 4.837512969970703125e-4f;
+        constexpr float PI_OVER_TWO_3 = 7.54978995489188216e-8f;
+
+        constexpr float SIN_C1 = -1.6666654611e-1f;
+        constexpr float SIN_C2 = 8.3321608736e-3f;
+        constexpr float SIN_C3 = -1.9515295891e-4f;
+
+        constexpr float COS_C1 = 4.166664568298827e-2f;
+        constexpr float COS_C2 = -1.388731625493765e-3f;
+        constexpr float COS_C3 = 2.443315711809948e-5f;
+
+        constexpr int QUADRANT_SWAP_BIT = 1;
+        constexpr int QUADRANT_SIGN_BIT = 2;
+        constexpr int QUADRANT_SIGN_SHIFT = 30;  // Moves QUADRANT_SIGN_BIT into the float sign bit
+
+        struct SinCos4
+        {
+            __m128 Sin;
+            __m128 Cos;
+        };
+
+        inline auto SinCos(__m128 angle) -> SinCos4
+        {
+            const auto QUADRANT = _mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(TWO_OVER_PI)));
+            const auto QUADRANT_FLOAT = _mm_cvtepi32_ps(QUADRANT);
+
+            auto x = _mm_sub_ps(angle, _mm_mul_ps(QUADRANT_FLOAT, _mm_set1_ps(PI_OVER_TWO_1)));
+            x = _mm_sub_ps(x, _mm_mul_ps(QUADRANT_FLOAT, _mm_set1_ps(PI_OVER_TWO_2)));
+            x = _mm_sub_ps(x, _mm_mul_ps(QUADRANT_FLOAT, _mm_set1_ps(PI_OVER_TWO_3)));
+
+            const auto X2 = _mm_mul_ps(x, x);
+
+            auto sin = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SIN_C3), X2), _mm_set1_ps(SIN_C2));
+            sin = _mm_add_ps(_mm_mul_ps(sin, X2), _mm_set1_ps(SIN_C1));
+            sin = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sin, X2), x), x);
+
+            auto cos = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(COS_C3), X2), _mm_set1_ps(COS_C2));
+            cos = _mm_add_ps(_mm_mul_ps(cos, X2), _mm_set1_ps(COS_C1));
+            cos = _mm_mul_ps(_mm_mul_ps(cos, X2), X2);
+            cos = _mm_add_ps(_mm_sub_ps(cos, _mm_mul_ps(X2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.f));
+
+            // Odd quadrants swap sin and cos, the sign follows the quadrant
+            const auto SWAP_BIT = _mm_set1_epi32(QUADRANT_SWAP_BIT);
+            const auto SWAP = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(QUADRANT, SWAP_BIT), SWAP_BIT));
+            const auto SIGN_BIT = _mm_set1_epi32(QUADRANT_SIGN_BIT);
+            const auto NEXT_QUADRANT = _mm_add_epi32(QUADRANT, _mm_set1_epi32(1));
+            const auto SIN_SIGN =
+                _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(QUADRANT, SIGN_BIT), QUADRANT_SIGN_SHIFT));
+            const auto COS_SIGN =
+                _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(NEXT_QUADRANT, SIGN_BIT), QUADRANT_SIGN_SHIFT));
+
+            const auto SIN_RESULT = _mm_or_ps(_mm_and_ps(SWAP, cos), _mm_andnot_ps(SWAP, sin));
+            const auto COS_RESULT = _mm_or_ps(_mm_and_ps(SWAP, sin), _mm_andnot_ps(SWAP, cos));
+
+            return {_mm_xor_ps(SIN_RESULT, SIN_SIGN), _mm_xor_ps(COS_RESULT, COS_SIGN)};
+        }
+
+        /// Transposes four SoA lanes into four consecutive AoS vec4s
+        inline void StoreTransposed(
+            __m128 row0, __m128 row1, __m128 row2, __m128 row3, float* first, std::size_t stride)
+        {
+            _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+            _mm_storeu_ps(first, row0);
+            _mm_storeu_ps(first + stride, row1);  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            _mm_storeu_ps(first + 2 * stride, row2);  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            _mm_storeu_ps(first + 3 * stride, row3);  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+
+        struct QuadLanes
+        {
+            __m128 PositionX;
+            __m128 PositionY;
+            __m128 PositionZ;
+            __m128 ScaleX;
+            __m128 ScaleY;
+            __m128 ScaleZ;
+            SinCos4 Rotation;
+        };
+
+        inline void StoreTransforms(const QuadLanes& lanes, glm::mat4* first)
+        {
+            static constexpr std::size_t MATRIX_STRIDE = sizeof(glm::mat4) / sizeof(float);
+
+            const auto ZERO = _mm_setzero_ps();
+            StoreTransposed(_mm_mul_ps(lanes.Rotation.Cos, lanes.ScaleX),
+                            _mm_mul_ps(lanes.Rotation.Sin, lanes.ScaleX),
+                            ZERO,
+                            ZERO,
+                            &(*first)[0].x,
+                            MATRIX_STRIDE);
+            StoreTransposed(_mm_sub_ps(ZERO, _mm_mul_ps(lanes.Rotation.Sin, lanes.ScaleY)),
+                            _mm_mul_ps(lanes.Rotation.Cos, lanes.ScaleY),
+                            ZERO,
+                            ZERO,
+                            &(*first)[1].x,
+                            MATRIX_STRIDE);
+            StoreTransposed(ZERO, ZERO, lanes.ScaleZ, ZERO, &(*first)[2].x, MATRIX_STRIDE);
+            StoreTransposed(
+                lanes.PositionX, lanes.PositionY, lanes.PositionZ, _mm_set1_ps(1.f), &(*first)[3].x, MATRIX_STRIDE);
+        }
+
+        inline void StoreQuadCorners(const QuadLanes& lanes, glm::vec3* first)
+        {
+            static constexpr std::size_t QUAD_STRIDE =
+                sizeof(glm::vec3) * TransformBatch::QUAD_CORNER_COUNT / sizeof(float);
+            static constexpr float HALF = 0.5f;
+
+            // Half extents rotated into world space, corners are the center +- these
+            const auto AXIS_X_X = _mm_mul_ps(lanes.Rotation.Cos, _mm_mul_ps(lanes.ScaleX, _mm_set1_ps(HALF)));
+            const auto AXIS_X_Y = _mm_mul_ps(lanes.Rotation.Sin, _mm_mul_ps(lanes.ScaleX, _mm_set1_ps(HALF)));
+            const auto AXIS_Y_X = _mm_mul_ps(lanes.Rotation.Sin, _mm_mul_ps(lanes.ScaleY, _mm_set1_ps(HALF)));
+            const auto AXIS_Y_Y = _mm_mul_ps(lanes.Rotation.Cos, _mm_mul_ps(lanes.ScaleY, _mm_set1_ps(HALF)));
+
+            // (-x, +y), (-x, -y), (+x, -y), (+x, +y)
+            const auto LEFT_X = _mm_sub_ps(lanes.PositionX, AXIS_X_X);
+            const auto LEFT_Y = _mm_sub_ps(lanes.PositionY, AXIS_X_Y);
+            const auto RIGHT_X = _mm_add_ps(lanes.PositionX, AXIS_X_X);
+            const auto RIGHT_Y = _mm_add_ps(lanes.PositionY, AXIS_X_Y);
+
+            const auto X0 = _mm_sub_ps(LEFT_X, AXIS_Y_X);
+            const auto Y0 = _mm_add_ps(LEFT_Y, AXIS_Y_Y);
+            const auto X1 = _mm_add_ps(LEFT_X, AXIS_Y_X);
+            const auto Y1 = _mm_sub_ps(LEFT_Y, AXIS_Y_Y);
+            const auto X2 = _mm_add_ps(RIGHT_X, AXIS_Y_X);
+            const auto Y2 = _mm_sub_ps(RIGHT_Y, AXIS_Y_Y);
+            const auto X3 = _mm_sub_ps(RIGHT_X, AXIS_Y_X);
+            const auto Y3 = _mm_add_ps(RIGHT_Y, AXIS_Y_Y);
+            const auto Z = lanes.PositionZ;
+
+            // A quad is 12 consecutive floats, written as three transposed groups of four
+            auto* output = &first->x;
+            StoreTransposed(X0, Y0, Z, X1, output, QUAD_STRIDE);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            StoreTransposed(Y1, Z, X2, Y2, output + 4, QUAD_STRIDE);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            StoreTransposed(Z, X3, Y3, Z, output + 8, QUAD_STRIDE);
+        }
+
+        inline auto LoadQuadLanes(const TransformBatch& transforms, std::size_t i) -> QuadLanes
+        {
+            return {_mm_loadu_ps(&transforms.PositionX()[i]),
+                    _mm_loadu_ps(&transforms.PositionY()[i]),
+                    _mm_loadu_ps(&transforms.PositionZ()[i]),
+                    _mm_loadu_ps(&transforms.ScaleX()[i]),
+                    _mm_loadu_ps(&transforms.ScaleY()[i]),
+                    _mm_loadu_ps(&transforms.ScaleZ()[i]),
+                    SinCos(_mm_loadu_ps(&transforms.Rotation()[i]))};
+        }
+
+        constexpr std::size_t SSE_LANES = 4;
+        constexpr std::size_t AVX_LANES = 8;
+
+        auto BuildTransformsSSE(const TransformBatch& transforms, std::span<glm::mat4> matrices) -> std::size_t
+        {
+            const auto COUNT = transforms.Size() - transforms.Size() % SSE_LANES;
+            for (std::size_t i = 0; i < COUNT; i += SSE_LANES) {
+                StoreTransforms(LoadQuadLanes(transforms, i), &matrices[i]);
+            }
+            return COUNT;
+        }
+
+        auto BuildQuadCornersSSE(const TransformBatch& transforms, std::span<glm::vec3> corners) -> std::size_t
+        {
+            const auto COUNT = transforms.Size() - transforms.Size() % SSE_LANES;
+            for (std::size_t i = 0; i < COUNT; i += SSE_LANES) {
+                StoreQuadCorners(LoadQuadLanes(transforms, i), &corners[i * TransformBatch::QUAD_CORNER_COUNT]);
+            }
+            return COUNT;
+        }
+
+        // The AVX2 path evaluates sin/cos, the expensive part, eight lanes at a time with FMA and reuses the SSE
+        // stores per 128 bit half
+        struct SinCos8
+        {
+            __m256 Sin;
+            __m256 Cos;
+        };
+
+        JE_TARGET_AVX2 inline auto SinCosAVX2(__m256 angle) -> SinCos8
+        {
+            const auto QUADRANT = _mm256_cvtps_epi32(_mm256_mul_ps(angle, _mm256_set1_ps(TWO_OVER_PI)));
+            const auto QUADRANT_FLOAT = _mm256_cvtepi32_ps(QUADRANT);
+
+            auto x = _mm256_fnmadd_ps(QUADRANT_FLOAT, _mm256_set1_ps(PI_OVER_TWO_1), angle);
+            x = _mm256_fnmadd_ps(QUADRANT_FLOAT, _mm256_set1_ps(PI_OVER_TWO_2), x);
+            x = _mm256_fnmadd_ps(QUADRANT_FLOAT, _mm256_set1_ps(PI_OVER_TWO_3), x);
+
+            const auto X2 = _mm256_mul_ps(x, x);
+
+            auto sin = _mm256_fmadd_ps(_mm256_set1_ps(SIN_C3), X2, _mm256_set1_ps(SIN_C2));
+            sin = _mm256_fmadd_ps(sin, X2, _mm256_set1_ps(SIN_C1));
+            sin = _mm256_fmadd_ps(_mm256_mul_ps(sin, X2), x, x);
+
+            auto cos = _mm256_fmadd_ps(_mm256_set1_ps(COS_C3), X2, _mm256_set1_ps(COS_C2));
+            cos = _mm256_fmadd_ps(cos, X2, _mm256_set1_ps(COS_C1));
+            cos = _mm256_mul_ps(_mm256_mul_ps(cos, X2), X2);
+            cos = _mm256_add_ps(_mm256_fnmadd_ps(X2, _mm256_set1_ps(0.5f), cos), _mm256_set1_ps(1.f));
+
+            const auto SWAP_BIT = _mm256_set1_epi32(QUADRANT_SWAP_BIT);
+            const auto SIGN_BIT = _mm256_set1_epi32(QUADRANT_SIGN_BIT);
+            const auto SWAP = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(QUADRANT, SWAP_BIT), SWAP_BIT));
+            const auto SIN_SIGN =
+                _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(QUADRANT, SIGN_BIT), QUADRANT_SIGN_SHIFT));
+            const auto COS_SIGN = _mm256_castsi256_ps(_mm256_slli_epi32(
+                _mm256_and_si256(_mm256_add_epi32(QUADRANT, _mm256_set1_epi32(1)), SIGN_BIT), QUADRANT_SIGN_SHIFT));
+
+            return {_mm256_xor_ps(_mm256_blendv_ps(sin, cos, SWAP), SIN_SIGN),
+                    _mm256_xor_ps(_mm256_blendv_ps(cos, sin, SWAP), COS_SIGN)};
+        }
+
+        /// Loads eight transforms and splits them into the low and high SSE halves
+        JE_TARGET_AVX2 inline void LoadQuadLanesAVX2(const TransformBatch& transforms,
+                                                     std::size_t i,
+                                                     QuadLanes& low,
+                                                     QuadLanes& high)
+        {
+            const auto SIN_COS = SinCosAVX2(_mm256_loadu_ps(&transforms.Rotation()[i]));
+
+            low = {_mm_loadu_ps(&transforms.PositionX()[i]),
+                   _mm_loadu_ps(&transforms.PositionY()[i]),
+                   _mm_loadu_ps(&transforms.PositionZ()[i]),
+                   _mm_loadu_ps(&transforms.ScaleX()[i]),
+                   _mm_loadu_ps(&transforms.ScaleY()[i]),
+                   _mm_loadu_ps(&transforms.ScaleZ()[i]),
+                   {_mm256_castps256_ps128(SIN_COS.Sin), _mm256_castps256_ps128(SIN_COS.Cos)}};
+
+            const auto HIGH = i + SSE_LANES;
+            high = {_mm_loadu_ps(&transforms.PositionX()[HIGH]),
+                    _mm_loadu_ps(&transforms.PositionY()[HIGH]),
+                    _mm_loadu_ps(&transforms.PositionZ()[HIGH]),
+                    _mm_loadu_ps(&transforms.ScaleX()[HIGH]),
+                    _mm_loadu_ps(&transforms.ScaleY()[HIGH]),
+                    _mm_loadu_ps(&transforms.ScaleZ()[HIGH]),
+                    {_mm256_extractf128_ps(SIN_COS.Sin, 1), _mm256_extractf128_ps(SIN_COS.Cos, 1)}};
+        }
+
+        JE_TARGET_AVX2 auto BuildTransformsAVX2(const TransformBatch& transforms, std::span<glm::mat4> matrices)
+            -> std::size_t
+        {
+            const auto COUNT = transforms.Size() - transforms.Size() % AVX_LANES;
+            QuadLanes low{};
+            QuadLanes high{};
+            for (std::size_t i = 0; i < COUNT; i += AVX_LANES) {
+                LoadQuadLanesAVX2(transforms, i, low, high);
+                StoreTransforms(low, &matrices[i]);
+                StoreTransforms(high, &matrices[i + SSE_LANES]);
+            }
+            return COUNT;
+        }
+
+        JE_TARGET_AVX2 auto BuildQuadCornersAVX2(const TransformBatch& transforms, std::span<glm::vec3> corners)
+            -> std::size_t
+        {
+            const auto COUNT = transforms.Size() - transforms.Size() % AVX_LANES;
+            QuadLanes low{};
+            QuadLanes high{};
+            for (std::size_t i = 0; i < COUNT; i += AVX_LANES) {
+                LoadQuadLanesAVX2(transforms, i, low, high);
+                StoreQuadCorners(low, &corners[i * TransformBatch::QUAD_CORNER_COUNT]);
+                StoreQuadCorners(high, &corners[(i + SSE_LANES) * TransformBatch::QUAD_CORNER_COUNT]);
+            }
+            return COUNT;
+        }
+#endif
+
+    }  // namespace
+
+    void BuildTransforms(const TransformBatch& transforms, std::span<glm::mat4> matrices, SIMDLevel level)
+    {
+        ASSERT(matrices.size() >= transforms.Size());
+
+        std::size_t done = 0;
+#if JE_SIMD_X86
+        if (level == SIMDLevel::AVX2) {
+            done = BuildTransformsAVX2(transforms, matrices);
+        } else if (level == SIMDLevel::SSE2) {
+            done = BuildTransformsSSE(transforms, matrices);
+        }
+#else
+        static_cast<void>(level);
+#endif
+        BuildTransformsScalar(transforms, matrices, done);
+    }
+
+    void BuildQuadCorners(const TransformBatch& transforms, std::span<glm::vec3> corners, SIMDLevel level)
+    {
+        ASSERT(corners.size() >= transforms.Size() * TransformBatch::QUAD_CORNER_COUNT);
+
+        std::size_t done = 0;
+#if JE_SIMD_X86
+        if (level == SIMDLevel::AVX2) {
+            done = BuildQuadCornersAVX2(transforms, corners);
+        } else if (level == SIMDLevel::SSE2) {
+            done = BuildQuadCornersSSE(transforms, corners);
+        }
+#else
+        static_cast<void>(level);
+#endif
+        BuildQuadCornersScalar(transforms, corners, done);
+    }
+
+}  // namespace JE
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "Memory.hpp"
+#include "SIMD.hpp"
+
+namespace JE
+{
+
+    /// Structure of arrays 2D transforms (translation, rotation around Z and scale) for the batch kernels
+    class TransformBatch
+    {
+      public:
+        static constexpr std::size_t QUAD_CORNER_COUNT = 4;
+
+        inline void Add(const glm::vec3& position, float rotation, const glm::vec3& scale)
+        {
+            m_PositionX.push_back(position.x);
+            m_PositionY.push_back(position.y);
+            m_PositionZ.push_back(position.z);
+            m_Rotation.push_back(rotation);
+            m_ScaleX.push_back(scale.x);
+            m_ScaleY.push_back(scale.y);
+            m_ScaleZ.push_back(scale.z);
+        }
+
+        inline void Reserve(std::size_t count)
+        {
+            m_PositionX.reserve(count);
+            m_PositionY.reserve(count);
+            m_PositionZ.reserve(count);
+            m_Rotation.reserve(count);
+            m_ScaleX.reserve(count);
+            m_ScaleY.reserve(count);
+            m_ScaleZ.reserve(count);
+        }
+
+        inline void Clear()
+        {
+            m_PositionX.clear();
+            m_PositionY.clear();
+            m_PositionZ.clear();
+            m_Rotation.clear();
+            m_ScaleX.clear();
+            m_ScaleY.clear();
+            m_ScaleZ.clear();
+        }
+
+        inline auto Size() const -> std::size_t { return m_PositionX.size(); }
+        inline auto Empty() const -> bool { return m_PositionX.empty(); }
+
+        inline auto PositionX() const -> std::span<const float> { return m_PositionX; }
+        inline auto PositionY() const -> std::span<const float> { return m_PositionY; }
+        inline auto PositionZ() const -> std::span<const float> { return m_PositionZ; }
+        /// Radians around the Z axis
+        inline auto Rotation() const -> std::span<const float> { return m_Rotation; }
+        inline auto ScaleX() const -> std::span<const float> { return m_ScaleX; }
+        inline auto ScaleY() const -> std::span<const float> { return m_ScaleY; }
+        inline auto ScaleZ() const -> std::span<const float> { return m_ScaleZ; }
+
+      private:
+        Vector<float> m_PositionX;
+        Vector<float> m_PositionY;
+        Vector<float> m_PositionZ;
+        Vector<float> m_Rotation;
+        Vector<float> m_ScaleX;
+        Vector<float> m_ScaleY;
+        Vector<float> m_ScaleZ;
+    };
+
+    /// Writes translate * rotate * scale world matrices, one per transform
+    void BuildTransforms(const TransformBatch& transforms,
+                         std::span<glm::mat4> matrices,
+                         SIMDLevel level = HostSIMDLevel());
+
+    /// Writes the world space corners of a unit quad (same winding as CreateQuadMesh), four per transform
+    void BuildQuadCorners(const TransformBatch& transforms,
+                          std::span<glm::vec3> corners,
+                          SIMDLevel level = HostSIMDLevel());
+
+}  // namespace JE
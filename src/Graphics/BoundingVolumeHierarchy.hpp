@@ -0,0 +1,305 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "Assert.hpp"
+#include "Culling.hpp"
+#include "Memory.hpp"
+
+namespace JE
+{
+
+    /// Dynamic AABB tree, leaves are inserted next to the sibling with the cheapest surface area increase and
+    /// moved leaves only refit their ancestors, which is cheap for mostly static scenes. Insertions and removals
+    /// rotate unbalanced ancestors, otherwise leaves inserted in sorted order (e.g. a grid) build a list
+    template<typename T>
+    class BoundingVolumeHierarchy
+    {
+      public:
+        using NodeID = std::uint32_t;
+
+        static constexpr NodeID NULL_NODE = std::numeric_limits<NodeID>::max();
+
+        auto Insert(const AABB& box, T value) -> NodeID
+        {
+            ASSERT(box.Valid());
+
+            const auto LEAF = AllocateNode();
+            m_Nodes[LEAF].Box = box;
+            m_Nodes[LEAF].Value = std::move(value);
+
+            InsertLeaf(LEAF);
+            ++m_LeafCount;
+
+            return LEAF;
+        }
+
+        void Remove(NodeID leaf)
+        {
+            ASSERT(leaf < m_Nodes.size() && m_Nodes[leaf].Leaf());
+
+            RemoveLeaf(leaf);
+            FreeNode(leaf);
+            --m_LeafCount;
+        }
+
+        /// Changes the bounds of a leaf and refits its ancestors without restructuring the tree
+        void Update(NodeID leaf, const AABB& box)
+        {
+            ASSERT(leaf < m_Nodes.size() && m_Nodes[leaf].Leaf());
+            ASSERT(box.Valid());
+
+            m_Nodes[leaf].Box = box;
+            Refit(m_Nodes[leaf].Parent);
+        }
+
+        /// Calls func(const T&) for every leaf that is at least partially inside the frustum
+        template<typename Func>
+        void Query(const Frustum& frustum, Func&& func) const
+        {
+            if (m_Root == NULL_NODE) {
+                return;
+            }
+
+            m_QueryStack.clear();
+            m_QueryStack.emplace_back(m_Root, false);
+
+            while (!m_QueryStack.empty()) {
+                const auto [NODE_ID, FULLY_INSIDE] = m_QueryStack.back();
+                m_QueryStack.pop_back();
+
+                const auto& node = m_Nodes[NODE_ID];
+
+                auto inside = FULLY_INSIDE;
+                if (!inside) {
+                    const auto INTERSECTION = frustum.Classify(node.Box);
+                    if (INTERSECTION == Frustum::Intersection::OUTSIDE) {
+                        continue;
+                    }
+                    // Everything below a node that is fully inside is visible, skip the plane tests for the subtree
+                    inside = INTERSECTION == Frustum::Intersection::INSIDE;
+                }
+
+                if (node.Leaf()) {
+                    func(node.Value);
+                    continue;
+                }
+
+                m_QueryStack.emplace_back(node.Left, inside);
+                m_QueryStack.emplace_back(node.Right, inside);
+            }
+        }
+
+        inline void Clear()
+        {
+            m_Nodes.clear();
+            m_Root = NULL_NODE;
+            m_FreeList = NULL_NODE;
+            m_LeafCount = 0;
+        }
+
+        inline auto Size() const -> std::size_t { return m_LeafCount; }
+        inline auto Empty() const -> bool { return m_LeafCount == 0; }
+        inline auto Root() const -> NodeID { return m_Root; }
+
+        inline auto Bounds(NodeID node) const -> const AABB& { return m_Nodes[node].Box; }
+        inline auto Value(NodeID leaf) const -> const T& { return m_Nodes[leaf].Value; }
+
+        /// Height of the tree, mostly useful to check the insertion heuristic keeps it balanced
+        inline auto Height() const -> std::size_t { return m_Root == NULL_NODE ? 0 : m_Nodes[m_Root].Height; }
+
+      private:
+        struct Node
+        {
+            AABB Box;
+            T Value{};
+            NodeID Parent = NULL_NODE;  // Next free node while the node is in the free list
+            NodeID Left = NULL_NODE;
+            NodeID Right = NULL_NODE;
+            /// Leaves have a height of 1
+            std::uint32_t Height = 1;
+
+            inline auto Leaf() const -> bool { return Left == NULL_NODE; }
+        };
+
+        auto AllocateNode() -> NodeID
+        {
+            if (m_FreeList == NULL_NODE) {
+                m_Nodes.emplace_back();
+                return static_cast<NodeID>(m_Nodes.size() - 1);
+            }
+
+            const auto NODE = m_FreeList;
+            m_FreeList = m_Nodes[NODE].Parent;
+            m_Nodes[NODE] = Node{};
+            return NODE;
+        }
+
+        void FreeNode(NodeID node)
+        {
+            m_Nodes[node] = Node{};
+            m_Nodes[node].Parent = m_FreeList;
+            m_FreeList = node;
+        }
+
+        void InsertLeaf(NodeID leaf)
+        {
+            if (m_Root == NULL_NODE) {
+                m_Root = leaf;
+                return;
+            }
+
+            // Descend towards the child whose bounds grow the least
+            const auto LEAF_BOX = m_Nodes[leaf].Box;
+            auto sibling = m_Root;
+            while (!m_Nodes[sibling].Leaf()) {
+                const auto& node = m_Nodes[sibling];
+
+                const auto AREA = node.Box.SurfaceArea();
+                const auto COMBINED_AREA = AABB::Union(node.Box, LEAF_BOX).SurfaceArea();
+
+                // Cost of making a new parent for this node and the leaf, and the cost pushed down to the children
+                const auto COST = 2.0f * COMBINED_AREA;
+                const auto INHERITANCE_COST = 2.0f * (COMBINED_AREA - AREA);
+
+                const auto CHILD_COST = [this, &LEAF_BOX, INHERITANCE_COST](NodeID child)
+                {
+                    const auto& child_node = m_Nodes[child];
+                    const auto UNION_AREA = AABB::Union(child_node.Box, LEAF_BOX).SurfaceArea();
+                    if (child_node.Leaf()) {
+                        return UNION_AREA + INHERITANCE_COST;
+                    }
+                    return UNION_AREA - child_node.Box.SurfaceArea() + INHERITANCE_COST;
+                };
+
+                const auto LEFT_COST = CHILD_COST(node.Left);
+                const auto RIGHT_COST = CHILD_COST(node.Right);
+
+                if (COST < LEFT_COST && COST < RIGHT_COST) {
+                    break;
+                }
+
+                sibling = LEFT_COST < RIGHT_COST ? node.Left : node.Right;
+            }
+
+            const auto OLD_PARENT = m_Nodes[sibling].Parent;
+            const auto NEW_PARENT = AllocateNode();
+            m_Nodes[NEW_PARENT].Parent = OLD_PARENT;
+            m_Nodes[NEW_PARENT].Left = sibling;
+            m_Nodes[NEW_PARENT].Right = leaf;
+            m_Nodes[sibling].Parent = NEW_PARENT;
+            m_Nodes[leaf].Parent = NEW_PARENT;
+            ReplaceChild(OLD_PARENT, sibling, NEW_PARENT);
+
+            Refit(NEW_PARENT);
+        }
+
+        void RemoveLeaf(NodeID leaf)
+        {
+            if (leaf == m_Root) {
+                m_Root = NULL_NODE;
+                return;
+            }
+
+            // The parent is replaced by the sibling of the removed leaf
+            const auto PARENT = m_Nodes[leaf].Parent;
+            const auto GRANDPARENT = m_Nodes[PARENT].Parent;
+            const auto SIBLING = m_Nodes[PARENT].Left == leaf ? m_Nodes[PARENT].Right : m_Nodes[PARENT].Left;
+
+            m_Nodes[SIBLING].Parent = GRANDPARENT;
+            ReplaceChild(GRANDPARENT, PARENT, SIBLING);
+            Refit(GRANDPARENT);
+
+            FreeNode(PARENT);
+            m_Nodes[leaf].Parent = NULL_NODE;
+        }
+
+        /// Points the parent's link to old_child at new_child, or makes new_child the root
+        void ReplaceChild(NodeID parent, NodeID old_child, NodeID new_child)
+        {
+            if (parent == NULL_NODE) {
+                m_Root = new_child;
+            } else if (m_Nodes[parent].Left == old_child) {
+                m_Nodes[parent].Left = new_child;
+            } else {
+                m_Nodes[parent].Right = new_child;
+            }
+        }
+
+        void Fit(NodeID node)
+        {
+            auto& current = m_Nodes[node];
+            current.Box = AABB::Union(m_Nodes[current.Left].Box, m_Nodes[current.Right].Box);
+            current.Height = 1 + std::max(m_Nodes[current.Left].Height, m_Nodes[current.Right].Height);
+        }
+
+        /// Refits the node and its ancestors and rotates the ones whose subtrees differ in height by more than one.
+        /// Bounds that only moved (Update) keep the heights, so the tree isn't restructured then
+        void Refit(NodeID node)
+        {
+            while (node != NULL_NODE) {
+                node = Balance(node);
+                Fit(node);
+                node = m_Nodes[node].Parent;
+            }
+        }
+
+        /// \returns the node that took the place of node
+        auto Balance(NodeID node) -> NodeID
+        {
+            const auto& current = m_Nodes[node];
+            if (current.Leaf()) {
+                return node;
+            }
+
+            const auto LEFT_HEIGHT = m_Nodes[current.Left].Height;
+            const auto RIGHT_HEIGHT = m_Nodes[current.Right].Height;
+            if (RIGHT_HEIGHT > LEFT_HEIGHT + 1) {
+                return RotateUp(node, current.Right);
+            }
+            if (LEFT_HEIGHT > RIGHT_HEIGHT + 1) {
+                return RotateUp(node, current.Left);
+            }
+            return node;
+        }
+
+        /// The taller child takes the place of node, it keeps its own taller child and hands the shorter one to node
+        auto RotateUp(NodeID node, NodeID child) -> NodeID
+        {
+            const auto& child_node = m_Nodes[child];
+            const auto TALLER = m_Nodes[child_node.Left].Height > m_Nodes[child_node.Right].Height ? child_node.Left
+                                                                                                 : child_node.Right;
+            const auto SHORTER = TALLER == child_node.Left ? child_node.Right : child_node.Left;
+
+            const auto PARENT = m_Nodes[node].Parent;
+            m_Nodes[child].Parent = PARENT;
+            ReplaceChild(PARENT, node, child);
+
+            if (m_Nodes[node].Left == child) {
+                m_Nodes[node].Left = SHORTER;
+            } else {
+                m_Nodes[node].Right = SHORTER;
+            }
+            m_Nodes[SHORTER].Parent = node;
+            Fit(node);
+
+            m_Nodes[child].Left = node;
+            m_Nodes[child].Right = TALLER;
+            m_Nodes[node].Parent = child;
+            Fit(child);
+
+            return child;
+        }
+
+        Vector<Node> m_Nodes;
+        NodeID m_Root = NULL_NODE;
+        NodeID m_FreeList = NULL_NODE;
+        std::size_t m_LeafCount = 0;
+
+        mutable Vector<std::pair<NodeID, bool>> m_QueryStack;
+    };
+
+}  // namespace JE
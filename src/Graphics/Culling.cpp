@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Culling.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define JE_CULLING_SSE2 1
+#    include <emmintrin.h>
+#else
+#    define JE_CULLING_SSE2 0
+#endif
+
+#include "Assert.hpp"
+
+namespace JE
+{
+
+    auto ComputeBounds(std::span<const glm::vec3> vertices) -> MeshBounds
+    {
+        MeshBounds bounds;
+        if (vertices.empty()) {
+            bounds.Box = {glm::vec3{0}, glm::vec3{0}};
+            return bounds;
+        }
+
+        for (const auto& vertex : vertices) {
+            bounds.Box.Expand(vertex);
+        }
+
+        bounds.Sphere.Center = bounds.Box.Center();
+        for (const auto& vertex : vertices) {
+            bounds.Sphere.Radius = std::max(bounds.Sphere.Radius, glm::length(vertex - bounds.Sphere.Center));
+        }
+
+        return bounds;
+    }
+
+    Frustum::Frustum(const glm::mat4& view_projection)
+    {
+        // Gribb/Hartmann - planes are combinations of the matrix rows, glm is column major
+        const auto ROW = [&view_projection](glm::length_t row)
+        {
+            return glm::vec4{
+                view_projection[0][row], view_projection[1][row], view_projection[2][row], view_projection[3][row]};
+        };
+
+        const std::array<glm::vec4, PLANE_COUNT> PLANES = {ROW(3) + ROW(0),
+                                                           ROW(3) - ROW(0),
+                                                           ROW(3) + ROW(1),
+                                                           ROW(3) - ROW(1),
+                                                           ROW(3) + ROW(2),
+                                                           ROW(3) - ROW(2)};
+
+        for (std::size_t i = 0; i < PLANE_COUNT; ++i) {
+            const auto NORMAL = glm::vec3{PLANES[i].x, PLANES[i].y, PLANES[i].z};
+            const auto LENGTH = glm::length(NORMAL);
+            m_Planes[i] = {NORMAL / LENGTH, PLANES[i].w / LENGTH};
+        }
+    }
+
+    auto Frustum::Classify(const AABB& box) const -> Intersection
+    {
+        const auto CENTER = box.Center();
+        const auto EXTENTS = box.Extents();
+
+        auto result = Intersection::INSIDE;
+        for (const auto& plane : m_Planes) {
+            const auto DISTANCE = plane.SignedDistance(CENTER);
+            const auto RADIUS = glm::dot(glm::abs(plane.Normal), EXTENTS);
+
+            if (DISTANCE + RADIUS < 0) {
+                return Intersection::OUTSIDE;
+            }
+            if (DISTANCE - RADIUS < 0) {
+                result = Intersection::INTERSECTING;
+            }
+        }
+
+        return result;
+    }
+
+    auto Frustum::Classify(const BoundingSphere& sphere) const -> Intersection
+    {
+        auto result = Intersection::INSIDE;
+        for (const auto& plane : m_Planes) {
+            const auto DISTANCE = plane.SignedDistance(sphere.Center);
+
+            if (DISTANCE < -sphere.Radius) {
+                return Intersection::OUTSIDE;
+            }
+            if (DISTANCE < sphere.Radius) {
+                result = Intersection::INTERSECTING;
+            }
+        }
+
+        return result;
+    }
+
+    namespace detail
+    {
+
+        auto CullAABBsScalar(const Frustum& frustum,
+                             const AABBBatch& boxes,
+                             std::span<std::uint8_t> visibility,
+                             std::size_t first) -> std::size_t
+        {
+            std::size_t visible_count = 0;
+            for (std::size_t i = first; i < boxes.Size(); ++i) {
+                bool visible = true;
+                for (const auto& plane : frustum.Planes()) {
+                    const auto DISTANCE = plane.Normal.x * boxes.CenterX()[i] + plane.Normal.y * boxes.CenterY()[i]
+                        + plane.Normal.z * boxes.CenterZ()[i] + plane.Distance;
+                    const auto RADIUS = std::abs(plane.Normal.x) * boxes.ExtentX()[i]
+                        + std::abs(plane.Normal.y) * boxes.ExtentY()[i] + std::abs(plane.Normal.z) * boxes.ExtentZ()[i];
+
+                    if (DISTANCE + RADIUS < 0) {
+                        visible = false;
+                        break;
+                    }
+                }
+
+                visibility[i] = visible ? 1 : 0;
+                visible_count += visible ? 1 : 0;
+            }
+
+            return visible_count;
+        }
+
+    }  // namespace detail
+
+    auto CullAABBs(const Frustum& frustum, const AABBBatch& boxes, std::span<std::uint8_t> visibility) -> std::size_t
+    {
+        ASSERT(visibility.size() >= boxes.Size());
+
+#if JE_CULLING_SSE2
+        static constexpr std::size_t LANES = 4;
+
+        struct SIMDPlane
+        {
+            __m128 NormalX;
+            __m128 NormalY;
+            __m128 NormalZ;
+            __m128 AbsNormalX;
+            __m128 AbsNormalY;
+            __m128 AbsNormalZ;
+            __m128 Distance;
+        };
+
+        std::array<SIMDPlane, Frustum::PLANE_COUNT> planes{};
+        for (std::size_t i = 0; i < Frustum::PLANE_COUNT; ++i) {
+            const auto& plane = frustum.Planes()[i];
+            planes[i] = {_mm_set1_ps(plane.Normal.x),
+                         _mm_set1_ps(plane.Normal.y),
+                         _mm_set1_ps(plane.Normal.z),
+                         _mm_set1_ps(std::abs(plane.Normal.x)),
+                         _mm_set1_ps(std::abs(plane.Normal.y)),
+                         _mm_set1_ps(std::abs(plane.Normal.z)),
+                         _mm_set1_ps(plane.Distance)};
+        }
+
+        const auto ZERO = _mm_setzero_ps();
+        const auto SIMD_COUNT = boxes.Size() - boxes.Size() % LANES;
+
+        std::size_t visible_count = 0;
+        for (std::size_t i = 0; i < SIMD_COUNT; i += LANES) {
+            const auto CENTER_X = _mm_loadu_ps(&boxes.CenterX()[i]);
+            const auto CENTER_Y = _mm_loadu_ps(&boxes.CenterY()[i]);
+            const auto CENTER_Z = _mm_loadu_ps(&boxes.CenterZ()[i]);
+            const auto EXTENT_X = _mm_loadu_ps(&boxes.ExtentX()[i]);
+            const auto EXTENT_Y = _mm_loadu_ps(&boxes.ExtentY()[i]);
+            const auto EXTENT_Z = _mm_loadu_ps(&boxes.ExtentZ()[i]);
+
+            auto outside = _mm_setzero_ps();
+            for (const auto& plane : planes) {
+                auto dist = _mm_add_ps(_mm_mul_ps(plane.NormalX, CENTER_X), plane.Distance);
+                dist = _mm_add_ps(dist, _mm_mul_ps(plane.NormalY, CENTER_Y));
+                dist = _mm_add_ps(dist, _mm_mul_ps(plane.NormalZ, CENTER_Z));
+
+                auto radius = _mm_mul_ps(plane.AbsNormalX, EXTENT_X);
+                radius = _mm_add_ps(radius, _mm_mul_ps(plane.AbsNormalY, EXTENT_Y));
+                radius = _mm_add_ps(radius, _mm_mul_ps(plane.AbsNormalZ, EXTENT_Z));
+
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, radius), ZERO));
+            }
+
+            const auto OUTSIDE_MASK = static_cast<std::uint32_t>(_mm_movemask_ps(outside));
+            for (std::size_t lane = 0; lane < LANES; ++lane) {
+                const bool VISIBLE = (OUTSIDE_MASK & (1u << lane)) == 0;
+                visibility[i + lane] = VISIBLE ? 1 : 0;
+                visible_count += VISIBLE ? 1 : 0;
+            }
+        }
+
+        return visible_count + detail::CullAABBsScalar(frustum, boxes, visibility, SIMD_COUNT);
+#else
+        return detail::CullAABBsScalar(frustum, boxes, visibility);
+#endif
+    }
+
+}  // namespace JE
\ No newline at end of file
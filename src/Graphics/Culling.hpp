@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "Memory.hpp"
+
+namespace JE
+{
+
+    struct AABB
+    {
+        glm::vec3 Min{std::numeric_limits<float>::max()};
+        glm::vec3 Max{std::numeric_limits<float>::lowest()};
+
+        inline auto Valid() const -> bool { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+        inline auto Center() const -> glm::vec3 { return (Min + Max) * 0.5f; }
+        inline auto Extents() const -> glm::vec3 { return (Max - Min) * 0.5f; }
+
+        inline auto SurfaceArea() const -> float
+        {
+            const auto SIZE = Max - Min;
+            return 2.0f * (SIZE.x * SIZE.y + SIZE.y * SIZE.z + SIZE.z * SIZE.x);
+        }
+
+        inline auto Contains(const AABB& other) const -> bool
+        {
+            return Min.x <= other.Min.x && Min.y <= other.Min.y && Min.z <= other.Min.z && other.Max.x <= Max.x
+                && other.Max.y <= Max.y && other.Max.z <= Max.z;
+        }
+
+        inline void Expand(const glm::vec3& point)
+        {
+            Min = glm::min(Min, point);
+            Max = glm::max(Max, point);
+        }
+
+        static inline auto Union(const AABB& lhs, const AABB& rhs) -> AABB
+        {
+            return {glm::min(lhs.Min, rhs.Min), glm::max(lhs.Max, rhs.Max)};
+        }
+    };
+
+    struct BoundingSphere
+    {
+        glm::vec3 Center{0};
+        float Radius = 0;
+    };
+
+    struct MeshBounds
+    {
+        AABB Box;
+        BoundingSphere Sphere;
+    };
+
+    auto ComputeBounds(std::span<const glm::vec3> vertices) -> MeshBounds;
+
+    struct Plane
+    {
+        glm::vec3 Normal{0};
+        float Distance = 0;
+
+        inline auto SignedDistance(const glm::vec3& point) const -> float
+        {
+            return glm::dot(Normal, point) + Distance;
+        }
+    };
+
+    class Frustum
+    {
+      public:
+        enum class Intersection
+        {
+            OUTSIDE,
+            INTERSECTING,
+            INSIDE
+        };
+
+        static constexpr std::size_t PLANE_COUNT = 6;
+
+        Frustum() = default;
+        /// Extracts the clip planes from a (OpenGL convention) view projection matrix
+        explicit Frustum(const glm::mat4& view_projection);
+
+        auto Classify(const AABB& box) const -> Intersection;
+        auto Classify(const BoundingSphere& sphere) const -> Intersection;
+
+        inline auto Planes() const -> const std::array<Plane, PLANE_COUNT>& { return m_Planes; }
+
+      private:
+        std::array<Plane, PLANE_COUNT> m_Planes{};
+    };
+
+    /// Structure of arrays AABB storage, stored as center/extents for the culling kernel
+    class AABBBatch
+    {
+      public:
+        inline void Add(const AABB& box)
+        {
+            const auto CENTER = box.Center();
+            const auto EXTENTS = box.Extents();
+
+            m_CenterX.push_back(CENTER.x);
+            m_CenterY.push_back(CENTER.y);
+            m_CenterZ.push_back(CENTER.z);
+            m_ExtentX.push_back(EXTENTS.x);
+            m_ExtentY.push_back(EXTENTS.y);
+            m_ExtentZ.push_back(EXTENTS.z);
+        }
+
+        inline void Clear()
+        {
+            m_CenterX.clear();
+            m_CenterY.clear();
+            m_CenterZ.clear();
+            m_ExtentX.clear();
+            m_ExtentY.clear();
+            m_ExtentZ.clear();
+        }
+
+        inline auto Size() const -> std::size_t { return m_CenterX.size(); }
+
+        inline auto CenterX() const -> std::span<const float> { return m_CenterX; }
+        inline auto CenterY() const -> std::span<const float> { return m_CenterY; }
+        inline auto CenterZ() const -> std::span<const float> { return m_CenterZ; }
+        inline auto ExtentX() const -> std::span<const float> { return m_ExtentX; }
+        inline auto ExtentY() const -> std::span<const float> { return m_ExtentY; }
+        inline auto ExtentZ() const -> std::span<const float> { return m_ExtentZ; }
+
+      private:
+        Vector<float> m_CenterX;
+        Vector<float> m_CenterY;
+        Vector<float> m_CenterZ;
+        Vector<float> m_ExtentX;
+        Vector<float> m_ExtentY;
+        Vector<float> m_ExtentZ;
+    };
+
+    /// Writes 1 for every box that is at least partially inside the frustum and 0 otherwise
+    /// \returns number of visible boxes
+    auto CullAABBs(const Frustum& frustum, const AABBBatch& boxes, std::span<std::uint8_t> visibility) -> std::size_t;
+
+    namespace detail  // NOLINT(readability-identifier-naming)
+    {
+
+        auto CullAABBsScalar(const Frustum& frustum,
+                             const AABBBatch& boxes,
+                             std::span<std::uint8_t> visibility,
+                             std::size_t first = 0) -> std::size_t;
+
+    }  // namespace detail
+
+}  // namespace JE
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cmath>
+
+#include "DynamicResolution.hpp"
+
+#include "Assert.hpp"
+#include "Graphics/Sprite.hpp"
+#include "Graphics/Texture.hpp"
+#include "Logger.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        /// Errors beyond this (e.g. a frame stalled on a shader compile) don't slam the scale to the minimum
+        constexpr float MAX_RELATIVE_ERROR = 1.0f;
+
+        auto ScaledExtent(std::int32_t extent, float scale) -> std::int32_t
+        {
+            return std::max(1, static_cast<std::int32_t>(std::lround(static_cast<float>(extent) * scale)));
+        }
+
+    }  // namespace
+
+    DynamicResolutionController::DynamicResolutionController(const DynamicResolutionSettings& settings)
+    {
+        SetSettings(settings);
+    }
+
+    void DynamicResolutionController::SetSettings(const DynamicResolutionSettings& settings)
+    {
+        ASSERT(settings.TargetFrameTime.count() > 0);
+        ASSERT(settings.MinScale > 0 && settings.MinScale <= settings.MaxScale);
+        ASSERT(settings.IntegralGain > 0);
+        ASSERT(settings.ScaleStep > 0);
+
+        m_Settings = settings;
+        m_Integral = 0;
+        m_Scale = settings.MaxScale;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto DynamicResolutionController::Update(std::optional<PerformanceClock::duration> gpu_time,
+                                             PerformanceClock::duration cpu_time) -> float
+    {
+        const auto MEASURED = std::chrono::duration<float>{gpu_time.value_or(cpu_time)};
+        const auto TARGET = std::chrono::duration<float>{m_Settings.TargetFrameTime};
+
+        // Positive while there's headroom, relative so the gains don't depend on the target
+        const auto RELATIVE_ERROR = std::clamp((TARGET - MEASURED) / TARGET, -MAX_RELATIVE_ERROR, MAX_RELATIVE_ERROR);
+
+        // The integral alone can move the scale across the whole range and no further, otherwise it winds up
+        // during long stretches at full resolution and reacts late once the scene gets heavy
+        const auto MIN_INTEGRAL = (m_Settings.MinScale - m_Settings.MaxScale) / m_Settings.IntegralGain;
+        m_Integral = std::clamp(m_Integral + RELATIVE_ERROR, MIN_INTEGRAL, 0.f);
+
+        m_Scale = std::clamp(m_Settings.MaxScale + m_Settings.ProportionalGain * RELATIVE_ERROR
+                                 + m_Settings.IntegralGain * m_Integral,
+                             m_Settings.MinScale,
+                             m_Settings.MaxScale);
+        return m_Scale;
+    }
+
+    auto DynamicResolutionController::SteppedScale() const -> float
+    {
+        const auto STEPPED = std::round(m_Scale / m_Settings.ScaleStep) * m_Settings.ScaleStep;
+        return std::clamp(STEPPED, m_Settings.MinScale, m_Settings.MaxScale);
+    }
+
+    DynamicResolution::DynamicResolution(const DynamicResolutionSettings& settings)
+        : m_Controller(settings)
+    {
+    }
+
+    DynamicResolution::~DynamicResolution()
+    {
+        for (const auto QUERY : m_TimerQueries) {
+            if (QUERY != 0) {
+                RendererAPI().DeleteTimerQuery(QUERY);
+            }
+        }
+    }
+
+    // cppcheck-suppress unusedFunction
+    void DynamicResolution::BeginFrame(const Size2D& output_size, PerformanceClock::duration cpu_time)
+    {
+        ASSERT(output_size.X > 0 && output_size.Y > 0);
+
+        // Without timer queries the CPU time is all there is, with them the controller waits for fresh results
+        const auto GPU_TIME = ReadTimerQueries();
+        if (GPU_TIME || !m_TimerQueriesSupported) {
+            m_Controller.Update(GPU_TIME, cpu_time);
+        }
+
+        const auto SCALE = m_Controller.SteppedScale();
+        const Size2D SIZE{ScaledExtent(output_size.X, SCALE), ScaledExtent(output_size.Y, SCALE)};
+        if (m_Framebuffer != nullptr && SIZE.X == m_RenderSize.X && SIZE.Y == m_RenderSize.Y) {
+            return;
+        }
+
+        EngineLogger()->debug("Dynamic resolution - render size: {} | scale: {}", SIZE, SCALE);
+
+        FramebufferDescription description;
+        description.Size = SIZE;
+        m_Framebuffer = CreateFramebuffer(description);
+        m_Framebuffer->ColorAttachment(0)->SetSampler(
+            {TextureFilter::LINEAR, TextureFilter::LINEAR, TextureFilter::LINEAR, TextureWrap::CLAMP_TO_EDGE,
+             TextureWrap::CLAMP_TO_EDGE});
+        m_RenderSize = SIZE;
+    }
+
+    void DynamicResolution::Bind()
+    {
+        ASSERT(m_Framebuffer != nullptr);
+
+        if (m_TimerQueriesSupported) {
+            // The GPU is this many frames behind, drop the oldest measurement instead of waiting for it
+            auto& query = m_TimerQueries[m_NextTimerQuery];
+            if (query != 0) {
+                RendererAPI().DeleteTimerQuery(query);
+            }
+
+            query = RendererAPI().BeginTimerQuery();
+            m_TimerQueriesSupported = query != 0;
+            m_ActiveTimerQuery = query;
+            m_NextTimerQuery = (m_NextTimerQuery + 1) % TIMER_QUERY_COUNT;
+        }
+
+        m_Framebuffer->Bind();
+    }
+
+    void DynamicResolution::Unbind()
+    {
+        m_Framebuffer->Unbind();
+
+        if (m_ActiveTimerQuery != 0) {
+            RendererAPI().EndTimerQuery(m_ActiveTimerQuery);
+            m_ActiveTimerQuery = 0;
+        }
+    }
+
+    // cppcheck-suppress unusedFunction
+    void DynamicResolution::Upscale(Renderer& renderer, IRenderTarget& output, const RGBA& clear_color)
+    {
+        ASSERT(m_Framebuffer != nullptr);
+
+        // Quads span one unit and the output two. Framebuffer rows start at the bottom, so the top samples v = 1
+        const Sprite SCENE{m_Framebuffer->ColorAttachment(0).get(), glm::vec2{0.f, 1.f}, glm::vec2{1.f, 0.f}};
+
+        renderer.Begin(&output, clear_color);
+        renderer.DrawQuad(SCENE, RGBA{1.f, 1.f, 1.f, 1.f}, {0.f, 0.f}, {0.f, 0.f, 0.f}, {2.f, 2.f, 1.f});
+        renderer.End();
+    }
+
+    auto DynamicResolution::ReadTimerQueries() -> std::optional<PerformanceClock::duration>
+    {
+        // Queries finish in submission order, starting at the oldest slot
+        std::optional<PerformanceClock::duration> latest;
+        for (std::size_t offset = 0; offset < TIMER_QUERY_COUNT; ++offset) {
+            auto& query = m_TimerQueries[(m_NextTimerQuery + offset) % TIMER_QUERY_COUNT];
+            if (query == 0 || query == m_ActiveTimerQuery) {
+                continue;
+            }
+
+            const auto RESULT = RendererAPI().TimerQueryResult(query);
+            if (!RESULT) {
+                break;
+            }
+
+            latest = std::chrono::nanoseconds{*RESULT};
+            RendererAPI().DeleteTimerQuery(query);
+            query = 0;
+        }
+
+        if (latest) {
+            m_LastGPUTime = latest;
+        }
+        return latest;
+    }
+
+}  // namespace JE
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+#include "Graphics/IRendererAPI.hpp"
+#include "Graphics/Renderer.hpp"
+#include "Memory.hpp"
+#include "Time.hpp"
+#include "Types.hpp"
+
+namespace JE
+{
+
+    struct DynamicResolutionSettings
+    {
+        static constexpr auto DEFAULT_TARGET_FRAME_TIME = std::chrono::microseconds{16'667};
+
+        /// GPU time the scene may take per frame, leave headroom for the upscale and everything drawn after it
+        PerformanceClock::duration TargetFrameTime = DEFAULT_TARGET_FRAME_TIME;
+        /// Render size relative to the output size on each axis
+        float MinScale = 0.5f;
+        float MaxScale = 1.0f;
+        /// Scale change per relative frame time error, and per frame of accumulated relative error
+        float ProportionalGain = 0.2f;
+        float IntegralGain = 0.05f;
+        /// The render size snaps to multiples of this scale, so the framebuffer isn't recreated every frame
+        float ScaleStep = 0.05f;
+    };
+
+    /// PI controller that picks the render scale from the measured frame time. The GPU cost of a frame grows with
+    /// the pixel count, so the error is relative to the target and the integral settles where the target is hit
+    class DynamicResolutionController
+    {
+      public:
+        explicit DynamicResolutionController(const DynamicResolutionSettings& settings = {});
+
+        void SetSettings(const DynamicResolutionSettings& settings);
+        inline auto Settings() const -> const DynamicResolutionSettings& { return m_Settings; }
+
+        /// gpu_time is the GPU time of the scene, without it the CPU time of the frame is used. Resolution only
+        /// helps GPU bound frames, CPU bound frames measure little GPU time and keep the scale up
+        auto Update(std::optional<PerformanceClock::duration> gpu_time, PerformanceClock::duration cpu_time)
+            -> float;
+
+        /// Continuous output of the controller
+        inline auto Scale() const -> float { return m_Scale; }
+        /// Scale snapped to the settings' ScaleStep
+        auto SteppedScale() const -> float;
+
+      private:
+        DynamicResolutionSettings m_Settings;
+        float m_Integral = 0;
+        float m_Scale = 1.0f;
+    };
+
+    /// Render target the scene is drawn into at the controller's scale, Upscale then draws it over the output.
+    /// Bind and Unbind measure the GPU time of everything rendered into it with timer queries, results are read
+    /// back frames later so the CPU never waits for them
+    class DynamicResolution final : public IRenderTarget
+    {
+      public:
+        /// One query per frame the CPU can run ahead plus the one being recorded
+        static constexpr std::size_t TIMER_QUERY_COUNT = 6;
+
+        DynamicResolution(const DynamicResolution& other) = delete;
+        DynamicResolution(DynamicResolution&& other) = delete;
+        auto operator=(const DynamicResolution& other) -> DynamicResolution& = delete;
+        auto operator=(DynamicResolution&& other) -> DynamicResolution& = delete;
+
+        explicit DynamicResolution(const DynamicResolutionSettings& settings = {});
+        ~DynamicResolution() override;
+
+        inline void SetSettings(const DynamicResolutionSettings& settings) { m_Controller.SetSettings(settings); }
+        inline auto Controller() const -> const DynamicResolutionController& { return m_Controller; }
+
+        /// Feeds the latest timings to the controller and resizes the framebuffer, call before rendering into it
+        void BeginFrame(const Size2D& output_size, PerformanceClock::duration cpu_time);
+
+        void Bind() override;
+        void Unbind() override;
+
+        /// Records a pass over the output that stretches the scene across it with linear filtering
+        void Upscale(Renderer& renderer, IRenderTarget& output, const RGBA& clear_color);
+
+        inline auto RenderSize() const -> Size2D { return m_RenderSize; }
+        inline auto Framebuffer() const -> IFramebuffer* { return m_Framebuffer.get(); }
+        /// Most recent GPU time read back, std::nullopt if the backend has no timer queries
+        inline auto LastGPUTime() const -> std::optional<PerformanceClock::duration> { return m_LastGPUTime; }
+
+      private:
+        /// Newest result that finished since the last call
+        auto ReadTimerQueries() -> std::optional<PerformanceClock::duration>;
+
+        DynamicResolutionController m_Controller;
+        Scope<IFramebuffer> m_Framebuffer;
+        Size2D m_RenderSize;
+
+        std::array<IRendererAPI::TimerQueryID, TIMER_QUERY_COUNT> m_TimerQueries{};
+        std::size_t m_NextTimerQuery = 0;
+        IRendererAPI::TimerQueryID m_ActiveTimerQuery = 0;
+        bool m_TimerQueriesSupported = true;
+        std::optional<PerformanceClock::duration> m_LastGPUTime;
+    };
+
+}  // namespace JE
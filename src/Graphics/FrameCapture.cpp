@@ -0,0 +1,354 @@
+#include <fstream>
+#include <type_traits>
+
+#include "FrameCapture.hpp"
+
+#include "Assert.hpp"
+#include "GeometryPool.hpp"
+#include "IRendererAPI.hpp"
+#include "Logger.hpp"
+#include "PipelineState.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        constexpr std::uint32_t CAPTURE_MAGIC = 0x4346454A;  // "JEFC"
+        constexpr std::uint32_t CAPTURE_VERSION = 2;
+
+        template<typename T>
+        void Write(std::ofstream& file, const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            file.write(reinterpret_cast<const char*>(&value), sizeof(T));  // NOLINT
+        }
+
+        template<typename T>
+        auto Read(std::ifstream& file, T& value) -> bool
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            file.read(reinterpret_cast<char*>(&value), sizeof(T));  // NOLINT
+            return file.good();
+        }
+
+        template<typename T>
+        void WriteArray(std::ofstream& file, std::span<const T> values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            Write(file, static_cast<std::uint32_t>(values.size()));
+            file.write(reinterpret_cast<const char*>(values.data()),  // NOLINT
+                       static_cast<std::streamsize>(values.size_bytes()));
+        }
+
+        template<typename Container>
+        auto ReadArray(std::ifstream& file, Container& values) -> bool
+        {
+            static_assert(std::is_trivially_copyable_v<typename Container::value_type>);
+            std::uint32_t count = 0;
+            if (!Read(file, count)) {
+                return false;
+            }
+            values.resize(count);
+            file.read(reinterpret_cast<char*>(values.data()),  // NOLINT
+                      static_cast<std::streamsize>(values.size() * sizeof(typename Container::value_type)));
+            return file.good();
+        }
+
+        void WriteString(std::ofstream& file, const std::string& value)
+        {
+            WriteArray(file, std::span<const char>{value});
+        }
+
+        void WriteCommand(std::ofstream& file, const CapturedCommand& command)
+        {
+            Write(file, command.CommandType);
+            Write(file, command.ClearColor.R());
+            Write(file, command.ClearColor.G());
+            Write(file, command.ClearColor.B());
+            Write(file, command.ClearColor.A());
+            Write(file, command.Mesh);
+            Write(file, command.Shader);
+            Write(file, command.Texture);
+            Write(file, command.First);
+            Write(file, command.Count);
+        }
+
+        auto ReadCommand(std::ifstream& file, CapturedCommand& command) -> bool
+        {
+            std::array<float, 4> color{};
+            const bool SUCCESS = Read(file, command.CommandType) && Read(file, color) && Read(file, command.Mesh)
+                                 && Read(file, command.Shader) && Read(file, command.Texture)
+                                 && Read(file, command.First) && Read(file, command.Count);
+            command.ClearColor = {color[0], color[1], color[2], color[3]};
+            return SUCCESS;
+        }
+
+    }  // namespace
+
+    // cppcheck-suppress unusedFunction
+    void FrameCapture::RecordBegin(const RGBA& clear_color)
+    {
+        CapturedCommand command;
+        command.CommandType = CapturedCommand::Type::BEGIN;
+        command.ClearColor = clear_color;
+        m_Commands.push_back(command);
+    }
+
+    // cppcheck-suppress unusedFunction
+    void FrameCapture::RecordEnd()
+    {
+        CapturedCommand command;
+        command.CommandType = CapturedCommand::Type::END;
+        m_Commands.push_back(command);
+    }
+
+    // cppcheck-suppress unusedFunction
+    void FrameCapture::RecordMesh(const Mesh& mesh, const IShaderProgram* shader_program, const MeshLOD& lod)
+    {
+        CapturedCommand command;
+        command.CommandType = CapturedCommand::Type::DRAW_MESH;
+        command.First = lod.FirstIndex;
+        command.Count = lod.IndexCount;
+
+        const auto [MESH, NEW_MESH] = m_ResourceIndices.try_emplace(&mesh, static_cast<std::uint32_t>(m_Meshes.size()));
+        if (NEW_MESH) {
+            m_Meshes.push_back({{mesh.Vertices().begin(), mesh.Vertices().end()},
+                                {mesh.IndexData().begin(), mesh.IndexData().end()}});
+        }
+        command.Mesh = MESH->second;
+
+        if (shader_program != nullptr) {
+            const auto [SHADER, NEW_SHADER] =
+                m_ResourceIndices.try_emplace(shader_program, static_cast<std::uint32_t>(m_Shaders.size()));
+            if (NEW_SHADER) {
+                if (shader_program->VertexSource().empty()) {
+                    EngineLogger()->warn("Shader {} was not created with CreateShader, its sources are not captured",
+                                         shader_program->DebugName());
+                }
+                m_Shaders.push_back({std::string{shader_program->DebugName()},
+                                     std::string{shader_program->VertexSource()},
+                                     std::string{shader_program->FragmentSource()}});
+            }
+            command.Shader = SHADER->second;
+        }
+
+        m_Commands.push_back(command);
+    }
+
+    // cppcheck-suppress unusedFunction
+    void FrameCapture::RecordQuads(std::span<const VertexType> corners,
+                                   std::span<const glm::vec2> tex_coords,
+                                   std::span<const glm::vec4> colors,
+                                   const ITexture2D* texture)
+    {
+        ASSERT(corners.size() == tex_coords.size() && corners.size() == colors.size());
+
+        CapturedCommand command;
+        command.CommandType = CapturedCommand::Type::DRAW_QUADS;
+        command.First = static_cast<std::uint32_t>(m_QuadCorners.size());
+        command.Count = static_cast<std::uint32_t>(corners.size());
+        m_QuadCorners.insert(m_QuadCorners.end(), corners.begin(), corners.end());
+        m_QuadTexCoords.insert(m_QuadTexCoords.end(), tex_coords.begin(), tex_coords.end());
+        m_QuadColors.insert(m_QuadColors.end(), colors.begin(), colors.end());
+
+        if (texture != nullptr) {
+            const auto [TEXTURE, NEW_TEXTURE] =
+                m_ResourceIndices.try_emplace(texture, static_cast<std::uint32_t>(m_Textures.size()));
+            if (NEW_TEXTURE) {
+                m_Textures.push_back(texture->Description());
+            }
+            command.Texture = TEXTURE->second;
+        }
+
+        m_Commands.push_back(command);
+    }
+
+    // cppcheck-suppress unusedFunction
+    void FrameCapture::Clear()
+    {
+        m_Commands.clear();
+        m_Meshes.clear();
+        m_Shaders.clear();
+        m_Textures.clear();
+        m_QuadCorners.clear();
+        m_QuadTexCoords.clear();
+        m_QuadColors.clear();
+        m_ResourceIndices.clear();
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto FrameCapture::Write(const std::filesystem::path& path) const -> bool
+    {
+        std::ofstream file{path, std::ios::binary};
+        if (!file) {
+            EngineLogger()->error("Failed to open frame capture {} for writing", path.string());
+            return false;
+        }
+
+        JE::Write(file, CAPTURE_MAGIC);
+        JE::Write(file, CAPTURE_VERSION);
+
+        JE::Write(file, static_cast<std::uint32_t>(m_Meshes.size()));
+        for (const auto& mesh : m_Meshes) {
+            WriteArray(file, std::span<const VertexType>{mesh.Vertices});
+            WriteArray(file, std::span<const IndexType>{mesh.Indices});
+        }
+
+        JE::Write(file, static_cast<std::uint32_t>(m_Shaders.size()));
+        for (const auto& shader : m_Shaders) {
+            WriteString(file, shader.DebugName);
+            WriteString(file, shader.VertexSource);
+            WriteString(file, shader.FragmentSource);
+        }
+
+        WriteArray(file, std::span<const TextureDescription>{m_Textures});
+        WriteArray(file, std::span<const VertexType>{m_QuadCorners});
+        WriteArray(file, std::span<const glm::vec2>{m_QuadTexCoords});
+        WriteArray(file, std::span<const glm::vec4>{m_QuadColors});
+
+        JE::Write(file, static_cast<std::uint32_t>(m_Commands.size()));
+        for (const auto& command : m_Commands) {
+            WriteCommand(file, command);
+        }
+
+        return file.good();
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto FrameCapture::Read(const std::filesystem::path& path) -> std::optional<FrameCapture>
+    {
+        std::ifstream file{path, std::ios::binary};
+        if (!file) {
+            EngineLogger()->error("Failed to open frame capture {}", path.string());
+            return std::nullopt;
+        }
+
+        std::uint32_t magic = 0;
+        std::uint32_t version = 0;
+        if (!JE::Read(file, magic) || !JE::Read(file, version) || magic != CAPTURE_MAGIC
+            || version != CAPTURE_VERSION) {
+            EngineLogger()->error("{} is not a frame capture of version {}", path.string(), CAPTURE_VERSION);
+            return std::nullopt;
+        }
+
+        FrameCapture capture;
+        std::uint32_t count = 0;
+        bool success = JE::Read(file, count);
+        capture.m_Meshes.resize(success ? count : 0);
+        for (auto& mesh : capture.m_Meshes) {
+            success = success && ReadArray(file, mesh.Vertices) && ReadArray(file, mesh.Indices);
+        }
+
+        success = success && JE::Read(file, count);
+        capture.m_Shaders.resize(success ? count : 0);
+        for (auto& shader : capture.m_Shaders) {
+            success = success && ReadArray(file, shader.DebugName) && ReadArray(file, shader.VertexSource)
+                      && ReadArray(file, shader.FragmentSource);
+        }
+
+        success = success && ReadArray(file, capture.m_Textures) && ReadArray(file, capture.m_QuadCorners)
+                  && ReadArray(file, capture.m_QuadTexCoords) && ReadArray(file, capture.m_QuadColors)
+                  && JE::Read(file, count);
+        capture.m_Commands.resize(success ? count : 0);
+        for (auto& command : capture.m_Commands) {
+            success = success && ReadCommand(file, command);
+        }
+
+        if (!success) {
+            EngineLogger()->error("Frame capture {} is truncated", path.string());
+            return std::nullopt;
+        }
+
+        // Replays index into the capture without checking, reject anything that doesn't fit
+        for (const auto& command : capture.m_Commands) {
+            const auto OUT_OF_RANGE = [](std::uint32_t index, std::size_t size)
+            {
+                return index != CapturedCommand::NONE && index >= size;
+            };
+
+            bool valid = !OUT_OF_RANGE(command.Shader, capture.m_Shaders.size())
+                         && !OUT_OF_RANGE(command.Texture, capture.m_Textures.size());
+            if (command.CommandType == CapturedCommand::Type::DRAW_MESH) {
+                valid = valid && command.Mesh < capture.m_Meshes.size()
+                        && std::size_t{command.First} + command.Count <= capture.m_Meshes[command.Mesh].Indices.size();
+            } else if (command.CommandType == CapturedCommand::Type::DRAW_QUADS) {
+                valid = valid && std::size_t{command.First} + command.Count <= capture.m_QuadCorners.size()
+                        && capture.m_QuadCorners.size() == capture.m_QuadTexCoords.size()
+                        && capture.m_QuadCorners.size() == capture.m_QuadColors.size();
+            }
+            if (!valid) {
+                EngineLogger()->error("Frame capture {} references data it doesn't contain", path.string());
+                return std::nullopt;
+            }
+        }
+
+        return capture;
+    }
+
+    FrameReplay::FrameReplay(FrameCapture capture)
+        : m_Capture(std::move(capture))
+    {
+        for (const auto& mesh : m_Capture.Meshes()) {
+            m_Meshes.push_back(CreateScope<Mesh>(std::span<const VertexType>{mesh.Vertices},
+                                                 std::span<const IndexType>{mesh.Indices}));
+        }
+        for (const auto& shader : m_Capture.Shaders()) {
+            // Shaders without sources can't be recreated, their meshes are drawn without binding a program
+            m_Shaders.push_back(shader.VertexSource.empty()
+                                    ? nullptr
+                                    : CreateShader(shader.DebugName, shader.VertexSource, shader.FragmentSource));
+            m_ShaderPipelines.push_back(m_Shaders.back() == nullptr
+                                            ? DEFAULT_PIPELINE
+                                            : RendererAPI().Pipelines().Create(PipelineState{m_Shaders.back().get(),
+                                                                               MeshGeometryPool().Layout()}));
+        }
+        for (const auto& description : m_Capture.Textures()) {
+            m_Textures.push_back(CreateTexture2D(description));
+        }
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto FrameReplay::Replay(Renderer& renderer, IRenderTarget& target) -> bool
+    {
+        const auto& corners = m_Capture.QuadCorners();
+        const auto& tex_coords = m_Capture.QuadTexCoords();
+        const auto& colors = m_Capture.QuadColors();
+
+        bool success = true;
+        for (const auto& command : m_Capture.Commands()) {
+            switch (command.CommandType) {
+                case CapturedCommand::Type::BEGIN:
+                    target.Bind();
+                    success = RendererAPI().SetClearColor(command.ClearColor) && success;
+                    success = RendererAPI().ClearFramebuffer(Renderer::DEFAULT_ATTACHMENT_FLAGS) && success;
+                    break;
+                case CapturedCommand::Type::END:
+                    target.Unbind();
+                    break;
+                case CapturedCommand::Type::DRAW_MESH: {
+                    const auto PIPELINE =
+                        command.Shader != CapturedCommand::NONE ? m_ShaderPipelines[command.Shader] : DEFAULT_PIPELINE;
+                    success = Renderer::DrawMeshLOD(*m_Meshes[command.Mesh],
+                                                    PIPELINE,
+                                                    MeshLOD{command.First, command.Count, 0})
+                              && success;
+                    break;
+                }
+                case CapturedCommand::Type::DRAW_QUADS: {
+                    auto* texture =
+                        command.Texture != CapturedCommand::NONE ? m_Textures[command.Texture].get() : nullptr;
+                    success = renderer.DrawQuadBatch(std::span{corners}.subspan(command.First, command.Count),
+                                                     std::span{tex_coords}.subspan(command.First, command.Count),
+                                                     std::span{colors}.subspan(command.First, command.Count),
+                                                     texture)
+                              && success;
+                    break;
+                }
+            }
+        }
+        return success;
+    }
+
+}  // namespace JE
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+#include "Memory.hpp"
+#include "Renderer.hpp"
+#include "Texture.hpp"
+#include "Types.hpp"
+
+namespace JE
+{
+
+    struct CapturedMesh
+    {
+        Vector<VertexType> Vertices;
+        /// Indices of every level of detail
+        Vector<IndexType> Indices;
+    };
+
+    struct CapturedShader
+    {
+        std::string DebugName;
+        std::string VertexSource;
+        std::string FragmentSource;
+    };
+
+    struct CapturedCommand
+    {
+        enum class Type : std::uint32_t
+        {
+            BEGIN,
+            END,
+            DRAW_MESH,
+            DRAW_QUADS
+        };
+
+        static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+        Type CommandType = Type::BEGIN;
+        /// Clear color of BEGIN
+        RGBA ClearColor;
+        /// Resources of the draw, indices into the capture
+        std::uint32_t Mesh = NONE;
+        std::uint32_t Shader = NONE;
+        std::uint32_t Texture = NONE;
+        /// Index range of DRAW_MESH, quad corner range of DRAW_QUADS
+        std::uint32_t First = 0;
+        std::uint32_t Count = 0;
+    };
+
+    /// Command stream of the frames the Renderer recorded while capturing, plus copies of the meshes, shader sources
+    /// and texture descriptions it used, so the frames can be replayed without the game
+    class FrameCapture
+    {
+      public:
+        void RecordBegin(const RGBA& clear_color);
+        void RecordEnd();
+        void RecordMesh(const Mesh& mesh, const IShaderProgram* shader_program, const MeshLOD& lod);
+        void RecordQuads(std::span<const VertexType> corners,
+                         std::span<const glm::vec2> tex_coords,
+                         std::span<const glm::vec4> colors,
+                         const ITexture2D* texture);
+
+        void Clear();
+
+        auto Write(const std::filesystem::path& path) const -> bool;
+        static auto Read(const std::filesystem::path& path) -> std::optional<FrameCapture>;
+
+        inline auto Commands() const -> const Vector<CapturedCommand>& { return m_Commands; }
+        inline auto Meshes() const -> const Vector<CapturedMesh>& { return m_Meshes; }
+        inline auto Shaders() const -> const Vector<CapturedShader>& { return m_Shaders; }
+        /// Only the descriptions, replays sample uninitialized textures of the same size and format
+        inline auto Textures() const -> const Vector<TextureDescription>& { return m_Textures; }
+        inline auto QuadCorners() const -> const Vector<VertexType>& { return m_QuadCorners; }
+        inline auto QuadTexCoords() const -> const Vector<glm::vec2>& { return m_QuadTexCoords; }
+        inline auto QuadColors() const -> const Vector<glm::vec4>& { return m_QuadColors; }
+
+      private:
+        Vector<CapturedCommand> m_Commands;
+        Vector<CapturedMesh> m_Meshes;
+        Vector<CapturedShader> m_Shaders;
+        Vector<TextureDescription> m_Textures;
+        Vector<VertexType> m_QuadCorners;
+        Vector<glm::vec2> m_QuadTexCoords;
+        Vector<glm::vec4> m_QuadColors;
+
+        /// Resources already copied into the capture, the pointers are only compared while capturing
+        std::unordered_map<const void*, std::uint32_t> m_ResourceIndices;
+    };
+
+    /// Recreates the resources of a capture with the current RendererAPI and issues its commands again
+    class FrameReplay
+    {
+      public:
+        explicit FrameReplay(FrameCapture capture);
+
+        /// Every captured frame is drawn into target, regardless of the target it was captured with
+        auto Replay(Renderer& renderer, IRenderTarget& target) -> bool;
+
+        inline auto Capture() const -> const FrameCapture& { return m_Capture; }
+
+      private:
+        FrameCapture m_Capture;
+        Vector<Scope<Mesh>> m_Meshes;
+        Vector<Scope<IShaderProgram>> m_Shaders;
+        /// Pipeline of each captured shader in the default render state, render state is not captured
+        Vector<PipelineID> m_ShaderPipelines;
+        Vector<Scope<ITexture2D>> m_Textures;
+    };
+
+}  // namespace JE
@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "GeometryPool.hpp"
+
+#include "Assert.hpp"
+#include "Logger.hpp"
+
+namespace JE
+{
+
+    GeometryPool::GeometryPool(AttributeLayout layout, const GeometryPoolSettings& settings)
+        : m_Layout(std::move(layout))
+        , m_Settings(settings)
+    {
+        ASSERT(m_Layout.Stride() > 0);
+        ASSERT(settings.PageVertexCount > 0 && settings.PageIndexCount > 0 && settings.MaxRangesPerPage > 0);
+    }
+
+    auto GeometryPool::Allocate(std::span<const std::byte> vertices, std::span<const IndexType> indices)
+        -> GeometryHandle
+    {
+        const auto STRIDE = m_Layout.Stride();
+        ASSERT(vertices.size() % STRIDE == 0);
+
+        if (vertices.empty() || indices.empty()) {
+            return INVALID_GEOMETRY;
+        }
+
+        const auto SLOT =
+            Place(static_cast<std::uint32_t>(vertices.size() / STRIDE), static_cast<std::uint32_t>(indices.size()));
+        if (!SLOT) {
+            return INVALID_GEOMETRY;
+        }
+
+        auto& vertex_buffer = *m_Pages[SLOT->Range.Page]->VertexArray->Buffers().front();
+        vertex_buffer.Bind();
+        const bool VERTICES_UPLOADED = vertex_buffer.SetSubData(std::size_t{SLOT->Vertices.Offset} * STRIDE, vertices);
+        vertex_buffer.Unbind();
+        if (!VERTICES_UPLOADED || !UploadIndices(*SLOT, indices)) {
+            Release(*SLOT);
+            return INVALID_GEOMETRY;
+        }
+
+        GeometryHandle handle = 0;
+        if (m_FreeSlots.empty()) {
+            handle = static_cast<GeometryHandle>(m_Slots.size());
+            m_Slots.emplace_back();
+        } else {
+            handle = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        }
+        m_Slots[handle] = *SLOT;
+        return handle;
+    }
+
+    auto GeometryPool::SetIndices(GeometryHandle handle, std::span<const IndexType> indices) -> bool
+    {
+        ASSERT(handle < m_Slots.size() && m_Slots[handle].Live);
+
+        if (indices.empty()) {
+            return false;
+        }
+
+        auto& slot = m_Slots[handle];
+        auto& page = *m_Pages[slot.Range.Page];
+        const auto INDEX_COUNT = static_cast<std::uint32_t>(indices.size());
+
+        if (INDEX_COUNT <= page.IndexAllocator.AllocationSize(slot.Indices)) {
+            if (!UploadIndices(slot, indices)) {
+                return false;
+            }
+            slot.Range.IndexCount = INDEX_COUNT;
+            return true;
+        }
+
+        // The vertices stay where they are if the page has room for the indices
+        if (const auto INDICES = page.IndexAllocator.Allocate(INDEX_COUNT); INDICES.Valid()) {
+            auto moved = slot;
+            moved.Indices = INDICES;
+            moved.Range.FirstIndex = INDICES.Offset;
+            moved.Range.IndexCount = INDEX_COUNT;
+            if (!UploadIndices(moved, indices)) {
+                page.IndexAllocator.Free(INDICES);
+                return false;
+            }
+            page.IndexAllocator.Free(slot.Indices);
+            slot = moved;
+            return true;
+        }
+
+        const auto MOVED = Place(slot.Range.VertexCount, INDEX_COUNT);
+        if (!MOVED) {
+            return false;
+        }
+        if (!CopyRange(page, slot, *m_Pages[MOVED->Range.Page], *MOVED, false) || !UploadIndices(*MOVED, indices)) {
+            Release(*MOVED);
+            return false;
+        }
+        Release(slot);
+        slot = *MOVED;
+        return true;
+    }
+
+    void GeometryPool::Free(GeometryHandle handle)
+    {
+        ASSERT(handle < m_Slots.size() && m_Slots[handle].Live);
+
+        Release(m_Slots[handle]);
+        m_Slots[handle] = {};
+        m_FreeSlots.push_back(handle);
+    }
+
+    auto GeometryPool::Range(GeometryHandle handle) const -> const GeometryRange&
+    {
+        ASSERT(handle < m_Slots.size() && m_Slots[handle].Live);
+
+        return m_Slots[handle].Range;
+    }
+
+    auto GeometryPool::VertexArray(std::uint32_t page) const -> IVertexArray&
+    {
+        ASSERT(page < m_Pages.size() && m_Pages[page] != nullptr);
+
+        return *m_Pages[page]->VertexArray;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto GeometryPool::Defragment() -> bool
+    {
+        bool success = true;
+        for (std::uint32_t page = 0; page < m_Pages.size(); ++page) {
+            if (m_Pages[page] != nullptr) {
+                success = CompactPage(page) && success;
+            }
+        }
+        return success;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto GeometryPool::Statistics() const -> GeometryPoolStatistics
+    {
+        GeometryPoolStatistics statistics;
+        for (const auto& page : m_Pages) {
+            if (page == nullptr) {
+                continue;
+            }
+
+            ++statistics.PageCount;
+            statistics.RangeCount += page->RangeCount;
+            statistics.VertexCapacity += page->VertexAllocator.Size();
+            statistics.IndexCapacity += page->IndexAllocator.Size();
+            statistics.FreeVertices += page->VertexAllocator.FreeSpace();
+            statistics.FreeIndices += page->IndexAllocator.FreeSpace();
+        }
+        return statistics;
+    }
+
+    auto GeometryPool::CreatePage(std::uint32_t vertex_count, std::uint32_t index_count) const -> Scope<Page>
+    {
+        // Base vertices are signed
+        ASSERT(vertex_count <= static_cast<std::uint32_t>(std::numeric_limits<std::int32_t>::max()));
+
+        auto vertex_buffer = CreateVertexBuffer(m_Layout);
+        vertex_buffer->Bind();
+        const bool VERTICES_ALLOCATED = vertex_buffer->AllocateStorage(std::size_t{vertex_count} * m_Layout.Stride());
+        vertex_buffer->Unbind();
+
+        auto index_buffer = CreateElementBuffer();
+        index_buffer->Bind();
+        const bool INDICES_ALLOCATED = index_buffer->AllocateStorage(std::size_t{index_count} * sizeof(IndexType));
+        index_buffer->Unbind();
+
+        if (!VERTICES_ALLOCATED || !INDICES_ALLOCATED) {
+            EngineLogger()->error(
+                "Geometry pool page of {} vertices and {} indices couldn't be allocated", vertex_count, index_count);
+            return nullptr;
+        }
+
+        auto page = CreateScope<Page>(vertex_count, index_count, m_Settings.MaxRangesPerPage);
+        page->VertexArray = CreateVertexArray();
+        page->VertexArray->AddBuffer(std::move(vertex_buffer));
+        page->VertexArray->SetIndexBuffer(std::move(index_buffer));
+        page->VertexArray->Build();
+        return page;
+    }
+
+    auto GeometryPool::Place(std::uint32_t vertex_count, std::uint32_t index_count) -> std::optional<Slot>
+    {
+        for (std::uint32_t index = 0; index < m_Pages.size(); ++index) {
+            if (m_Pages[index] == nullptr) {
+                continue;
+            }
+            if (auto slot = PlaceInPage(*m_Pages[index], index, vertex_count, index_count)) {
+                return slot;
+            }
+        }
+
+        auto page = CreatePage(std::max(m_Settings.PageVertexCount, vertex_count),
+                               std::max(m_Settings.PageIndexCount, index_count));
+        if (page == nullptr) {
+            return std::nullopt;
+        }
+
+        const auto EMPTY =
+            std::ranges::find_if(m_Pages, [](const Scope<Page>& existing) { return existing == nullptr; });
+        const auto INDEX = static_cast<std::uint32_t>(EMPTY - m_Pages.begin());
+        if (EMPTY == m_Pages.end()) {
+            m_Pages.push_back(std::move(page));
+        } else {
+            *EMPTY = std::move(page);
+        }
+        return PlaceInPage(*m_Pages[INDEX], INDEX, vertex_count, index_count);
+    }
+
+    auto GeometryPool::PlaceInPage(Page& page,
+                                   std::uint32_t page_index,
+                                   std::uint32_t vertex_count,
+                                   std::uint32_t index_count) -> std::optional<Slot>
+    {
+        const auto VERTICES = page.VertexAllocator.Allocate(vertex_count);
+        if (!VERTICES.Valid()) {
+            return std::nullopt;
+        }
+        const auto INDICES = page.IndexAllocator.Allocate(index_count);
+        if (!INDICES.Valid()) {
+            page.VertexAllocator.Free(VERTICES);
+            return std::nullopt;
+        }
+        ++page.RangeCount;
+
+        Slot slot;
+        slot.Range = {
+            INDICES.Offset, index_count, static_cast<std::int32_t>(VERTICES.Offset), vertex_count, page_index};
+        slot.Vertices = VERTICES;
+        slot.Indices = INDICES;
+        slot.Live = true;
+        return slot;
+    }
+
+    void GeometryPool::Release(const Slot& slot)
+    {
+        auto& page = m_Pages[slot.Range.Page];
+        page->VertexAllocator.Free(slot.Vertices);
+        page->IndexAllocator.Free(slot.Indices);
+
+        // Meshes are usually destroyed before the graphics context, empty pages don't hold on to buffers until exit
+        if (--page->RangeCount == 0) {
+            page.reset();
+        }
+    }
+
+    auto GeometryPool::CopyRange(const Page& source_page,
+                                 const Slot& source,
+                                 Page& destination_page,
+                                 const Slot& destination,
+                                 bool copy_indices) const -> bool
+    {
+        ASSERT(source.Range.VertexCount == destination.Range.VertexCount);
+
+        const auto STRIDE = m_Layout.Stride();
+        bool success = destination_page.VertexArray->Buffers().front()->CopySubData(
+            *source_page.VertexArray->Buffers().front(),
+            std::size_t{source.Vertices.Offset} * STRIDE,
+            std::size_t{destination.Vertices.Offset} * STRIDE,
+            std::size_t{source.Range.VertexCount} * STRIDE);
+
+        if (copy_indices) {
+            ASSERT(source.Range.IndexCount == destination.Range.IndexCount);
+
+            success = destination_page.VertexArray->IndexBuffer().CopySubData(
+                          source_page.VertexArray->IndexBuffer(),
+                          std::size_t{source.Indices.Offset} * sizeof(IndexType),
+                          std::size_t{destination.Indices.Offset} * sizeof(IndexType),
+                          std::size_t{source.Range.IndexCount} * sizeof(IndexType))
+                && success;
+        }
+        return success;
+    }
+
+    auto GeometryPool::UploadIndices(const Slot& slot, std::span<const IndexType> indices) const -> bool
+    {
+        auto& index_buffer = m_Pages[slot.Range.Page]->VertexArray->IndexBuffer();
+        index_buffer.Bind();
+        const bool SUCCESS =
+            index_buffer.SetSubData(std::size_t{slot.Indices.Offset} * sizeof(IndexType), std::as_bytes(indices));
+        index_buffer.Unbind();
+        return SUCCESS;
+    }
+
+    auto GeometryPool::CompactPage(std::uint32_t page_index) -> bool
+    {
+        const auto& page = *m_Pages[page_index];
+        if (page.VertexAllocator.LargestFreeRegion() == page.VertexAllocator.FreeSpace()
+            && page.IndexAllocator.LargestFreeRegion() == page.IndexAllocator.FreeSpace()) {
+            return true;
+        }
+
+        auto compacted = CreatePage(page.VertexAllocator.Size(), page.IndexAllocator.Size());
+        if (compacted == nullptr) {
+            return false;
+        }
+
+        // Ranges keep their order, meshes uploaded together stay next to each other
+        Vector<GeometryHandle> handles;
+        for (GeometryHandle handle = 0; handle < m_Slots.size(); ++handle) {
+            if (m_Slots[handle].Live && m_Slots[handle].Range.Page == page_index) {
+                handles.push_back(handle);
+            }
+        }
+        std::ranges::sort(handles,
+                          [this](GeometryHandle first, GeometryHandle second)
+                          { return m_Slots[first].Vertices.Offset < m_Slots[second].Vertices.Offset; });
+
+        // The page is only replaced once every range was copied, a failed copy leaves it untouched
+        Vector<Slot> moved;
+        moved.reserve(handles.size());
+        for (const auto HANDLE : handles) {
+            const auto& slot = m_Slots[HANDLE];
+            auto packed = PlaceInPage(*compacted, page_index, slot.Range.VertexCount, slot.Range.IndexCount);
+            ASSERT(packed.has_value());
+            if (!CopyRange(page, slot, *compacted, *packed, true)) {
+                return false;
+            }
+            moved.push_back(*packed);
+        }
+
+        for (std::size_t i = 0; i < handles.size(); ++i) {
+            m_Slots[handles[i]] = moved[i];
+        }
+        m_Pages[page_index] = std::move(compacted);
+        return true;
+    }
+
+    auto MeshGeometryPool() -> GeometryPool&
+    {
+        static GeometryPool s_MeshPool{
+            AttributeLayout{{AttributeLayout::Attribute{"a_VertexPos", IRendererAPI::Type::FLOAT, 3}}}};
+        return s_MeshPool;
+    }
+
+    auto PooledGeometry::Range() const -> const GeometryRange&
+    {
+        ASSERT(Valid());
+
+        return m_Pool->Range(m_Handle);
+    }
+
+    auto PooledGeometry::VertexArray() const -> IVertexArray& { return m_Pool->VertexArray(Range().Page); }
+
+    auto PooledGeometry::SetIndices(std::span<const IndexType> indices) -> bool
+    {
+        ASSERT(Valid());
+
+        return m_Pool->SetIndices(m_Handle, indices);
+    }
+
+    void PooledGeometry::Reset()
+    {
+        if (!Valid()) {
+            return;
+        }
+
+        m_Pool->Free(m_Handle);
+        m_Handle = INVALID_GEOMETRY;
+    }
+
+}  // namespace JE
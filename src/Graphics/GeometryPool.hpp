@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "Graphics/OffsetAllocator.hpp"
+#include "Graphics/Renderer.hpp"
+#include "Memory.hpp"
+
+namespace JE
+{
+
+    struct GeometryPoolSettings
+    {
+        static constexpr std::uint32_t DEFAULT_PAGE_VERTEX_COUNT = 256 * 1024;
+        static constexpr std::uint32_t DEFAULT_PAGE_INDEX_COUNT = 3 * DEFAULT_PAGE_VERTEX_COUNT;
+        static constexpr std::uint32_t DEFAULT_MAX_RANGES_PER_PAGE = 4096;
+
+        /// Capacity of a page, geometry that doesn't fit an empty page gets a page of its own size
+        std::uint32_t PageVertexCount = DEFAULT_PAGE_VERTEX_COUNT;
+        std::uint32_t PageIndexCount = DEFAULT_PAGE_INDEX_COUNT;
+        std::uint32_t MaxRangesPerPage = DEFAULT_MAX_RANGES_PER_PAGE;
+    };
+
+    struct GeometryPoolStatistics
+    {
+        std::size_t PageCount = 0;
+        std::size_t RangeCount = 0;
+        std::size_t VertexCapacity = 0;
+        std::size_t IndexCapacity = 0;
+        std::size_t FreeVertices = 0;
+        std::size_t FreeIndices = 0;
+    };
+
+    /// Sub-allocates the geometry of many meshes with one vertex layout from a few large vertex and element buffers.
+    /// Each page of buffers has one vertex array, so draws of geometry in the same page only differ in their index
+    /// range and base vertex and need no rebinding
+    class GeometryPool
+    {
+      public:
+        GeometryPool(const GeometryPool& other) = delete;
+        GeometryPool(GeometryPool&& other) = delete;
+        auto operator=(const GeometryPool& other) -> GeometryPool& = delete;
+        auto operator=(GeometryPool&& other) -> GeometryPool& = delete;
+
+        explicit GeometryPool(AttributeLayout layout, const GeometryPoolSettings& settings = {});
+        ~GeometryPool() = default;
+
+        /// vertices holds whole vertices of the pool's layout, the indices are relative to the first of them
+        /// \returns INVALID_GEOMETRY if either is empty or the buffers can't be allocated
+        auto Allocate(std::span<const std::byte> vertices, std::span<const IndexType> indices) -> GeometryHandle;
+        /// The range is rewritten in place while the indices fit, otherwise it moves to wherever they fit
+        auto SetIndices(GeometryHandle handle, std::span<const IndexType> indices) -> bool;
+        /// Pages without any range left release their buffers
+        void Free(GeometryHandle handle);
+
+        auto Range(GeometryHandle handle) const -> const GeometryRange&;
+        auto VertexArray(std::uint32_t page) const -> IVertexArray&;
+
+        /// Packs the ranges of every fragmented page to its start, copying them on the GPU. Handles stay valid but
+        /// their ranges change, so nothing drawing them may be recorded in between
+        /// \returns false if a page couldn't be repacked, it keeps its previous layout then
+        auto Defragment() -> bool;
+
+        auto Statistics() const -> GeometryPoolStatistics;
+        inline auto Layout() const -> const AttributeLayout& { return m_Layout; }
+
+      private:
+        struct Page
+        {
+            Page(std::uint32_t vertex_count, std::uint32_t index_count, std::uint32_t max_ranges)
+                : VertexAllocator(vertex_count, max_ranges)
+                , IndexAllocator(index_count, max_ranges)
+            {
+            }
+
+            Scope<IVertexArray> VertexArray;
+            OffsetAllocator VertexAllocator;
+            OffsetAllocator IndexAllocator;
+            std::size_t RangeCount = 0;
+        };
+
+        struct Slot
+        {
+            GeometryRange Range;
+            OffsetAllocator::Allocation Vertices;
+            OffsetAllocator::Allocation Indices;
+            bool Live = false;
+        };
+
+        auto CreatePage(std::uint32_t vertex_count, std::uint32_t index_count) const -> Scope<Page>;
+        /// Allocates from the first page with room, creating a page if none has
+        auto Place(std::uint32_t vertex_count, std::uint32_t index_count) -> std::optional<Slot>;
+        static auto PlaceInPage(Page& page,
+                                std::uint32_t page_index,
+                                std::uint32_t vertex_count,
+                                std::uint32_t index_count) -> std::optional<Slot>;
+        void Release(const Slot& slot);
+        auto CopyRange(const Page& source_page,
+                       const Slot& source,
+                       Page& destination_page,
+                       const Slot& destination,
+                       bool copy_indices) const -> bool;
+        auto UploadIndices(const Slot& slot, std::span<const IndexType> indices) const -> bool;
+        auto CompactPage(std::uint32_t page_index) -> bool;
+
+        AttributeLayout m_Layout;
+        GeometryPoolSettings m_Settings;
+        /// Released pages stay empty until a new page takes their index, ranges refer to pages by index
+        Vector<Scope<Page>> m_Pages;
+        Vector<Slot> m_Slots;
+        Vector<GeometryHandle> m_FreeSlots;
+    };
+
+    /// Pool of every Mesh, created on first use with the mesh vertex layout
+    auto MeshGeometryPool() -> GeometryPool&;
+
+}  // namespace JE
@@ -4,6 +4,7 @@
 
 #include "Assert.hpp"
 #include "Graphics/OpenGLRendererAPI.hpp"
+#include "Graphics/PipelineState.hpp"
 #include "Logger.hpp"
 #include "Memory.hpp"
 
@@ -16,6 +17,13 @@ namespace JE
 
     }  // namespace
 
+    IRendererAPI::IRendererAPI()
+        : m_Pipelines(CreateScope<PipelineCache>(*this))
+    {
+    }
+
+    IRendererAPI::~IRendererAPI() = default;
+
     namespace detail
     {
         void SetCustomRendererAPI(Scope<IRendererAPI> renderer_api)
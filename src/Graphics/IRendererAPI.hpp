@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <string_view>
 #include <utility>
 
@@ -11,6 +12,18 @@
 namespace JE
 {
     struct RGBA;
+    class AttributeLayout;
+    class IVertexBuffer;
+    class IElementBuffer;
+    class IVertexArray;
+    class IShaderProgram;
+    class ITexture2D;
+    class ITextureUploader;
+    struct TextureDescription;
+    class IFramebuffer;
+    struct FramebufferDescription;
+    struct RenderState;
+    class PipelineCache;
 }  // namespace JE
 
 namespace JE
@@ -21,7 +34,9 @@ namespace JE
       public:
         enum class API
         {
-            OPENGL
+            OPENGL,
+            SOFTWARE,
+            VULKAN
         };
 
         enum AttachmentFlag : std::uint32_t
@@ -34,6 +49,9 @@ namespace JE
         using FramebufferID = std::uint32_t;
         using BufferID = std::uint32_t;
         using ProgramID = std::uint32_t;
+        using TextureID = std::uint32_t;
+        using FenceID = std::uintptr_t;
+        using TimerQueryID = std::uint32_t;
 
         enum class Primitive
         {
@@ -52,15 +70,55 @@ namespace JE
         auto operator=(const IRendererAPI& other) -> IRendererAPI& = delete;
         auto operator=(IRendererAPI&& other) -> IRendererAPI& = delete;
 
-        IRendererAPI() = default;
-        virtual ~IRendererAPI() = default;
+        IRendererAPI();
+        virtual ~IRendererAPI();
 
         virtual auto Name() const -> std::string_view = 0;
 
+        /// Pipelines created for this backend, they are applied through it and die with it
+        inline auto Pipelines() -> PipelineCache& { return *m_Pipelines; }
+
         virtual auto SetClearColor(const RGBA& color) -> bool = 0;
         virtual auto ClearFramebuffer(AttachmentFlags flags) -> bool = 0;
         virtual auto BindFramebuffer(FramebufferID buffer_id) -> bool = 0;
-        virtual auto DrawIndexed(Primitive primitive_type, std::uint32_t index_count, Type index_type) -> bool = 0;
+        /// Draws index_count indices of the bound element buffer starting at first_index, base_vertex is added to
+        /// every index so geometry packed into shared buffers keeps its own indices
+        virtual auto DrawIndexed(Primitive primitive_type,
+                                 std::uint32_t index_count,
+                                 Type index_type,
+                                 std::uint32_t first_index,
+                                 std::int32_t base_vertex) -> bool = 0;
+        /// Blend, depth, stencil and rasterizer state of the following draws
+        virtual auto SetRenderState(const RenderState& state) -> bool = 0;
+
+        virtual auto CreateVertexBuffer(const AttributeLayout& layout) -> Scope<IVertexBuffer> = 0;
+        virtual auto CreateElementBuffer() -> Scope<IElementBuffer> = 0;
+        virtual auto CreateVertexArray() -> Scope<IVertexArray> = 0;
+        virtual auto CreateShader(std::string_view debug_name,
+                                  std::string_view vertex_source,
+                                  std::string_view fragment_source) -> Scope<IShaderProgram> = 0;
+        virtual auto CreateTexture2D(const TextureDescription& description) -> Scope<ITexture2D> = 0;
+        virtual auto CreateTextureUploader(std::size_t frame_budget) -> Scope<ITextureUploader> = 0;
+        virtual auto CreateFramebuffer(const FramebufferDescription& description) -> Scope<IFramebuffer> = 0;
+
+        virtual auto InsertFence() -> FenceID = 0;
+        virtual auto WaitFence(FenceID fence, std::uint64_t timeout_ns) -> bool = 0;
+        virtual void DeleteFence(FenceID fence) = 0;
+        virtual auto Finish() -> bool = 0;
+        /// Called once per frame after the windows were swapped, objects destroyed during earlier frames whose
+        /// commands the GPU may have finished can be released here
+        virtual void EndFrame() = 0;
+
+        /// Measures how long the GPU spends on the commands between Begin and End, queries can't be nested.
+        /// BeginTimerQuery returns 0 when the backend can't measure GPU time
+        virtual auto BeginTimerQuery() -> TimerQueryID = 0;
+        virtual auto EndTimerQuery(TimerQueryID query) -> bool = 0;
+        /// Elapsed nanoseconds, std::nullopt while the GPU hasn't finished the measured commands yet
+        virtual auto TimerQueryResult(TimerQueryID query) -> std::optional<std::uint64_t> = 0;
+        virtual void DeleteTimerQuery(TimerQueryID query) = 0;
+
+      private:
+        Scope<PipelineCache> m_Pipelines;
     };
 
     constexpr auto TypeByteCount(IRendererAPI::Type type) -> std::size_t
@@ -69,6 +127,12 @@ namespace JE
             case IRendererAPI::Type::FLOAT:
                 return 4;
                 break;
+            case IRendererAPI::Type::UNSIGNED_SHORT:
+                return 2;
+                break;
+            case IRendererAPI::Type::UNSIGNED_INT:
+                return 4;
+                break;
             default:
                 return 0;
                 break;
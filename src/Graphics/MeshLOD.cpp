@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <queue>
+#include <tuple>
+
+#include "MeshLOD.hpp"
+
+#include "Assert.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        constexpr std::size_t TRIANGLE_CORNERS = 3;
+        /// Border edges are kept in place by planes perpendicular to them, weighted much higher than the surface
+        constexpr float BORDER_WEIGHT = 10.f;
+        constexpr std::uint32_t REMOVED = std::numeric_limits<std::uint32_t>::max();
+
+        /// Sum of squared distances to a set of planes, weighted by the area they were taken from. Accumulated in
+        /// double precision, in float the expanded form cancels out to zero error for collapses that move the surface
+        struct Quadric
+        {
+            double A00 = 0;
+            double A01 = 0;
+            double A02 = 0;
+            double A11 = 0;
+            double A12 = 0;
+            double A22 = 0;
+            glm::dvec3 B{0};
+            double C = 0;
+            double Weight = 0;
+
+            static auto FromPlane(const glm::vec3& normal, float distance, float weight) -> Quadric
+            {
+                const glm::dvec3 N{normal.x, normal.y, normal.z};
+                const auto D = static_cast<double>(distance);
+                const auto W = static_cast<double>(weight);
+                return {N.x * N.x * W,
+                        N.x * N.y * W,
+                        N.x * N.z * W,
+                        N.y * N.y * W,
+                        N.y * N.z * W,
+                        N.z * N.z * W,
+                        N * D * W,
+                        D * D * W,
+                        W};
+            }
+
+            inline auto operator+=(const Quadric& other) -> Quadric&
+            {
+                A00 += other.A00;
+                A01 += other.A01;
+                A02 += other.A02;
+                A11 += other.A11;
+                A12 += other.A12;
+                A22 += other.A22;
+                B += other.B;
+                C += other.C;
+                Weight += other.Weight;
+                return *this;
+            }
+
+            /// Weighted mean squared distance of the point to the planes
+            inline auto Evaluate(const glm::vec3& point) const -> float
+            {
+                if (Weight <= 0) {
+                    return 0;
+                }
+                const glm::dvec3 P{point.x, point.y, point.z};
+                const auto SQUARED_DISTANCE = A00 * P.x * P.x + A11 * P.y * P.y + A22 * P.z * P.z
+                                   + 2.0 * (A01 * P.x * P.y + A02 * P.x * P.z + A12 * P.y * P.z)
+                                   + 2.0 * glm::dot(B, P) + C;
+                return static_cast<float>(std::max(SQUARED_DISTANCE, 0.0) / Weight);
+            }
+        };
+
+        inline auto operator+(Quadric lhs, const Quadric& rhs) -> Quadric
+        {
+            lhs += rhs;
+            return lhs;
+        }
+
+        struct Collapse
+        {
+            float Error = 0;
+            std::uint32_t From = 0;
+            std::uint32_t To = 0;
+            /// Versions of both vertices when the collapse was queued, stale entries are skipped
+            std::uint32_t FromVersion = 0;
+            std::uint32_t ToVersion = 0;
+
+            inline auto operator>(const Collapse& other) const -> bool { return Error > other.Error; }
+        };
+
+        /// Maps every vertex to the first vertex with the same position so split vertices collapse together
+        auto WeldPositions(std::span<const glm::vec3> vertices) -> Vector<std::uint32_t>
+        {
+            Vector<std::uint32_t> order(vertices.size());
+            std::iota(order.begin(), order.end(), 0U);
+            std::stable_sort(order.begin(),
+                             order.end(),
+                             [&vertices](std::uint32_t lhs, std::uint32_t rhs)
+                             {
+                                 const auto& a = vertices[lhs];
+                                 const auto& b = vertices[rhs];
+                                 return std::tie(a.x, a.y, a.z) < std::tie(b.x, b.y, b.z);
+                             });
+
+            Vector<std::uint32_t> canonical(vertices.size());
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                const bool SAME = i > 0 && vertices[order[i]] == vertices[order[i - 1]];
+                canonical[order[i]] = SAME ? canonical[order[i - 1]] : order[i];
+            }
+            return canonical;
+        }
+
+        auto TriangleNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) -> glm::vec3
+        {
+            return glm::cross(b - a, c - a);
+        }
+
+    }  // namespace
+
+    // cppcheck-suppress unusedFunction
+    auto SimplifyMesh(std::span<const glm::vec3> vertices,
+                      std::span<const std::uint32_t> indices,
+                      std::size_t target_index_count,
+                      float max_error) -> SimplifiedMesh
+    {
+        ASSERT(indices.size() % TRIANGLE_CORNERS == 0);
+
+        const auto RADIUS = ComputeBounds(vertices).Sphere.Radius;
+        const auto SCALE = RADIUS > 0 ? RADIUS : 1.f;
+        const auto MAX_ERROR = max_error * SCALE;
+
+        const auto CANONICAL = WeldPositions(vertices);
+        Vector<std::uint32_t> triangles(indices.size());
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            ASSERT(indices[i] < vertices.size());
+            triangles[i] = CANONICAL[indices[i]];
+        }
+        const auto TRIANGLE_COUNT = triangles.size() / TRIANGLE_CORNERS;
+        const auto CORNER = [&triangles](std::size_t triangle, std::size_t corner) -> std::uint32_t&
+        {
+            return triangles[triangle * TRIANGLE_CORNERS + corner];
+        };
+
+        Vector<Vector<std::uint32_t>> vertex_triangles(vertices.size());
+        Vector<Quadric> quadrics(vertices.size());
+        Vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+        std::size_t live_triangles = 0;
+        for (std::size_t triangle = 0; triangle < TRIANGLE_COUNT; ++triangle) {
+            // Welding can leave triangles without area in the index buffer
+            if (CORNER(triangle, 0) == CORNER(triangle, 1) || CORNER(triangle, 1) == CORNER(triangle, 2)
+                || CORNER(triangle, 2) == CORNER(triangle, 0)) {
+                std::fill_n(&CORNER(triangle, 0), TRIANGLE_CORNERS, REMOVED);
+                continue;
+            }
+            ++live_triangles;
+
+            const auto NORMAL = TriangleNormal(
+                vertices[CORNER(triangle, 0)], vertices[CORNER(triangle, 1)], vertices[CORNER(triangle, 2)]);
+            const auto DOUBLE_AREA = glm::length(NORMAL);
+            const auto UNIT_NORMAL = DOUBLE_AREA > 0 ? NORMAL / DOUBLE_AREA : glm::vec3{0};
+            const auto PLANE = Quadric::FromPlane(
+                UNIT_NORMAL, -glm::dot(UNIT_NORMAL, vertices[CORNER(triangle, 0)]), DOUBLE_AREA * 0.5f);
+
+            for (std::size_t corner = 0; corner < TRIANGLE_CORNERS; ++corner) {
+                const auto VERTEX = CORNER(triangle, corner);
+                const auto NEXT = CORNER(triangle, (corner + 1) % TRIANGLE_CORNERS);
+                vertex_triangles[VERTEX].push_back(static_cast<std::uint32_t>(triangle));
+                quadrics[VERTEX] += PLANE;
+                edges.emplace_back(std::min(VERTEX, NEXT), std::max(VERTEX, NEXT));
+            }
+        }
+
+        // Edges used by a single triangle are on the border of the mesh
+        std::sort(edges.begin(), edges.end());
+        for (std::size_t i = 0; i < edges.size();) {
+            auto end = i + 1;
+            while (end < edges.size() && edges[end] == edges[i]) {
+                ++end;
+            }
+            if (end - i == 1) {
+                const auto [FIRST, SECOND] = edges[i];
+                const auto EDGE = vertices[SECOND] - vertices[FIRST];
+                for (const auto TRIANGLE : vertex_triangles[FIRST]) {
+                    const auto* corners = &CORNER(TRIANGLE, 0);
+                    if (std::find(corners, corners + TRIANGLE_CORNERS, SECOND) == corners + TRIANGLE_CORNERS) {
+                        continue;
+                    }
+
+                    const auto BORDER_NORMAL = glm::cross(
+                        EDGE, TriangleNormal(vertices[corners[0]], vertices[corners[1]], vertices[corners[2]]));
+                    const auto LENGTH = glm::length(BORDER_NORMAL);
+                    if (LENGTH <= 0) {
+                        continue;
+                    }
+                    const auto UNIT_NORMAL = BORDER_NORMAL / LENGTH;
+                    const auto PLANE = Quadric::FromPlane(UNIT_NORMAL,
+                                                          -glm::dot(UNIT_NORMAL, vertices[FIRST]),
+                                                          glm::dot(EDGE, EDGE) * BORDER_WEIGHT);
+                    quadrics[FIRST] += PLANE;
+                    quadrics[SECOND] += PLANE;
+                }
+            }
+            i = end;
+        }
+
+        Vector<std::uint32_t> versions(vertices.size(), 0);
+        std::priority_queue<Collapse, Vector<Collapse>, std::greater<>> queue;
+        const auto QUEUE_EDGE = [&](std::uint32_t a, std::uint32_t b)
+        {
+            const auto QUADRIC = quadrics[a] + quadrics[b];
+            const auto ERROR_TO_B = QUADRIC.Evaluate(vertices[b]);
+            const auto ERROR_TO_A = QUADRIC.Evaluate(vertices[a]);
+            if (ERROR_TO_B <= ERROR_TO_A) {
+                queue.push({ERROR_TO_B, a, b, versions[a], versions[b]});
+            } else {
+                queue.push({ERROR_TO_A, b, a, versions[b], versions[a]});
+            }
+        };
+        const auto QUEUE_VERTEX_EDGES = [&](std::uint32_t vertex)
+        {
+            for (const auto TRIANGLE : vertex_triangles[vertex]) {
+                for (std::size_t corner = 0; corner < TRIANGLE_CORNERS; ++corner) {
+                    if (CORNER(TRIANGLE, corner) != vertex) {
+                        QUEUE_EDGE(vertex, CORNER(TRIANGLE, corner));
+                    }
+                }
+            }
+        };
+        for (std::size_t i = 0; i < edges.size(); ++i) {
+            if (i == 0 || edges[i] != edges[i - 1]) {
+                QUEUE_EDGE(edges[i].first, edges[i].second);
+            }
+        }
+
+        // Moving the collapsed vertex must not flip or degenerate any of the triangles that stay
+        const auto FLIPS = [&](std::uint32_t from, std::uint32_t to)
+        {
+            for (const auto TRIANGLE : vertex_triangles[from]) {
+                std::array<glm::vec3, TRIANGLE_CORNERS> corners{};
+                bool contains_to = false;
+                for (std::size_t corner = 0; corner < TRIANGLE_CORNERS; ++corner) {
+                    corners[corner] = vertices[CORNER(TRIANGLE, corner)];
+                    contains_to = contains_to || CORNER(TRIANGLE, corner) == to;
+                }
+                if (contains_to) {
+                    continue;
+                }
+
+                const auto BEFORE = TriangleNormal(corners[0], corners[1], corners[2]);
+                for (std::size_t corner = 0; corner < TRIANGLE_CORNERS; ++corner) {
+                    if (CORNER(TRIANGLE, corner) == from) {
+                        corners[corner] = vertices[to];
+                    }
+                }
+                const auto AFTER = TriangleNormal(corners[0], corners[1], corners[2]);
+                if (glm::dot(BEFORE, AFTER) <= 0) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        float max_collapse_error = 0;
+        while (live_triangles * TRIANGLE_CORNERS > target_index_count && !queue.empty()) {
+            const auto COLLAPSE = queue.top();
+            queue.pop();
+            if (versions[COLLAPSE.From] != COLLAPSE.FromVersion || versions[COLLAPSE.To] != COLLAPSE.ToVersion) {
+                continue;
+            }
+            if (std::sqrt(COLLAPSE.Error) > MAX_ERROR) {
+                break;
+            }
+            if (FLIPS(COLLAPSE.From, COLLAPSE.To)) {
+                continue;
+            }
+
+            for (const auto TRIANGLE : vertex_triangles[COLLAPSE.From]) {
+                auto* corners = &CORNER(TRIANGLE, 0);
+                if (std::find(corners, corners + TRIANGLE_CORNERS, COLLAPSE.To) == corners + TRIANGLE_CORNERS) {
+                    std::replace(corners, corners + TRIANGLE_CORNERS, COLLAPSE.From, COLLAPSE.To);
+                    vertex_triangles[COLLAPSE.To].push_back(TRIANGLE);
+                    continue;
+                }
+
+                // Triangles sharing the collapsed edge degenerate, the other vertices must forget them
+                for (std::size_t corner = 0; corner < TRIANGLE_CORNERS; ++corner) {
+                    if (corners[corner] != COLLAPSE.From) {
+                        std::erase(vertex_triangles[corners[corner]], TRIANGLE);
+                    }
+                }
+                std::fill(corners, corners + TRIANGLE_CORNERS, REMOVED);
+                --live_triangles;
+            }
+            vertex_triangles[COLLAPSE.From].clear();
+
+            quadrics[COLLAPSE.To] += quadrics[COLLAPSE.From];
+            max_collapse_error = std::max(max_collapse_error, std::sqrt(COLLAPSE.Error));
+            ++versions[COLLAPSE.From];
+            ++versions[COLLAPSE.To];
+            QUEUE_VERTEX_EDGES(COLLAPSE.To);
+        }
+
+        SimplifiedMesh result;
+        result.Error = max_collapse_error / SCALE;
+        result.Indices.reserve(live_triangles * TRIANGLE_CORNERS);
+        std::copy_if(triangles.begin(),
+                     triangles.end(),
+                     std::back_inserter(result.Indices),
+                     [](std::uint32_t index) { return index != REMOVED; });
+        return result;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto GenerateLODs(std::span<const glm::vec3> vertices,
+                      std::span<const std::uint32_t> indices,
+                      std::size_t lod_count,
+                      float reduction) -> Vector<SimplifiedMesh>
+    {
+        ASSERT(reduction > 0 && reduction < 1);
+
+        Vector<SimplifiedMesh> lods;
+        auto source = indices;
+        float error = 0;
+        for (std::size_t lod = 0; lod < lod_count; ++lod) {
+            const auto TARGET = static_cast<std::size_t>(static_cast<float>(source.size()) * reduction);
+            auto simplified = SimplifyMesh(vertices, source, TARGET);
+            if (simplified.Indices.empty() || simplified.Indices.size() >= source.size()) {
+                break;
+            }
+            // Errors of the chain add up, every level is compared against the full detail mesh
+            error += simplified.Error;
+            simplified.Error = error;
+            lods.push_back(std::move(simplified));
+            source = lods.back().Indices;
+        }
+        return lods;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto ScreenSize(const BoundingSphere& sphere, const glm::mat4& view_projection) -> float
+    {
+        const auto CLIP = view_projection * glm::vec4{sphere.Center, 1.0f};
+        if (CLIP.w <= sphere.Radius) {
+            return std::numeric_limits<float>::max();
+        }
+        // The length of the y row is the projection's scale, the view part is a rotation
+        const auto SCALE = glm::length(glm::vec3{view_projection[0][1], view_projection[1][1], view_projection[2][1]});
+        return sphere.Radius * SCALE / CLIP.w;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto SelectLOD(std::span<const MeshLOD> lods, float screen_size, std::size_t current, const LODSettings& settings)
+        -> std::size_t
+    {
+        if (!settings.Enabled) {
+            return 0;
+        }
+
+        std::size_t selected = 0;
+        for (std::size_t lod = 1; lod < lods.size(); ++lod) {
+            const auto THRESHOLD =
+                settings.MaxScreenError * (lod > current ? 1.f - settings.Hysteresis : 1.f + settings.Hysteresis);
+            if (lods[lod].Error * screen_size > THRESHOLD) {
+                break;
+            }
+            selected = lod;
+        }
+        return selected;
+    }
+
+}  // namespace JE
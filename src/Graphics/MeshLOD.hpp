@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "Culling.hpp"
+#include "Memory.hpp"
+
+namespace JE
+{
+
+    /// Index range of one level of detail inside the mesh's index buffer
+    struct MeshLOD
+    {
+        std::uint32_t FirstIndex = 0;
+        std::uint32_t IndexCount = 0;
+        /// Largest deviation from the full detail mesh relative to the radius of its bounding sphere
+        float Error = 0;
+    };
+
+    struct SimplifiedMesh
+    {
+        Vector<std::uint32_t> Indices;
+        float Error = 0;
+    };
+
+    /// Quadric error metric edge collapse, vertices are collapsed into their neighbours instead of moving to new
+    /// positions so every level of detail can index the original vertex buffer
+    /// \param target_index_count collapses stop once the mesh has at most this many indices
+    /// \param max_error collapses stop before the error (relative to the bounding sphere radius) would exceed this
+    auto SimplifyMesh(std::span<const glm::vec3> vertices,
+                      std::span<const std::uint32_t> indices,
+                      std::size_t target_index_count,
+                      float max_error = std::numeric_limits<float>::max()) -> SimplifiedMesh;
+
+    /// Every level is simplified from the previous one to reduction times its index count, levels that can't be
+    /// simplified any further end the chain early
+    auto GenerateLODs(std::span<const glm::vec3> vertices,
+                      std::span<const std::uint32_t> indices,
+                      std::size_t lod_count,
+                      float reduction = 0.5f) -> Vector<SimplifiedMesh>;
+
+    struct LODSettings
+    {
+        /// Largest error a level may show on screen, as a fraction of the viewport height
+        float MaxScreenError = 0.001f;
+        /// Switching to a coarser level needs the error to be this much below MaxScreenError, switching back this much
+        /// above it, so meshes sitting at the threshold don't flicker between levels
+        float Hysteresis = 0.25f;
+        bool Enabled = true;
+    };
+
+    /// Projected radius of the sphere as a fraction of the viewport height, spheres reaching behind the camera are
+    /// infinitely large
+    auto ScreenSize(const BoundingSphere& sphere, const glm::mat4& view_projection) -> float;
+
+    /// Coarsest level whose projected error stays below the threshold, with hysteresis around the current level
+    auto SelectLOD(std::span<const MeshLOD> lods, float screen_size, std::size_t current, const LODSettings& settings)
+        -> std::size_t;
+
+}  // namespace JE
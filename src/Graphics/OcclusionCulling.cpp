@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "OcclusionCulling.hpp"
+
+#include "Assert.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        constexpr float PIXEL_CENTER = 0.5f;
+        constexpr float CLEAR_DEPTH = 1.0f;
+        /// Vertices closer to the camera plane than this are treated as behind the camera
+        constexpr float MIN_CLIP_W = 1e-5f;
+        /// Boxes are tested against the pyramid level where they cover at most this many texels per side
+        constexpr std::int32_t MAX_TEST_TEXELS = 4;
+        constexpr std::size_t BOX_CORNER_COUNT = 8;
+
+        /// Window coordinates in pixels and depth in [0, 1]
+        auto ToWindow(const glm::vec4& clip, const Size2D& size) -> glm::vec3
+        {
+            const auto NDC = glm::vec3{clip} / clip.w;
+            return {(NDC.x * 0.5f + 0.5f) * static_cast<float>(size.X),
+                    (NDC.y * 0.5f + 0.5f) * static_cast<float>(size.Y),
+                    NDC.z * 0.5f + 0.5f};
+        }
+
+        /// Rejects points behind the camera and in front of the near plane, neither is drawn by the GPU
+        auto Projectable(const glm::vec4& clip) -> bool { return clip.w > MIN_CLIP_W && clip.z >= -clip.w; }
+
+        /// Points close to the camera plane project far outside of the buffer, clamp before converting
+        auto ToPixel(float value, std::int32_t size) -> std::int32_t
+        {
+            return static_cast<std::int32_t>(std::clamp(value, -1.0f, static_cast<float>(size)));
+        }
+
+        auto EdgeFunction(const glm::vec3& from, const glm::vec3& to) -> glm::vec3
+        {
+            return {from.y - to.y, to.x - from.x, from.x * to.y - from.y * to.x};
+        }
+
+        /// Same order of operations as the SIMD path, which adds the per row part last
+        inline auto EvaluatePlane(const glm::vec3& plane, float x, float y) -> float
+        {
+            return plane.x * x + (plane.y * y + plane.z);
+        }
+
+#if JE_SIMD_X86
+        /// Four pixels of a row at a time, rows start at a multiple of OcclusionBuffer::LANE_COUNT
+        template<typename Triangle>
+        void RasterizeRowsSSE(const Triangle& triangle,
+                              std::int32_t min_x,
+                              std::int32_t min_y,
+                              std::int32_t max_x,
+                              std::int32_t max_y,
+                              float* depth,
+                              std::int32_t width)
+        {
+            const __m128 LANE_OFFSETS = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);  // NOLINT(readability-magic-numbers)
+            const __m128 ZERO = _mm_setzero_ps();
+            const __m128 EDGE_0_X = _mm_set1_ps(triangle.Edges[0].x);
+            const __m128 EDGE_1_X = _mm_set1_ps(triangle.Edges[1].x);
+            const __m128 EDGE_2_X = _mm_set1_ps(triangle.Edges[2].x);
+            const __m128 DEPTH_X = _mm_set1_ps(triangle.Depth.x);
+
+            // The y part of the planes only changes per row
+            const auto ROW = [](const glm::vec3& plane, float y) { return _mm_set1_ps(plane.y * y + plane.z); };
+
+            const auto FIRST_X = min_x - min_x % OcclusionBuffer::LANE_COUNT;
+            for (auto y = min_y; y <= max_y; ++y) {
+                const auto PY = static_cast<float>(y) + PIXEL_CENTER;
+                const __m128 EDGE_0_ROW = ROW(triangle.Edges[0], PY);
+                const __m128 EDGE_1_ROW = ROW(triangle.Edges[1], PY);
+                const __m128 EDGE_2_ROW = ROW(triangle.Edges[2], PY);
+                const __m128 DEPTH_ROW = ROW(triangle.Depth, PY);
+                float* row = depth + static_cast<std::ptrdiff_t>(y) * width;  // NOLINT
+
+                for (auto x = FIRST_X; x <= max_x; x += OcclusionBuffer::LANE_COUNT) {
+                    const __m128 PX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), LANE_OFFSETS);
+
+                    __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(EDGE_0_X, PX), EDGE_0_ROW), ZERO);
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(EDGE_1_X, PX), EDGE_1_ROW), ZERO));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(EDGE_2_X, PX), EDGE_2_ROW), ZERO));
+                    if (_mm_movemask_ps(inside) == 0) {
+                        continue;
+                    }
+
+                    const __m128 OLD_DEPTH = _mm_loadu_ps(row + x);  // NOLINT
+                    const __m128 NEW_DEPTH = _mm_min_ps(OLD_DEPTH, _mm_add_ps(_mm_mul_ps(DEPTH_X, PX), DEPTH_ROW));
+                    _mm_storeu_ps(row + x,  // NOLINT
+                                  _mm_or_ps(_mm_and_ps(inside, NEW_DEPTH), _mm_andnot_ps(inside, OLD_DEPTH)));
+                }
+            }
+        }
+#endif
+
+        template<typename Triangle>
+        void RasterizeRowsScalar(const Triangle& triangle,
+                                 std::int32_t min_x,
+                                 std::int32_t min_y,
+                                 std::int32_t max_x,
+                                 std::int32_t max_y,
+                                 float* depth,
+                                 std::int32_t width)
+        {
+            for (auto y = min_y; y <= max_y; ++y) {
+                const auto PY = static_cast<float>(y) + PIXEL_CENTER;
+                float* row = depth + static_cast<std::ptrdiff_t>(y) * width;  // NOLINT
+
+                for (auto x = min_x; x <= max_x; ++x) {
+                    const auto PX = static_cast<float>(x) + PIXEL_CENTER;
+                    const bool INSIDE = EvaluatePlane(triangle.Edges[0], PX, PY) >= 0
+                                        && EvaluatePlane(triangle.Edges[1], PX, PY) >= 0
+                                        && EvaluatePlane(triangle.Edges[2], PX, PY) >= 0;
+                    if (INSIDE) {
+                        row[x] = std::min(row[x], EvaluatePlane(triangle.Depth, PX, PY));  // NOLINT
+                    }
+                }
+            }
+        }
+
+    }  // namespace
+
+    OcclusionBuffer::OcclusionBuffer(const Size2D& size, std::uint32_t worker_count)
+        : m_Size(size)
+        , m_Workers(worker_count)
+        , m_TilesX((size.X + TILE_SIZE - 1) / TILE_SIZE)
+        , m_TilesY((size.Y + TILE_SIZE - 1) / TILE_SIZE)
+    {
+        ASSERT(size.X > 0 && size.Y > 0);
+        ASSERT(size.X % LANE_COUNT == 0);
+
+        m_TileBins.resize(static_cast<std::size_t>(m_TilesX) * static_cast<std::size_t>(m_TilesY));
+
+        auto level_size = size;
+        while (true) {
+            m_LevelSizes.push_back(level_size);
+            m_Levels.emplace_back(static_cast<std::size_t>(level_size.X) * static_cast<std::size_t>(level_size.Y),
+                                  CLEAR_DEPTH);
+            if (level_size.X == 1 && level_size.Y == 1) {
+                break;
+            }
+            level_size = {(level_size.X + 1) / 2, (level_size.Y + 1) / 2};
+        }
+    }
+
+    // cppcheck-suppress unusedFunction
+    void OcclusionBuffer::Begin(const glm::mat4& view_projection)
+    {
+        m_ViewProjection = view_projection;
+        m_Triangles.clear();
+    }
+
+    // cppcheck-suppress unusedFunction
+    void OcclusionBuffer::AddOccluder(std::span<const glm::vec3> vertices, std::span<const std::uint32_t> indices)
+    {
+        ASSERT(indices.size() % EDGE_COUNT == 0);
+
+        for (std::size_t i = 0; i + EDGE_COUNT <= indices.size(); i += EDGE_COUNT) {
+            std::array<glm::vec3, EDGE_COUNT> window{};
+            bool projectable = true;
+            for (std::size_t corner = 0; corner < EDGE_COUNT; ++corner) {
+                ASSERT(indices[i + corner] < vertices.size());
+                const auto CLIP = m_ViewProjection * glm::vec4{vertices[indices[i + corner]], 1.0f};
+                projectable = projectable && Projectable(CLIP);
+                if (projectable) {
+                    window[corner] = ToWindow(CLIP, m_Size);
+                }
+            }
+            // Clipping against the near plane would only add occlusion, skipping the triangle is always safe
+            if (!projectable) {
+                continue;
+            }
+
+            // Occluders are rasterized regardless of their winding
+            auto area = (window[1].x - window[0].x) * (window[2].y - window[0].y)
+                         - (window[1].y - window[0].y) * (window[2].x - window[0].x);
+            if (area < 0) {
+                std::swap(window[1], window[2]);
+                area = -area;
+            }
+            if (area <= 0) {
+                continue;
+            }
+
+            Triangle triangle;
+            const auto MIN_WINDOW = glm::min(glm::min(window[0], window[1]), window[2]);
+            const auto MAX_WINDOW = glm::max(glm::max(window[0], window[1]), window[2]);
+            triangle.MinX = std::max(ToPixel(std::ceil(MIN_WINDOW.x - PIXEL_CENTER), m_Size.X), 0);
+            triangle.MinY = std::max(ToPixel(std::ceil(MIN_WINDOW.y - PIXEL_CENTER), m_Size.Y), 0);
+            triangle.MaxX = std::min(ToPixel(std::floor(MAX_WINDOW.x - PIXEL_CENTER), m_Size.X), m_Size.X - 1);
+            triangle.MaxY = std::min(ToPixel(std::floor(MAX_WINDOW.y - PIXEL_CENTER), m_Size.Y), m_Size.Y - 1);
+            if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY) {
+                continue;
+            }
+
+            // Edge i is opposite to corner i, its value divided by the area is the barycentric weight of the corner
+            triangle.Edges = {EdgeFunction(window[1], window[2]),
+                              EdgeFunction(window[2], window[0]),
+                              EdgeFunction(window[0], window[1])};
+            const auto DEPTH_1 = (window[1].z - window[0].z) / area;
+            const auto DEPTH_2 = (window[2].z - window[0].z) / area;
+            triangle.Depth = triangle.Edges[1] * DEPTH_1 + triangle.Edges[2] * DEPTH_2;
+            triangle.Depth.z += window[0].z;
+
+            m_Triangles.push_back(triangle);
+        }
+    }
+
+    // cppcheck-suppress unusedFunction
+    void OcclusionBuffer::Rasterize(SIMDLevel level)
+    {
+        std::fill(m_Levels.front().begin(), m_Levels.front().end(), CLEAR_DEPTH);
+
+        BinTriangles();
+        // Tiles don't share pixels, every worker writes its own part of the depth buffer
+        m_Workers.ParallelFor(m_TileBins.size(), [this, level](std::size_t tile) { RasterizeTile(tile, level); });
+
+        BuildPyramid();
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto OcclusionBuffer::TestAABB(const AABB& box) const -> bool
+    {
+        glm::vec2 window_min{std::numeric_limits<float>::max()};
+        glm::vec2 window_max{std::numeric_limits<float>::lowest()};
+        float nearest_depth = std::numeric_limits<float>::max();
+
+        for (std::size_t corner = 0; corner < BOX_CORNER_COUNT; ++corner) {
+            const glm::vec3 POSITION{(corner & 1U) != 0 ? box.Max.x : box.Min.x,
+                                     (corner & 2U) != 0 ? box.Max.y : box.Min.y,
+                                     (corner & 4U) != 0 ? box.Max.z : box.Min.z};
+            const auto CLIP = m_ViewProjection * glm::vec4{POSITION, 1.0f};
+            // The box reaches past the near plane, it's either visible or already culled by the frustum
+            if (!Projectable(CLIP)) {
+                return true;
+            }
+
+            const auto WINDOW = ToWindow(CLIP, m_Size);
+            window_min = glm::min(window_min, glm::vec2{WINDOW});
+            window_max = glm::max(window_max, glm::vec2{WINDOW});
+            nearest_depth = std::min(nearest_depth, WINDOW.z);
+        }
+
+        const auto MIN_X = std::max(ToPixel(std::floor(window_min.x), m_Size.X), 0);
+        const auto MIN_Y = std::max(ToPixel(std::floor(window_min.y), m_Size.Y), 0);
+        const auto MAX_X = std::min(ToPixel(std::ceil(window_max.x), m_Size.X) - 1, m_Size.X - 1);
+        const auto MAX_Y = std::min(ToPixel(std::ceil(window_max.y), m_Size.Y) - 1, m_Size.Y - 1);
+        // Nothing is known about boxes outside of the buffer, the frustum decides about them
+        if (MIN_X > MAX_X || MIN_Y > MAX_Y) {
+            return true;
+        }
+
+        std::size_t level = 0;
+        while (level + 1 < m_Levels.size()
+               && std::max((MAX_X >> level) - (MIN_X >> level), (MAX_Y >> level) - (MIN_Y >> level))
+                      >= MAX_TEST_TEXELS) {
+            ++level;
+        }
+
+        const auto& depth = m_Levels[level];
+        const auto WIDTH = static_cast<std::size_t>(m_LevelSizes[level].X);
+        for (auto y = MIN_Y >> level; y <= MAX_Y >> level; ++y) {
+            for (auto x = MIN_X >> level; x <= MAX_X >> level; ++x) {
+                if (depth[static_cast<std::size_t>(y) * WIDTH + static_cast<std::size_t>(x)] >= nearest_depth) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void OcclusionBuffer::BinTriangles()
+    {
+        for (auto& bin : m_TileBins) {
+            bin.clear();
+        }
+
+        for (std::size_t i = 0; i < m_Triangles.size(); ++i) {
+            const auto& triangle = m_Triangles[i];
+            for (auto tile_y = triangle.MinY / TILE_SIZE; tile_y <= triangle.MaxY / TILE_SIZE; ++tile_y) {
+                for (auto tile_x = triangle.MinX / TILE_SIZE; tile_x <= triangle.MaxX / TILE_SIZE; ++tile_x) {
+                    m_TileBins[static_cast<std::size_t>(tile_y * m_TilesX + tile_x)].push_back(
+                        static_cast<std::uint32_t>(i));
+                }
+            }
+        }
+    }
+
+    void OcclusionBuffer::RasterizeTile(std::size_t tile, SIMDLevel level)
+    {
+        const auto TILE_X = static_cast<std::int32_t>(tile) % m_TilesX * TILE_SIZE;
+        const auto TILE_Y = static_cast<std::int32_t>(tile) / m_TilesX * TILE_SIZE;
+        const auto TILE_MAX_X = std::min(TILE_X + TILE_SIZE, m_Size.X) - 1;
+        const auto TILE_MAX_Y = std::min(TILE_Y + TILE_SIZE, m_Size.Y) - 1;
+        float* depth = m_Levels.front().data();
+
+        for (const auto INDEX : m_TileBins[tile]) {
+            const auto& triangle = m_Triangles[INDEX];
+            const auto MIN_X = std::max(triangle.MinX, TILE_X);
+            const auto MIN_Y = std::max(triangle.MinY, TILE_Y);
+            const auto MAX_X = std::min(triangle.MaxX, TILE_MAX_X);
+            const auto MAX_Y = std::min(triangle.MaxY, TILE_MAX_Y);
+
+#if JE_SIMD_X86
+            // Tiles start at a multiple of the lane count, aligning the rows down never leaves the tile
+            if (level != SIMDLevel::SCALAR) {
+                RasterizeRowsSSE(triangle, MIN_X, MIN_Y, MAX_X, MAX_Y, depth, m_Size.X);
+                continue;
+            }
+#else
+            static_cast<void>(level);
+#endif
+            RasterizeRowsScalar(triangle, MIN_X, MIN_Y, MAX_X, MAX_Y, depth, m_Size.X);
+        }
+    }
+
+    void OcclusionBuffer::BuildPyramid()
+    {
+        for (std::size_t level = 1; level < m_Levels.size(); ++level) {
+            const auto& source = m_Levels[level - 1];
+            const auto& source_size = m_LevelSizes[level - 1];
+            auto& destination = m_Levels[level];
+            const auto& size = m_LevelSizes[level];
+
+            const auto SOURCE = [&source, &source_size](std::int32_t x, std::int32_t y)
+            {
+                x = std::min(x, source_size.X - 1);
+                y = std::min(y, source_size.Y - 1);
+                return source[static_cast<std::size_t>(y * source_size.X + x)];
+            };
+
+            for (std::int32_t y = 0; y < size.Y; ++y) {
+                for (std::int32_t x = 0; x < size.X; ++x) {
+                    destination[static_cast<std::size_t>(y * size.X + x)] = std::max({SOURCE(x * 2, y * 2),
+                                                                                      SOURCE(x * 2 + 1, y * 2),
+                                                                                      SOURCE(x * 2, y * 2 + 1),
+                                                                                      SOURCE(x * 2 + 1, y * 2 + 1)});
+                }
+            }
+        }
+    }
+
+}  // namespace JE
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "Culling.hpp"
+#include "Memory.hpp"
+#include "Parallel.hpp"
+#include "SIMD.hpp"
+#include "Types.hpp"
+
+namespace JE
+{
+
+    /// Low resolution depth-only software rasterizer, a handful of large occluders (walls, terrain, buildings) are
+    /// rendered on the CPU and bounding boxes are tested against the max depth pyramid built from them, boxes that
+    /// are completely behind the occluders can be skipped before they're submitted to the GPU
+    class OcclusionBuffer
+    {
+      public:
+        static constexpr Size2D DEFAULT_SIZE{256, 128};
+        static constexpr std::int32_t TILE_SIZE = 32;
+        /// Width has to be a multiple of this so rows can be rasterized a SIMD register at a time
+        static constexpr std::int32_t LANE_COUNT = 4;
+
+        explicit OcclusionBuffer(const Size2D& size = DEFAULT_SIZE, std::uint32_t worker_count = 0);
+
+        /// Removes the occluders of the last frame, occluders and boxes are projected with the view projection
+        void Begin(const glm::mat4& view_projection);
+
+        /// Triangles that are (partially) behind the camera or in front of the near plane are skipped
+        void AddOccluder(std::span<const glm::vec3> vertices, std::span<const std::uint32_t> indices);
+
+        /// Bins the occluder triangles into tiles, rasterizes the tiles in parallel and builds the depth pyramid
+        void Rasterize(SIMDLevel level = HostSIMDLevel());
+
+        /// Conservative, boxes that can't be projected safely are always visible
+        /// \returns false if the box is completely behind the rasterized occluders
+        auto TestAABB(const AABB& box) const -> bool;
+
+        inline auto Size() const -> const Size2D& { return m_Size; }
+        inline auto TriangleCount() const -> std::size_t { return m_Triangles.size(); }
+
+        /// Nearest occluder depth of every pixel in [0, 1], 1 where no occluder was rasterized
+        inline auto Depth() const -> std::span<const float> { return m_Levels.front(); }
+        inline auto LevelCount() const -> std::size_t { return m_Levels.size(); }
+        /// Farthest depth of the pixels every texel covers, level 0 is Depth()
+        inline auto Level(std::size_t level) const -> std::span<const float> { return m_Levels[level]; }
+        inline auto LevelSize(std::size_t level) const -> const Size2D& { return m_LevelSizes[level]; }
+
+      private:
+        static constexpr std::size_t EDGE_COUNT = 3;
+
+        /// Edge functions and depth as planes over the screen (a * x + b * y + c), a pixel is inside if all edge
+        /// functions are positive at its center
+        struct Triangle
+        {
+            std::array<glm::vec3, EDGE_COUNT> Edges;
+            glm::vec3 Depth{0};
+            std::int32_t MinX = 0;
+            std::int32_t MinY = 0;
+            std::int32_t MaxX = 0;
+            std::int32_t MaxY = 0;
+        };
+
+        void BinTriangles();
+        void RasterizeTile(std::size_t tile, SIMDLevel level);
+        void BuildPyramid();
+
+        Size2D m_Size;
+        WorkerPool m_Workers;
+        glm::mat4 m_ViewProjection{1.0f};
+
+        Vector<Triangle> m_Triangles;
+        std::int32_t m_TilesX = 0;
+        std::int32_t m_TilesY = 0;
+        Vector<Vector<std::uint32_t>> m_TileBins;
+
+        Vector<Vector<float>> m_Levels;
+        Vector<Size2D> m_LevelSizes;
+    };
+
+}  // namespace JE
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <bit>
+
+#include "OffsetAllocator.hpp"
+
+#include "Assert.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        constexpr std::uint32_t MANTISSA_BITS = 3;
+        constexpr std::uint32_t MANTISSA_VALUE = 1U << MANTISSA_BITS;
+        constexpr std::uint32_t MANTISSA_MASK = MANTISSA_VALUE - 1;
+        constexpr std::uint32_t MASK_BITS = 32;
+
+        constexpr auto HighestSetBit(std::uint32_t mask) -> std::uint32_t
+        {
+            return MASK_BITS - 1 - static_cast<std::uint32_t>(std::countl_zero(mask));
+        }
+
+        /// Bin of a free region, every region in a bin is at least as large as the bin's size
+        constexpr auto BinRoundDown(std::uint32_t size) -> std::uint32_t
+        {
+            // Sizes below the mantissa get a bin each, like denormals
+            if (size < MANTISSA_VALUE) {
+                return size;
+            }
+
+            const auto MANTISSA_START = HighestSetBit(size) - MANTISSA_BITS;
+            const auto EXPONENT = MANTISSA_START + 1;
+            const auto MANTISSA = (size >> MANTISSA_START) & MANTISSA_MASK;
+            return (EXPONENT << MANTISSA_BITS) | MANTISSA;
+        }
+
+        /// Smallest bin whose regions all fit size, a mantissa overflow carries into the exponent
+        constexpr auto BinRoundUp(std::uint32_t size) -> std::uint32_t
+        {
+            if (size < MANTISSA_VALUE) {
+                return size;
+            }
+
+            const auto MANTISSA_START = HighestSetBit(size) - MANTISSA_BITS;
+            const auto LOW_BITS = size & ((1U << MANTISSA_START) - 1);
+            return BinRoundDown(size) + (LOW_BITS != 0 ? 1 : 0);
+        }
+
+        constexpr auto LowestSetBitFrom(std::uint32_t mask, std::uint32_t first_bit) -> std::uint32_t
+        {
+            if (first_bit >= MASK_BITS) {
+                return OffsetAllocator::NO_SPACE;
+            }
+
+            const auto MASKED = mask & ~((1U << first_bit) - 1);
+            return MASKED == 0 ? OffsetAllocator::NO_SPACE : static_cast<std::uint32_t>(std::countr_zero(MASKED));
+        }
+
+        static_assert(BinRoundDown(7) == 7 && BinRoundUp(7) == 7);
+        static_assert(BinRoundDown(17) == 16 && BinRoundUp(17) == 17);
+        static_assert(BinRoundUp(std::numeric_limits<std::uint32_t>::max()) < MASK_BITS * MANTISSA_VALUE);
+
+    }  // namespace
+
+    OffsetAllocator::OffsetAllocator(std::uint32_t size, std::uint32_t max_allocations)
+        : m_Size(size)
+        , m_MaxAllocations(max_allocations)
+        // Free regions never touch, so there is at most one more of them than there are allocations
+        , m_Nodes(std::size_t{max_allocations} * 2 + 1)
+    {
+        ASSERT(max_allocations > 0);
+
+        Reset();
+    }
+
+    auto OffsetAllocator::Allocate(std::uint32_t size) -> Allocation
+    {
+        ASSERT(size > 0);
+
+        if (m_AllocationCount == m_MaxAllocations) {
+            return {};
+        }
+
+        // A bin holds regions from its size up to the next bin's size, only bins past the rounded up one fit for sure
+        const auto MIN_BIN = BinRoundUp(size);
+        const auto MIN_TOP_BIN = MIN_BIN >> MANTISSA_BITS;
+
+        auto top_bin = MIN_TOP_BIN;
+        auto leaf_bin = NO_SPACE;
+        if ((m_UsedTopBins & (1U << MIN_TOP_BIN)) != 0) {
+            leaf_bin = LowestSetBitFrom(m_UsedLeafBins[MIN_TOP_BIN], MIN_BIN & MANTISSA_MASK);
+        }
+        if (leaf_bin == NO_SPACE) {
+            top_bin = LowestSetBitFrom(m_UsedTopBins, MIN_TOP_BIN + 1);
+        }
+        if (leaf_bin == NO_SPACE && top_bin != NO_SPACE) {
+            leaf_bin = static_cast<std::uint32_t>(std::countr_zero(m_UsedLeafBins[top_bin]));
+        }
+
+        auto index = INVALID_NODE;
+        if (leaf_bin != NO_SPACE) {
+            index = m_BinHeads[(top_bin << MANTISSA_BITS) | leaf_bin];
+        } else {
+            // Nothing larger is free, the bin size rounds down to might still hold a region that fits, e.g. the
+            // whole range of a fresh allocator
+            for (auto candidate = m_BinHeads[BinRoundDown(size)]; candidate != INVALID_NODE;
+                 candidate = m_Nodes[candidate].BinNext) {
+                if (m_Nodes[candidate].Size >= size) {
+                    index = candidate;
+                    break;
+                }
+            }
+            if (index == INVALID_NODE) {
+                return {};
+            }
+        }
+
+        const auto INDEX = index;
+        auto& node = m_Nodes[INDEX];
+        const auto REGION_SIZE = node.Size;
+        RemoveFreeNode(INDEX);
+        node.Size = size;
+        node.Used = true;
+        ++m_AllocationCount;
+
+        if (REGION_SIZE > size) {
+            const auto REST = InsertFreeNode(node.Offset + size, REGION_SIZE - size);
+            m_Nodes[REST].NeighborPrevious = INDEX;
+            m_Nodes[REST].NeighborNext = node.NeighborNext;
+            if (node.NeighborNext != INVALID_NODE) {
+                m_Nodes[node.NeighborNext].NeighborPrevious = REST;
+            }
+            node.NeighborNext = REST;
+        }
+
+        return {node.Offset, INDEX};
+    }
+
+    void OffsetAllocator::Free(const Allocation& allocation)
+    {
+        ASSERT(allocation.Valid() && m_Nodes[allocation.Node].Used);
+
+        const auto& node = m_Nodes[allocation.Node];
+        auto offset = node.Offset;
+        auto size = node.Size;
+        auto previous = node.NeighborPrevious;
+        auto next = node.NeighborNext;
+
+        if (previous != INVALID_NODE && !m_Nodes[previous].Used) {
+            const auto MERGED = previous;
+            offset = m_Nodes[MERGED].Offset;
+            size += m_Nodes[MERGED].Size;
+            previous = m_Nodes[MERGED].NeighborPrevious;
+            RemoveFreeNode(MERGED);
+            m_UnusedNodes.push_back(MERGED);
+        }
+        if (next != INVALID_NODE && !m_Nodes[next].Used) {
+            const auto MERGED = next;
+            size += m_Nodes[MERGED].Size;
+            next = m_Nodes[MERGED].NeighborNext;
+            RemoveFreeNode(MERGED);
+            m_UnusedNodes.push_back(MERGED);
+        }
+
+        m_Nodes[allocation.Node] = {};
+        m_UnusedNodes.push_back(allocation.Node);
+        --m_AllocationCount;
+
+        const auto REGION = InsertFreeNode(offset, size);
+        m_Nodes[REGION].NeighborPrevious = previous;
+        m_Nodes[REGION].NeighborNext = next;
+        if (previous != INVALID_NODE) {
+            m_Nodes[previous].NeighborNext = REGION;
+        }
+        if (next != INVALID_NODE) {
+            m_Nodes[next].NeighborPrevious = REGION;
+        }
+    }
+
+    void OffsetAllocator::Reset()
+    {
+        m_FreeSpace = 0;
+        m_AllocationCount = 0;
+        m_UsedTopBins = 0;
+        m_UsedLeafBins.fill(0);
+        m_BinHeads.fill(INVALID_NODE);
+
+        std::ranges::fill(m_Nodes, Node{});
+        m_UnusedNodes.resize(m_Nodes.size());
+        for (std::size_t i = 0; i < m_UnusedNodes.size(); ++i) {
+            m_UnusedNodes[i] = static_cast<NodeIndex>(m_UnusedNodes.size() - 1 - i);
+        }
+
+        if (m_Size > 0) {
+            InsertFreeNode(0, m_Size);
+        }
+    }
+
+    auto OffsetAllocator::LargestFreeRegion() const -> std::uint32_t
+    {
+        if (m_UsedTopBins == 0) {
+            return 0;
+        }
+
+        // The largest region is in the largest bin, which also holds smaller ones
+        const auto TOP_BIN = HighestSetBit(m_UsedTopBins);
+        const auto LEAF_BIN = HighestSetBit(m_UsedLeafBins[TOP_BIN]);
+
+        std::uint32_t largest = 0;
+        for (auto index = m_BinHeads[(TOP_BIN << MANTISSA_BITS) | LEAF_BIN]; index != INVALID_NODE;
+             index = m_Nodes[index].BinNext) {
+            largest = std::max(largest, m_Nodes[index].Size);
+        }
+        return largest;
+    }
+
+    auto OffsetAllocator::AllocationSize(const Allocation& allocation) const -> std::uint32_t
+    {
+        ASSERT(allocation.Valid() && m_Nodes[allocation.Node].Used);
+
+        return m_Nodes[allocation.Node].Size;
+    }
+
+    auto OffsetAllocator::InsertFreeNode(std::uint32_t offset, std::uint32_t size) -> NodeIndex
+    {
+        ASSERT(!m_UnusedNodes.empty());
+
+        const auto BIN = BinRoundDown(size);
+        const auto TOP_BIN = BIN >> MANTISSA_BITS;
+        const auto LEAF_BIN = BIN & MANTISSA_MASK;
+
+        if (m_BinHeads[BIN] == INVALID_NODE) {
+            m_UsedLeafBins[TOP_BIN] = static_cast<std::uint8_t>(m_UsedLeafBins[TOP_BIN] | (1U << LEAF_BIN));
+            m_UsedTopBins |= 1U << TOP_BIN;
+        }
+
+        const auto INDEX = m_UnusedNodes.back();
+        m_UnusedNodes.pop_back();
+
+        auto& node = m_Nodes[INDEX];
+        node = {};
+        node.Offset = offset;
+        node.Size = size;
+        node.BinNext = m_BinHeads[BIN];
+        if (node.BinNext != INVALID_NODE) {
+            m_Nodes[node.BinNext].BinPrevious = INDEX;
+        }
+        m_BinHeads[BIN] = INDEX;
+
+        m_FreeSpace += size;
+        return INDEX;
+    }
+
+    void OffsetAllocator::RemoveFreeNode(NodeIndex index)
+    {
+        auto& node = m_Nodes[index];
+        ASSERT(!node.Used);
+
+        if (node.BinPrevious != INVALID_NODE) {
+            m_Nodes[node.BinPrevious].BinNext = node.BinNext;
+        } else {
+            const auto BIN = BinRoundDown(node.Size);
+            m_BinHeads[BIN] = node.BinNext;
+
+            if (m_BinHeads[BIN] == INVALID_NODE) {
+                const auto TOP_BIN = BIN >> MANTISSA_BITS;
+                const auto LEAF_BIN = BIN & MANTISSA_MASK;
+                m_UsedLeafBins[TOP_BIN] = static_cast<std::uint8_t>(m_UsedLeafBins[TOP_BIN] & ~(1U << LEAF_BIN));
+                if (m_UsedLeafBins[TOP_BIN] == 0) {
+                    m_UsedTopBins &= ~(1U << TOP_BIN);
+                }
+            }
+        }
+        if (node.BinNext != INVALID_NODE) {
+            m_Nodes[node.BinNext].BinPrevious = node.BinPrevious;
+        }
+        node.BinPrevious = INVALID_NODE;
+        node.BinNext = INVALID_NODE;
+
+        m_FreeSpace -= node.Size;
+    }
+
+}  // namespace JE
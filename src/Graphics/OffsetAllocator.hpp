@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include "Memory.hpp"
+
+namespace JE
+{
+
+    /// TLSF style allocator of offsets into a range, e.g. elements of a GPU buffer. Free regions are kept in bins
+    /// of a small float (3 mantissa bits) so Allocate and Free find and coalesce regions in constant time, two levels
+    /// of bitmasks point to the bins that aren't empty. Allocations are split to their exact size, the bin a request
+    /// rounds down to is only searched when no larger bin has a region
+    class OffsetAllocator
+    {
+      public:
+        using NodeIndex = std::uint32_t;
+
+        static constexpr std::uint32_t NO_SPACE = std::numeric_limits<std::uint32_t>::max();
+        static constexpr NodeIndex INVALID_NODE = std::numeric_limits<NodeIndex>::max();
+        static constexpr std::uint32_t DEFAULT_MAX_ALLOCATIONS = 64 * 1024;
+
+        struct Allocation
+        {
+            std::uint32_t Offset = NO_SPACE;
+            NodeIndex Node = INVALID_NODE;
+
+            inline auto Valid() const -> bool { return Offset != NO_SPACE; }
+        };
+
+        explicit OffsetAllocator(std::uint32_t size, std::uint32_t max_allocations = DEFAULT_MAX_ALLOCATIONS);
+
+        /// \returns an invalid allocation if no free region fits size or all nodes are in use
+        auto Allocate(std::uint32_t size) -> Allocation;
+        /// Merges the region with its free neighbours
+        void Free(const Allocation& allocation);
+        /// Frees every allocation at once
+        void Reset();
+
+        inline auto Size() const -> std::uint32_t { return m_Size; }
+        inline auto FreeSpace() const -> std::uint32_t { return m_FreeSpace; }
+        /// Largest size Allocate can succeed with, less than FreeSpace once the free space is fragmented
+        auto LargestFreeRegion() const -> std::uint32_t;
+        auto AllocationSize(const Allocation& allocation) const -> std::uint32_t;
+
+      private:
+        static constexpr std::uint32_t TOP_BIN_COUNT = 32;
+        static constexpr std::uint32_t BINS_PER_LEAF = 8;
+        static constexpr std::uint32_t LEAF_BIN_COUNT = TOP_BIN_COUNT * BINS_PER_LEAF;
+
+        struct Node
+        {
+            std::uint32_t Offset = 0;
+            std::uint32_t Size = 0;
+            NodeIndex BinPrevious = INVALID_NODE;
+            NodeIndex BinNext = INVALID_NODE;
+            NodeIndex NeighborPrevious = INVALID_NODE;
+            NodeIndex NeighborNext = INVALID_NODE;
+            bool Used = false;
+        };
+
+        auto InsertFreeNode(std::uint32_t offset, std::uint32_t size) -> NodeIndex;
+        void RemoveFreeNode(NodeIndex index);
+
+        std::uint32_t m_Size;
+        std::uint32_t m_MaxAllocations;
+        std::uint32_t m_AllocationCount = 0;
+        std::uint32_t m_FreeSpace = 0;
+
+        std::uint32_t m_UsedTopBins = 0;
+        std::array<std::uint8_t, TOP_BIN_COUNT> m_UsedLeafBins{};
+        std::array<NodeIndex, LEAF_BIN_COUNT> m_BinHeads{};
+
+        Vector<Node> m_Nodes;
+        /// Stack of the nodes neither used nor holding a free region
+        Vector<NodeIndex> m_UnusedNodes;
+    };
+
+}  // namespace JE
@@ -0,0 +1,166 @@
+#include <array>
+
+#include "OpenGLObjectPool.hpp"
+
+#include <glad/gl.h>
+
+#include "Assert.hpp"
+
+namespace JE
+{
+
+    OpenGLObjectPool::OpenGLObjectPool(std::uint32_t frame_lag, std::size_t max_free_names)
+        : m_FrameLag(frame_lag)
+        , m_MaxFreeNames(max_free_names)
+    {
+    }
+
+    auto OpenGLObjectPool::CreateBuffer() -> IRendererAPI::BufferID
+    {
+        if (m_FreeBuffers.empty()) {
+            std::array<std::uint32_t, NAME_BATCH_SIZE> names{};
+            GenerateNames(ObjectType::BUFFER, names);
+            // The first generated name is handed out first
+            m_FreeBuffers.insert(m_FreeBuffers.end(), names.rbegin(), names.rend());
+            m_Statistics.GeneratedBuffers += names.size();
+        }
+
+        const auto BUFFER = m_FreeBuffers.back();
+        m_FreeBuffers.pop_back();
+        return BUFFER;
+    }
+
+    auto OpenGLObjectPool::CreateVertexArray() -> IRendererAPI::BufferID
+    {
+        if (m_FreeVertexArrays.empty()) {
+            std::array<std::uint32_t, NAME_BATCH_SIZE> names{};
+            GenerateNames(ObjectType::VERTEX_ARRAY, names);
+            m_FreeVertexArrays.insert(m_FreeVertexArrays.end(), names.rbegin(), names.rend());
+            m_Statistics.GeneratedVertexArrays += names.size();
+        }
+
+        const auto VERTEX_ARRAY = m_FreeVertexArrays.back();
+        m_FreeVertexArrays.pop_back();
+        return VERTEX_ARRAY;
+    }
+
+    void OpenGLObjectPool::DestroyBuffer(IRendererAPI::BufferID buffer)
+    {
+        ASSERT(buffer != 0);
+
+        m_Pending.push_back({ObjectType::BUFFER, buffer, 0, m_Frame});
+    }
+
+    void OpenGLObjectPool::DestroyVertexArray(IRendererAPI::BufferID vertex_array, std::uint32_t attribute_count)
+    {
+        ASSERT(vertex_array != 0);
+
+        m_Pending.push_back({ObjectType::VERTEX_ARRAY, vertex_array, attribute_count, m_Frame});
+    }
+
+    void OpenGLObjectPool::DestroyProgram(IRendererAPI::ProgramID program)
+    {
+        ASSERT(program != 0);
+
+        m_Pending.push_back({ObjectType::PROGRAM, program, 0, m_Frame});
+    }
+
+    void OpenGLObjectPool::EndFrame()
+    {
+        ++m_Frame;
+
+        bool released = false;
+        while (!m_Pending.empty() && m_Pending.front().Frame + m_FrameLag <= m_Frame) {
+            Release(m_Pending.front());
+            m_Pending.pop_front();
+            released = true;
+        }
+
+        if (released) {
+            TrimFreeNames();
+        }
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto OpenGLObjectPool::Statistics() const -> OpenGLObjectPoolStatistics
+    {
+        auto statistics = m_Statistics;
+        statistics.PendingDeletions = m_Pending.size();
+        return statistics;
+    }
+
+    void OpenGLObjectPool::Release(const PendingDeletion& deletion)
+    {
+        ReleaseObject(deletion.Type, deletion.Name, deletion.AttributeCount);
+
+        switch (deletion.Type) {
+            case ObjectType::BUFFER:
+                m_FreeBuffers.push_back(deletion.Name);
+                ++m_Statistics.RecycledBuffers;
+                break;
+            case ObjectType::VERTEX_ARRAY:
+                m_FreeVertexArrays.push_back(deletion.Name);
+                ++m_Statistics.RecycledVertexArrays;
+                break;
+            default:
+                break;
+        }
+    }
+
+    void OpenGLObjectPool::TrimFreeNames()
+    {
+        if (m_FreeBuffers.size() > m_MaxFreeNames) {
+            DeleteNames(ObjectType::BUFFER, std::span{m_FreeBuffers}.subspan(m_MaxFreeNames));
+            m_FreeBuffers.resize(m_MaxFreeNames);
+        }
+        if (m_FreeVertexArrays.size() > m_MaxFreeNames) {
+            DeleteNames(ObjectType::VERTEX_ARRAY, std::span{m_FreeVertexArrays}.subspan(m_MaxFreeNames));
+            m_FreeVertexArrays.resize(m_MaxFreeNames);
+        }
+    }
+
+    void OpenGLObjectPool::GenerateNames(ObjectType type, std::span<std::uint32_t> names)
+    {
+        if (type == ObjectType::BUFFER) {
+            glGenBuffers(static_cast<GLsizei>(names.size()), names.data());
+        } else if (type == ObjectType::VERTEX_ARRAY) {
+            glGenVertexArrays(static_cast<GLsizei>(names.size()), names.data());
+        }
+    }
+
+    void OpenGLObjectPool::ReleaseObject(ObjectType type, std::uint32_t name, std::uint32_t attribute_count)
+    {
+        switch (type) {
+            case ObjectType::BUFFER:
+                // Orphaning frees the storage right away, a reused name starts out like a newly generated one.
+                // The copy target leaves the array and element buffer bindings alone
+                glBindBuffer(GL_COPY_WRITE_BUFFER, name);
+                glBufferData(GL_COPY_WRITE_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                break;
+            case ObjectType::VERTEX_ARRAY:
+                // Build only enables the attributes of the new buffers, stale ones would read from released buffers
+                glBindVertexArray(name);
+                for (GLuint location = 0; location < attribute_count; ++location) {
+                    glDisableVertexAttribArray(location);
+                }
+                glBindVertexArray(0);
+                break;
+            case ObjectType::PROGRAM:
+                glDeleteProgram(name);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void OpenGLObjectPool::DeleteNames(ObjectType type, std::span<const std::uint32_t> names)
+    {
+        if (type == ObjectType::BUFFER) {
+            glDeleteBuffers(static_cast<GLsizei>(names.size()), names.data());
+        } else if (type == ObjectType::VERTEX_ARRAY) {
+            glDeleteVertexArrays(static_cast<GLsizei>(names.size()), names.data());
+        }
+    }
+
+}  // namespace JE
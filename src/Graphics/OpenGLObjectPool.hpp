@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+
+#include "FramePacer.hpp"
+#include "Graphics/IRendererAPI.hpp"
+#include "Memory.hpp"
+
+namespace JE
+{
+
+    struct OpenGLObjectPoolStatistics
+    {
+        /// Names returned by glGen* calls, NAME_BATCH_SIZE per call
+        std::size_t GeneratedBuffers = 0;
+        std::size_t GeneratedVertexArrays = 0;
+        /// Names of destroyed objects put back to be handed out again
+        std::size_t RecycledBuffers = 0;
+        std::size_t RecycledVertexArrays = 0;
+        std::size_t PendingDeletions = 0;
+    };
+
+    /// Defers releasing destroyed GL objects until the frames that may still use them have ended and recycles the
+    /// names of buffers and vertex arrays. Streaming content creates and destroys thousands of objects per second,
+    /// deleting objects the GPU still reads from can make the driver synchronize mid-frame.
+    /// Nothing is deleted on destruction, the pool outlives the GL context and the context frees its objects itself.
+    /// The GL calls are virtual so the bookkeeping can be tested without a context
+    class OpenGLObjectPool
+    {
+      public:
+        /// Objects may still be used by every frame the CPU is allowed to run ahead
+        static constexpr std::uint32_t DEFAULT_FRAME_LAG = FramePacer::MAX_FRAMES_IN_FLIGHT_LIMIT;
+        static constexpr std::size_t NAME_BATCH_SIZE = 32;
+        static constexpr std::size_t DEFAULT_MAX_FREE_NAMES = 1024;
+
+        OpenGLObjectPool(const OpenGLObjectPool& other) = delete;
+        OpenGLObjectPool(OpenGLObjectPool&& other) = delete;
+        auto operator=(const OpenGLObjectPool& other) -> OpenGLObjectPool& = delete;
+        auto operator=(OpenGLObjectPool&& other) -> OpenGLObjectPool& = delete;
+
+        explicit OpenGLObjectPool(std::uint32_t frame_lag = DEFAULT_FRAME_LAG,
+                                  std::size_t max_free_names = DEFAULT_MAX_FREE_NAMES);
+        virtual ~OpenGLObjectPool() = default;
+
+        auto CreateBuffer() -> IRendererAPI::BufferID;
+        auto CreateVertexArray() -> IRendererAPI::BufferID;
+
+        /// The storage of the buffer is orphaned once its frames ended, the name is reused afterwards
+        void DestroyBuffer(IRendererAPI::BufferID buffer);
+        /// attribute_count attribute locations starting at 0 were enabled, they are disabled before the name is reused
+        void DestroyVertexArray(IRendererAPI::BufferID vertex_array, std::uint32_t attribute_count);
+        void DestroyProgram(IRendererAPI::ProgramID program);
+
+        /// Releases the objects destroyed frame lag frames ago, has to be called once per frame
+        void EndFrame();
+
+        inline auto FrameLag() const -> std::uint32_t { return m_FrameLag; }
+        auto Statistics() const -> OpenGLObjectPoolStatistics;
+
+      protected:
+        enum class ObjectType
+        {
+            BUFFER,
+            VERTEX_ARRAY,
+            PROGRAM
+        };
+
+        virtual void GenerateNames(ObjectType type, std::span<std::uint32_t> names);
+        /// Programs are deleted, buffers and vertex arrays are reset to the state of a newly generated name
+        virtual void ReleaseObject(ObjectType type, std::uint32_t name, std::uint32_t attribute_count);
+        virtual void DeleteNames(ObjectType type, std::span<const std::uint32_t> names);
+
+      private:
+
+        struct PendingDeletion
+        {
+            ObjectType Type = ObjectType::BUFFER;
+            std::uint32_t Name = 0;
+            std::uint32_t AttributeCount = 0;
+            std::uint64_t Frame = 0;
+        };
+
+        void Release(const PendingDeletion& deletion);
+        /// Deletes the names past max free names in one call per type
+        void TrimFreeNames();
+
+        std::uint32_t m_FrameLag;
+        std::size_t m_MaxFreeNames;
+        std::uint64_t m_Frame = 0;
+
+        /// Ordered by frame, the oldest deletions are released first
+        std::deque<PendingDeletion> m_Pending;
+        Vector<IRendererAPI::BufferID> m_FreeBuffers;
+        Vector<IRendererAPI::BufferID> m_FreeVertexArrays;
+
+        OpenGLObjectPoolStatistics m_Statistics;
+    };
+
+}  // namespace JE
@@ -1,4 +1,7 @@
+#pragma once
 
+#include <algorithm>
+#include <array>
 #include <optional>
 
 #include <glad/gl.h>
@@ -6,6 +9,7 @@
 #include "Assert.hpp"
 #include "IRendererAPI.hpp"
 #include "Logger.hpp"
+#include "OpenGLObjectPool.hpp"
 #include "Renderer.hpp"
 
 namespace JE
@@ -33,10 +37,11 @@ namespace JE
         auto operator=(const OpenGLVertexBuffer& other) -> OpenGLVertexBuffer& = delete;
         auto operator=(OpenGLVertexBuffer&& other) -> OpenGLVertexBuffer& = delete;
 
-        explicit OpenGLVertexBuffer(AttributeLayout layout)
+        OpenGLVertexBuffer(AttributeLayout layout, OpenGLObjectPool& objects)
             : IVertexBuffer(std::move(layout))
+            , m_Objects(objects)
         {
-            glGenBuffers(1, &m_BufferID);
+            m_BufferID = m_Objects.CreateBuffer();
             ASSERT(m_BufferID != 0);
         }
         ~OpenGLVertexBuffer() override
@@ -44,7 +49,7 @@ namespace JE
             if (m_BufferID == 0) {
                 return;
             }
-            glDeleteBuffers(1, &m_BufferID);
+            m_Objects.DestroyBuffer(m_BufferID);
         }
 
         inline auto Bind() -> bool override
@@ -81,17 +86,72 @@ namespace JE
         {
             ASSERT(sCurrentBoundBufferID == m_BufferID);
 
-            if (m_BufferID == 0) {
+            if (m_BufferID == 0 || !m_Resource.Allocate(DATA.size())) {
                 return false;
             }
 
             glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(DATA.size()), DATA.data(), GL_STATIC_DRAW);
+            m_Resource.Uploaded(DATA.size());
+
+            return true;
+        }
+
+        inline auto AllocateStorage(std::size_t size) -> bool override
+        {
+            ASSERT(sCurrentBoundBufferID == m_BufferID);
+
+            if (m_BufferID == 0 || !m_Resource.Allocate(size)) {
+                return false;
+            }
+
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STATIC_DRAW);
+
+            return true;
+        }
+
+        inline auto SetSubData(std::size_t offset, const std::span<const std::byte> DATA) -> bool override
+        {
+            ASSERT(sCurrentBoundBufferID == m_BufferID);
+            ASSERT(offset + DATA.size() <= m_Resource.Bytes());
+
+            if (m_BufferID == 0) {
+                return false;
+            }
+
+            glBufferSubData(
+                GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(DATA.size()), DATA.data());
+            m_Resource.Uploaded(DATA.size());
+
+            return true;
+        }
+
+        inline auto CopySubData(const IVertexBuffer& source,
+                                std::size_t source_offset,
+                                std::size_t offset,
+                                std::size_t size) -> bool override
+        {
+            ASSERT(source_offset + size <= source.StorageSize() && offset + size <= m_Resource.Bytes());
+
+            if (m_BufferID == 0 || source.ID() == 0) {
+                return false;
+            }
+
+            // The copy targets leave the array and element buffer bindings alone
+            glBindBuffer(GL_COPY_READ_BUFFER, source.ID());
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_BufferID);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER,
+                                GL_COPY_WRITE_BUFFER,
+                                static_cast<GLintptr>(source_offset),
+                                static_cast<GLintptr>(offset),
+                                static_cast<GLsizeiptr>(size));
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 
             return true;
         }
 
       private:
-        inline auto UploadLayout() -> bool override
+        inline auto UploadLayout(std::uint32_t first_location) -> bool override
         {
             ASSERT(sCurrentBoundBufferID == m_BufferID);
 
@@ -100,19 +160,22 @@ namespace JE
             }
 
             for (std::size_t i = 0; i < m_Layout.Count(); ++i) {
+                const auto LOCATION = first_location + static_cast<GLuint>(i);
                 glVertexAttribPointer(
-                    static_cast<GLuint>(i),
+                    LOCATION,
                     static_cast<GLint>(m_Layout[i].ComponentCount),
                     TypeToGLType(m_Layout[i].Type),
                     static_cast<GLboolean>(m_Layout[i].Normalized),
                     static_cast<GLsizei>(m_Layout.Stride()),
                     reinterpret_cast<void*>(m_Layout[i].Offset));  // NOLINT(performance-no-int-to-ptr)
-                glEnableVertexAttribArray(static_cast<GLuint>(i));
+                glEnableVertexAttribArray(LOCATION);
             }
 
             return true;
         }
 
+        OpenGLObjectPool& m_Objects;
+
         static inline IRendererAPI::BufferID sCurrentBoundBufferID = 0;
     };
 
@@ -126,9 +189,10 @@ namespace JE
         auto operator=(const OpenGLElementBuffer& other) -> OpenGLElementBuffer& = delete;
         auto operator=(OpenGLElementBuffer&& other) -> OpenGLElementBuffer& = delete;
 
-        explicit OpenGLElementBuffer()
+        explicit OpenGLElementBuffer(OpenGLObjectPool& objects)
+            : m_Objects(objects)
         {
-            glGenBuffers(1, &m_BufferID);
+            m_BufferID = m_Objects.CreateBuffer();
             ASSERT(m_BufferID != 0);
         }
         ~OpenGLElementBuffer() override
@@ -136,7 +200,7 @@ namespace JE
             if (m_BufferID == 0) {
                 return;
             }
-            glDeleteBuffers(1, &m_BufferID);
+            m_Objects.DestroyBuffer(m_BufferID);
         }
 
         inline auto Bind() -> bool override
@@ -173,16 +237,75 @@ namespace JE
         {
             ASSERT(sCurrentBoundBufferID == m_BufferID);
 
-            if (m_BufferID == 0) {
+            if (m_BufferID == 0 || !m_Resource.Allocate(DATA.size())) {
                 return false;
             }
 
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(DATA.size()), DATA.data(), GL_STATIC_DRAW);
+            m_Resource.Uploaded(DATA.size());
+
+            return true;
+        }
+
+        inline auto AllocateStorage(std::size_t size) -> bool override
+        {
+            ASSERT(sCurrentBoundBufferID == m_BufferID);
+
+            if (m_BufferID == 0 || !m_Resource.Allocate(size)) {
+                return false;
+            }
+
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STATIC_DRAW);
+
+            return true;
+        }
+
+        inline auto SetSubData(std::size_t offset, const std::span<const std::byte> DATA) -> bool override
+        {
+            ASSERT(sCurrentBoundBufferID == m_BufferID);
+            ASSERT(offset + DATA.size() <= m_Resource.Bytes());
+
+            if (m_BufferID == 0) {
+                return false;
+            }
+
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+                            static_cast<GLintptr>(offset),
+                            static_cast<GLsizeiptr>(DATA.size()),
+                            DATA.data());
+            m_Resource.Uploaded(DATA.size());
+
+            return true;
+        }
+
+        inline auto CopySubData(const IElementBuffer& source,
+                                std::size_t source_offset,
+                                std::size_t offset,
+                                std::size_t size) -> bool override
+        {
+            ASSERT(source_offset + size <= source.StorageSize() && offset + size <= m_Resource.Bytes());
+
+            if (m_BufferID == 0 || source.ID() == 0) {
+                return false;
+            }
+
+            // The copy targets leave the array and element buffer bindings alone
+            glBindBuffer(GL_COPY_READ_BUFFER, source.ID());
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_BufferID);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER,
+                                GL_COPY_WRITE_BUFFER,
+                                static_cast<GLintptr>(source_offset),
+                                static_cast<GLintptr>(offset),
+                                static_cast<GLsizeiptr>(size));
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 
             return true;
         }
 
       private:
+        OpenGLObjectPool& m_Objects;
+
         static inline IRendererAPI::BufferID sCurrentBoundBufferID = 0;
     };
 
@@ -194,9 +317,10 @@ namespace JE
         auto operator=(const OpenGLVertexArray& other) -> OpenGLVertexArray& = delete;
         auto operator=(OpenGLVertexArray&& other) -> OpenGLVertexArray& = delete;
 
-        OpenGLVertexArray()
+        explicit OpenGLVertexArray(OpenGLObjectPool& objects)
+            : m_Objects(objects)
         {
-            glGenVertexArrays(1, &m_VAOId);
+            m_VAOId = m_Objects.CreateVertexArray();
             ASSERT(m_VAOId != 0);
         }
 
@@ -205,20 +329,26 @@ namespace JE
             if (m_VAOId == 0) {
                 return;
             }
-            glDeleteVertexArrays(1, &m_VAOId);
+            m_Objects.DestroyVertexArray(m_VAOId, m_AttributeCount);
         }
 
         inline auto Build() -> bool override
         {
-            ASSERT(m_VertexBuffers.size()
-                   == 1);  // TODO(JesusKrists): Right now we only support one buffer for all vertex attributes
+            ASSERT(!m_VertexBuffers.empty());
 
             Bind();
-            m_VertexBuffers[0]->Bind();
 
-            auto success = m_VertexBuffers[0]->UploadLayout();
+            // Every buffer's attributes follow the previous buffer's, e.g. positions at 0 and texture coordinates at 1
+            bool success = true;
+            std::uint32_t location = 0;
+            for (auto& buffer : m_VertexBuffers) {
+                buffer->Bind();
+                success = buffer->UploadLayout(location) && success;
+                buffer->Unbind();
+                location += static_cast<std::uint32_t>(buffer->Layout().Count());
+            }
+            m_AttributeCount = std::max(m_AttributeCount, location);
 
-            m_VertexBuffers[0]->Unbind();
             Unbind();
 
             return success;
@@ -257,6 +387,9 @@ namespace JE
         }
 
       private:
+        OpenGLObjectPool& m_Objects;
+        std::uint32_t m_AttributeCount = 0;
+
         static inline IRendererAPI::BufferID sCurrentBoundBufferID = 0;
     };
 
@@ -296,8 +429,10 @@ namespace JE
 
         OpenGLShaderProgram(std::string_view debug_name,  // NOLINT(bugprone-easily-swappable-parameters)
                             std::string_view vertex_source,
-                            std::string_view fragment_source)
+                            std::string_view fragment_source,
+                            OpenGLObjectPool& objects)
             : IShaderProgram(debug_name)
+            , m_Objects(objects)
         {
             auto vertex_shader = CompileShader(vertex_source, ShaderType::VERTEX);
             if (!vertex_shader) {
@@ -337,7 +472,7 @@ namespace JE
             if (m_ProgramID == 0) {
                 return;
             }
-            glDeleteProgram(m_ProgramID);
+            m_Objects.DestroyProgram(m_ProgramID);
         }
 
         inline auto Bind() -> bool override
@@ -393,7 +528,85 @@ namespace JE
             return shader_program;
         }
 
+        OpenGLObjectPool& m_Objects;
+
         static inline IRendererAPI::ProgramID sCurrentBoundShaderProgram = 0;
     };
 
-}  // namespace JE
\ No newline at end of file
+    class OpenGLFramebuffer : public IFramebuffer
+    {
+      public:
+        OpenGLFramebuffer(const OpenGLFramebuffer& other) = delete;
+        OpenGLFramebuffer(OpenGLFramebuffer&& other) = delete;
+        auto operator=(const OpenGLFramebuffer& other) -> OpenGLFramebuffer& = delete;
+        auto operator=(OpenGLFramebuffer&& other) -> OpenGLFramebuffer& = delete;
+
+        explicit OpenGLFramebuffer(const FramebufferDescription& description)
+            : IFramebuffer(description)
+        {
+            // GL_DEPTH24_STENCIL8
+            constexpr std::size_t DEPTH_STENCIL_PIXEL_BYTES = 4;
+            const auto PIXEL_COUNT = static_cast<std::size_t>(Size().X) * static_cast<std::size_t>(Size().Y);
+
+            glGenFramebuffers(1, &m_FramebufferID);
+            ASSERT(m_FramebufferID != 0);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferID);
+
+            Vector<GLenum> draw_buffers;
+            for (std::size_t i = 0; i < m_ColorAttachments.size(); ++i) {
+                const auto ATTACHMENT = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, ATTACHMENT, GL_TEXTURE_2D, m_ColorAttachments[i]->ID(), 0);
+                draw_buffers.push_back(ATTACHMENT);
+            }
+            glDrawBuffers(static_cast<GLsizei>(draw_buffers.size()), draw_buffers.data());
+
+            if (m_Description.DepthStencil && m_Resource.Allocate(DEPTH_STENCIL_PIXEL_BYTES * PIXEL_COUNT)) {
+                glGenRenderbuffers(1, &m_DepthStencilID);
+                glBindRenderbuffer(GL_RENDERBUFFER, m_DepthStencilID);
+                glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Description.Size.X, m_Description.Size.Y);
+                glBindRenderbuffer(GL_RENDERBUFFER, 0);
+                glFramebufferRenderbuffer(GL_FRAMEBUFFER,
+                                          GL_DEPTH_STENCIL_ATTACHMENT,
+                                          GL_RENDERBUFFER,
+                                          m_DepthStencilID);
+            }
+
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                EngineLogger()->error("Framebuffer of size {} is incomplete", m_Description.Size);
+            }
+
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+
+        ~OpenGLFramebuffer() override
+        {
+            if (m_DepthStencilID != 0) {
+                glDeleteRenderbuffers(1, &m_DepthStencilID);
+            }
+            if (m_FramebufferID != 0) {
+                glDeleteFramebuffers(1, &m_FramebufferID);
+            }
+        }
+
+        inline void Bind() override
+        {
+            // Remember the viewport of the target we render into next, usually the window
+            glGetIntegerv(GL_VIEWPORT, m_PreviousViewport.data());
+
+            glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferID);
+            glViewport(0, 0, m_Description.Size.X, m_Description.Size.Y);
+        }
+
+        inline void Unbind() override
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(m_PreviousViewport[0], m_PreviousViewport[1], m_PreviousViewport[2], m_PreviousViewport[3]);
+        }
+
+      private:
+        GLuint m_DepthStencilID = 0;
+        std::array<GLint, 4> m_PreviousViewport{};
+    };
+
+}  // namespace JE
@@ -1,4 +1,5 @@
 #include <cstdint>
+#include <limits>
 
 #include "OpenGLRendererAPI.hpp"
 
@@ -6,6 +7,8 @@
 #include <spdlog/fmt/fmt.h>
 
 #include "Graphics/IRendererAPI.hpp"
+#include "Graphics/OpenGLRenderer.hpp"
+#include "Graphics/OpenGLTexture.hpp"
 #include "Logger.hpp"
 #include "Memory.hpp"
 #include "Types.hpp"
@@ -63,8 +66,12 @@ namespace JE::detail
 
     auto OpenGLRendererAPI::ClearFramebuffer(AttachmentFlags flags) -> bool
     {
+        // The depth write mask applies to clears as well
+        const bool DEPTH_MASKED = m_AppliedRenderState && !m_AppliedRenderState->DepthStencil.DepthWrite
+                                  && (flags & AttachmentFlag::DEPTH) != 0u;
+
         return OpenGLErrorWrapper::Call(
-            [flags]()
+            [flags, DEPTH_MASKED]()
             {
                 AttachmentFlags gl_flags = 0;
                 if ((flags & AttachmentFlag::COLOR) != 0u) {
@@ -79,7 +86,13 @@ namespace JE::detail
                     gl_flags |= static_cast<std::uint32_t>(GL_STENCIL_BUFFER_BIT);
                 }
 
+                if (DEPTH_MASKED) {
+                    glDepthMask(GL_TRUE);
+                }
                 glClear(gl_flags);
+                if (DEPTH_MASKED) {
+                    glDepthMask(GL_FALSE);
+                }
             });
     }
 
@@ -112,18 +125,252 @@ namespace JE::detail
             return 0;
         }
 
+        constexpr auto BlendFactorToOpenGLBlendFactor(BlendFactor factor) -> GLenum
+        {
+            switch (factor) {
+                case BlendFactor::ZERO:
+                    return GL_ZERO;
+                case BlendFactor::ONE:
+                    return GL_ONE;
+                case BlendFactor::SOURCE_ALPHA:
+                    return GL_SRC_ALPHA;
+                case BlendFactor::ONE_MINUS_SOURCE_ALPHA:
+                    return GL_ONE_MINUS_SRC_ALPHA;
+                case BlendFactor::DESTINATION_ALPHA:
+                    return GL_DST_ALPHA;
+                case BlendFactor::ONE_MINUS_DESTINATION_ALPHA:
+                    return GL_ONE_MINUS_DST_ALPHA;
+                default:
+                    return GL_ONE;
+            }
+        }
+
+        constexpr auto CompareFunctionToOpenGLFunction(CompareFunction function) -> GLenum
+        {
+            switch (function) {
+                case CompareFunction::NEVER:
+                    return GL_NEVER;
+                case CompareFunction::LESS:
+                    return GL_LESS;
+                case CompareFunction::LESS_EQUAL:
+                    return GL_LEQUAL;
+                case CompareFunction::EQUAL:
+                    return GL_EQUAL;
+                case CompareFunction::NOT_EQUAL:
+                    return GL_NOTEQUAL;
+                case CompareFunction::GREATER_EQUAL:
+                    return GL_GEQUAL;
+                case CompareFunction::GREATER:
+                    return GL_GREATER;
+                case CompareFunction::ALWAYS:
+                    return GL_ALWAYS;
+                default:
+                    return GL_ALWAYS;
+            }
+        }
+
+        inline void SetCapability(GLenum capability, bool enabled)
+        {
+            if (enabled) {
+                glEnable(capability);
+            } else {
+                glDisable(capability);
+            }
+        }
+
     }  // namespace
 
-    auto OpenGLRendererAPI::DrawIndexed(Primitive primitive_type, std::uint32_t index_count, Type index_type) -> bool
+    auto OpenGLRendererAPI::DrawIndexed(Primitive primitive_type,
+                                        std::uint32_t index_count,
+                                        Type index_type,
+                                        std::uint32_t first_index,
+                                        std::int32_t base_vertex) -> bool
     {
         return OpenGLErrorWrapper::Call(
-            [primitive_type, index_count, index_type]()
+            [primitive_type, index_count, index_type, first_index, base_vertex]()
             {
-                glDrawElements(PrimitiveToOpenGLPrimitive(primitive_type),
-                               static_cast<GLsizei>(index_count),
-                               TypeToOpenGLType(index_type),
-                               nullptr);
+                // The element buffer is bound, the pointer is a byte offset into it
+                const auto OFFSET = static_cast<std::uintptr_t>(first_index) * TypeByteCount(index_type);
+                glDrawElementsBaseVertex(PrimitiveToOpenGLPrimitive(primitive_type),
+                                         static_cast<GLsizei>(index_count),
+                                         TypeToOpenGLType(index_type),
+                                         reinterpret_cast<const void*>(OFFSET),  // NOLINT(performance-no-int-to-ptr)
+                                         base_vertex);
             });
     }
 
+    auto OpenGLRendererAPI::SetRenderState(const RenderState& state) -> bool
+    {
+        const auto* applied = m_AppliedRenderState ? &*m_AppliedRenderState : nullptr;
+        const bool SUCCESS = OpenGLErrorWrapper::Call(
+            [&state, applied]()
+            {
+                if (applied == nullptr || state.Blend != applied->Blend) {
+                    SetCapability(GL_BLEND, state.Blend.Enabled);
+                    glBlendFunc(BlendFactorToOpenGLBlendFactor(state.Blend.Source),
+                                BlendFactorToOpenGLBlendFactor(state.Blend.Destination));
+                }
+
+                if (applied == nullptr || state.DepthStencil != applied->DepthStencil) {
+                    const auto& depth_stencil = state.DepthStencil;
+                    SetCapability(GL_DEPTH_TEST, depth_stencil.DepthTest);
+                    glDepthMask(depth_stencil.DepthWrite ? GL_TRUE : GL_FALSE);
+                    glDepthFunc(CompareFunctionToOpenGLFunction(depth_stencil.DepthCompare));
+
+                    SetCapability(GL_STENCIL_TEST, depth_stencil.StencilTest);
+                    glStencilFunc(CompareFunctionToOpenGLFunction(depth_stencil.StencilCompare),
+                                  depth_stencil.StencilReference,
+                                  std::numeric_limits<std::uint8_t>::max());
+                    glStencilOp(GL_KEEP, GL_KEEP, depth_stencil.StencilWrite ? GL_REPLACE : GL_KEEP);
+                }
+
+                if (applied == nullptr || state.Rasterizer != applied->Rasterizer) {
+                    SetCapability(GL_CULL_FACE, state.Rasterizer.Cull != CullMode::NONE);
+                    glCullFace(state.Rasterizer.Cull == CullMode::FRONT ? GL_FRONT : GL_BACK);
+                    glFrontFace(state.Rasterizer.FrontCounterClockwise ? GL_CCW : GL_CW);
+                }
+            });
+
+        m_AppliedRenderState = state;
+        return SUCCESS;
+    }
+
+    auto OpenGLRendererAPI::CreateVertexBuffer(const AttributeLayout& layout) -> Scope<IVertexBuffer>
+    {
+        return CreateScope<OpenGLVertexBuffer>(layout, m_Objects);
+    }
+
+    auto OpenGLRendererAPI::CreateElementBuffer() -> Scope<IElementBuffer>
+    {
+        return CreateScope<OpenGLElementBuffer>(m_Objects);
+    }
+
+    auto OpenGLRendererAPI::CreateVertexArray() -> Scope<IVertexArray>
+    {
+        return CreateScope<OpenGLVertexArray>(m_Objects);
+    }
+
+    auto OpenGLRendererAPI::CreateShader(std::string_view debug_name,
+                                         std::string_view vertex_source,
+                                         std::string_view fragment_source) -> Scope<IShaderProgram>
+    {
+        return CreateScope<OpenGLShaderProgram>(debug_name, vertex_source, fragment_source, m_Objects);
+    }
+
+    auto OpenGLRendererAPI::CreateTexture2D(const TextureDescription& description) -> Scope<ITexture2D>
+    {
+        return CreateScope<OpenGLTexture2D>(description);
+    }
+
+    auto OpenGLRendererAPI::CreateTextureUploader(std::size_t frame_budget) -> Scope<ITextureUploader>
+    {
+        return CreateScope<OpenGLTextureUploader>(frame_budget);
+    }
+
+    auto OpenGLRendererAPI::CreateFramebuffer(const FramebufferDescription& description) -> Scope<IFramebuffer>
+    {
+        return CreateScope<OpenGLFramebuffer>(description);
+    }
+
+    auto OpenGLRendererAPI::InsertFence() -> FenceID
+    {
+        GLsync fence = nullptr;
+        OpenGLErrorWrapper::Call([&fence]() { fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); });
+
+        return reinterpret_cast<FenceID>(fence);  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    auto OpenGLRendererAPI::WaitFence(FenceID fence, std::uint64_t timeout_ns) -> bool
+    {
+        if (fence == 0) {
+            return true;
+        }
+
+        GLenum result = GL_WAIT_FAILED;
+        const bool SUCCESS = OpenGLErrorWrapper::Call(
+            [fence, timeout_ns, &result]()
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, performance-no-int-to-ptr)
+                result = glClientWaitSync(reinterpret_cast<GLsync>(fence), GL_SYNC_FLUSH_COMMANDS_BIT, timeout_ns);
+            });
+
+        return SUCCESS && (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED);
+    }
+
+    void OpenGLRendererAPI::DeleteFence(FenceID fence)
+    {
+        if (fence == 0) {
+            return;
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, performance-no-int-to-ptr)
+        OpenGLErrorWrapper::Call([fence]() { glDeleteSync(reinterpret_cast<GLsync>(fence)); });
+    }
+
+    auto OpenGLRendererAPI::Finish() -> bool
+    {
+        return OpenGLErrorWrapper::Call([]() { glFinish(); });
+    }
+
+    void OpenGLRendererAPI::EndFrame() { m_Objects.EndFrame(); }
+
+    auto OpenGLRendererAPI::BeginTimerQuery() -> TimerQueryID
+    {
+        GLuint query = 0;
+        const bool SUCCESS = OpenGLErrorWrapper::Call(
+            [&query]()
+            {
+                glGenQueries(1, &query);
+                glBeginQuery(GL_TIME_ELAPSED, query);
+            });
+        if (!SUCCESS && query != 0) {
+            glDeleteQueries(1, &query);
+            return 0;
+        }
+
+        return query;
+    }
+
+    auto OpenGLRendererAPI::EndTimerQuery(TimerQueryID query) -> bool
+    {
+        if (query == 0) {
+            return false;
+        }
+
+        return OpenGLErrorWrapper::Call([]() { glEndQuery(GL_TIME_ELAPSED); });
+    }
+
+    auto OpenGLRendererAPI::TimerQueryResult(TimerQueryID query) -> std::optional<std::uint64_t>
+    {
+        if (query == 0) {
+            return std::nullopt;
+        }
+
+        // Checking availability first keeps the CPU from stalling until the GPU catches up
+        GLint available = GL_FALSE;
+        GLuint64 elapsed_ns = 0;
+        const bool SUCCESS = OpenGLErrorWrapper::Call(
+            [query, &available, &elapsed_ns]()
+            {
+                glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (available == GL_TRUE) {
+                    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed_ns);
+                }
+            });
+        if (!SUCCESS || available != GL_TRUE) {
+            return std::nullopt;
+        }
+
+        return elapsed_ns;
+    }
+
+    void OpenGLRendererAPI::DeleteTimerQuery(TimerQueryID query)
+    {
+        if (query == 0) {
+            return;
+        }
+
+        OpenGLErrorWrapper::Call([query]() { glDeleteQueries(1, &query); });
+    }
+
 }  // namespace JE::detail
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <string_view>
 
 #include "Graphics/IRendererAPI.hpp"
+#include "Graphics/OpenGLObjectPool.hpp"
+#include "Graphics/RenderState.hpp"
 
 namespace JE
 {
@@ -21,7 +24,40 @@ namespace JE::detail
         auto SetClearColor(const RGBA& color) -> bool override;
         auto ClearFramebuffer(AttachmentFlags flags) -> bool override;
         auto BindFramebuffer(FramebufferID buffer_id) -> bool override;
-        auto DrawIndexed(Primitive primitive_type, std::uint32_t index_count, Type index_type) -> bool override;
+        auto DrawIndexed(Primitive primitive_type,
+                         std::uint32_t index_count,
+                         Type index_type,
+                         std::uint32_t first_index,
+                         std::int32_t base_vertex) -> bool override;
+        auto SetRenderState(const RenderState& state) -> bool override;
+
+        auto CreateVertexBuffer(const AttributeLayout& layout) -> Scope<IVertexBuffer> override;
+        auto CreateElementBuffer() -> Scope<IElementBuffer> override;
+        auto CreateVertexArray() -> Scope<IVertexArray> override;
+        auto CreateShader(std::string_view debug_name,
+                          std::string_view vertex_source,
+                          std::string_view fragment_source) -> Scope<IShaderProgram> override;
+        auto CreateTexture2D(const TextureDescription& description) -> Scope<ITexture2D> override;
+        auto CreateTextureUploader(std::size_t frame_budget) -> Scope<ITextureUploader> override;
+        auto CreateFramebuffer(const FramebufferDescription& description) -> Scope<IFramebuffer> override;
+
+        auto InsertFence() -> FenceID override;
+        auto WaitFence(FenceID fence, std::uint64_t timeout_ns) -> bool override;
+        void DeleteFence(FenceID fence) override;
+        auto Finish() -> bool override;
+        void EndFrame() override;
+
+        auto BeginTimerQuery() -> TimerQueryID override;
+        auto EndTimerQuery(TimerQueryID query) -> bool override;
+        auto TimerQueryResult(TimerQueryID query) -> std::optional<std::uint64_t> override;
+        void DeleteTimerQuery(TimerQueryID query) override;
+
+        inline auto Objects() -> OpenGLObjectPool& { return m_Objects; }
+
+      private:
+        OpenGLObjectPool m_Objects;
+        /// Nothing is known about the context state before the first SetRenderState, it applies everything
+        std::optional<RenderState> m_AppliedRenderState;
     };
 
 }  // namespace JE::detail
\ No newline at end of file
@@ -0,0 +1,341 @@
+#include <algorithm>
+
+#include "OpenGLTexture.hpp"
+
+#include "Assert.hpp"
+#include "Logger.hpp"
+#include "ResourceTracker.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        constexpr GLint DEFAULT_UNPACK_ALIGNMENT = 4;
+
+        constexpr auto FilterToOpenGLFilter(TextureFilter filter) -> GLint
+        {
+            return filter == TextureFilter::NEAREST ? GL_NEAREST : GL_LINEAR;
+        }
+
+        constexpr auto MinFilterToOpenGLFilter(TextureFilter filter, TextureFilter mip_filter, bool mipmapped) -> GLint
+        {
+            if (!mipmapped) {
+                return FilterToOpenGLFilter(filter);
+            }
+
+            if (filter == TextureFilter::NEAREST) {
+                return mip_filter == TextureFilter::NEAREST ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST_MIPMAP_LINEAR;
+            }
+            return mip_filter == TextureFilter::NEAREST ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR;
+        }
+
+        auto FormatSupported(TextureFormat format) -> bool
+        {
+            if (!IsCompressedFormat(format)) {
+                return true;
+            }
+
+            // S3TC is an extension on desktop GL, sRGB block formats additionally need EXT_texture_sRGB
+            if (GLAD_GL_EXT_texture_compression_s3tc == 0) {
+                return false;
+            }
+            return !IsSRGBFormat(format) || GLAD_GL_EXT_texture_sRGB != 0;
+        }
+
+        constexpr auto WrapToOpenGLWrap(TextureWrap wrap) -> GLint
+        {
+            switch (wrap) {
+                case TextureWrap::REPEAT:
+                    return GL_REPEAT;
+                case TextureWrap::MIRRORED_REPEAT:
+                    return GL_MIRRORED_REPEAT;
+                case TextureWrap::CLAMP_TO_EDGE:
+                    return GL_CLAMP_TO_EDGE;
+                default:
+                    return GL_REPEAT;
+            }
+        }
+
+    }  // namespace
+
+    OpenGLTexture2D::OpenGLTexture2D(const TextureDescription& description)
+        : ITexture2D(description)
+    {
+        const auto GL_FORMAT = TextureFormatToOpenGLFormat(m_Description.Format);
+
+        if (!FormatSupported(m_Description.Format)) {
+            EngineLogger()->error("Texture format {} is not supported by this OpenGL driver",
+                                  static_cast<int>(m_Description.Format));
+            return;
+        }
+
+        if (!m_Resource.Allocate(ByteSize())) {
+            return;
+        }
+
+        glGenTextures(1, &m_TextureID);
+        ASSERT(m_TextureID != 0);
+
+        glBindTexture(GL_TEXTURE_2D, m_TextureID);
+        if (GLAD_GL_VERSION_4_2 != 0) {
+            glTexStorage2D(GL_TEXTURE_2D,
+                           static_cast<GLsizei>(m_Description.MipLevels),
+                           GL_FORMAT.InternalFormat,
+                           m_Description.Size.X,
+                           m_Description.Size.Y);
+        } else {
+            // Immutable storage is GL 4.2, the 4.1 context on Apple allocates every level separately
+            for (std::uint32_t level = 0; level < m_Description.MipLevels; ++level) {
+                const auto LEVEL_SIZE = LevelSize(level);
+                if (IsCompressedFormat(m_Description.Format)) {
+                    glCompressedTexImage2D(GL_TEXTURE_2D,
+                                           static_cast<GLint>(level),
+                                           GL_FORMAT.InternalFormat,
+                                           LEVEL_SIZE.X,
+                                           LEVEL_SIZE.Y,
+                                           0,
+                                           static_cast<GLsizei>(LevelByteSize(level)),
+                                           nullptr);
+                } else {
+                    glTexImage2D(GL_TEXTURE_2D,
+                                 static_cast<GLint>(level),
+                                 static_cast<GLint>(GL_FORMAT.InternalFormat),
+                                 LEVEL_SIZE.X,
+                                 LEVEL_SIZE.Y,
+                                 0,
+                                 GL_FORMAT.PixelFormat,
+                                 GL_FORMAT.PixelType,
+                                 nullptr);
+                }
+            }
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_Description.MipLevels - 1));
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        SetSampler(m_Sampler);
+    }
+
+    OpenGLTexture2D::~OpenGLTexture2D()
+    {
+        if (m_TextureID == 0) {
+            return;
+        }
+        glDeleteTextures(1, &m_TextureID);
+    }
+
+    auto OpenGLTexture2D::Bind(std::uint32_t slot) -> bool
+    {
+        if (m_TextureID == 0) {
+            return false;
+        }
+
+        glActiveTexture(GL_TEXTURE0 + slot);
+        glBindTexture(GL_TEXTURE_2D, m_TextureID);
+
+        return true;
+    }
+
+    auto OpenGLTexture2D::Unbind(std::uint32_t slot) -> bool
+    {
+        if (m_TextureID == 0) {
+            return false;
+        }
+
+        glActiveTexture(GL_TEXTURE0 + slot);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        return true;
+    }
+
+    auto OpenGLTexture2D::SetSampler(const SamplerState& sampler) -> bool
+    {
+        if (m_TextureID == 0) {
+            return false;
+        }
+
+        m_Sampler = sampler;
+
+        glBindTexture(GL_TEXTURE_2D, m_TextureID);
+        glTexParameteri(GL_TEXTURE_2D,
+                        GL_TEXTURE_MIN_FILTER,
+                        MinFilterToOpenGLFilter(sampler.MinFilter, sampler.MipFilter, m_Description.MipLevels > 1));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, FilterToOpenGLFilter(sampler.MagFilter));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, WrapToOpenGLWrap(sampler.WrapU));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, WrapToOpenGLWrap(sampler.WrapV));
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        return true;
+    }
+
+    auto OpenGLTexture2D::SetData(std::uint32_t level, std::span<const std::byte> data) -> bool
+    {
+        ASSERT(level < m_Description.MipLevels);
+
+        if (m_TextureID == 0 || data.size() != LevelByteSize(level)) {
+            return false;
+        }
+
+        return UploadRows(level, 0, LevelRowCount(level), data.data());
+    }
+
+    auto OpenGLTexture2D::SetRows(std::uint32_t level, std::uint32_t first_row, std::span<const std::byte> data) -> bool
+    {
+        ASSERT(level < m_Description.MipLevels);
+
+        const auto ROW_BYTES = LevelRowBytes(level);
+        const auto ROW_COUNT = static_cast<std::uint32_t>(data.size() / ROW_BYTES);
+        if (m_TextureID == 0 || data.size() % ROW_BYTES != 0 || first_row + ROW_COUNT > LevelRowCount(level)) {
+            return false;
+        }
+
+        return UploadRows(level, first_row, ROW_COUNT, data.data());
+    }
+
+    auto OpenGLTexture2D::GenerateMipmaps() -> bool
+    {
+        if (m_TextureID == 0) {
+            return false;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, m_TextureID);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        return true;
+    }
+
+    auto OpenGLTexture2D::UploadRows(std::uint32_t level,
+                                     std::uint32_t first_row,
+                                     std::uint32_t row_count,
+                                     const void* data) -> bool
+    {
+        if (m_TextureID == 0) {
+            return false;
+        }
+
+        const auto GL_FORMAT = TextureFormatToOpenGLFormat(m_Description.Format);
+        const auto INFO = GetTextureFormatInfo(m_Description.Format);
+        const auto LEVEL_SIZE = LevelSize(level);
+
+        const auto Y_OFFSET = static_cast<GLint>(first_row * INFO.BlockHeight);
+        const auto HEIGHT = std::min(static_cast<GLint>(row_count * INFO.BlockHeight), LEVEL_SIZE.Y - Y_OFFSET);
+
+        glBindTexture(GL_TEXTURE_2D, m_TextureID);
+        if (IsCompressedFormat(m_Description.Format)) {
+            // Block compressed levels are uploaded as is, rows of blocks are already the GPU layout
+            glCompressedTexSubImage2D(GL_TEXTURE_2D,
+                                      static_cast<GLint>(level),
+                                      0,
+                                      Y_OFFSET,
+                                      LEVEL_SIZE.X,
+                                      HEIGHT,
+                                      GL_FORMAT.InternalFormat,
+                                      static_cast<GLsizei>(row_count * LevelRowBytes(level)),
+                                      data);
+        } else {
+            // Rows are tightly packed
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexSubImage2D(GL_TEXTURE_2D,
+                            static_cast<GLint>(level),
+                            0,
+                            Y_OFFSET,
+                            LEVEL_SIZE.X,
+                            HEIGHT,
+                            GL_FORMAT.PixelFormat,
+                            GL_FORMAT.PixelType,
+                            data);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, DEFAULT_UNPACK_ALIGNMENT);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        m_Resource.Uploaded(row_count * LevelRowBytes(level));
+
+        return true;
+    }
+
+    OpenGLTextureUploader::OpenGLTextureUploader(std::size_t frame_budget)
+        : ITextureUploader(frame_budget)
+    {
+    }
+
+    OpenGLTextureUploader::~OpenGLTextureUploader()
+    {
+        for (auto& buffer : m_Ring) {
+            RendererAPI().DeleteFence(buffer.Fence);
+            if (buffer.BufferID != 0) {
+                glDeleteBuffers(1, &buffer.BufferID);
+                ResourceTracker().Destroyed(ResourceType::STAGING_BUFFER, buffer.Capacity);
+            }
+        }
+    }
+
+    auto OpenGLTextureUploader::MapStaging(std::size_t size) -> std::span<std::byte>
+    {
+        auto& buffer = m_Ring[m_RingIndex];
+
+        // Never block the frame on the GPU, if the oldest buffer is still being read the upload waits a frame
+        if (buffer.Fence != 0) {
+            if (!RendererAPI().WaitFence(buffer.Fence, 0)) {
+                return {};
+            }
+            RendererAPI().DeleteFence(buffer.Fence);
+            buffer.Fence = 0;
+        }
+
+        // Buffers are created lazily and only ever grow
+        if (buffer.BufferID == 0) {
+            glGenBuffers(1, &buffer.BufferID);
+            ResourceTracker().Created(ResourceType::STAGING_BUFFER);
+        }
+
+        // Over a rejecting budget the uploads wait until memory is freed, like they wait for a busy buffer
+        if (buffer.Capacity < size
+            && !ResourceTracker().Reallocate(ResourceType::STAGING_BUFFER, buffer.Capacity, size)) {
+            return {};
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.BufferID);
+        if (buffer.Capacity < size) {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+            buffer.Capacity = size;
+        }
+
+        auto* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+                                        0,
+                                        static_cast<GLsizeiptr>(size),
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (mapped == nullptr) {
+            EngineLogger()->error("Failed to map {} bytes of texture staging memory", size);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return {};
+        }
+
+        return {static_cast<std::byte*>(mapped), size};
+    }
+
+    auto OpenGLTextureUploader::SubmitStaging(std::span<const StagedRegion> regions) -> bool
+    {
+        auto& buffer = m_Ring[m_RingIndex];
+
+        bool success = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+
+        // With a pixel unpack buffer bound the data pointer is an offset into it
+        for (const auto& region : regions) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+            auto& texture = static_cast<OpenGLTexture2D&>(*region.Texture);
+            // NOLINTNEXTLINE(performance-no-int-to-ptr, cppcoreguidelines-pro-type-reinterpret-cast)
+            const auto* offset = reinterpret_cast<const void*>(region.StagingOffset);
+
+            success = texture.UploadRows(region.Level, region.FirstRow, region.RowCount, offset) && success;
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        buffer.Fence = RendererAPI().InsertFence();
+        m_RingIndex = (m_RingIndex + 1) % RING_SIZE;
+
+        return success;
+    }
+
+}  // namespace JE
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <glad/gl.h>
+
+#include "IRendererAPI.hpp"
+#include "Texture.hpp"
+
+namespace JE
+{
+
+    /// Compressed formats only have an internal format, their data is uploaded as whole blocks
+    struct OpenGLTextureFormat
+    {
+        GLenum InternalFormat = 0;
+        GLenum PixelFormat = 0;
+        GLenum PixelType = 0;
+    };
+
+    constexpr auto TextureFormatToOpenGLFormat(TextureFormat format) -> OpenGLTextureFormat
+    {
+        switch (format) {
+            case TextureFormat::R8:
+                return {GL_R8, GL_RED, GL_UNSIGNED_BYTE};
+            case TextureFormat::RG8:
+                return {GL_RG8, GL_RG, GL_UNSIGNED_BYTE};
+            case TextureFormat::RGBA8:
+                return {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE};
+            case TextureFormat::SRGB8_ALPHA8:
+                return {GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE};
+            case TextureFormat::RGBA16F:
+                return {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT};
+            case TextureFormat::RGBA32F:
+                return {GL_RGBA32F, GL_RGBA, GL_FLOAT};
+            case TextureFormat::BC1_RGBA:
+                return {GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 0, 0};
+            case TextureFormat::BC1_SRGB_ALPHA:
+                return {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, 0, 0};
+            case TextureFormat::BC3_RGBA:
+                return {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 0, 0};
+            case TextureFormat::BC3_SRGB_ALPHA:
+                return {GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, 0, 0};
+            default:
+                return {};
+        }
+    }
+
+    class OpenGLTexture2D : public ITexture2D
+    {
+      public:
+        OpenGLTexture2D(const OpenGLTexture2D& other) = delete;
+        OpenGLTexture2D(OpenGLTexture2D&& other) = delete;
+        auto operator=(const OpenGLTexture2D& other) -> OpenGLTexture2D& = delete;
+        auto operator=(OpenGLTexture2D&& other) -> OpenGLTexture2D& = delete;
+
+        explicit OpenGLTexture2D(const TextureDescription& description);
+        ~OpenGLTexture2D() override;
+
+        auto Bind(std::uint32_t slot) -> bool override;
+        auto Unbind(std::uint32_t slot) -> bool override;
+
+        auto SetSampler(const SamplerState& sampler) -> bool override;
+        auto SetData(std::uint32_t level, std::span<const std::byte> data) -> bool override;
+        auto SetRows(std::uint32_t level, std::uint32_t first_row, std::span<const std::byte> data) -> bool override;
+        auto GenerateMipmaps() -> bool override;
+
+        /// Uploads rows of a mip level from the currently bound pixel unpack buffer (or client memory if none is bound)
+        auto UploadRows(std::uint32_t level, std::uint32_t first_row, std::uint32_t row_count, const void* data)
+            -> bool;
+    };
+
+    /// Stages uploads through a ring of persistently reused pixel unpack buffers, a buffer is only written again once
+    /// the fence of the frame that last used it has signaled so the CPU never waits on the GPU
+    class OpenGLTextureUploader final : public ITextureUploader
+    {
+      public:
+        static constexpr std::size_t RING_SIZE = 3;
+
+        OpenGLTextureUploader(const OpenGLTextureUploader& other) = delete;
+        OpenGLTextureUploader(OpenGLTextureUploader&& other) = delete;
+        auto operator=(const OpenGLTextureUploader& other) -> OpenGLTextureUploader& = delete;
+        auto operator=(OpenGLTextureUploader&& other) -> OpenGLTextureUploader& = delete;
+
+        explicit OpenGLTextureUploader(std::size_t frame_budget);
+        ~OpenGLTextureUploader() override;
+
+      protected:
+        auto MapStaging(std::size_t size) -> std::span<std::byte> override;
+        auto SubmitStaging(std::span<const StagedRegion> regions) -> bool override;
+
+      private:
+        struct PixelBuffer
+        {
+            IRendererAPI::BufferID BufferID = 0;
+            std::size_t Capacity = 0;
+            IRendererAPI::FenceID Fence = 0;
+        };
+
+        std::array<PixelBuffer, RING_SIZE> m_Ring{};
+        std::size_t m_RingIndex = 0;
+    };
+
+}  // namespace JE
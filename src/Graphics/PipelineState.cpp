@@ -0,0 +1,204 @@
+#include <functional>
+#include <utility>
+
+#include "PipelineState.hpp"
+
+#include "Assert.hpp"
+#include "Graphics/IRendererAPI.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        template<typename T>
+        inline void HashCombine(std::size_t& seed, const T& value)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+            seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ULL + (seed << 6U) + (seed >> 2U);
+        }
+
+        auto HashPipeline(const IShaderProgram* shader_program,
+                          const AttributeLayout& vertex_layout,
+                          const RenderState& state) -> std::size_t
+        {
+            std::size_t seed = 0;
+            HashCombine(seed, shader_program);
+            for (const auto& attribute : vertex_layout) {
+                HashCombine(seed, attribute.Name);
+                HashCombine(seed, attribute.Type);
+                HashCombine(seed, attribute.ComponentCount);
+                HashCombine(seed, attribute.Normalized);
+            }
+
+            HashCombine(seed, state.Blend.Enabled);
+            HashCombine(seed, state.Blend.Source);
+            HashCombine(seed, state.Blend.Destination);
+
+            const auto& depth_stencil = state.DepthStencil;
+            HashCombine(seed, depth_stencil.DepthTest);
+            HashCombine(seed, depth_stencil.DepthWrite);
+            HashCombine(seed, depth_stencil.DepthCompare);
+            HashCombine(seed, depth_stencil.StencilTest);
+            HashCombine(seed, depth_stencil.StencilCompare);
+            HashCombine(seed, depth_stencil.StencilReference);
+            HashCombine(seed, depth_stencil.StencilWrite);
+
+            HashCombine(seed, state.Rasterizer.Cull);
+            HashCombine(seed, state.Rasterizer.FrontCounterClockwise);
+            return seed;
+        }
+
+    }  // namespace
+
+    PipelineState::PipelineState(IShaderProgram* shader_program,
+                                 AttributeLayout vertex_layout,
+                                 const RenderState& state)
+        : m_ShaderProgram(shader_program)
+        , m_VertexLayout(std::move(vertex_layout))
+        , m_State(state)
+        , m_Hash(HashPipeline(shader_program, m_VertexLayout, state))
+    {
+    }
+
+    auto PipelineState::operator==(const PipelineState& other) const -> bool
+    {
+        if (m_Hash != other.m_Hash || m_ShaderProgram != other.m_ShaderProgram || m_State != other.m_State
+            || m_VertexLayout.Count() != other.m_VertexLayout.Count()) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < m_VertexLayout.Count(); ++i) {
+            const auto& attribute = m_VertexLayout[i];
+            const auto& other_attribute = other.m_VertexLayout[i];
+            if (attribute.Name != other_attribute.Name || attribute.Type != other_attribute.Type
+                || attribute.ComponentCount != other_attribute.ComponentCount
+                || attribute.Normalized != other_attribute.Normalized) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    PipelineCache::PipelineCache(IRendererAPI& renderer_api)
+        : m_RendererAPI(renderer_api)
+    {
+        Create(PipelineState{nullptr, AttributeLayout{}});
+    }
+
+    PipelineCache::~PipelineCache()
+    {
+        // Programs outliving the cache must not evict from it
+        for (const auto& pipeline : m_Pipelines) {
+            if (pipeline.ShaderProgram() != nullptr) {
+                pipeline.ShaderProgram()->m_Pipelines = nullptr;
+            }
+        }
+    }
+
+    auto PipelineCache::Create(const PipelineState& state) -> PipelineID
+    {
+        const auto [FIRST, LAST] = m_Lookup.equal_range(state.Hash());
+        for (auto iter = FIRST; iter != LAST; ++iter) {
+            if (m_Pipelines[iter->second] == state) {
+                return iter->second;
+            }
+        }
+
+        if (state.ShaderProgram() != nullptr) {
+            ASSERT(state.ShaderProgram()->m_Pipelines == nullptr || state.ShaderProgram()->m_Pipelines == this);
+            state.ShaderProgram()->m_Pipelines = this;
+        }
+
+        PipelineID pipeline = 0;
+        if (m_FreePipelines.empty()) {
+            pipeline = static_cast<PipelineID>(m_Pipelines.size());
+            m_Pipelines.push_back(state);
+        } else {
+            pipeline = m_FreePipelines.back();
+            m_FreePipelines.pop_back();
+            m_Pipelines[pipeline] = state;
+        }
+        m_Lookup.emplace(state.Hash(), pipeline);
+        return pipeline;
+    }
+
+    void PipelineCache::Evict(IShaderProgram& shader_program)
+    {
+        for (std::size_t i = 0; i < m_Pipelines.size(); ++i) {
+            if (m_Pipelines[i].ShaderProgram() != &shader_program) {
+                continue;
+            }
+
+            const auto PIPELINE = static_cast<PipelineID>(i);
+            const auto [FIRST, LAST] = m_Lookup.equal_range(m_Pipelines[i].Hash());
+            for (auto iter = FIRST; iter != LAST; ++iter) {
+                if (iter->second == PIPELINE) {
+                    m_Lookup.erase(iter);
+                    break;
+                }
+            }
+
+            // The slot keeps no program so a later eviction can't match it again
+            m_Pipelines[i] = PipelineState{nullptr, AttributeLayout{}};
+            m_FreePipelines.push_back(PIPELINE);
+            if (m_AppliedPipeline == PIPELINE) {
+                m_AppliedPipeline = NO_PIPELINE;
+            }
+        }
+
+        if (m_BoundProgram == &shader_program) {
+            m_BoundProgram = nullptr;
+        }
+        shader_program.m_Pipelines = nullptr;
+    }
+
+    auto PipelineCache::Pipeline(PipelineID pipeline) const -> const PipelineState&
+    {
+        ASSERT(pipeline < m_Pipelines.size());
+
+        return m_Pipelines[pipeline];
+    }
+
+    auto PipelineCache::Apply(PipelineID pipeline) -> bool
+    {
+        ASSERT(pipeline < m_Pipelines.size());
+
+        if (pipeline == m_AppliedPipeline) {
+            return true;
+        }
+
+        const auto& state = m_Pipelines[pipeline];
+        bool success = true;
+        if (state.ShaderProgram() != m_BoundProgram) {
+            if (m_BoundProgram != nullptr) {
+                success = m_BoundProgram->Unbind() && success;
+            }
+            m_BoundProgram = state.ShaderProgram();
+            if (m_BoundProgram != nullptr) {
+                success = m_BoundProgram->Bind() && success;
+            }
+        }
+
+        // Pipelines often differ only in their program, the render state is left alone then
+        if (!m_StateApplied || state.State() != m_AppliedState) {
+            success = m_RendererAPI.SetRenderState(state.State()) && success;
+            m_AppliedState = state.State();
+            m_StateApplied = true;
+        }
+
+        m_AppliedPipeline = pipeline;
+        return success;
+    }
+
+    void PipelineCache::Release()
+    {
+        if (m_BoundProgram != nullptr) {
+            m_BoundProgram->Unbind();
+            m_BoundProgram = nullptr;
+        }
+        m_AppliedPipeline = NO_PIPELINE;
+    }
+
+}  // namespace JE
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+
+#include "Graphics/RenderState.hpp"
+#include "Graphics/Renderer.hpp"
+#include "Memory.hpp"
+
+namespace JE
+{
+
+    /// Everything a draw binds besides its geometry and textures, immutable once created so equal states can share
+    /// one PipelineID
+    class PipelineState
+    {
+      public:
+        PipelineState(IShaderProgram* shader_program, AttributeLayout vertex_layout, const RenderState& state = {});
+
+        inline auto ShaderProgram() const -> IShaderProgram* { return m_ShaderProgram; }
+        inline auto VertexLayout() const -> const AttributeLayout& { return m_VertexLayout; }
+        inline auto State() const -> const RenderState& { return m_State; }
+        inline auto Hash() const -> std::size_t { return m_Hash; }
+
+        auto operator==(const PipelineState& other) const -> bool;
+
+      private:
+        IShaderProgram* m_ShaderProgram;
+        AttributeLayout m_VertexLayout;
+        RenderState m_State;
+        std::size_t m_Hash;
+    };
+
+    /// Deduplicates pipeline states and applies them by diffing against the last applied one, consecutive draws with
+    /// the same pipeline don't touch the backend at all. State changed directly through RendererAPI is not tracked.
+    /// Every IRendererAPI owns one, see IRendererAPI::Pipelines
+    class PipelineCache
+    {
+      public:
+        PipelineCache(const PipelineCache& other) = delete;
+        PipelineCache(PipelineCache&& other) = delete;
+        auto operator=(const PipelineCache& other) -> PipelineCache& = delete;
+        auto operator=(PipelineCache&& other) -> PipelineCache& = delete;
+
+        explicit PipelineCache(IRendererAPI& renderer_api);
+        ~PipelineCache();
+
+        /// Returns the ID of an equal state if there is one, IDs stay valid until their shader program is destroyed
+        auto Create(const PipelineState& state) -> PipelineID;
+        /// Frees the IDs of every pipeline using the program, called when it is destroyed
+        void Evict(IShaderProgram& shader_program);
+        auto Pipeline(PipelineID pipeline) const -> const PipelineState&;
+        inline auto Size() const -> std::size_t { return m_Pipelines.size(); }
+
+        /// Binds the shader program and sets the render state of the pipeline where they differ from the applied one
+        auto Apply(PipelineID pipeline) -> bool;
+        /// Unbinds the shader program, the render state stays applied until the next pipeline changes it
+        void Release();
+
+      private:
+        static constexpr PipelineID NO_PIPELINE = std::numeric_limits<PipelineID>::max();
+
+        IRendererAPI& m_RendererAPI;
+        Vector<PipelineState> m_Pipelines;
+        std::unordered_multimap<std::size_t, PipelineID> m_Lookup;
+        /// Slots of evicted pipelines, reused before the cache grows
+        Vector<PipelineID> m_FreePipelines;
+
+        PipelineID m_AppliedPipeline = NO_PIPELINE;
+        IShaderProgram* m_BoundProgram = nullptr;
+        /// Nothing is known about the backend state before the first Apply
+        bool m_StateApplied = false;
+        RenderState m_AppliedState;
+    };
+
+}  // namespace JE
@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "RenderGraph.hpp"
+
+#include "Assert.hpp"
+#include "Logger.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        constexpr std::size_t DEPTH_STENCIL_BYTES = 4;
+
+        auto DescriptionsMatch(const FramebufferDescription& lhs, const FramebufferDescription& rhs) -> bool
+        {
+            return lhs.Size.X == rhs.Size.X && lhs.Size.Y == rhs.Size.Y && lhs.ColorFormats == rhs.ColorFormats
+                   && lhs.DepthStencil == rhs.DepthStencil;
+        }
+
+        auto FramebufferByteSize(const FramebufferDescription& description) -> std::size_t
+        {
+            const auto PIXELS =
+                static_cast<std::size_t>(description.Size.X) * static_cast<std::size_t>(description.Size.Y);
+
+            std::size_t bytes = description.DepthStencil ? PIXELS * DEPTH_STENCIL_BYTES : 0;
+            for (const auto FORMAT : description.ColorFormats) {
+                const auto INFO = GetTextureFormatInfo(FORMAT);
+                bytes += PIXELS / (INFO.BlockWidth * INFO.BlockHeight) * INFO.BlockBytes;
+            }
+            return bytes;
+        }
+
+    }  // namespace
+
+    // cppcheck-suppress unusedFunction
+    void RenderPassBuilder::Read(RenderGraphResource resource)
+    {
+        ASSERT(resource.Index < m_Graph.m_Resources.size());
+        m_Graph.m_Passes[m_PassIndex].Reads.push_back(resource.Index);
+    }
+
+    // cppcheck-suppress unusedFunction
+    void RenderPassBuilder::Write(RenderGraphResource resource)
+    {
+        ASSERT(resource.Index < m_Graph.m_Resources.size());
+        m_Graph.m_Passes[m_PassIndex].Writes.push_back(resource.Index);
+        m_Graph.m_Resources[resource.Index].Writers.push_back(m_PassIndex);
+    }
+
+    // cppcheck-suppress unusedFunction
+    void RenderPassBuilder::SetSideEffect() { m_Graph.m_Passes[m_PassIndex].SideEffect = true; }
+
+    // cppcheck-suppress unusedFunction
+    auto RenderPassContext::Target(RenderGraphResource resource) const -> IRenderTarget&
+    {
+        ASSERT(resource.Index < m_Graph.m_Resources.size());
+
+        const auto& node = m_Graph.m_Resources[resource.Index];
+        if (node.Imported != nullptr) {
+            return *node.Imported;
+        }
+
+        ASSERT(node.Framebuffer.has_value());
+        return *m_Graph.m_FramebufferPool[*node.Framebuffer].Framebuffer;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto RenderPassContext::Texture(RenderGraphResource resource, std::size_t attachment) const -> ITexture2D&
+    {
+        ASSERT(resource.Index < m_Graph.m_Resources.size());
+
+        const auto& node = m_Graph.m_Resources[resource.Index];
+        ASSERT(node.Framebuffer.has_value());
+
+        const auto& framebuffer = *m_Graph.m_FramebufferPool[*node.Framebuffer].Framebuffer;
+        ASSERT(attachment < framebuffer.ColorAttachmentCount());
+        return *framebuffer.ColorAttachment(attachment);
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto RenderGraph::CreateTransient(std::string_view name, const FramebufferDescription& description)
+        -> RenderGraphResource
+    {
+        m_Resources.push_back({std::string{name}, description, nullptr, {}, std::nullopt});
+        return {static_cast<std::uint32_t>(m_Resources.size() - 1)};
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto RenderGraph::Import(std::string_view name, IRenderTarget& target) -> RenderGraphResource
+    {
+        m_Resources.push_back({std::string{name}, {}, &target, {}, std::nullopt});
+        return {static_cast<std::uint32_t>(m_Resources.size() - 1)};
+    }
+
+    // cppcheck-suppress unusedFunction
+    void RenderGraph::AddPass(std::string_view name, const SetupFunction& setup, ExecuteFunction execute)
+    {
+        m_Passes.push_back({std::string{name}, std::move(execute), {}, {}, false});
+
+        RenderPassBuilder builder{*this, m_Passes.size() - 1};
+        setup(builder);
+    }
+
+    auto RenderGraph::Dependencies(std::size_t pass_index) const -> Vector<std::size_t>
+    {
+        Vector<std::size_t> dependencies;
+
+        const auto& pass = m_Passes[pass_index];
+        for (const auto RESOURCE : pass.Reads) {
+            for (const auto WRITER : m_Resources[RESOURCE].Writers) {
+                // Imported targets are written in submission order, only earlier writes are visible
+                if (WRITER != pass_index && (m_Resources[RESOURCE].Imported == nullptr || WRITER < pass_index)) {
+                    dependencies.push_back(WRITER);
+                }
+            }
+        }
+
+        // Writes to the same imported target keep their submission order
+        for (const auto RESOURCE : pass.Writes) {
+            if (m_Resources[RESOURCE].Imported == nullptr) {
+                continue;
+            }
+            for (const auto WRITER : m_Resources[RESOURCE].Writers) {
+                if (WRITER < pass_index) {
+                    dependencies.push_back(WRITER);
+                }
+            }
+        }
+
+        return dependencies;
+    }
+
+    auto RenderGraph::CullPasses() const -> Vector<bool>
+    {
+        Vector<bool> live(m_Passes.size(), false);
+        Vector<std::size_t> stack;
+
+        const auto IS_IMPORTED = [this](std::uint32_t resource) { return m_Resources[resource].Imported != nullptr; };
+
+        // Passes with visible results are the roots, everything they transitively depend on is kept
+        for (std::size_t i = 0; i < m_Passes.size(); ++i) {
+            const auto WRITES_IMPORTED = std::ranges::any_of(m_Passes[i].Writes, IS_IMPORTED);
+            if (m_Passes[i].SideEffect || WRITES_IMPORTED) {
+                live[i] = true;
+                stack.push_back(i);
+            }
+        }
+
+        while (!stack.empty()) {
+            const auto PASS = stack.back();
+            stack.pop_back();
+            for (const auto DEPENDENCY : Dependencies(PASS)) {
+                if (!live[DEPENDENCY]) {
+                    live[DEPENDENCY] = true;
+                    stack.push_back(DEPENDENCY);
+                }
+            }
+        }
+
+        return live;
+    }
+
+    auto RenderGraph::SortPasses(const Vector<bool>& live) -> bool
+    {
+        // Kahn's algorithm, among the passes that are ready the one added first runs first
+        Vector<Vector<std::size_t>> dependents(m_Passes.size());
+        Vector<std::size_t> pending_dependencies(m_Passes.size(), 0);
+        for (std::size_t i = 0; i < m_Passes.size(); ++i) {
+            if (!live[i]) {
+                continue;
+            }
+            for (const auto DEPENDENCY : Dependencies(i)) {
+                dependents[DEPENDENCY].push_back(i);
+                ++pending_dependencies[i];
+            }
+        }
+
+        Vector<bool> scheduled(m_Passes.size(), false);
+        const auto LIVE_COUNT = static_cast<std::size_t>(std::ranges::count(live, true));
+        while (m_ExecutionOrder.size() < LIVE_COUNT) {
+            std::optional<std::size_t> next;
+            for (std::size_t i = 0; i < m_Passes.size() && !next; ++i) {
+                if (live[i] && !scheduled[i] && pending_dependencies[i] == 0) {
+                    next = i;
+                }
+            }
+
+            if (!next) {
+                EngineLogger()->error("Render graph has a cycle, {} of {} passes could not be ordered",
+                                      LIVE_COUNT - m_ExecutionOrder.size(),
+                                      LIVE_COUNT);
+                return false;
+            }
+
+            scheduled[*next] = true;
+            m_ExecutionOrder.push_back(*next);
+            for (const auto DEPENDENT : dependents[*next]) {
+                --pending_dependencies[DEPENDENT];
+            }
+        }
+
+        return true;
+    }
+
+    void RenderGraph::AssignFramebuffers()
+    {
+        struct Lifetime
+        {
+            std::uint32_t Resource = 0;
+            std::size_t First = 0;
+            std::size_t Last = 0;
+        };
+
+        Vector<std::optional<Lifetime>> resource_lifetimes(m_Resources.size());
+        for (std::size_t position = 0; position < m_ExecutionOrder.size(); ++position) {
+            const auto& pass = m_Passes[m_ExecutionOrder[position]];
+            for (const auto& resources : {std::cref(pass.Reads), std::cref(pass.Writes)}) {
+                for (const auto RESOURCE : resources.get()) {
+                    if (m_Resources[RESOURCE].Imported != nullptr) {
+                        continue;
+                    }
+                    auto& lifetime = resource_lifetimes[RESOURCE];
+                    if (!lifetime) {
+                        lifetime = Lifetime{RESOURCE, position, position};
+                    }
+                    lifetime->Last = position;
+                }
+            }
+        }
+
+        Vector<Lifetime> lifetimes;
+        for (const auto& lifetime : resource_lifetimes) {
+            if (lifetime) {
+                lifetimes.push_back(*lifetime);
+            }
+        }
+        std::ranges::stable_sort(lifetimes, {}, &Lifetime::First);
+
+        for (auto& pooled : m_FramebufferPool) {
+            pooled.BusyUntil.reset();
+        }
+
+        // Resources are visited in the order they come alive, a pooled framebuffer is reused once the previous
+        // resource assigned to it is dead
+        m_TransientBytes = 0;
+        for (const auto& lifetime : lifetimes) {
+            auto& resource = m_Resources[lifetime.Resource];
+            m_TransientBytes += FramebufferByteSize(resource.Description);
+
+            const auto AVAILABLE = [&](const PooledFramebuffer& pooled)
+            {
+                return (!pooled.BusyUntil || *pooled.BusyUntil < lifetime.First)
+                       && DescriptionsMatch(pooled.Framebuffer->Description(), resource.Description);
+            };
+            auto pooled = std::ranges::find_if(m_FramebufferPool, AVAILABLE);
+            if (pooled == m_FramebufferPool.end()) {
+                m_FramebufferPool.push_back({CreateFramebuffer(resource.Description), std::nullopt});
+                pooled = std::prev(m_FramebufferPool.end());
+            }
+
+            pooled->BusyUntil = lifetime.Last;
+            resource.Framebuffer = static_cast<std::size_t>(std::distance(m_FramebufferPool.begin(), pooled));
+        }
+
+        // Framebuffers the graph no longer needs are released, resources refer to the pool by index
+        Vector<std::size_t> remap(m_FramebufferPool.size());
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < m_FramebufferPool.size(); ++i) {
+            if (m_FramebufferPool[i].BusyUntil) {
+                remap[i] = kept;
+                m_FramebufferPool[kept++] = std::move(m_FramebufferPool[i]);
+            } else {
+                m_ReleasedFramebuffers.push_back(std::move(m_FramebufferPool[i].Framebuffer));
+            }
+        }
+        m_FramebufferPool.resize(kept);
+
+        m_AllocatedBytes = 0;
+        for (const auto& pooled : m_FramebufferPool) {
+            m_AllocatedBytes += FramebufferByteSize(pooled.Framebuffer->Description());
+        }
+        for (auto& resource : m_Resources) {
+            if (resource.Framebuffer) {
+                resource.Framebuffer = remap[*resource.Framebuffer];
+            }
+        }
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto RenderGraph::Compile() -> bool
+    {
+        m_ExecutionOrder.clear();
+        for (auto& resource : m_Resources) {
+            resource.Framebuffer.reset();
+        }
+
+        for (const auto& resource : m_Resources) {
+            if (resource.Imported == nullptr && resource.Writers.size() > 1) {
+                EngineLogger()->error("Transient render graph resource {} is written by {} passes",
+                                      resource.Name,
+                                      resource.Writers.size());
+                return false;
+            }
+        }
+
+        const auto LIVE = CullPasses();
+        for (std::size_t i = 0; i < m_Passes.size(); ++i) {
+            if (!LIVE[i]) {
+                continue;
+            }
+            for (const auto RESOURCE : m_Passes[i].Reads) {
+                const auto& resource = m_Resources[RESOURCE];
+                if (resource.Imported == nullptr && resource.Writers.empty()) {
+                    EngineLogger()->error("Render pass {} reads {} which no pass writes",
+                                          m_Passes[i].Name,
+                                          resource.Name);
+                    return false;
+                }
+            }
+        }
+
+        if (!SortPasses(LIVE)) {
+            m_ExecutionOrder.clear();
+            return false;
+        }
+
+        AssignFramebuffers();
+        return true;
+    }
+
+    // cppcheck-suppress unusedFunction
+    void RenderGraph::Execute()
+    {
+        const RenderPassContext CONTEXT{*this};
+        for (const auto PASS : m_ExecutionOrder) {
+            m_Passes[PASS].Execute(CONTEXT);
+        }
+    }
+
+    // cppcheck-suppress unusedFunction
+    void RenderGraph::Reset()
+    {
+        m_Resources.clear();
+        m_Passes.clear();
+        m_ExecutionOrder.clear();
+        m_ReleasedFramebuffers.clear();
+    }
+
+}  // namespace JE
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Memory.hpp"
+#include "Renderer.hpp"
+#include "Texture.hpp"
+
+namespace JE
+{
+
+    struct RenderGraphResource
+    {
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t Index = INVALID_INDEX;
+
+        inline auto Valid() const -> bool { return Index != INVALID_INDEX; }
+    };
+
+    class RenderGraph;
+
+    /// Declares what a pass reads and writes while it is added to the graph
+    class RenderPassBuilder
+    {
+        friend class RenderGraph;
+
+      public:
+        void Read(RenderGraphResource resource);
+        /// A transient resource has exactly one writer, imported resources are written in the order passes were added
+        void Write(RenderGraphResource resource);
+        /// Keeps the pass even if nothing reads what it writes (e.g. readbacks)
+        void SetSideEffect();
+
+      private:
+        RenderPassBuilder(RenderGraph& graph, std::size_t pass_index)
+            : m_Graph(graph)
+            , m_PassIndex(pass_index)
+        {
+        }
+
+        RenderGraph& m_Graph;
+        std::size_t m_PassIndex;
+    };
+
+    /// Resolves resources to the targets they were assigned to while a pass executes
+    class RenderPassContext
+    {
+        friend class RenderGraph;
+
+      public:
+        auto Target(RenderGraphResource resource) const -> IRenderTarget&;
+        /// Color attachment of a transient resource, e.g. to sample what an earlier pass rendered
+        auto Texture(RenderGraphResource resource, std::size_t attachment = 0) const -> ITexture2D&;
+
+      private:
+        explicit RenderPassContext(const RenderGraph& graph)
+            : m_Graph(graph)
+        {
+        }
+
+        const RenderGraph& m_Graph;
+    };
+
+    /// Frame graph of render passes, passes can be added in any order and are executed after the passes writing the
+    /// resources they read, passes that nothing depends on are culled and transient framebuffers whose lifetimes don't
+    /// overlap share the same memory
+    class RenderGraph
+    {
+        friend class RenderPassBuilder;
+        friend class RenderPassContext;
+
+      public:
+        using SetupFunction = std::function<void(RenderPassBuilder&)>;
+        using ExecuteFunction = std::function<void(const RenderPassContext&)>;
+
+        auto CreateTransient(std::string_view name, const FramebufferDescription& description) -> RenderGraphResource;
+        /// Targets living outside the graph (e.g. the window), passes writing them are never culled
+        auto Import(std::string_view name, IRenderTarget& target) -> RenderGraphResource;
+
+        void AddPass(std::string_view name, const SetupFunction& setup, ExecuteFunction execute);
+
+        /// Culls, orders and assigns framebuffers to the passes added since the last Reset. Framebuffers the graph no
+        /// longer needs are kept until Reset, commands recorded by an earlier Execute of this frame may still use them
+        /// \returns false if the graph has a cycle or a transient resource is read without being written
+        auto Compile() -> bool;
+
+        /// Runs the passes in their compiled order, they record into the Renderer like any other draw code
+        void Execute();
+
+        /// Removes every pass and resource, pooled framebuffers are kept for the next frame's graph. The commands
+        /// recorded by Execute have to have run, the framebuffers released by Compile are destroyed
+        void Reset();
+
+        inline auto PassCount() const -> std::size_t { return m_Passes.size(); }
+        inline auto CulledPassCount() const -> std::size_t { return m_Passes.size() - m_ExecutionOrder.size(); }
+        /// Pass indices in the order they are executed
+        inline auto ExecutionOrder() const -> const Vector<std::size_t>& { return m_ExecutionOrder; }
+        inline auto PassName(std::size_t index) const -> std::string_view { return m_Passes[index].Name; }
+
+        inline auto FramebufferCount() const -> std::size_t { return m_FramebufferPool.size(); }
+        /// Bytes the transient resources of the compiled graph would take without aliasing
+        inline auto TransientBytes() const -> std::size_t { return m_TransientBytes; }
+        /// Bytes of the framebuffers actually allocated for them
+        inline auto AllocatedBytes() const -> std::size_t { return m_AllocatedBytes; }
+
+      private:
+        struct ResourceNode
+        {
+            std::string Name;
+            FramebufferDescription Description;
+            IRenderTarget* Imported = nullptr;
+            Vector<std::size_t> Writers;
+            std::optional<std::size_t> Framebuffer;
+        };
+
+        struct PassNode
+        {
+            std::string Name;
+            ExecuteFunction Execute;
+            Vector<std::uint32_t> Reads;
+            Vector<std::uint32_t> Writes;
+            bool SideEffect = false;
+        };
+
+        struct PooledFramebuffer
+        {
+            Scope<IFramebuffer> Framebuffer;
+            /// Execution position of the last pass using the framebuffer in the compiled graph
+            std::optional<std::size_t> BusyUntil;
+        };
+
+        /// Passes that have to run before the pass, the writers of everything it reads
+        auto Dependencies(std::size_t pass_index) const -> Vector<std::size_t>;
+        auto CullPasses() const -> Vector<bool>;
+        auto SortPasses(const Vector<bool>& live) -> bool;
+        void AssignFramebuffers();
+
+        Vector<ResourceNode> m_Resources;
+        Vector<PassNode> m_Passes;
+        Vector<std::size_t> m_ExecutionOrder;
+
+        Vector<PooledFramebuffer> m_FramebufferPool;
+        Vector<Scope<IFramebuffer>> m_ReleasedFramebuffers;
+        std::size_t m_TransientBytes = 0;
+        std::size_t m_AllocatedBytes = 0;
+    };
+
+}  // namespace JE
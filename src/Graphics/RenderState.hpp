@@ -0,0 +1,87 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+
+namespace JE
+{
+
+    enum class BlendFactor : std::uint8_t
+    {
+        ZERO,
+        ONE,
+        SOURCE_ALPHA,
+        ONE_MINUS_SOURCE_ALPHA,
+        DESTINATION_ALPHA,
+        ONE_MINUS_DESTINATION_ALPHA
+    };
+
+    enum class CompareFunction : std::uint8_t
+    {
+        NEVER,
+        LESS,
+        LESS_EQUAL,
+        EQUAL,
+        NOT_EQUAL,
+        GREATER_EQUAL,
+        GREATER,
+        ALWAYS
+    };
+
+    enum class CullMode : std::uint8_t
+    {
+        NONE,
+        FRONT,
+        BACK
+    };
+
+    struct BlendState
+    {
+        bool Enabled = false;
+        BlendFactor Source = BlendFactor::ONE;
+        BlendFactor Destination = BlendFactor::ZERO;
+
+        auto operator<=>(const BlendState& other) const = default;
+    };
+
+    struct DepthStencilState
+    {
+        bool DepthTest = false;
+        bool DepthWrite = true;
+        CompareFunction DepthCompare = CompareFunction::LESS;
+
+        bool StencilTest = false;
+        CompareFunction StencilCompare = CompareFunction::ALWAYS;
+        std::uint8_t StencilReference = 0;
+        /// Fragments passing the stencil and depth test write the reference value
+        bool StencilWrite = false;
+
+        auto operator<=>(const DepthStencilState& other) const = default;
+    };
+
+    struct RasterizerState
+    {
+        CullMode Cull = CullMode::NONE;
+        bool FrontCounterClockwise = true;
+
+        auto operator<=>(const RasterizerState& other) const = default;
+    };
+
+    /// Fixed function state of a draw, the defaults match the initial OpenGL state
+    struct RenderState
+    {
+        BlendState Blend;
+        DepthStencilState DepthStencil;
+        RasterizerState Rasterizer;
+
+        auto operator<=>(const RenderState& other) const = default;
+    };
+
+    inline constexpr BlendState ALPHA_BLENDING{true, BlendFactor::SOURCE_ALPHA, BlendFactor::ONE_MINUS_SOURCE_ALPHA};
+
+    /// Compact reference to a pipeline state in the PipelineCache
+    using PipelineID = std::uint32_t;
+    /// Draws without a shader program in the default render state
+    inline constexpr PipelineID DEFAULT_PIPELINE = 0;
+
+}  // namespace JE
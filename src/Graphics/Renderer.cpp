@@ -1,28 +1,88 @@
+#include <algorithm>
+#include <array>
 #include <cstdint>
 
 #include "Renderer.hpp"
 
 #include "Assert.hpp"
+#include "FrameCapture.hpp"
+#include "GeometryPool.hpp"
 #include "IRendererAPI.hpp"
-#include "OpenGLRenderer.hpp"
+#include "PipelineState.hpp"
 
 namespace JE
 {
 
+    namespace
+    {
+
+        constexpr auto QUAD_VERTEX_SOURCE = R"(
+            #version 330 core
+            layout (location = 0) in vec3 a_VertexPos;
+            layout (location = 1) in vec2 a_TexCoord;
+            layout (location = 2) in vec4 a_Color;
+            out vec2 v_TexCoord;
+            out vec4 v_Color;
+            void main()
+            {
+                v_TexCoord = a_TexCoord;
+                v_Color = a_Color;
+                gl_Position = vec4(a_VertexPos, 1.0);
+            }
+            )";
+
+        constexpr auto QUAD_FRAGMENT_SOURCE = R"(
+            #version 330 core
+            in vec2 v_TexCoord;
+            in vec4 v_Color;
+            uniform sampler2D u_Texture;
+            out vec4 out_FragColor;
+            void main()
+            {
+                out_FragColor = texture(u_Texture, v_TexCoord) * v_Color;
+            }
+            )";
+
+    }  // namespace
+
     auto CreateVertexBuffer(const AttributeLayout& layout) -> Scope<IVertexBuffer>
     {
-        return CreateScope<OpenGLVertexBuffer>(layout);
+        return RendererAPI().CreateVertexBuffer(layout);
     }
 
-    auto CreateElementBuffer() -> Scope<IElementBuffer> { return CreateScope<OpenGLElementBuffer>(); }
+    auto CreateElementBuffer() -> Scope<IElementBuffer> { return RendererAPI().CreateElementBuffer(); }
 
-    auto CreateVertexArray() -> Scope<IVertexArray> { return CreateScope<OpenGLVertexArray>(); }
+    auto CreateVertexArray() -> Scope<IVertexArray> { return RendererAPI().CreateVertexArray(); }
+
+    // cppcheck-suppress unusedFunction
+    auto CreateFramebuffer(const FramebufferDescription& description) -> Scope<IFramebuffer>
+    {
+        return RendererAPI().CreateFramebuffer(description);
+    }
 
     // cppcheck-suppress unusedFunction
     auto CreateShader(std::string_view debug_name, std::string_view vertex_source, std::string_view fragment_source)
         -> Scope<IShaderProgram>
     {
-        return CreateScope<OpenGLShaderProgram>(debug_name, vertex_source, fragment_source);
+        auto shader_program = RendererAPI().CreateShader(debug_name, vertex_source, fragment_source);
+        shader_program->RetainSources(vertex_source, fragment_source);
+        return shader_program;
+    }
+
+    IShaderProgram::~IShaderProgram()
+    {
+        if (m_Pipelines != nullptr) {
+            m_Pipelines->Evict(*this);
+        }
+    }
+
+    void Mesh::UploadMesh()
+    {
+        m_Bounds = ComputeBounds(m_Vertices);
+        m_LODs = {MeshLOD{0, static_cast<std::uint32_t>(m_Indices.size()), 0}};
+
+        auto& pool = MeshGeometryPool();
+        m_Geometry = PooledGeometry{pool, pool.Allocate(std::as_bytes(std::span{m_Vertices}), m_Indices)};
     }
 
     // class RendererMesh
@@ -103,15 +163,19 @@ namespace JE
     //     "}\n\0";
 
     // cppcheck-suppress unusedFunction
-    void Renderer::Begin(IRenderTarget* target, [[maybe_unused]] const RGBA& color)
+    void Renderer::Begin(IRenderTarget* target, const RGBA& color)
     {
         ASSERT(target != nullptr);
         ASSERT(m_CurrentRenderTarget == nullptr);
 
         m_CurrentRenderTarget = target;
+        if (m_FrameCapture != nullptr) {
+            m_FrameCapture->RecordBegin(color);
+        }
 
+        // The command runs after Begin returned, the color has to be copied
         SubmitRenderCommand(
-            [target, &color]() -> bool
+            [target, color]() -> bool
             {
                 target->Bind();
                 RendererAPI().SetClearColor(color);
@@ -125,59 +189,353 @@ namespace JE
     {
         ASSERT(m_CurrentRenderTarget != nullptr);
 
+        FlushPendingDraws();
+
         SubmitRenderCommand(
             [target = m_CurrentRenderTarget]()
             {
                 target->Unbind();
                 return true;
             });
+        if (m_FrameCapture != nullptr) {
+            m_FrameCapture->RecordEnd();
+        }
 
         m_CurrentRenderTarget = nullptr;
     }
 
     // cppcheck-suppress unusedFunction
-    void Renderer::DrawMesh(Mesh& mesh)
+    void Renderer::SetViewProjection(const glm::mat4& view_projection)
     {
-        ASSERT(!mesh.Vertices().empty());
-        ASSERT(!mesh.Indices().empty());
+        // Meshes submitted so far were meant for the previous camera
+        FlushPendingDraws();
 
-        SubmitRenderCommand(
-            [&mesh]()
-            {
-                mesh.VAO().Bind();
-                const bool SUCCESS = RendererAPI().DrawIndexed(IRendererAPI::Primitive::TRIANGLES,
-                                                               static_cast<std::uint32_t>(mesh.Indices().size()),
-                                                               IRendererAPI::Type::UNSIGNED_INT);
-                mesh.VAO().Unbind();
-                return SUCCESS;
-            });
+        m_ViewProjection = view_projection;
+        m_Frustum = Frustum{view_projection};
     }
 
+    // cppcheck-suppress unusedFunction
+    void Renderer::DrawMesh(Mesh& mesh) { SubmitMesh(mesh, DEFAULT_PIPELINE); }
+
     // cppcheck-suppress unusedFunction
     void Renderer::DrawMesh(Mesh& mesh, IShaderProgram& shader_program)
     {
+        ASSERT(shader_program.Valid());
+        SubmitMesh(mesh, RendererAPI().Pipelines().Create(PipelineState{&shader_program, MeshGeometryPool().Layout()}));
+    }
+
+    // cppcheck-suppress unusedFunction
+    void Renderer::DrawMesh(Mesh& mesh, PipelineID pipeline)
+    {
+        ASSERT(pipeline < RendererAPI().Pipelines().Size());
+        SubmitMesh(mesh, pipeline);
+    }
+
+    // cppcheck-suppress unusedFunction
+    void Renderer::DrawStaticMeshes(const StaticMeshBVH& meshes) { DrawStaticMeshes(meshes, DEFAULT_PIPELINE); }
+
+    // cppcheck-suppress unusedFunction
+    void Renderer::DrawStaticMeshes(const StaticMeshBVH& meshes, IShaderProgram& shader_program)
+    {
+        ASSERT(shader_program.Valid());
+        DrawStaticMeshes(meshes,
+                         RendererAPI().Pipelines().Create(PipelineState{&shader_program, MeshGeometryPool().Layout()}));
+    }
+
+    void Renderer::DrawStaticMeshes(const StaticMeshBVH& meshes, PipelineID pipeline)
+    {
+        ASSERT(m_CurrentRenderTarget != nullptr);
+        ASSERT(pipeline < RendererAPI().Pipelines().Size());
+
+        FlushPendingDraws();
+
+        // The BVH already culled against the frustum, draw the meshes directly
+        m_SubmittedMeshCount += meshes.Size();
+        std::size_t visible_count = 0;
+        meshes.Query(m_Frustum,
+                     [this, &visible_count, pipeline](Mesh* mesh)
+                     {
+                         ++visible_count;
+                         if (Occluded(*mesh)) {
+                             ++m_OccludedMeshCount;
+                             return;
+                         }
+                         AddMeshDraw(*mesh, pipeline);
+                     });
+        m_CulledMeshCount += meshes.Size() - visible_count;
+        FlushMeshDraws();
+    }
+
+    void Renderer::SubmitMesh(Mesh& mesh, PipelineID pipeline)
+    {
+        ASSERT(m_CurrentRenderTarget != nullptr);
         ASSERT(!mesh.Vertices().empty());
         ASSERT(!mesh.Indices().empty());
-        ASSERT(shader_program.Valid());
 
+        // Keep the submission order, quads drawn before the mesh are recorded first
+        FlushQuadSubmissions();
+
+        m_MeshSubmissions.push_back({&mesh, pipeline});
+        m_SubmissionBounds.Add(mesh.Bounds().Box);
+        ++m_SubmittedMeshCount;
+    }
+
+    void Renderer::AddMeshDraw(Mesh& mesh, PipelineID pipeline)
+    {
+        // Picked while recording, the command draws the level the mesh had in this frame
+        const auto LOD = mesh.SelectLOD(m_ViewProjection, m_LODSettings);
+        if (m_FrameCapture != nullptr) {
+            m_FrameCapture->RecordMesh(mesh, RendererAPI().Pipelines().Pipeline(pipeline).ShaderProgram(), LOD);
+        }
+        m_MeshDraws.push_back({&mesh, pipeline, LOD});
+    }
+
+    void Renderer::FlushMeshDraws()
+    {
+        const auto FIRST = m_MeshDrawStart;
+        const auto COUNT = m_MeshDraws.size() - FIRST;
+        if (COUNT == 0) {
+            return;
+        }
+
+        // Like the quads, the draws of a frame share storage that's cleared once the commands ran
+        m_MeshDrawStart = m_MeshDraws.size();
+        SubmitRenderCommand([this, FIRST, COUNT]()
+                            { return DrawMeshes(std::span{m_MeshDraws}.subspan(FIRST, COUNT)); });
+    }
+
+    auto Renderer::DrawMeshLOD(Mesh& mesh, PipelineID pipeline, const MeshLOD& lod) -> bool
+    {
+        const MeshDraw DRAW{&mesh, pipeline, lod};
+        return DrawMeshes({&DRAW, 1});
+    }
+
+    auto Renderer::DrawMeshes(std::span<const MeshDraw> draws) -> bool
+    {
+        auto& pipelines = RendererAPI().Pipelines();
+        IVertexArray* bound_vertex_array = nullptr;
+
+        bool success = true;
+        for (const auto& draw : draws) {
+            const auto& geometry = draw.Mesh->Geometry();
+            if (!geometry.Valid()) {
+                success = false;
+                continue;
+            }
+
+            // Applying the pipeline that is already applied does nothing
+            success = pipelines.Apply(draw.Pipeline) && success;
+
+            auto& vertex_array = geometry.VertexArray();
+            if (&vertex_array != bound_vertex_array) {
+                if (bound_vertex_array != nullptr) {
+                    bound_vertex_array->Unbind();
+                }
+                bound_vertex_array = &vertex_array;
+                bound_vertex_array->Bind();
+            }
+
+            const auto& range = geometry.Range();
+            success = RendererAPI().DrawIndexed(IRendererAPI::Primitive::TRIANGLES,
+                                                draw.LOD.IndexCount,
+                                                IRendererAPI::Type::UNSIGNED_INT,
+                                                range.FirstIndex + draw.LOD.FirstIndex,
+                                                range.BaseVertex)
+                && success;
+        }
+
+        if (bound_vertex_array != nullptr) {
+            bound_vertex_array->Unbind();
+        }
+        pipelines.Release();
+        return success;
+    }
+
+    void Renderer::FlushMeshSubmissions()
+    {
+        if (m_MeshSubmissions.empty()) {
+            return;
+        }
+
+        if (m_FrustumCulling) {
+            m_SubmissionVisibility.resize(m_MeshSubmissions.size());
+            const auto VISIBLE_COUNT = CullAABBs(m_Frustum, m_SubmissionBounds, m_SubmissionVisibility);
+            m_CulledMeshCount += m_MeshSubmissions.size() - VISIBLE_COUNT;
+        } else {
+            m_SubmissionVisibility.assign(m_MeshSubmissions.size(), 1);
+        }
+
+        for (std::size_t i = 0; i < m_MeshSubmissions.size(); ++i) {
+            if (m_SubmissionVisibility[i] == 0) {
+                continue;
+            }
+            if (Occluded(*m_MeshSubmissions[i].Mesh)) {
+                ++m_OccludedMeshCount;
+                continue;
+            }
+            AddMeshDraw(*m_MeshSubmissions[i].Mesh, m_MeshSubmissions[i].Pipeline);
+        }
+        FlushMeshDraws();
+
+        m_MeshSubmissions.clear();
+        m_SubmissionBounds.Clear();
+    }
+
+    // cppcheck-suppress unusedFunction
+    void Renderer::DrawQuad(const RGBA& color,
+                            const glm::vec2& position,
+                            const glm::vec3& rotation,
+                            const glm::vec3& scale)
+    {
+        DrawQuad(Sprite{}, color, position, rotation, scale);
+    }
+
+    // cppcheck-suppress unusedFunction
+    void Renderer::DrawQuad(const Sprite& sprite,
+                            const RGBA& color,
+                            const glm::vec2& position,
+                            const glm::vec3& rotation,
+                            const glm::vec3& scale)
+    {
+        ASSERT(m_CurrentRenderTarget != nullptr);
+
+        // Keep the submission order, meshes drawn before the quad are culled and recorded first
+        FlushMeshSubmissions();
+
+        // A batch samples a single texture, switching textures starts a new one
+        if (sprite.Texture != m_QuadTexture) {
+            FlushQuadSubmissions();
+            m_QuadTexture = sprite.Texture;
+        }
+
+        m_QuadTransforms.Add(glm::vec3{position.x, position.y, 0.f}, rotation.z, scale);
+
+        // Same corner order as BuildQuadCorners, texture rows start at the top of the quad
+        m_QuadTexCoords.emplace_back(sprite.UVMin.x, sprite.UVMin.y);
+        m_QuadTexCoords.emplace_back(sprite.UVMin.x, sprite.UVMax.y);
+        m_QuadTexCoords.emplace_back(sprite.UVMax.x, sprite.UVMax.y);
+        m_QuadTexCoords.emplace_back(sprite.UVMax.x, sprite.UVMin.y);
+        m_QuadColors.insert(m_QuadColors.end(), TransformBatch::QUAD_CORNER_COUNT, color.Color);
+    }
+
+    void Renderer::FlushQuadSubmissions()
+    {
+        if (m_QuadTransforms.Empty()) {
+            return;
+        }
+
+        // The batches of a frame are appended to the same storage, it's cleared once the commands ran
+        const auto FIRST = m_QuadBatchStart;
+        const auto COUNT = m_QuadTransforms.Size() * TransformBatch::QUAD_CORNER_COUNT;
+        m_QuadCorners.resize(FIRST + COUNT);
+        BuildQuadCorners(m_QuadTransforms, std::span{m_QuadCorners}.subspan(FIRST));
+        m_QuadTransforms.Clear();
+        m_QuadBatchStart = FIRST + COUNT;
+        if (m_FrameCapture != nullptr) {
+            m_FrameCapture->RecordQuads(std::span{m_QuadCorners}.subspan(FIRST),
+                                        std::span{m_QuadTexCoords}.subspan(FIRST),
+                                        std::span{m_QuadColors}.subspan(FIRST),
+                                        m_QuadTexture);
+        }
+
+        // Offsets instead of spans, the storage may still grow while the frame is recorded
         SubmitRenderCommand(
-            [&mesh, &shader_program]()
+            [this, FIRST, COUNT, texture = m_QuadTexture]()
             {
-                shader_program.Bind();
-                mesh.VAO().Bind();
-                const bool SUCCESS = RendererAPI().DrawIndexed(IRendererAPI::Primitive::TRIANGLES,
-                                                               static_cast<std::uint32_t>(mesh.Indices().size()),
-                                                               IRendererAPI::Type::UNSIGNED_INT);
-                mesh.VAO().Unbind();
-                shader_program.Unbind();
-                return SUCCESS;
+                return DrawQuadBatch(std::span{m_QuadCorners}.subspan(FIRST, COUNT),
+                                     std::span{m_QuadTexCoords}.subspan(FIRST, COUNT),
+                                     std::span{m_QuadColors}.subspan(FIRST, COUNT),
+                                     texture);
             });
     }
 
-// cppcheck-suppress unusedFunction
-void Renderer::DrawQuad(const RGBA& color, const glm::vec2& position, const glm::vec3& rotation, const glm::vec3& scale)
-{
-    SubmitRenderCommand([]() {});
-}
+    auto Renderer::DrawQuadBatch(std::span<const VertexType> corners,
+                                 std::span<const glm::vec2> tex_coords,
+                                 std::span<const glm::vec4> colors,
+                                 ITexture2D* texture) -> bool
+    {
+        ASSERT(corners.size() == tex_coords.size() && corners.size() == colors.size());
+
+        static constexpr std::array<IndexType, 6> QUAD_INDICES = {0, 1, 2, 2, 3, 0};
+
+        if (m_QuadVAO == nullptr) {
+            Vector<IndexType> indices;
+            indices.reserve(MAX_QUADS_PER_BATCH * QUAD_INDICES.size());
+            for (std::size_t quad = 0; quad < MAX_QUADS_PER_BATCH; ++quad) {
+                for (const auto INDEX : QUAD_INDICES) {
+                    indices.push_back(static_cast<IndexType>(quad * TransformBatch::QUAD_CORNER_COUNT) + INDEX);
+                }
+            }
+
+            auto index_buffer = CreateElementBuffer();
+            index_buffer->Bind();
+            index_buffer->SetData(std::as_bytes(std::span<const IndexType>{indices}));
+            index_buffer->Unbind();
+
+            const AttributeLayout POSITION_LAYOUT{
+                {AttributeLayout::Attribute{"a_VertexPos", IRendererAPI::Type::FLOAT, 3}}};
+            const AttributeLayout TEX_COORD_LAYOUT{
+                {AttributeLayout::Attribute{"a_TexCoord", IRendererAPI::Type::FLOAT, 2}}};
+            const AttributeLayout COLOR_LAYOUT{{AttributeLayout::Attribute{"a_Color", IRendererAPI::Type::FLOAT, 4}}};
+
+            m_QuadVAO = CreateVertexArray();
+            m_QuadVAO->AddBuffer(CreateVertexBuffer(POSITION_LAYOUT));
+            m_QuadVAO->AddBuffer(CreateVertexBuffer(TEX_COORD_LAYOUT));
+            m_QuadVAO->AddBuffer(CreateVertexBuffer(COLOR_LAYOUT));
+            m_QuadVAO->SetIndexBuffer(std::move(index_buffer));
+            m_QuadVAO->Build();
+
+            // Untextured quads sample a white texel, so every quad goes through the same program
+            static constexpr std::array<std::byte, 4> WHITE_TEXEL = {
+                std::byte{0xFF}, std::byte{0xFF}, std::byte{0xFF}, std::byte{0xFF}};
+            m_WhiteTexture = CreateTexture2D(TextureDescription{Size2D{1, 1}});
+            m_WhiteTexture->SetData(0, WHITE_TEXEL);
+
+            // Quads are drawn in the default render state, whatever the meshes before them set
+            m_QuadProgram = CreateShader(QUAD_SHADER_NAME, QUAD_VERTEX_SOURCE, QUAD_FRAGMENT_SOURCE);
+            ASSERT(m_QuadProgram->Valid());
+            m_QuadPipeline = RendererAPI().Pipelines().Create(PipelineState{m_QuadProgram.get(), POSITION_LAYOUT});
+        }
+
+        auto& vertex_buffer = *m_QuadVAO->Buffers()[0];
+        auto& tex_coord_buffer = *m_QuadVAO->Buffers()[1];
+        auto& color_buffer = *m_QuadVAO->Buffers()[2];
+
+        auto* sampled_texture = texture != nullptr ? texture : m_WhiteTexture.get();
+        sampled_texture->Bind(0);
+
+        bool success = RendererAPI().Pipelines().Apply(m_QuadPipeline);
+        const auto CHUNK_SIZE = MAX_QUADS_PER_BATCH * TransformBatch::QUAD_CORNER_COUNT;
+        for (std::size_t first = 0; first < corners.size(); first += CHUNK_SIZE) {
+            const auto CHUNK = corners.subspan(first, std::min(CHUNK_SIZE, corners.size() - first));
+
+            vertex_buffer.Bind();
+            vertex_buffer.SetData(std::as_bytes(CHUNK));
+            vertex_buffer.Unbind();
+
+            tex_coord_buffer.Bind();
+            tex_coord_buffer.SetData(std::as_bytes(tex_coords.subspan(first, CHUNK.size())));
+            tex_coord_buffer.Unbind();
+
+            color_buffer.Bind();
+            color_buffer.SetData(std::as_bytes(colors.subspan(first, CHUNK.size())));
+            color_buffer.Unbind();
+
+            m_QuadVAO->Bind();
+            const auto INDEX_COUNT = CHUNK.size() / TransformBatch::QUAD_CORNER_COUNT * QUAD_INDICES.size();
+            success = RendererAPI().DrawIndexed(IRendererAPI::Primitive::TRIANGLES,
+                                                static_cast<std::uint32_t>(INDEX_COUNT),
+                                                IRendererAPI::Type::UNSIGNED_INT,
+                                                0,
+                                                0)
+                && success;
+            m_QuadVAO->Unbind();
+        }
+
+        sampled_texture->Unbind(0);
+        RendererAPI().Pipelines().Release();
+
+        return success;
+    }
 
 }  // namespace JE
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <limits>
 #include <span>
 #include <string>
 #include <string_view>
@@ -13,9 +14,18 @@
 #include <glm/glm.hpp>
 
 #include "Assert.hpp"
+#include "BatchTransform.hpp"
+#include "BoundingVolumeHierarchy.hpp"
+#include "Culling.hpp"
 #include "IRendererAPI.hpp"
 #include "Logger.hpp"
 #include "Memory.hpp"
+#include "MeshLOD.hpp"
+#include "OcclusionCulling.hpp"
+#include "RenderState.hpp"
+#include "ResourceTracker.hpp"
+#include "Sprite.hpp"
+#include "Texture.hpp"
 
 namespace JE
 {
@@ -37,6 +47,53 @@ namespace JE
         virtual void Unbind() = 0;
     };
 
+    struct FramebufferDescription
+    {
+        Size2D Size;
+        Vector<TextureFormat> ColorFormats{TextureFormat::RGBA8};
+        bool DepthStencil = true;
+    };
+
+    /// Offscreen render target, the color attachments are regular textures so later passes can sample them
+    class IFramebuffer : public IRenderTarget
+    {
+      public:
+        IFramebuffer(const IFramebuffer& other) = delete;
+        IFramebuffer(IFramebuffer&& other) = delete;
+        auto operator=(const IFramebuffer& other) -> IFramebuffer& = delete;
+        auto operator=(IFramebuffer&& other) -> IFramebuffer& = delete;
+
+        explicit IFramebuffer(const FramebufferDescription& description)
+            : m_Description(description)
+        {
+            ASSERT(description.Size.X > 0 && description.Size.Y > 0);
+
+            for (const auto FORMAT : description.ColorFormats) {
+                m_ColorAttachments.push_back(CreateTexture2D({description.Size, FORMAT, 1}));
+            }
+        }
+        ~IFramebuffer() override = default;
+
+        inline auto ID() const -> IRendererAPI::FramebufferID { return m_FramebufferID; }
+        inline auto Description() const -> const FramebufferDescription& { return m_Description; }
+        inline auto Size() const -> const Size2D& { return m_Description.Size; }
+
+        inline auto ColorAttachmentCount() const -> std::size_t { return m_ColorAttachments.size(); }
+        inline auto ColorAttachment(std::size_t index) const -> const Ref<ITexture2D>&
+        {
+            return m_ColorAttachments[index];
+        }
+
+      protected:
+        IRendererAPI::FramebufferID m_FramebufferID = 0;
+        FramebufferDescription m_Description;
+        Vector<Ref<ITexture2D>> m_ColorAttachments;
+        /// The color attachments are tracked as textures, backends allocate the depth and stencil storage here
+        TrackedResource m_Resource{ResourceType::FRAMEBUFFER};
+    };
+
+    auto CreateFramebuffer(const FramebufferDescription& description) -> Scope<IFramebuffer>;
+
     class AttributeLayout
     {
       public:
@@ -107,13 +164,26 @@ namespace JE
 
         virtual auto SetData(std::span<const std::byte> data) -> bool = 0;
 
+        /// Replaces the storage with size bytes of undefined content, SetSubData and CopySubData fill it in place
+        virtual auto AllocateStorage(std::size_t size) -> bool = 0;
+        virtual auto SetSubData(std::size_t offset, std::span<const std::byte> data) -> bool = 0;
+        /// Copies between buffers without a round trip through the CPU where the backend allows it, neither has to
+        /// be bound
+        virtual auto CopySubData(const IVertexBuffer& source,
+                                 std::size_t source_offset,
+                                 std::size_t offset,
+                                 std::size_t size) -> bool = 0;
+        inline auto StorageSize() const -> std::size_t { return m_Resource.Bytes(); }
+
         inline auto Layout() const -> const AttributeLayout& { return m_Layout; }
 
-        virtual auto UploadLayout() -> bool = 0;
+        /// Attributes use consecutive locations starting at first_location
+        virtual auto UploadLayout(std::uint32_t first_location) -> bool = 0;
 
       protected:
         IRendererAPI::BufferID m_BufferID = 0;
         AttributeLayout m_Layout;
+        TrackedResource m_Resource{ResourceType::VERTEX_BUFFER};
     };
 
     auto CreateVertexBuffer(const AttributeLayout& layout) -> Scope<IVertexBuffer>;
@@ -137,8 +207,18 @@ namespace JE
 
         virtual auto SetData(std::span<const std::byte> data) -> bool = 0;
 
+        /// Same as the IVertexBuffer ones
+        virtual auto AllocateStorage(std::size_t size) -> bool = 0;
+        virtual auto SetSubData(std::size_t offset, std::span<const std::byte> data) -> bool = 0;
+        virtual auto CopySubData(const IElementBuffer& source,
+                                 std::size_t source_offset,
+                                 std::size_t offset,
+                                 std::size_t size) -> bool = 0;
+        inline auto StorageSize() const -> std::size_t { return m_Resource.Bytes(); }
+
       protected:
         IRendererAPI::BufferID m_BufferID = 0;
+        TrackedResource m_Resource{ResourceType::ELEMENT_BUFFER};
     };
 
     auto CreateElementBuffer() -> Scope<IElementBuffer>;
@@ -160,6 +240,7 @@ namespace JE
         inline void AddBuffer(Scope<IVertexBuffer> buffer) { m_VertexBuffers.emplace_back(std::move(buffer)); }
 
         inline void SetIndexBuffer(Scope<IElementBuffer> buffer) { m_IndexBuffer = std::move(buffer); }
+        inline auto IndexBuffer() -> IElementBuffer& { return *m_IndexBuffer; }
 
         virtual auto Build() -> bool = 0;
 
@@ -171,6 +252,7 @@ namespace JE
         IRendererAPI::BufferID m_VAOId = 0;
         Vector<Scope<IVertexBuffer>> m_VertexBuffers;
         Scope<IElementBuffer> m_IndexBuffer;
+        TrackedResource m_Resource{ResourceType::VERTEX_ARRAY};
     };
 
     auto CreateVertexArray() -> Scope<IVertexArray>;
@@ -178,6 +260,66 @@ namespace JE
     using VertexType = glm::tvec3<float>;
     using IndexType = std::uint32_t;
 
+    class GeometryPool;
+
+    /// Location of geometry inside a GeometryPool, the indices are relative to BaseVertex
+    struct GeometryRange
+    {
+        std::uint32_t FirstIndex = 0;
+        std::uint32_t IndexCount = 0;
+        std::int32_t BaseVertex = 0;
+        std::uint32_t VertexCount = 0;
+        std::uint32_t Page = 0;
+    };
+
+    using GeometryHandle = std::uint32_t;
+    constexpr GeometryHandle INVALID_GEOMETRY = std::numeric_limits<GeometryHandle>::max();
+
+    /// Owns a range of a GeometryPool and frees it when destroyed
+    class PooledGeometry
+    {
+      public:
+        PooledGeometry(const PooledGeometry& other) = delete;
+        auto operator=(const PooledGeometry& other) -> PooledGeometry& = delete;
+
+        PooledGeometry() = default;
+        PooledGeometry(GeometryPool& pool, GeometryHandle handle)
+            : m_Pool(&pool)
+            , m_Handle(handle)
+        {
+        }
+        PooledGeometry(PooledGeometry&& other) noexcept
+            : m_Pool(other.m_Pool)
+            , m_Handle(std::exchange(other.m_Handle, INVALID_GEOMETRY))
+        {
+        }
+        auto operator=(PooledGeometry&& other) noexcept -> PooledGeometry&
+        {
+            if (this != &other) {
+                Reset();
+                m_Pool = other.m_Pool;
+                m_Handle = std::exchange(other.m_Handle, INVALID_GEOMETRY);
+            }
+            return *this;
+        }
+        ~PooledGeometry() { Reset(); }
+
+        inline auto Valid() const -> bool { return m_Handle != INVALID_GEOMETRY; }
+        inline auto Handle() const -> GeometryHandle { return m_Handle; }
+
+        auto Range() const -> const GeometryRange&;
+        /// Vertex array of the pool page holding the range, shared with every other range of the page
+        auto VertexArray() const -> IVertexArray&;
+        /// Replaces the indices, the range moves inside the pool if they outgrow it
+        auto SetIndices(std::span<const IndexType> indices) -> bool;
+        void Reset();
+
+      private:
+        GeometryPool* m_Pool = nullptr;
+        GeometryHandle m_Handle = INVALID_GEOMETRY;
+    };
+
+    /// Geometry lives in the shared MeshGeometryPool(), meshes of one pool page are drawn from the same vertex array
     class Mesh
     {
       public:
@@ -198,35 +340,58 @@ namespace JE
         }
 
         inline auto Vertices() const -> const Vector<VertexType>& { return m_Vertices; }
-        inline auto Indices() const -> const Vector<IndexType>& { return m_Indices; }
-        inline auto VAO() -> IVertexArray& { return *m_VAO; }
+        /// Indices of the full detail level
+        inline auto Indices() const -> std::span<const IndexType> { return LODIndices(0); }
+        inline auto VAO() -> IVertexArray& { return m_Geometry.VertexArray(); }
+        /// Invalid if the pool couldn't fit the mesh, e.g. once a rejecting memory budget is exhausted
+        inline auto Geometry() const -> const PooledGeometry& { return m_Geometry; }
+        inline auto Bounds() const -> const MeshBounds& { return m_Bounds; }
+
+        /// Level 0 is the full detail mesh, every level indexes the same vertices
+        inline auto LODs() const -> std::span<const MeshLOD> { return m_LODs; }
+        /// Indices of every level, one after the other as they are stored in the pool
+        inline auto IndexData() const -> std::span<const IndexType> { return m_Indices; }
+        inline auto LODIndices(std::size_t lod) const -> std::span<const IndexType>
+        {
+            return std::span{m_Indices}.subspan(m_LODs[lod].FirstIndex, m_LODs[lod].IndexCount);
+        }
+        /// Level of the last selection, the next selection applies its hysteresis around it
+        inline auto CurrentLOD() const -> std::size_t { return m_CurrentLOD; }
 
-      private:
-        inline void UploadMesh()
+        inline auto SelectLOD(const glm::mat4& view_projection, const LODSettings& settings) -> MeshLOD
+        {
+            m_CurrentLOD = JE::SelectLOD(m_LODs, ScreenSize(m_Bounds.Sphere, view_projection), m_CurrentLOD, settings);
+            return m_LODs[m_CurrentLOD];
+        }
+
+        /// Replaces the coarser levels with lod_count levels simplified from the full detail mesh, all levels are
+        /// stored one after the other in the pool
+        inline void GenerateLODs(std::size_t lod_count, float reduction = 0.5f)
         {
-            auto vertex_buffer = CreateVertexBuffer(
-                AttributeLayout{{AttributeLayout::Attribute{"a_VertexPos", IRendererAPI::Type::FLOAT, 3}}});
-            auto index_buffer = CreateElementBuffer();
-
-            vertex_buffer->Bind();
-            vertex_buffer->SetData(
-                {reinterpret_cast<std::byte*>(m_Vertices.data()), m_Vertices.size() * sizeof(VertexType)});
-            vertex_buffer->Unbind();
-
-            index_buffer->Bind();
-            index_buffer->SetData(
-                {reinterpret_cast<std::byte*>(m_Indices.data()), m_Indices.size() * sizeof(IndexType)});
-            index_buffer->Unbind();
-
-            m_VAO = CreateVertexArray();
-            m_VAO->AddBuffer(std::move(vertex_buffer));
-            m_VAO->SetIndexBuffer(std::move(index_buffer));
-            m_VAO->Build();
+            m_LODs.resize(1);
+            m_Indices.resize(m_LODs.front().IndexCount);
+            m_CurrentLOD = 0;
+
+            for (auto& lod : JE::GenerateLODs(m_Vertices, m_Indices, lod_count, reduction)) {
+                m_LODs.push_back({static_cast<std::uint32_t>(m_Indices.size()),
+                                  static_cast<std::uint32_t>(lod.Indices.size()),
+                                  lod.Error});
+                m_Indices.insert(m_Indices.end(), lod.Indices.begin(), lod.Indices.end());
+            }
+            if (m_Geometry.Valid()) {
+                m_Geometry.SetIndices(m_Indices);
+            }
         }
 
+      private:
+        void UploadMesh();
+
         Vector<VertexType> m_Vertices;
         Vector<IndexType> m_Indices;
-        Scope<IVertexArray> m_VAO;
+        PooledGeometry m_Geometry;
+        MeshBounds m_Bounds;
+        Vector<MeshLOD> m_LODs;
+        std::size_t m_CurrentLOD = 0;
     };
 
     inline auto CreateTriangleMesh()
@@ -252,6 +417,8 @@ namespace JE
 
     class IShaderProgram
     {
+        friend class PipelineCache;
+
       public:
         IShaderProgram(const IShaderProgram& other) = delete;
         IShaderProgram(IShaderProgram&& other) = delete;
@@ -262,7 +429,8 @@ namespace JE
             : m_DebugName(debug_name)
         {
         }
-        virtual ~IShaderProgram() = default;
+        /// Evicts the pipelines using the program so a later program at the same address can't inherit them
+        virtual ~IShaderProgram();
 
         inline auto ID() const -> IRendererAPI::ProgramID { return m_ProgramID; }
 
@@ -272,41 +440,150 @@ namespace JE
 
         inline auto Valid() const -> bool { return m_Valid; }
 
+        inline auto DebugName() const -> std::string_view { return m_DebugName; }
+        /// Empty unless the program was created with CreateShader, frame captures store them
+        inline auto VertexSource() const -> std::string_view { return m_VertexSource; }
+        inline auto FragmentSource() const -> std::string_view { return m_FragmentSource; }
+        inline void RetainSources(std::string_view vertex_source, std::string_view fragment_source)
+        {
+            m_VertexSource = vertex_source;
+            m_FragmentSource = fragment_source;
+        }
+
       protected:
         std::string m_DebugName;
+        std::string m_VertexSource;
+        std::string m_FragmentSource;
         IRendererAPI::ProgramID m_ProgramID = 0;
         bool m_Valid = false;
+        TrackedResource m_Resource{ResourceType::SHADER_PROGRAM};
+
+      private:
+        /// Cache holding pipelines with this program, set by PipelineCache::Create
+        PipelineCache* m_Pipelines = nullptr;
     };
 
     auto CreateShader(std::string_view debug_name, std::string_view vertex_source, std::string_view fragment_source)
         -> Scope<IShaderProgram>;
 
+    using StaticMeshBVH = BoundingVolumeHierarchy<Mesh*>;
+
+    class FrameCapture;
+
     class Renderer
     {
         friend class App;
+        friend class FrameReplay;
 
       public:
         using RenderCommand = std::function<bool()>;
 
         static constexpr IRendererAPI::AttachmentFlags DEFAULT_ATTACHMENT_FLAGS = IRendererAPI::AttachmentFlag::COLOR
             | IRendererAPI::AttachmentFlag::DEPTH | IRendererAPI::AttachmentFlag::STENCIL;
+        static constexpr std::size_t MAX_QUADS_PER_BATCH = 4096;
+        /// Debug name of the program quads are drawn with, backends without GLSL register their stand-in under it
+        static constexpr auto QUAD_SHADER_NAME = "Quad";
         Renderer() = default;
 
         void Begin(IRenderTarget* target, const RGBA& color);
         void End();
 
         void DrawMesh(Mesh& mesh);
+        /// Looks up the pipeline of the program with the default render state, drawing with a pipeline created once
+        /// up front skips the lookup
         void DrawMesh(Mesh& mesh, IShaderProgram& shader_program);
+        /// The pipeline comes from RendererAPI().Pipelines(), its vertex layout has to match the mesh geometry pool
+        void DrawMesh(Mesh& mesh, PipelineID pipeline);
+
+        /// Submits the static meshes of the BVH that intersect the view frustum
+        void DrawStaticMeshes(const StaticMeshBVH& meshes);
+        void DrawStaticMeshes(const StaticMeshBVH& meshes, IShaderProgram& shader_program);
+        void DrawStaticMeshes(const StaticMeshBVH& meshes, PipelineID pipeline);
 
         void DrawQuad(const RGBA& color, const glm::vec2& position, const glm::vec3& rotation, const glm::vec3& scale);
+        /// Consecutive quads sampling the same texture (e.g. sprites of one atlas page) are drawn in a single batch,
+        /// the color tints the sampled texels
+        void DrawQuad(const Sprite& sprite,
+                      const RGBA& color,
+                      const glm::vec2& position,
+                      const glm::vec3& rotation,
+                      const glm::vec3& scale);
 
         inline auto CommandQueue() const -> const Vector<RenderCommand>& { return m_CommandQueue; }
 
+        /// Meshes are culled against the frustum of this matrix, identity culls against normalized device coordinates
+        void SetViewProjection(const glm::mat4& view_projection);
+        inline auto ViewProjection() const -> const glm::mat4& { return m_ViewProjection; }
+        inline auto ViewFrustum() const -> const Frustum& { return m_Frustum; }
+
+        inline void SetFrustumCulling(bool enabled) { m_FrustumCulling = enabled; }
+        inline auto FrustumCulling() const -> bool { return m_FrustumCulling; }
+
+        /// Meshes inside the frustum are tested against the occluders rasterized into the buffer, it has to be
+        /// rasterized with the same view projection, nullptr disables occlusion culling
+        inline void SetOcclusionBuffer(const OcclusionBuffer* buffer) { m_OcclusionBuffer = buffer; }
+
+        /// Everything recorded while set is also written into the capture, nullptr stops capturing
+        inline void SetFrameCapture(FrameCapture* capture) { m_FrameCapture = capture; }
+
+        /// Meshes with generated levels of detail are drawn at the level their screen size needs
+        inline void SetLODSettings(const LODSettings& settings) { m_LODSettings = settings; }
+
+        /// Meshes submitted and culled since the last processed command queue
+        inline auto SubmittedMeshCount() const -> std::size_t { return m_SubmittedMeshCount; }
+        inline auto CulledMeshCount() const -> std::size_t { return m_CulledMeshCount; }
+        /// Meshes inside the frustum that were hidden by the occluders, not included in CulledMeshCount
+        inline auto OccludedMeshCount() const -> std::size_t { return m_OccludedMeshCount; }
+
+        /// How far between the previous and the current fixed simulation step this frame is rendered [0, 1)
+        inline auto InterpolationAlpha() const -> float { return m_InterpolationAlpha; }
+
       private:
-        inline void SubmitRenderCommand(const RenderCommand& command)
+        struct MeshSubmission
+        {
+            JE::Mesh* Mesh = nullptr;
+            PipelineID Pipeline = DEFAULT_PIPELINE;
+        };
+
+        struct MeshDraw
+        {
+            JE::Mesh* Mesh = nullptr;
+            PipelineID Pipeline = DEFAULT_PIPELINE;
+            MeshLOD LOD;
+        };
+
+        inline void SetInterpolationAlpha(float alpha) { m_InterpolationAlpha = alpha; }
+
+        void SubmitMesh(Mesh& mesh, PipelineID pipeline);
+        /// Picks the level of detail and queues the draw, FlushMeshDraws records the queued ones as one command
+        void AddMeshDraw(Mesh& mesh, PipelineID pipeline);
+        void FlushMeshDraws();
+        static auto DrawMeshLOD(Mesh& mesh, PipelineID pipeline, const MeshLOD& lod) -> bool;
+        /// Consecutive draws from the same pool page and pipeline share their bindings
+        static auto DrawMeshes(std::span<const MeshDraw> draws) -> bool;
+        inline auto Occluded(const Mesh& mesh) const -> bool
+        {
+            return m_OcclusionBuffer != nullptr && !m_OcclusionBuffer->TestAABB(mesh.Bounds().Box);
+        }
+        /// Culls the pending mesh submissions and records draw commands for the visible ones
+        void FlushMeshSubmissions();
+        /// Transforms the pending quads in one batch and records a single draw command for them, all of them sample
+        /// m_QuadTexture
+        void FlushQuadSubmissions();
+        inline void FlushPendingDraws()
+        {
+            FlushMeshSubmissions();
+            FlushQuadSubmissions();
+        }
+        auto DrawQuadBatch(std::span<const VertexType> corners,
+                           std::span<const glm::vec2> tex_coords,
+                           std::span<const glm::vec4> colors,
+                           ITexture2D* texture) -> bool;
+
+        inline void SubmitRenderCommand(RenderCommand&& command)
         {
             ASSERT(m_CurrentRenderTarget != nullptr);
-            m_CommandQueue.push_back(command);
+            m_CommandQueue.push_back(std::move(command));
         }
 
         inline void ProcessCommandQueue()
@@ -318,10 +595,52 @@ namespace JE
                 }
             }
             m_CommandQueue.clear();
+            // Keeps the capacity for the next frame, End already flushed the pending quads
+            ASSERT(m_QuadTransforms.Empty());
+            m_QuadCorners.clear();
+            m_QuadTexCoords.clear();
+            m_QuadColors.clear();
+            m_QuadBatchStart = 0;
+            m_MeshDraws.clear();
+            m_MeshDrawStart = 0;
+            m_SubmittedMeshCount = 0;
+            m_CulledMeshCount = 0;
+            m_OccludedMeshCount = 0;
         }
 
         IRenderTarget* m_CurrentRenderTarget = nullptr;
         Vector<RenderCommand> m_CommandQueue;
+
+        glm::mat4 m_ViewProjection{1.0f};
+        Frustum m_Frustum{glm::mat4{1.0f}};
+        bool m_FrustumCulling = true;
+        const OcclusionBuffer* m_OcclusionBuffer = nullptr;
+        LODSettings m_LODSettings;
+        FrameCapture* m_FrameCapture = nullptr;
+
+        Vector<MeshSubmission> m_MeshSubmissions;
+        /// Draws of every command recorded this frame, the pending ones start at m_MeshDrawStart
+        Vector<MeshDraw> m_MeshDraws;
+        std::size_t m_MeshDrawStart = 0;
+        AABBBatch m_SubmissionBounds;
+        Vector<std::uint8_t> m_SubmissionVisibility;
+        std::size_t m_SubmittedMeshCount = 0;
+        std::size_t m_CulledMeshCount = 0;
+        std::size_t m_OccludedMeshCount = 0;
+
+        TransformBatch m_QuadTransforms;
+        /// Quads of every batch recorded this frame, the pending batch starts at m_QuadBatchStart
+        Vector<VertexType> m_QuadCorners;
+        Vector<glm::vec2> m_QuadTexCoords;
+        Vector<glm::vec4> m_QuadColors;
+        std::size_t m_QuadBatchStart = 0;
+        ITexture2D* m_QuadTexture = nullptr;
+        Scope<IVertexArray> m_QuadVAO;
+        Scope<ITexture2D> m_WhiteTexture;
+        Scope<IShaderProgram> m_QuadProgram;
+        PipelineID m_QuadPipeline = DEFAULT_PIPELINE;
+
+        float m_InterpolationAlpha = 0;
     };
 
 }  // namespace JE
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include <algorithm>
+
+#include "ResourceTracker.hpp"
+
+#include "Assert.hpp"
+#include "Logger.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+        // Constant initialized, so it outlives resources owned by other globals like the RendererAPI
+        constinit GPUResourceTracker g_ResourceTracker;
+
+        auto Usage(ResourceStatistics& statistics, ResourceType type) -> ResourceUsage&
+        {
+            return statistics.Resources[static_cast<std::size_t>(type)];
+        }
+
+    }  // namespace
+
+    void GPUResourceTracker::Created(ResourceType type)
+    {
+        const std::scoped_lock LOCK(m_Mutex);
+
+        auto& usage = Usage(m_Statistics, type);
+        ++usage.Count;
+        usage.PeakCount = std::max(usage.PeakCount, usage.Count);
+    }
+
+    void GPUResourceTracker::Destroyed(ResourceType type, std::size_t bytes)
+    {
+        const std::scoped_lock LOCK(m_Mutex);
+
+        auto& usage = Usage(m_Statistics, type);
+        ASSERT(usage.Count > 0 && usage.Bytes >= bytes);
+
+        --usage.Count;
+        usage.Bytes -= bytes;
+        m_Statistics.Bytes -= bytes;
+    }
+
+    auto GPUResourceTracker::Reallocate(ResourceType type, std::size_t old_bytes, std::size_t new_bytes) -> bool
+    {
+        const std::scoped_lock LOCK(m_Mutex);
+
+        auto& usage = Usage(m_Statistics, type);
+        ASSERT(usage.Bytes >= old_bytes);
+
+        // Bytes count as freed when the resource is destroyed. On OpenGL the storage is only orphaned once the frames
+        // in flight ended (see OpenGLObjectPool), the driver can hold up to that many frames of destroyed bytes more
+        const auto TOTAL = m_Statistics.Bytes - old_bytes + new_bytes;
+        if (m_Budget && new_bytes > old_bytes && TOTAL > m_Budget->Bytes) {
+            if (m_Budget->Policy == BudgetPolicy::REJECT) {
+                ++m_Statistics.RejectedAllocations;
+                EngineLogger()->error("GPU memory budget of {} bytes exceeded - rejected {} bytes of {}",
+                                      m_Budget->Bytes,
+                                      new_bytes,
+                                      ToString(type));
+                LogStatisticsLocked();
+                return false;
+            }
+
+            // Only the allocation that crosses the budget logs, the ones after it would flood the log every frame
+            if (m_Statistics.Bytes <= m_Budget->Bytes) {
+                EngineLogger()->warn("GPU memory budget of {} bytes exceeded by {} bytes of {}",
+                                     m_Budget->Bytes,
+                                     new_bytes,
+                                     ToString(type));
+                LogStatisticsLocked();
+            }
+        }
+
+        usage.Bytes = usage.Bytes - old_bytes + new_bytes;
+        usage.PeakBytes = std::max(usage.PeakBytes, usage.Bytes);
+        m_Statistics.Bytes = TOTAL;
+        m_Statistics.PeakBytes = std::max(m_Statistics.PeakBytes, TOTAL);
+        return true;
+    }
+
+    void GPUResourceTracker::Uploaded(std::size_t bytes)
+    {
+        const std::scoped_lock LOCK(m_Mutex);
+
+        m_Statistics.FrameUploadBytes += bytes;
+        m_Statistics.PeakFrameUploadBytes =
+            std::max(m_Statistics.PeakFrameUploadBytes, m_Statistics.FrameUploadBytes);
+    }
+
+    // cppcheck-suppress unusedFunction
+    void GPUResourceTracker::BeginFrame()
+    {
+        const std::scoped_lock LOCK(m_Mutex);
+
+        m_Statistics.LastFrameUploadBytes = m_Statistics.FrameUploadBytes;
+        m_Statistics.FrameUploadBytes = 0;
+    }
+
+    // cppcheck-suppress unusedFunction
+    void GPUResourceTracker::SetBudget(std::optional<MemoryBudget> budget)
+    {
+        const std::scoped_lock LOCK(m_Mutex);
+
+        m_Budget = budget;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto GPUResourceTracker::Budget() const -> std::optional<MemoryBudget>
+    {
+        const std::scoped_lock LOCK(m_Mutex);
+
+        return m_Budget;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto GPUResourceTracker::Statistics() const -> ResourceStatistics
+    {
+        const std::scoped_lock LOCK(m_Mutex);
+
+        return m_Statistics;
+    }
+
+    // cppcheck-suppress unusedFunction
+    void GPUResourceTracker::LogStatistics() const
+    {
+        const std::scoped_lock LOCK(m_Mutex);
+
+        LogStatisticsLocked();
+    }
+
+    void GPUResourceTracker::LogStatisticsLocked() const
+    {
+        EngineLogger()->info("GPU resources - {} bytes | peak: {} bytes | uploaded last frame: {} bytes",
+                             m_Statistics.Bytes,
+                             m_Statistics.PeakBytes,
+                             m_Statistics.LastFrameUploadBytes);
+
+        for (std::size_t i = 0; i < RESOURCE_TYPE_COUNT; ++i) {
+            const auto& usage = m_Statistics.Resources[i];
+            EngineLogger()->info("    {} - count: {} | bytes: {} | peak count: {} | peak bytes: {}",
+                                 ToString(static_cast<ResourceType>(i)),
+                                 usage.Count,
+                                 usage.Bytes,
+                                 usage.PeakCount,
+                                 usage.PeakBytes);
+        }
+    }
+
+    auto ResourceTracker() -> GPUResourceTracker&
+    {
+        return g_ResourceTracker;
+    }
+
+}  // namespace JE
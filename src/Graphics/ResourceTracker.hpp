@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+namespace JE
+{
+
+    enum class ResourceType
+    {
+        VERTEX_BUFFER,
+        ELEMENT_BUFFER,
+        VERTEX_ARRAY,
+        SHADER_PROGRAM,
+        TEXTURE,
+        FRAMEBUFFER,
+        STAGING_BUFFER
+    };
+
+    constexpr std::size_t RESOURCE_TYPE_COUNT = 7;
+
+    constexpr auto ToString(ResourceType type) -> std::string_view
+    {
+        switch (type) {
+            case ResourceType::VERTEX_BUFFER:
+                return "VERTEX_BUFFER";
+            case ResourceType::ELEMENT_BUFFER:
+                return "ELEMENT_BUFFER";
+            case ResourceType::VERTEX_ARRAY:
+                return "VERTEX_ARRAY";
+            case ResourceType::SHADER_PROGRAM:
+                return "SHADER_PROGRAM";
+            case ResourceType::TEXTURE:
+                return "TEXTURE";
+            case ResourceType::FRAMEBUFFER:
+                return "FRAMEBUFFER";
+            case ResourceType::STAGING_BUFFER:
+                return "STAGING_BUFFER";
+            default:
+                return "UNKNOWN";
+        }
+    }
+
+    struct ResourceUsage
+    {
+        std::size_t Count = 0;
+        std::size_t Bytes = 0;
+        std::size_t PeakCount = 0;
+        std::size_t PeakBytes = 0;
+    };
+
+    struct ResourceStatistics
+    {
+        std::array<ResourceUsage, RESOURCE_TYPE_COUNT> Resources{};
+        /// Bytes of every resource type together
+        std::size_t Bytes = 0;
+        std::size_t PeakBytes = 0;
+        /// Bytes uploaded since the frame began, in the frame before and in the largest frame so far
+        std::size_t FrameUploadBytes = 0;
+        std::size_t LastFrameUploadBytes = 0;
+        std::size_t PeakFrameUploadBytes = 0;
+        std::size_t RejectedAllocations = 0;
+
+        constexpr auto operator[](ResourceType type) const -> const ResourceUsage&
+        {
+            return Resources[static_cast<std::size_t>(type)];
+        }
+    };
+
+    enum class BudgetPolicy
+    {
+        /// Allocations over the budget succeed, crossing it logs the usage of every resource type
+        LOG,
+        /// Allocations over the budget fail and the resource keeps its previous storage
+        REJECT
+    };
+
+    struct MemoryBudget
+    {
+        std::size_t Bytes = 0;
+        BudgetPolicy Policy = BudgetPolicy::LOG;
+    };
+
+    /// Counts the live GPU resources and the bytes they hold per type, the graphics interfaces report to it through
+    /// their TrackedResource so every backend is accounted the same way
+    class GPUResourceTracker
+    {
+      public:
+        void Created(ResourceType type);
+        void Destroyed(ResourceType type, std::size_t bytes);
+
+        /// Replaces old_bytes of a resource with new_bytes
+        /// \returns false if the budget rejects the allocation, the usage is unchanged then
+        auto Reallocate(ResourceType type, std::size_t old_bytes, std::size_t new_bytes) -> bool;
+
+        void Uploaded(std::size_t bytes);
+
+        /// Starts counting the uploads of the next frame, called once per frame
+        void BeginFrame();
+
+        void SetBudget(std::optional<MemoryBudget> budget);
+        auto Budget() const -> std::optional<MemoryBudget>;
+
+        auto Statistics() const -> ResourceStatistics;
+
+        /// Logs the usage of every resource type
+        void LogStatistics() const;
+
+      private:
+        void LogStatisticsLocked() const;
+
+        mutable std::mutex m_Mutex;
+        ResourceStatistics m_Statistics;
+        std::optional<MemoryBudget> m_Budget;
+    };
+
+    auto ResourceTracker() -> GPUResourceTracker&;
+
+    /// Accounts a resource with the ResourceTracker for as long as it lives
+    class TrackedResource
+    {
+      public:
+        TrackedResource(const TrackedResource& other) = delete;
+        TrackedResource(TrackedResource&& other) = delete;
+        auto operator=(const TrackedResource& other) -> TrackedResource& = delete;
+        auto operator=(TrackedResource&& other) -> TrackedResource& = delete;
+
+        explicit TrackedResource(ResourceType type)
+            : m_Type(type)
+        {
+            ResourceTracker().Created(m_Type);
+        }
+        ~TrackedResource() { ResourceTracker().Destroyed(m_Type, m_Bytes); }
+
+        /// Replaces the storage of the resource, call before allocating it
+        /// \returns false if the budget rejects it, the previous storage stays accounted
+        inline auto Allocate(std::size_t bytes) -> bool
+        {
+            if (!ResourceTracker().Reallocate(m_Type, m_Bytes, bytes)) {
+                return false;
+            }
+            m_Bytes = bytes;
+            return true;
+        }
+
+        // cppcheck-suppress unusedFunction
+        inline void Uploaded(std::size_t bytes) const { ResourceTracker().Uploaded(bytes); }
+
+        inline auto Type() const -> ResourceType { return m_Type; }
+        inline auto Bytes() const -> std::size_t { return m_Bytes; }
+
+      private:
+        ResourceType m_Type;
+        std::size_t m_Bytes = 0;
+    };
+
+}  // namespace JE
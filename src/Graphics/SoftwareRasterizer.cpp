@@ -0,0 +1,476 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "SoftwareRasterizer.hpp"
+
+#include "Assert.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        constexpr float PIXEL_CENTER = 0.5f;
+        constexpr float COLOR8_MAX = 255.0f;
+        constexpr std::size_t COLOR_CHANNELS = 4;
+        /// Vertices closer to the camera plane than this can't be projected
+        constexpr float MIN_CLIP_W = 1e-5f;
+        /// Vertices shaded by one worker at a time
+        constexpr std::size_t VERTEX_CHUNK_SIZE = 1024;
+        /// Draws with fewer vertices are shaded on the calling thread, waking the workers costs more than shading them
+        constexpr std::size_t MIN_PARALLEL_VERTEX_COUNT = 8 * VERTEX_CHUNK_SIZE;
+
+        auto PackColor(const glm::vec4& color) -> std::array<std::byte, COLOR_CHANNELS>
+        {
+            const auto BYTES = glm::round(glm::clamp(color, 0.0f, 1.0f) * COLOR8_MAX);
+            return {static_cast<std::byte>(static_cast<std::uint8_t>(BYTES.r)),
+                    static_cast<std::byte>(static_cast<std::uint8_t>(BYTES.g)),
+                    static_cast<std::byte>(static_cast<std::uint8_t>(BYTES.b)),
+                    static_cast<std::byte>(static_cast<std::uint8_t>(BYTES.a))};
+        }
+
+        auto WrapCoordinate(std::int32_t coordinate, std::int32_t size, TextureWrap wrap) -> std::int32_t
+        {
+            switch (wrap) {
+                case TextureWrap::REPEAT:
+                    return (coordinate % size + size) % size;
+                case TextureWrap::MIRRORED_REPEAT: {
+                    const auto PERIOD = size * 2;
+                    const auto MIRRORED = (coordinate % PERIOD + PERIOD) % PERIOD;
+                    return MIRRORED < size ? MIRRORED : PERIOD - 1 - MIRRORED;
+                }
+                case TextureWrap::CLAMP_TO_EDGE:
+                default:
+                    return std::clamp(coordinate, 0, size - 1);
+            }
+        }
+
+        /// Points close to the camera plane project far outside of the surface, clamp before converting
+        auto ToPixel(float value, std::int32_t size) -> std::int32_t
+        {
+            return static_cast<std::int32_t>(std::clamp(value, -1.0f, static_cast<float>(size)));
+        }
+
+        auto EdgeFunction(const glm::vec3& from, const glm::vec3& to) -> glm::vec3
+        {
+            return {from.y - to.y, to.x - from.x, from.x * to.y - from.y * to.x};
+        }
+
+        /// Same order of operations as the SIMD path, which adds the per row part last
+        inline auto EvaluatePlane(const glm::vec3& plane, float x, float y) -> float
+        {
+            return plane.x * x + (plane.y * y + plane.z);
+        }
+
+        /// Edge i divided by the area is the barycentric weight of corner i, the values are interpolated linearly
+        auto InterpolationPlane(const std::array<glm::vec3, 3>& edges, float area, float v0, float v1, float v2)
+            -> glm::vec3
+        {
+            auto plane = edges[1] * ((v1 - v0) / area) + edges[2] * ((v2 - v0) / area);
+            plane.z += v0;
+            return plane;
+        }
+
+    }  // namespace
+
+    // cppcheck-suppress unusedFunction
+    auto SoftwareSamplers::Sample(std::size_t slot, const glm::vec2& uv) const -> glm::vec4
+    {
+        const auto& image = m_Images[slot];
+        if (image.Pixels.empty()) {
+            return {0, 0, 0, 1};
+        }
+
+        const auto FETCH = [&image](std::int32_t x, std::int32_t y)
+        {
+            x = WrapCoordinate(x, image.Size.X, image.Sampler.WrapU);
+            y = WrapCoordinate(y, image.Size.Y, image.Sampler.WrapV);
+            return image.Pixels[static_cast<std::size_t>(y) * static_cast<std::size_t>(image.Size.X)
+                                + static_cast<std::size_t>(x)];
+        };
+
+        const auto U = uv.x * static_cast<float>(image.Size.X);
+        const auto V = uv.y * static_cast<float>(image.Size.Y);
+        if (image.Sampler.MagFilter == TextureFilter::NEAREST) {
+            return FETCH(static_cast<std::int32_t>(std::floor(U)), static_cast<std::int32_t>(std::floor(V)));
+        }
+
+        const auto X = std::floor(U - PIXEL_CENTER);
+        const auto Y = std::floor(V - PIXEL_CENTER);
+        const auto WEIGHT_X = U - PIXEL_CENTER - X;
+        const auto WEIGHT_Y = V - PIXEL_CENTER - Y;
+        const auto X0 = static_cast<std::int32_t>(X);
+        const auto Y0 = static_cast<std::int32_t>(Y);
+        const auto BOTTOM = glm::mix(FETCH(X0, Y0), FETCH(X0 + 1, Y0), WEIGHT_X);
+        const auto TOP = glm::mix(FETCH(X0, Y0 + 1), FETCH(X0 + 1, Y0 + 1), WEIGHT_X);
+        return glm::mix(BOTTOM, TOP, WEIGHT_Y);
+    }
+
+#if JE_SIMD_X86
+    namespace
+    {
+
+        /// Coverage and depth test of four pixels of a row at a time, returns the lanes that have to be shaded
+        inline auto CoverageSSE(const std::array<glm::vec3, 3>& edges,
+                                const std::array<float, 3>& thresholds,
+                                const glm::vec3& depth_plane,
+                                float pixel_x,
+                                float pixel_y,
+                                float limit_x,
+                                const float* old_depth,
+                                float* depth) -> int
+        {
+            const __m128 LANE_OFFSETS = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+            const __m128 X = _mm_add_ps(_mm_set1_ps(pixel_x), LANE_OFFSETS);
+            const __m128 PX = _mm_add_ps(X, _mm_set1_ps(PIXEL_CENTER));
+
+            // The y part of the planes only changes per row
+            const auto EDGE = [&PX, pixel_y](const glm::vec3& plane, float threshold)
+            {
+                const __m128 ROW = _mm_set1_ps(plane.y * pixel_y + plane.z);
+                return _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), PX), ROW), _mm_set1_ps(threshold));
+            };
+
+            __m128 inside = _mm_cmplt_ps(X, _mm_set1_ps(limit_x));
+            inside = _mm_and_ps(inside, EDGE(edges[0], thresholds[0]));
+            inside = _mm_and_ps(inside, EDGE(edges[1], thresholds[1]));
+            inside = _mm_and_ps(inside, EDGE(edges[2], thresholds[2]));
+            if (_mm_movemask_ps(inside) == 0) {
+                return 0;
+            }
+
+            const __m128 DEPTH_ROW = _mm_set1_ps(depth_plane.y * pixel_y + depth_plane.z);
+            const __m128 DEPTH = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(depth_plane.x), PX), DEPTH_ROW);
+            _mm_storeu_ps(depth, DEPTH);
+            if (old_depth != nullptr) {
+                inside = _mm_and_ps(inside, _mm_cmplt_ps(DEPTH, _mm_loadu_ps(old_depth)));
+            }
+            return _mm_movemask_ps(inside);
+        }
+
+    }  // namespace
+#endif
+
+    SoftwareRasterizer::SoftwareRasterizer(std::uint32_t worker_count)
+        : m_Workers(worker_count)
+    {
+    }
+
+    // cppcheck-suppress unusedFunction
+    void SoftwareRasterizer::SetSurface(const SoftwareSurface& surface)
+    {
+        Flush();
+
+        ASSERT(surface.Color.empty()
+               || surface.Color.size() >= static_cast<std::size_t>(surface.Size.X * surface.Size.Y) * COLOR_CHANNELS);
+        ASSERT(surface.Depth.empty() || surface.DepthStride >= SoftwareDepthStride(surface.Size.X));
+
+        m_Surface = surface;
+        m_TilesX = (surface.Size.X + TILE_SIZE - 1) / TILE_SIZE;
+        m_TilesY = (surface.Size.Y + TILE_SIZE - 1) / TILE_SIZE;
+        m_TileBins.resize(static_cast<std::size_t>(m_TilesX) * static_cast<std::size_t>(m_TilesY));
+    }
+
+    // cppcheck-suppress unusedFunction
+    void SoftwareRasterizer::Clear(std::optional<glm::vec4> color, std::optional<float> depth)
+    {
+        Flush();
+
+        if (color && !m_Surface.Color.empty()) {
+            const auto PIXEL = PackColor(*color);
+            for (std::size_t i = 0; i + COLOR_CHANNELS <= m_Surface.Color.size(); i += COLOR_CHANNELS) {
+                std::copy(PIXEL.begin(), PIXEL.end(), m_Surface.Color.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+        if (depth) {
+            std::fill(m_Surface.Depth.begin(), m_Surface.Depth.end(), *depth);
+        }
+    }
+
+    // cppcheck-suppress unusedFunction
+    void SoftwareRasterizer::Draw(const SoftwareShader& shader,
+                                  const SoftwareSamplers& samplers,
+                                  std::span<const SoftwareShader::Attributes> vertices,
+                                  std::span<const std::uint32_t> indices)
+    {
+        ASSERT(indices.size() % CORNER_COUNT == 0);
+        ASSERT(shader.Vertex && shader.Fragment);
+        ASSERT(shader.VaryingCount <= SoftwareShader::MAX_VARYINGS);
+
+        if (indices.empty() || m_Surface.Size.X == 0 || m_Surface.Size.Y == 0) {
+            return;
+        }
+
+        // Only the vertices the indices reach are shaded, large ranges are split over the workers
+        const auto [MIN_INDEX, MAX_INDEX] = std::minmax_element(indices.begin(), indices.end());
+        ASSERT(*MAX_INDEX < vertices.size());
+        const auto FIRST_VERTEX = std::size_t{*MIN_INDEX};
+        const auto VERTEX_COUNT = std::size_t{*MAX_INDEX} - FIRST_VERTEX + 1;
+        m_ShadedVertices.resize(VERTEX_COUNT);
+
+        const auto SHADE_CHUNK = [&](std::size_t chunk)
+        {
+            const auto END = std::min((chunk + 1) * VERTEX_CHUNK_SIZE, VERTEX_COUNT);
+            for (auto i = chunk * VERTEX_CHUNK_SIZE; i < END; ++i) {
+                auto& shaded = m_ShadedVertices[i];
+                shaded.Position = shader.Vertex(vertices[FIRST_VERTEX + i], shaded.Varyings);
+            }
+        };
+        const auto CHUNK_COUNT = (VERTEX_COUNT + VERTEX_CHUNK_SIZE - 1) / VERTEX_CHUNK_SIZE;
+        if (VERTEX_COUNT < MIN_PARALLEL_VERTEX_COUNT) {
+            for (std::size_t chunk = 0; chunk < CHUNK_COUNT; ++chunk) {
+                SHADE_CHUNK(chunk);
+            }
+        } else {
+            m_Workers.ParallelFor(CHUNK_COUNT, SHADE_CHUNK);
+        }
+
+        m_Draws.push_back({shader, samplers, m_DepthTest});
+        for (std::size_t i = 0; i < indices.size(); i += CORNER_COUNT) {
+            ClipTriangle({m_ShadedVertices[indices[i] - FIRST_VERTEX],
+                          m_ShadedVertices[indices[i + 1] - FIRST_VERTEX],
+                          m_ShadedVertices[indices[i + 2] - FIRST_VERTEX]},
+                         shader.VaryingCount);
+        }
+    }
+
+    // cppcheck-suppress unusedFunction
+    void SoftwareRasterizer::Flush()
+    {
+        if (!m_Triangles.empty()) {
+            BinTriangles();
+            // Tiles don't share pixels, every worker writes its own part of the surface
+            m_Workers.ParallelFor(m_TileBins.size(), [this](std::size_t tile) { RasterizeTile(tile); });
+        }
+
+        m_Triangles.clear();
+        m_VaryingPlanes.clear();
+        m_Draws.clear();
+    }
+
+    void SoftwareRasterizer::ClipTriangle(const std::array<ShadedVertex, CORNER_COUNT>& vertices,
+                                          std::size_t varying_count)
+    {
+        // Triangles completely outside of one side of the clip volume are never visible
+        for (glm::length_t axis = 0; axis < 3; ++axis) {
+            std::size_t above = 0;
+            std::size_t below = 0;
+            for (const auto& vertex : vertices) {
+                above += vertex.Position[axis] > vertex.Position.w ? 1U : 0U;
+                below += vertex.Position[axis] < -vertex.Position.w ? 1U : 0U;
+            }
+            if (above == CORNER_COUNT || below == CORNER_COUNT) {
+                return;
+            }
+        }
+
+        // Distance to the near plane (z = -w), positive on the visible side
+        const auto DISTANCE = [](const ShadedVertex& vertex) { return vertex.Position.z + vertex.Position.w; };
+        if (std::all_of(vertices.begin(), vertices.end(), [&](const auto& vertex) { return DISTANCE(vertex) >= 0; })) {
+            SetupTriangle(vertices, varying_count);
+            return;
+        }
+
+        // Sutherland-Hodgman against the near plane, a triangle becomes at most a quad
+        std::array<ShadedVertex, CORNER_COUNT + 1> polygon{};
+        std::size_t polygon_size = 0;
+        for (std::size_t i = 0; i < CORNER_COUNT; ++i) {
+            const auto& current = vertices[i];
+            const auto& next = vertices[(i + 1) % CORNER_COUNT];
+            const auto CURRENT_DISTANCE = DISTANCE(current);
+            const auto NEXT_DISTANCE = DISTANCE(next);
+
+            if (CURRENT_DISTANCE >= 0) {
+                polygon[polygon_size++] = current;
+            }
+            if ((CURRENT_DISTANCE >= 0) != (NEXT_DISTANCE >= 0)) {
+                const auto WEIGHT = CURRENT_DISTANCE / (CURRENT_DISTANCE - NEXT_DISTANCE);
+                auto& clipped = polygon[polygon_size++];
+                clipped.Position = glm::mix(current.Position, next.Position, WEIGHT);
+                for (std::size_t varying = 0; varying < varying_count; ++varying) {
+                    clipped.Varyings[varying] = glm::mix(current.Varyings[varying], next.Varyings[varying], WEIGHT);
+                }
+            }
+        }
+
+        for (std::size_t i = 2; i < polygon_size; ++i) {
+            SetupTriangle({polygon[0], polygon[i - 1], polygon[i]}, varying_count);
+        }
+    }
+
+    void SoftwareRasterizer::SetupTriangle(std::array<ShadedVertex, CORNER_COUNT> vertices, std::size_t varying_count)
+    {
+        std::array<glm::vec3, CORNER_COUNT> window{};
+        std::array<float, CORNER_COUNT> inverse_w{};
+        for (std::size_t corner = 0; corner < CORNER_COUNT; ++corner) {
+            const auto& clip = vertices[corner].Position;
+            if (clip.w < MIN_CLIP_W) {
+                return;
+            }
+            inverse_w[corner] = 1.0f / clip.w;
+            const auto NDC = glm::vec3{clip} * inverse_w[corner];
+            window[corner] = {(NDC.x * 0.5f + 0.5f) * static_cast<float>(m_Surface.Size.X),
+                              (NDC.y * 0.5f + 0.5f) * static_cast<float>(m_Surface.Size.Y),
+                              NDC.z * 0.5f + 0.5f};
+        }
+
+        // Both windings are drawn, the edges are set up counter clockwise
+        auto area = (window[1].x - window[0].x) * (window[2].y - window[0].y)
+                     - (window[1].y - window[0].y) * (window[2].x - window[0].x);
+        if (area < 0) {
+            std::swap(window[1], window[2]);
+            std::swap(inverse_w[1], inverse_w[2]);
+            std::swap(vertices[1], vertices[2]);
+            area = -area;
+        }
+        if (area <= 0) {
+            return;
+        }
+
+        Triangle triangle;
+        const auto MIN_WINDOW = glm::min(glm::min(window[0], window[1]), window[2]);
+        const auto MAX_WINDOW = glm::max(glm::max(window[0], window[1]), window[2]);
+        triangle.MinX = std::max(ToPixel(std::ceil(MIN_WINDOW.x - PIXEL_CENTER), m_Surface.Size.X), 0);
+        triangle.MinY = std::max(ToPixel(std::ceil(MIN_WINDOW.y - PIXEL_CENTER), m_Surface.Size.Y), 0);
+        triangle.MaxX = std::min(ToPixel(std::floor(MAX_WINDOW.x - PIXEL_CENTER), m_Surface.Size.X),
+                                 m_Surface.Size.X - 1);
+        triangle.MaxY = std::min(ToPixel(std::floor(MAX_WINDOW.y - PIXEL_CENTER), m_Surface.Size.Y),
+                                 m_Surface.Size.Y - 1);
+        if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY) {
+            return;
+        }
+
+        triangle.Edges = {EdgeFunction(window[1], window[2]),
+                          EdgeFunction(window[2], window[0]),
+                          EdgeFunction(window[0], window[1])};
+        // Left edges and horizontal top edges own the pixels exactly on them, the others need a positive value
+        for (std::size_t edge = 0; edge < CORNER_COUNT; ++edge) {
+            const auto& plane = triangle.Edges[edge];
+            const bool TOP_LEFT = plane.x > 0 || (plane.x >= 0 && plane.y < 0);
+            triangle.Thresholds[edge] = TOP_LEFT ? 0.0f : std::numeric_limits<float>::denorm_min();
+        }
+
+        triangle.Depth = InterpolationPlane(triangle.Edges, area, window[0].z, window[1].z, window[2].z);
+        triangle.InverseW = InterpolationPlane(triangle.Edges, area, inverse_w[0], inverse_w[1], inverse_w[2]);
+        triangle.FirstVaryingPlane = m_VaryingPlanes.size();
+        for (std::size_t varying = 0; varying < varying_count; ++varying) {
+            for (glm::length_t component = 0; component < 4; ++component) {
+                m_VaryingPlanes.push_back(InterpolationPlane(triangle.Edges,
+                                                             area,
+                                                             vertices[0].Varyings[varying][component] * inverse_w[0],
+                                                             vertices[1].Varyings[varying][component] * inverse_w[1],
+                                                             vertices[2].Varyings[varying][component] * inverse_w[2]));
+            }
+        }
+        triangle.DrawIndex = static_cast<std::uint32_t>(m_Draws.size() - 1);
+
+        m_Triangles.push_back(triangle);
+    }
+
+    void SoftwareRasterizer::BinTriangles()
+    {
+        for (auto& bin : m_TileBins) {
+            bin.clear();
+        }
+
+        for (std::size_t i = 0; i < m_Triangles.size(); ++i) {
+            const auto& triangle = m_Triangles[i];
+            for (auto tile_y = triangle.MinY / TILE_SIZE; tile_y <= triangle.MaxY / TILE_SIZE; ++tile_y) {
+                for (auto tile_x = triangle.MinX / TILE_SIZE; tile_x <= triangle.MaxX / TILE_SIZE; ++tile_x) {
+                    m_TileBins[static_cast<std::size_t>(tile_y * m_TilesX + tile_x)].push_back(
+                        static_cast<std::uint32_t>(i));
+                }
+            }
+        }
+    }
+
+    void SoftwareRasterizer::RasterizeTile(std::size_t tile)
+    {
+        const auto TILE_X = static_cast<std::int32_t>(tile) % m_TilesX * TILE_SIZE;
+        const auto TILE_Y = static_cast<std::int32_t>(tile) / m_TilesX * TILE_SIZE;
+        const auto TILE_MAX_X = std::min(TILE_X + TILE_SIZE, m_Surface.Size.X) - 1;
+        const auto TILE_MAX_Y = std::min(TILE_Y + TILE_SIZE, m_Surface.Size.Y) - 1;
+
+        for (const auto INDEX : m_TileBins[tile]) {
+            const auto& triangle = m_Triangles[INDEX];
+            const bool DEPTH_TEST = m_Draws[triangle.DrawIndex].DepthTest && !m_Surface.Depth.empty();
+            const auto MIN_X = std::max(triangle.MinX, TILE_X);
+            const auto MIN_Y = std::max(triangle.MinY, TILE_Y);
+            const auto MAX_X = std::min(triangle.MaxX, TILE_MAX_X);
+            const auto MAX_Y = std::min(triangle.MaxY, TILE_MAX_Y);
+
+            for (auto y = MIN_Y; y <= MAX_Y; ++y) {
+                const auto PY = static_cast<float>(y) + PIXEL_CENTER;
+                const float* depth_row =
+                    DEPTH_TEST ? &m_Surface.Depth[static_cast<std::size_t>(y * m_Surface.DepthStride)] : nullptr;
+
+#if JE_SIMD_X86
+                // Tiles start at a multiple of the lane count and depth rows are padded, a register never leaves
+                // the tile or the row
+                if (m_SIMDLevel != SIMDLevel::SCALAR) {
+                    std::array<float, LANE_COUNT> depth{};
+                    for (auto x = MIN_X - MIN_X % LANE_COUNT; x <= MAX_X; x += LANE_COUNT) {
+                        const auto MASK = CoverageSSE(triangle.Edges,
+                                                      triangle.Thresholds,
+                                                      triangle.Depth,
+                                                      static_cast<float>(x),
+                                                      PY,
+                                                      static_cast<float>(MAX_X + 1),
+                                                      depth_row != nullptr ? depth_row + x : nullptr,  // NOLINT
+                                                      depth.data());
+                        for (std::int32_t lane = 0; lane < LANE_COUNT; ++lane) {
+                            if ((MASK & (1 << lane)) != 0) {
+                                ShadePixel(triangle, x + lane, y, depth[static_cast<std::size_t>(lane)]);
+                            }
+                        }
+                    }
+                    continue;
+                }
+#endif
+                for (auto x = MIN_X; x <= MAX_X; ++x) {
+                    const auto PX = static_cast<float>(x) + PIXEL_CENTER;
+                    const bool INSIDE = EvaluatePlane(triangle.Edges[0], PX, PY) >= triangle.Thresholds[0]
+                                        && EvaluatePlane(triangle.Edges[1], PX, PY) >= triangle.Thresholds[1]
+                                        && EvaluatePlane(triangle.Edges[2], PX, PY) >= triangle.Thresholds[2];
+                    if (!INSIDE) {
+                        continue;
+                    }
+                    const auto DEPTH = EvaluatePlane(triangle.Depth, PX, PY);
+                    if (depth_row == nullptr || DEPTH < depth_row[x]) {  // NOLINT
+                        ShadePixel(triangle, x, y, DEPTH);
+                    }
+                }
+            }
+        }
+    }
+
+    void SoftwareRasterizer::ShadePixel(const Triangle& triangle, std::int32_t x, std::int32_t y, float depth)
+    {
+        const auto& draw = m_Draws[triangle.DrawIndex];
+        const auto PX = static_cast<float>(x) + PIXEL_CENTER;
+        const auto PY = static_cast<float>(y) + PIXEL_CENTER;
+
+        const auto W = 1.0f / EvaluatePlane(triangle.InverseW, PX, PY);
+        SoftwareShader::Varyings varyings{};
+        auto plane = m_VaryingPlanes.begin() + static_cast<std::ptrdiff_t>(triangle.FirstVaryingPlane);
+        for (std::size_t varying = 0; varying < draw.Shader.VaryingCount; ++varying) {
+            for (glm::length_t component = 0; component < 4; ++component) {
+                varyings[varying][component] = EvaluatePlane(*plane++, PX, PY) * W;
+            }
+        }
+
+        const auto PIXEL = static_cast<std::size_t>(y) * static_cast<std::size_t>(m_Surface.Size.X)
+                           + static_cast<std::size_t>(x);
+        if (!m_Surface.Color.empty()) {
+            const auto COLOR = PackColor(draw.Shader.Fragment(varyings, draw.Samplers));
+            const auto OFFSET = static_cast<std::ptrdiff_t>(PIXEL * COLOR_CHANNELS);
+            std::copy(COLOR.begin(), COLOR.end(), m_Surface.Color.begin() + OFFSET);
+        }
+        if (draw.DepthTest && !m_Surface.Depth.empty()) {
+            m_Surface.Depth[static_cast<std::size_t>(y * m_Surface.DepthStride + x)] = depth;
+        }
+    }
+
+}  // namespace JE
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "Memory.hpp"
+#include "Parallel.hpp"
+#include "SIMD.hpp"
+#include "Texture.hpp"
+#include "Types.hpp"
+
+namespace JE
+{
+
+    /// Level 0 of a texture converted to float RGBA, rows from bottom to top like OpenGL stores them
+    struct SoftwareImage
+    {
+        Size2D Size;
+        std::span<const glm::vec4> Pixels;
+        SamplerState Sampler;
+    };
+
+    /// Textures bound to the slots of a draw, fragment functions sample them like GLSL's texture()
+    class SoftwareSamplers
+    {
+      public:
+        static constexpr std::size_t SLOT_COUNT = 8;
+
+        inline void Bind(std::size_t slot, const SoftwareImage& image) { m_Images[slot] = image; }
+        inline void Unbind(std::size_t slot) { m_Images[slot] = {}; }
+        inline auto Bound(std::size_t slot) const -> bool { return !m_Images[slot].Pixels.empty(); }
+
+        /// Level 0 only, unbound slots return opaque black like an incomplete texture in OpenGL
+        auto Sample(std::size_t slot, const glm::vec2& uv) const -> glm::vec4;
+
+      private:
+        std::array<SoftwareImage, SLOT_COUNT> m_Images{};
+    };
+
+    /// C++ stand-in for a GLSL program, both functions are called from the rasterizer's worker threads
+    struct SoftwareShader
+    {
+        static constexpr std::size_t MAX_ATTRIBUTES = 4;
+        static constexpr std::size_t MAX_VARYINGS = 4;
+
+        /// Attributes with fewer than four components are filled up with (0, 0, 0, 1) like in OpenGL
+        using Attributes = std::array<glm::vec4, MAX_ATTRIBUTES>;
+        using Varyings = std::array<glm::vec4, MAX_VARYINGS>;
+
+        /// Returns the clip space position and writes the varyings interpolated over the triangle
+        using VertexFunction = std::function<glm::vec4(const Attributes& attributes, Varyings& varyings)>;
+        using FragmentFunction = std::function<glm::vec4(const Varyings& varyings, const SoftwareSamplers& samplers)>;
+
+        VertexFunction Vertex;
+        FragmentFunction Fragment;
+        /// Only the first VaryingCount varyings are interpolated
+        std::size_t VaryingCount = 0;
+    };
+
+    /// Memory the rasterizer draws into, color is RGBA8 and depth has DepthStride floats per row
+    struct SoftwareSurface
+    {
+        Size2D Size;
+        std::span<std::byte> Color;
+        std::span<float> Depth;
+        std::int32_t DepthStride = 0;
+    };
+
+    /// Depth rows are padded so whole SIMD registers can be loaded at the end of a row
+    constexpr auto SoftwareDepthStride(std::int32_t width) -> std::int32_t
+    {
+        constexpr std::int32_t LANE_COUNT = 4;
+        return (width + LANE_COUNT - 1) / LANE_COUNT * LANE_COUNT;
+    }
+
+    /// Tile based rasterizer of indexed triangles, vertices are shaded when a draw is submitted and the triangles
+    /// are binned into screen tiles, Flush rasterizes the tiles in parallel while keeping the submission order
+    /// within every tile. There's no blending and no face culling
+    class SoftwareRasterizer
+    {
+      public:
+        static constexpr std::int32_t TILE_SIZE = 32;
+        static constexpr std::int32_t LANE_COUNT = 4;
+
+        explicit SoftwareRasterizer(std::uint32_t worker_count = 0);
+
+        /// Flushes the draws of the previous surface
+        void SetSurface(const SoftwareSurface& surface);
+        inline auto Surface() const -> const SoftwareSurface& { return m_Surface; }
+
+        void Clear(std::optional<glm::vec4> color, std::optional<float> depth);
+
+        /// Depth test is less with depth writes, applies to the draws submitted afterwards
+        inline void SetDepthTest(bool enabled) { m_DepthTest = enabled; }
+
+        /// Indices address vertices, triangles crossing the near plane are clipped
+        void Draw(const SoftwareShader& shader,
+                  const SoftwareSamplers& samplers,
+                  std::span<const SoftwareShader::Attributes> vertices,
+                  std::span<const std::uint32_t> indices);
+
+        void Flush();
+
+        inline void SetSIMDLevel(SIMDLevel level) { m_SIMDLevel = level; }
+        inline auto PendingTriangleCount() const -> std::size_t { return m_Triangles.size(); }
+
+      private:
+        static constexpr std::size_t CORNER_COUNT = 3;
+
+        struct ShadedVertex
+        {
+            glm::vec4 Position{0};
+            SoftwareShader::Varyings Varyings{};
+        };
+
+        struct DrawState
+        {
+            SoftwareShader Shader;
+            SoftwareSamplers Samplers;
+            bool DepthTest = false;
+        };
+
+        /// Edge functions and interpolants as planes over the window (a * x + b * y + c), varyings are divided by w
+        /// so they're interpolated perspective correct
+        struct Triangle
+        {
+            std::array<glm::vec3, CORNER_COUNT> Edges;
+            /// Pixels exactly on an edge belong to it if the value reaches the threshold (top left fill rule)
+            std::array<float, CORNER_COUNT> Thresholds{};
+            glm::vec3 Depth{0};
+            glm::vec3 InverseW{0};
+            std::size_t FirstVaryingPlane = 0;
+            std::uint32_t DrawIndex = 0;
+            std::int32_t MinX = 0;
+            std::int32_t MinY = 0;
+            std::int32_t MaxX = 0;
+            std::int32_t MaxY = 0;
+        };
+
+        void ClipTriangle(const std::array<ShadedVertex, CORNER_COUNT>& vertices, std::size_t varying_count);
+        void SetupTriangle(std::array<ShadedVertex, CORNER_COUNT> vertices, std::size_t varying_count);
+        void BinTriangles();
+        void RasterizeTile(std::size_t tile);
+        void ShadePixel(const Triangle& triangle, std::int32_t x, std::int32_t y, float depth);
+
+        WorkerPool m_Workers;
+        SIMDLevel m_SIMDLevel = HostSIMDLevel();
+        bool m_DepthTest = false;
+        SoftwareSurface m_Surface;
+        std::int32_t m_TilesX = 0;
+        std::int32_t m_TilesY = 0;
+
+        Vector<ShadedVertex> m_ShadedVertices;
+        Vector<DrawState> m_Draws;
+        Vector<Triangle> m_Triangles;
+        Vector<glm::vec3> m_VaryingPlanes;
+        Vector<Vector<std::uint32_t>> m_TileBins;
+    };
+
+}  // namespace JE
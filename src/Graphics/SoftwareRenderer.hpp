@@ -0,0 +1,412 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "Graphics/IRendererAPI.hpp"
+#include "Graphics/Renderer.hpp"
+#include "Graphics/SoftwareRasterizer.hpp"
+#include "Graphics/SoftwareRendererAPI.hpp"
+#include "Graphics/Texture.hpp"
+#include "Memory.hpp"
+
+namespace JE::detail
+{
+
+    /// Converts a mip level to float RGBA, sRGB formats are converted to linear like OpenGL samples them
+    auto DecodeTextureLevel(const Size2D& size, TextureFormat format, std::span<const std::byte> data)
+        -> Vector<glm::vec4>;
+
+    class SoftwareVertexBuffer : public IVertexBuffer
+    {
+      public:
+        SoftwareVertexBuffer(const SoftwareVertexBuffer& other) = delete;
+        SoftwareVertexBuffer(SoftwareVertexBuffer&& other) = delete;
+        auto operator=(const SoftwareVertexBuffer& other) -> SoftwareVertexBuffer& = delete;
+        auto operator=(SoftwareVertexBuffer&& other) -> SoftwareVertexBuffer& = delete;
+
+        explicit SoftwareVertexBuffer(AttributeLayout layout)
+            : IVertexBuffer(std::move(layout))
+        {
+        }
+        ~SoftwareVertexBuffer() override = default;
+
+        inline auto Bind() -> bool override { return true; }
+        inline auto Unbind() -> bool override { return true; }
+
+        // Vertices are shaded when the draw is submitted, the data can be replaced right after it
+        inline auto SetData(std::span<const std::byte> data) -> bool override
+        {
+            if (!m_Resource.Allocate(data.size())) {
+                return false;
+            }
+            m_Data.assign(data.begin(), data.end());
+            m_Resource.Uploaded(data.size());
+            return true;
+        }
+
+        inline auto AllocateStorage(std::size_t size) -> bool override
+        {
+            if (!m_Resource.Allocate(size)) {
+                return false;
+            }
+            m_Data.assign(size, std::byte{0});
+            return true;
+        }
+
+        inline auto SetSubData(std::size_t offset, std::span<const std::byte> data) -> bool override
+        {
+            if (offset + data.size() > m_Data.size()) {
+                return false;
+            }
+            std::ranges::copy(data, m_Data.begin() + static_cast<std::ptrdiff_t>(offset));
+            m_Resource.Uploaded(data.size());
+            return true;
+        }
+
+        inline auto CopySubData(const IVertexBuffer& source,
+                                std::size_t source_offset,
+                                std::size_t offset,
+                                std::size_t size) -> bool override
+        {
+            const auto SOURCE = static_cast<const SoftwareVertexBuffer&>(source).Data();
+            if (source_offset + size > SOURCE.size() || offset + size > m_Data.size()) {
+                return false;
+            }
+            const auto DESTINATION = m_Data.begin() + static_cast<std::ptrdiff_t>(offset);
+            std::ranges::copy(SOURCE.subspan(source_offset, size), DESTINATION);
+            return true;
+        }
+
+        inline auto Data() const -> std::span<const std::byte> { return m_Data; }
+
+      private:
+        inline auto UploadLayout([[maybe_unused]] std::uint32_t first_location) -> bool override { return true; }
+
+        Vector<std::byte> m_Data;
+    };
+
+    class SoftwareElementBuffer : public IElementBuffer
+    {
+      public:
+        SoftwareElementBuffer(const SoftwareElementBuffer& other) = delete;
+        SoftwareElementBuffer(SoftwareElementBuffer&& other) = delete;
+        auto operator=(const SoftwareElementBuffer& other) -> SoftwareElementBuffer& = delete;
+        auto operator=(SoftwareElementBuffer&& other) -> SoftwareElementBuffer& = delete;
+
+        SoftwareElementBuffer() = default;
+        ~SoftwareElementBuffer() override = default;
+
+        inline auto Bind() -> bool override { return true; }
+        inline auto Unbind() -> bool override { return true; }
+
+        inline auto SetData(std::span<const std::byte> data) -> bool override
+        {
+            if (!m_Resource.Allocate(data.size())) {
+                return false;
+            }
+            m_Data.assign(data.begin(), data.end());
+            m_Resource.Uploaded(data.size());
+            return true;
+        }
+
+        inline auto AllocateStorage(std::size_t size) -> bool override
+        {
+            if (!m_Resource.Allocate(size)) {
+                return false;
+            }
+            m_Data.assign(size, std::byte{0});
+            return true;
+        }
+
+        inline auto SetSubData(std::size_t offset, std::span<const std::byte> data) -> bool override
+        {
+            if (offset + data.size() > m_Data.size()) {
+                return false;
+            }
+            std::ranges::copy(data, m_Data.begin() + static_cast<std::ptrdiff_t>(offset));
+            m_Resource.Uploaded(data.size());
+            return true;
+        }
+
+        inline auto CopySubData(const IElementBuffer& source,
+                                std::size_t source_offset,
+                                std::size_t offset,
+                                std::size_t size) -> bool override
+        {
+            const auto SOURCE = static_cast<const SoftwareElementBuffer&>(source).Data();
+            if (source_offset + size > SOURCE.size() || offset + size > m_Data.size()) {
+                return false;
+            }
+            const auto DESTINATION = m_Data.begin() + static_cast<std::ptrdiff_t>(offset);
+            std::ranges::copy(SOURCE.subspan(source_offset, size), DESTINATION);
+            return true;
+        }
+
+        inline auto Data() const -> std::span<const std::byte> { return m_Data; }
+
+      private:
+        Vector<std::byte> m_Data;
+    };
+
+    class SoftwareVertexArray : public IVertexArray
+    {
+      public:
+        SoftwareVertexArray(const SoftwareVertexArray& other) = delete;
+        SoftwareVertexArray(SoftwareVertexArray&& other) = delete;
+        auto operator=(const SoftwareVertexArray& other) -> SoftwareVertexArray& = delete;
+        auto operator=(SoftwareVertexArray&& other) -> SoftwareVertexArray& = delete;
+
+        explicit SoftwareVertexArray(SoftwareRendererAPI& api)
+            : m_API(api)
+        {
+        }
+        ~SoftwareVertexArray() override { m_API.BindVertexArray(nullptr); }
+
+        inline auto Build() -> bool override { return m_IndexBuffer != nullptr; }
+
+        inline auto Bind() -> bool override
+        {
+            m_API.BindVertexArray(this);
+            return true;
+        }
+
+        inline auto Unbind() -> bool override
+        {
+            m_API.BindVertexArray(nullptr);
+            return true;
+        }
+
+        inline auto VertexBuffer(std::size_t index) const -> const SoftwareVertexBuffer&
+        {
+            return static_cast<const SoftwareVertexBuffer&>(*m_VertexBuffers[index]);
+        }
+        inline auto Indices() const -> std::span<const std::byte>
+        {
+            return m_IndexBuffer == nullptr ? std::span<const std::byte>{}
+                                            : static_cast<const SoftwareElementBuffer&>(*m_IndexBuffer).Data();
+        }
+
+      private:
+        SoftwareRendererAPI& m_API;
+    };
+
+    class SoftwareShaderProgram : public IShaderProgram
+    {
+      public:
+        SoftwareShaderProgram(const SoftwareShaderProgram& other) = delete;
+        SoftwareShaderProgram(SoftwareShaderProgram&& other) = delete;
+        auto operator=(const SoftwareShaderProgram& other) -> SoftwareShaderProgram& = delete;
+        auto operator=(SoftwareShaderProgram&& other) -> SoftwareShaderProgram& = delete;
+
+        SoftwareShaderProgram(std::string_view debug_name, SoftwareShader shader, SoftwareRendererAPI& api)
+            : IShaderProgram(debug_name)
+            , m_Shader(std::move(shader))
+            , m_API(api)
+        {
+            m_Valid = m_Shader.Vertex && m_Shader.Fragment;
+        }
+        ~SoftwareShaderProgram() override { m_API.BindShader(nullptr); }
+
+        inline auto Bind() -> bool override
+        {
+            m_API.BindShader(&m_Shader);
+            return true;
+        }
+
+        inline auto Unbind() -> bool override
+        {
+            m_API.BindShader(nullptr);
+            return true;
+        }
+
+      private:
+        SoftwareShader m_Shader;
+        SoftwareRendererAPI& m_API;
+    };
+
+    class SoftwareTexture2D : public ITexture2D
+    {
+      public:
+        SoftwareTexture2D(const SoftwareTexture2D& other) = delete;
+        SoftwareTexture2D(SoftwareTexture2D&& other) = delete;
+        auto operator=(const SoftwareTexture2D& other) -> SoftwareTexture2D& = delete;
+        auto operator=(SoftwareTexture2D&& other) -> SoftwareTexture2D& = delete;
+
+        SoftwareTexture2D(const TextureDescription& description, SoftwareRendererAPI& api)
+            : ITexture2D(description)
+            , m_API(api)
+        {
+            // Without levels every upload and bind fails, like a texture the GPU had no memory for
+            if (!m_Resource.Allocate(ByteSize())) {
+                return;
+            }
+            for (std::uint32_t level = 0; level < MipLevels(); ++level) {
+                m_Levels.emplace_back(LevelByteSize(level));
+            }
+        }
+        // Pending draws may still sample the decoded pixels
+        ~SoftwareTexture2D() override { m_API.Flush(); }
+
+        /// Only level 0 is sampled, the sampler's mip filter is ignored
+        inline auto Bind(std::uint32_t slot) -> bool override
+        {
+            if (!Allocated()) {
+                return false;
+            }
+            if (m_Dirty) {
+                // Pending draws may sample the old pixels or render into this texture
+                m_API.Flush();
+                m_Pixels = DecodeTextureLevel(Size(), Format(), m_Levels.front());
+                m_Dirty = false;
+            }
+            m_API.Samplers().Bind(slot, {Size(), m_Pixels, m_Sampler});
+            return true;
+        }
+
+        inline auto Unbind(std::uint32_t slot) -> bool override
+        {
+            m_API.Samplers().Unbind(slot);
+            return true;
+        }
+
+        inline auto SetSampler(const SamplerState& sampler) -> bool override
+        {
+            m_Sampler = sampler;
+            return true;
+        }
+
+        inline auto SetData(std::uint32_t level, std::span<const std::byte> data) -> bool override
+        {
+            return SetRows(level, 0, data);
+        }
+
+        inline auto SetRows(std::uint32_t level, std::uint32_t first_row, std::span<const std::byte> data)
+            -> bool override
+        {
+            const auto OFFSET = first_row * LevelRowBytes(level);
+            if (level >= m_Levels.size() || OFFSET + data.size() > m_Levels[level].size()) {
+                return false;
+            }
+
+            m_API.Flush();
+            std::ranges::copy(data, m_Levels[level].begin() + static_cast<std::ptrdiff_t>(OFFSET));
+            m_Dirty = m_Dirty || level == 0;
+            m_Resource.Uploaded(data.size());
+            return true;
+        }
+
+        inline auto GenerateMipmaps() -> bool override { return true; }
+
+        inline auto Allocated() const -> bool { return !m_Levels.empty(); }
+        inline auto LevelData(std::uint32_t level) -> std::span<std::byte> { return m_Levels[level]; }
+        /// Called after level 0 was written without SetData, the next Bind decodes it again
+        inline void Invalidate() { m_Dirty = true; }
+
+      private:
+        SoftwareRendererAPI& m_API;
+        Vector<Vector<std::byte>> m_Levels;
+        Vector<glm::vec4> m_Pixels;
+        bool m_Dirty = true;
+    };
+
+    class SoftwareTextureUploader : public ITextureUploader
+    {
+      public:
+        SoftwareTextureUploader(const SoftwareTextureUploader& other) = delete;
+        SoftwareTextureUploader(SoftwareTextureUploader&& other) = delete;
+        auto operator=(const SoftwareTextureUploader& other) -> SoftwareTextureUploader& = delete;
+        auto operator=(SoftwareTextureUploader&& other) -> SoftwareTextureUploader& = delete;
+
+        explicit SoftwareTextureUploader(std::size_t frame_budget)
+            : ITextureUploader(frame_budget)
+        {
+        }
+        ~SoftwareTextureUploader() override = default;
+
+      private:
+        inline auto MapStaging(std::size_t size) -> std::span<std::byte> override
+        {
+            m_Staging.resize(size);
+            return m_Staging;
+        }
+
+        inline auto SubmitStaging(std::span<const StagedRegion> regions) -> bool override
+        {
+            bool success = true;
+            for (const auto& region : regions) {
+                success = region.Texture->SetRows(region.Level,
+                                                  region.FirstRow,
+                                                  std::span{m_Staging}.subspan(region.StagingOffset, region.ByteSize))
+                    && success;
+            }
+            return success;
+        }
+
+        Vector<std::byte> m_Staging;
+    };
+
+    class SoftwareFramebuffer : public IFramebuffer
+    {
+      public:
+        SoftwareFramebuffer(const SoftwareFramebuffer& other) = delete;
+        SoftwareFramebuffer(SoftwareFramebuffer&& other) = delete;
+        auto operator=(const SoftwareFramebuffer& other) -> SoftwareFramebuffer& = delete;
+        auto operator=(SoftwareFramebuffer&& other) -> SoftwareFramebuffer& = delete;
+
+        /// Draws go into the first color attachment if it's an 8 bit RGBA software texture, otherwise into memory
+        /// that isn't visible outside of the rasterizer
+        SoftwareFramebuffer(const FramebufferDescription& description, SoftwareRendererAPI& api)
+            : IFramebuffer(description)
+            , m_API(api)
+        {
+            constexpr std::size_t COLOR_CHANNELS = 4;
+            const auto PIXEL_COUNT = static_cast<std::size_t>(Size().X) * static_cast<std::size_t>(Size().Y);
+
+            SoftwareSurface surface{Size(), {}, {}, SoftwareDepthStride(Size().X)};
+            if (!m_ColorAttachments.empty()) {
+                // Attachments are created by the global RendererAPI, which doesn't have to be this one
+                m_Target = dynamic_cast<SoftwareTexture2D*>(m_ColorAttachments.front().get());
+                const auto FORMAT = m_ColorAttachments.front()->Format();
+                if (m_Target != nullptr && m_Target->Allocated()
+                    && (FORMAT == TextureFormat::RGBA8 || FORMAT == TextureFormat::SRGB8_ALPHA8)) {
+                    surface.Color = m_Target->LevelData(0);
+                } else {
+                    m_Target = nullptr;
+                    m_Color.resize(PIXEL_COUNT * COLOR_CHANNELS);
+                    surface.Color = m_Color;
+                }
+            }
+            const auto DEPTH_COUNT = static_cast<std::size_t>(surface.DepthStride) * static_cast<std::size_t>(Size().Y);
+            if (description.DepthStencil && m_Resource.Allocate(DEPTH_COUNT * sizeof(float))) {
+                m_Depth.resize(DEPTH_COUNT, 1);
+                surface.Depth = m_Depth;
+            }
+            m_FramebufferID = m_API.RegisterFramebuffer(surface);
+        }
+        ~SoftwareFramebuffer() override { m_API.UnregisterFramebuffer(m_FramebufferID); }
+
+        inline void Bind() override
+        {
+            m_API.BindFramebuffer(m_FramebufferID);
+            if (m_Target != nullptr) {
+                m_Target->Invalidate();
+            }
+        }
+
+        inline void Unbind() override { m_API.BindFramebuffer(0); }
+
+      private:
+        SoftwareRendererAPI& m_API;
+        SoftwareTexture2D* m_Target = nullptr;
+        Vector<std::byte> m_Color;
+        Vector<float> m_Depth;
+    };
+
+}  // namespace JE::detail
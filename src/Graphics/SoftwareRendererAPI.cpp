@@ -0,0 +1,427 @@
+#include "SoftwareRendererAPI.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <optional>
+
+#include "Graphics/Renderer.hpp"
+#include "Graphics/RenderState.hpp"
+#include "Graphics/SoftwareRenderer.hpp"
+#include "Graphics/TextureProcessing.hpp"
+#include "Logger.hpp"
+#include "Types.hpp"
+
+namespace JE::detail
+{
+
+    namespace
+    {
+
+        constexpr std::size_t COLOR_CHANNELS = 4;
+        constexpr float CLEAR_DEPTH = 1.0f;
+
+        auto HalfToFloat(std::uint16_t half) -> float
+        {
+            constexpr std::uint32_t SIGN_SHIFT = 16;
+            constexpr std::uint32_t MANTISSA_SHIFT = 13;
+            constexpr std::uint32_t HALF_EXPONENT_SHIFT = 10;
+            constexpr std::uint32_t EXPONENT_SHIFT = 23;
+            constexpr std::uint32_t EXPONENT_BIAS_DIFFERENCE = 127 - 15;
+            constexpr std::uint32_t HALF_EXPONENT_MASK = 0x1FU;
+            constexpr std::uint32_t HALF_MANTISSA_MASK = 0x3FFU;
+            constexpr std::uint32_t SIGN_MASK = 0x8000U;
+            constexpr std::uint32_t MAX_HALF_EXPONENT = 31;
+            constexpr std::uint32_t FLOAT_INFINITY = 0x7F800000U;
+
+            const auto SIGN = (half & SIGN_MASK) << SIGN_SHIFT;
+            const auto EXPONENT = (std::uint32_t{half} >> HALF_EXPONENT_SHIFT) & HALF_EXPONENT_MASK;
+            const auto MANTISSA = (std::uint32_t{half} & HALF_MANTISSA_MASK) << MANTISSA_SHIFT;
+
+            // Denormal halves are flushed to zero like FloatToHalf produces them
+            if (EXPONENT == 0) {
+                return std::bit_cast<float>(SIGN);
+            }
+            if (EXPONENT == MAX_HALF_EXPONENT) {
+                return std::bit_cast<float>(SIGN | FLOAT_INFINITY | MANTISSA);
+            }
+            return std::bit_cast<float>(SIGN | ((EXPONENT + EXPONENT_BIAS_DIFFERENCE) << EXPONENT_SHIFT) | MANTISSA);
+        }
+
+        template<typename T, std::size_t CHANNELS, typename Convert>
+        void DecodeUncompressed(std::span<const std::byte> data, Vector<glm::vec4>& pixels, Convert convert)
+        {
+            for (std::size_t i = 0; i < pixels.size(); ++i) {
+                for (std::size_t channel = 0; channel < CHANNELS; ++channel) {
+                    T value{};
+                    std::memcpy(&value, &data[(i * CHANNELS + channel) * sizeof(T)], sizeof(T));
+                    pixels[i][static_cast<glm::length_t>(channel)] = convert(value);
+                }
+            }
+        }
+
+        auto FromUnorm8(std::uint8_t value) -> float { return static_cast<float>(value) / RGBA::COLOR8_MAX_VALUE; }
+
+    }  // namespace
+
+    auto DecodeTextureLevel(const Size2D& size, TextureFormat format, std::span<const std::byte> data)
+        -> Vector<glm::vec4>
+    {
+        Image image{size, Vector<glm::vec4>(static_cast<std::size_t>(size.X) * static_cast<std::size_t>(size.Y))};
+        std::ranges::fill(image.Pixels, glm::vec4{0, 0, 0, 1});
+
+        switch (format) {
+            case TextureFormat::R8:
+                DecodeUncompressed<std::uint8_t, 1>(data, image.Pixels, FromUnorm8);
+                break;
+            case TextureFormat::RG8:
+                DecodeUncompressed<std::uint8_t, 2>(data, image.Pixels, FromUnorm8);
+                break;
+            case TextureFormat::RGBA8:
+            case TextureFormat::SRGB8_ALPHA8:
+                DecodeUncompressed<std::uint8_t, COLOR_CHANNELS>(data, image.Pixels, FromUnorm8);
+                break;
+            case TextureFormat::RGBA16F:
+                DecodeUncompressed<std::uint16_t, COLOR_CHANNELS>(data, image.Pixels, HalfToFloat);
+                break;
+            case TextureFormat::RGBA32F:
+                DecodeUncompressed<float, COLOR_CHANNELS>(data, image.Pixels, [](float value) { return value; });
+                break;
+            default: {
+                ASSERT(IsCompressedFormat(format));
+
+                const auto INFO = GetTextureFormatInfo(format);
+                const auto BLOCK_WIDTH = static_cast<std::int32_t>(INFO.BlockWidth);
+                const auto BLOCK_HEIGHT = static_cast<std::int32_t>(INFO.BlockHeight);
+                const auto BLOCKS_X = (size.X + BLOCK_WIDTH - 1) / BLOCK_WIDTH;
+                const auto IS_BC1 = format == TextureFormat::BC1_RGBA || format == TextureFormat::BC1_SRGB_ALPHA;
+                for (std::int32_t y = 0; y < size.Y; y += BLOCK_HEIGHT) {
+                    for (std::int32_t x = 0; x < size.X; x += BLOCK_WIDTH) {
+                        const auto BLOCK_INDEX = y / BLOCK_HEIGHT * BLOCKS_X + x / BLOCK_WIDTH;
+                        const auto BLOCK =
+                            data.subspan(static_cast<std::size_t>(BLOCK_INDEX) * INFO.BlockBytes, INFO.BlockBytes);
+                        const auto PIXELS = IS_BC1 ? DecodeBC1Block(BLOCK.first<BC1_BLOCK_BYTES>())
+                                                   : DecodeBC3Block(BLOCK.first<BC3_BLOCK_BYTES>());
+
+                        // Partial blocks at the right and top edges only keep the pixels inside the level
+                        const auto WIDTH = std::min(BLOCK_WIDTH, size.X - x);
+                        const auto HEIGHT = std::min(BLOCK_HEIGHT, size.Y - y);
+                        for (std::int32_t block_y = 0; block_y < HEIGHT; ++block_y) {
+                            for (std::int32_t block_x = 0; block_x < WIDTH; ++block_x) {
+                                image.Pixels[static_cast<std::size_t>((y + block_y) * size.X + x + block_x)] =
+                                    PIXELS[static_cast<std::size_t>(block_y * BLOCK_WIDTH + block_x)];
+                            }
+                        }
+                    }
+                }
+                break;
+            }
+        }
+
+        if (IsSRGBFormat(format)) {
+            return SRGBToLinear(image).Pixels;
+        }
+        return std::move(image.Pixels);
+    }
+
+    SoftwareRendererAPI::SoftwareRendererAPI(const Size2D& default_framebuffer_size, std::uint32_t worker_count)
+        : m_Rasterizer(worker_count)
+        , m_DefaultSize(default_framebuffer_size)
+        , m_DefaultColor(static_cast<std::size_t>(default_framebuffer_size.X)
+                         * static_cast<std::size_t>(default_framebuffer_size.Y) * COLOR_CHANNELS)
+        , m_DefaultDepth(static_cast<std::size_t>(SoftwareDepthStride(default_framebuffer_size.X))
+                             * static_cast<std::size_t>(default_framebuffer_size.Y),
+                         CLEAR_DEPTH)
+    {
+        RegisterShader(Renderer::QUAD_SHADER_NAME, QuadShader());
+        BindFramebuffer(0);
+    }
+
+    auto SoftwareRendererAPI::Name() const -> std::string_view { return "Software"; }
+
+    auto SoftwareRendererAPI::SetClearColor(const RGBA& color) -> bool
+    {
+        m_ClearColor = color.Color;
+        return true;
+    }
+
+    auto SoftwareRendererAPI::ClearFramebuffer(AttachmentFlags flags) -> bool
+    {
+        const bool CLEAR_COLOR = (flags & AttachmentFlag::COLOR) != 0u;
+        const bool CLEAR_DEPTH_BUFFER = (flags & AttachmentFlag::DEPTH) != 0u;
+        m_Rasterizer.Clear(CLEAR_COLOR ? std::optional{m_ClearColor} : std::nullopt,
+                           CLEAR_DEPTH_BUFFER ? std::optional{CLEAR_DEPTH} : std::nullopt);
+        return true;
+    }
+
+    auto SoftwareRendererAPI::BindFramebuffer(FramebufferID buffer_id) -> bool
+    {
+        if (buffer_id == 0) {
+            m_Rasterizer.SetSurface(
+                {m_DefaultSize, m_DefaultColor, m_DefaultDepth, SoftwareDepthStride(m_DefaultSize.X)});
+            m_BoundFramebuffer = 0;
+            return true;
+        }
+
+        const auto FRAMEBUFFER = m_Framebuffers.find(buffer_id);
+        if (FRAMEBUFFER == m_Framebuffers.end()) {
+            EngineLogger()->error("Software framebuffer {} doesn't exist", buffer_id);
+            return false;
+        }
+        m_Rasterizer.SetSurface(FRAMEBUFFER->second);
+        m_BoundFramebuffer = buffer_id;
+        return true;
+    }
+
+    auto SoftwareRendererAPI::DrawIndexed(Primitive primitive_type,
+                                          std::uint32_t index_count,
+                                          Type index_type,
+                                          std::uint32_t first_index,
+                                          std::int32_t base_vertex) -> bool
+    {
+        if (m_BoundVertexArray == nullptr || primitive_type != Primitive::TRIANGLES) {
+            return false;
+        }
+
+        const auto INDEX_BYTES = TypeByteCount(index_type);
+        const auto INDEX_DATA = m_BoundVertexArray->Indices();
+        if (index_type == Type::FLOAT || (std::size_t{first_index} + index_count) * INDEX_BYTES > INDEX_DATA.size()) {
+            EngineLogger()->error("Software draw of {} indices reads past the element buffer", index_count);
+            return false;
+        }
+        if (index_count == 0) {
+            return true;
+        }
+
+        m_Indices.resize(index_count);
+        for (std::size_t i = 0; i < index_count; ++i) {
+            const auto* source = &INDEX_DATA[(first_index + i) * INDEX_BYTES];
+            if (index_type == Type::UNSIGNED_SHORT) {
+                std::uint16_t index = 0;
+                std::memcpy(&index, source, sizeof(index));
+                m_Indices[i] = index;
+            } else {
+                std::memcpy(&m_Indices[i], source, sizeof(std::uint32_t));
+            }
+            // An index below zero wraps around and fails the vertex buffer bounds check below
+            m_Indices[i] += static_cast<std::uint32_t>(base_vertex);
+        }
+
+        const auto [MIN_INDEX, MAX_INDEX] = std::ranges::minmax(m_Indices);
+        if (!FetchVertices(*m_BoundVertexArray, MIN_INDEX, MAX_INDEX)) {
+            EngineLogger()->error("Software draw indexes vertex {} past the vertex buffers", MAX_INDEX);
+            return false;
+        }
+
+        const auto& shader = m_BoundShader != nullptr ? *m_BoundShader : m_DefaultShader;
+        m_Rasterizer.Draw(shader, m_Samplers, m_Vertices, m_Indices);
+        return true;
+    }
+
+    auto SoftwareRendererAPI::FetchVertices(const SoftwareVertexArray& vertex_array,
+                                            std::uint32_t first,
+                                            std::uint32_t last) -> bool
+    {
+        constexpr glm::vec4 DEFAULT_ATTRIBUTE{0, 0, 0, 1};
+
+        SoftwareShader::Attributes defaults;
+        defaults.fill(DEFAULT_ATTRIBUTE);
+        m_Vertices.resize(std::size_t{last} + 1);
+        std::fill(m_Vertices.begin() + first, m_Vertices.end(), defaults);
+
+        // Attribute locations continue from one buffer to the next like Build assigns them
+        std::size_t location = 0;
+        for (std::size_t buffer = 0; buffer < vertex_array.Buffers().size(); ++buffer) {
+            const auto& vertex_buffer = vertex_array.VertexBuffer(buffer);
+            const auto& layout = vertex_buffer.Layout();
+            const auto DATA = vertex_buffer.Data();
+            if ((std::size_t{last} + 1) * layout.Stride() > DATA.size()) {
+                return false;
+            }
+
+            for (const auto& attribute : layout) {
+                if (location >= SoftwareShader::MAX_ATTRIBUTES) {
+                    return true;
+                }
+
+                const auto COMPONENTS = std::min<std::size_t>(attribute.ComponentCount, COLOR_CHANNELS);
+                for (std::size_t vertex = first; vertex <= last; ++vertex) {
+                    std::memcpy(&m_Vertices[vertex][location],
+                                &DATA[vertex * layout.Stride() + attribute.Offset],
+                                COMPONENTS * sizeof(float));
+                }
+                ++location;
+            }
+        }
+        return true;
+    }
+
+    auto SoftwareRendererAPI::SetRenderState(const RenderState& state) -> bool
+    {
+        m_Rasterizer.SetDepthTest(state.DepthStencil.DepthTest);
+        return true;
+    }
+
+    auto SoftwareRendererAPI::CreateVertexBuffer(const AttributeLayout& layout) -> Scope<IVertexBuffer>
+    {
+        return CreateScope<SoftwareVertexBuffer>(layout);
+    }
+
+    auto SoftwareRendererAPI::CreateElementBuffer() -> Scope<IElementBuffer>
+    {
+        return CreateScope<SoftwareElementBuffer>();
+    }
+
+    auto SoftwareRendererAPI::CreateVertexArray() -> Scope<IVertexArray>
+    {
+        return CreateScope<SoftwareVertexArray>(*this);
+    }
+
+    auto SoftwareRendererAPI::CreateShader(std::string_view debug_name,
+                                           [[maybe_unused]] std::string_view vertex_source,
+                                           [[maybe_unused]] std::string_view fragment_source) -> Scope<IShaderProgram>
+    {
+        const auto SHADER = m_Shaders.find(std::string{debug_name});
+        if (SHADER == m_Shaders.end()) {
+            EngineLogger()->debug("No software shader registered for {}, using the default shader", debug_name);
+            return CreateScope<SoftwareShaderProgram>(debug_name, m_DefaultShader, *this);
+        }
+        return CreateScope<SoftwareShaderProgram>(debug_name, SHADER->second, *this);
+    }
+
+    auto SoftwareRendererAPI::CreateTexture2D(const TextureDescription& description) -> Scope<ITexture2D>
+    {
+        return CreateScope<SoftwareTexture2D>(description, *this);
+    }
+
+    auto SoftwareRendererAPI::CreateTextureUploader(std::size_t frame_budget) -> Scope<ITextureUploader>
+    {
+        return CreateScope<SoftwareTextureUploader>(frame_budget);
+    }
+
+    auto SoftwareRendererAPI::CreateFramebuffer(const FramebufferDescription& description) -> Scope<IFramebuffer>
+    {
+        return CreateScope<SoftwareFramebuffer>(description, *this);
+    }
+
+    auto SoftwareRendererAPI::InsertFence() -> FenceID { return ++m_LastFence; }
+
+    auto SoftwareRendererAPI::WaitFence([[maybe_unused]] FenceID fence, [[maybe_unused]] std::uint64_t timeout_ns)
+        -> bool
+    {
+        m_Rasterizer.Flush();
+        return true;
+    }
+
+    void SoftwareRendererAPI::DeleteFence([[maybe_unused]] FenceID fence) {}
+
+    auto SoftwareRendererAPI::Finish() -> bool
+    {
+        m_Rasterizer.Flush();
+        return true;
+    }
+
+    // Draws are rasterized before the frame ends, nothing outlives the objects it reads
+    void SoftwareRendererAPI::EndFrame() {}
+
+    auto SoftwareRendererAPI::BeginTimerQuery() -> TimerQueryID
+    {
+        // Triangles binned before the query belong to the commands in front of it
+        m_Rasterizer.Flush();
+        m_TimerQueryStarts[++m_LastTimerQuery] = std::chrono::steady_clock::now();
+        return m_LastTimerQuery;
+    }
+
+    auto SoftwareRendererAPI::EndTimerQuery(TimerQueryID query) -> bool
+    {
+        const auto START = m_TimerQueryStarts.find(query);
+        if (START == m_TimerQueryStarts.end()) {
+            return false;
+        }
+
+        m_Rasterizer.Flush();
+        const auto ELAPSED = std::chrono::steady_clock::now() - START->second;
+        m_TimerQueryResults[query] =
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(ELAPSED).count());
+        m_TimerQueryStarts.erase(START);
+        return true;
+    }
+
+    auto SoftwareRendererAPI::TimerQueryResult(TimerQueryID query) -> std::optional<std::uint64_t>
+    {
+        const auto RESULT = m_TimerQueryResults.find(query);
+        if (RESULT == m_TimerQueryResults.end()) {
+            return std::nullopt;
+        }
+        return RESULT->second;
+    }
+
+    void SoftwareRendererAPI::DeleteTimerQuery(TimerQueryID query)
+    {
+        m_TimerQueryStarts.erase(query);
+        m_TimerQueryResults.erase(query);
+    }
+
+    // cppcheck-suppress unusedFunction
+    void SoftwareRendererAPI::RegisterShader(std::string_view debug_name, SoftwareShader shader)
+    {
+        m_Shaders.insert_or_assign(std::string{debug_name}, std::move(shader));
+    }
+
+    auto SoftwareRendererAPI::DefaultShader() -> SoftwareShader
+    {
+        SoftwareShader shader;
+        shader.Vertex = [](const SoftwareShader::Attributes& attributes, SoftwareShader::Varyings& varyings)
+        {
+            varyings[0] = attributes[1];
+            return glm::vec4{attributes[0].x, attributes[0].y, attributes[0].z, 1};
+        };
+        shader.Fragment = [](const SoftwareShader::Varyings& varyings, const SoftwareSamplers& samplers)
+        {
+            return samplers.Bound(0) ? samplers.Sample(0, {varyings[0].x, varyings[0].y}) : glm::vec4{1};
+        };
+        shader.VaryingCount = 1;
+        return shader;
+    }
+
+    auto SoftwareRendererAPI::QuadShader() -> SoftwareShader
+    {
+        SoftwareShader shader;
+        shader.Vertex = [](const SoftwareShader::Attributes& attributes, SoftwareShader::Varyings& varyings)
+        {
+            varyings[0] = attributes[1];
+            varyings[1] = attributes[2];
+            return glm::vec4{attributes[0].x, attributes[0].y, attributes[0].z, 1};
+        };
+        shader.Fragment = [](const SoftwareShader::Varyings& varyings, const SoftwareSamplers& samplers)
+        {
+            const auto TEXEL = samplers.Bound(0) ? samplers.Sample(0, {varyings[0].x, varyings[0].y}) : glm::vec4{1};
+            return TEXEL * varyings[1];
+        };
+        shader.VaryingCount = 2;
+        return shader;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto SoftwareRendererAPI::DefaultFramebufferPixels() -> std::span<const std::byte>
+    {
+        m_Rasterizer.Flush();
+        return m_DefaultColor;
+    }
+
+    auto SoftwareRendererAPI::RegisterFramebuffer(const SoftwareSurface& surface) -> FramebufferID
+    {
+        const auto ID = m_NextFramebufferID++;
+        m_Framebuffers.emplace(ID, surface);
+        return ID;
+    }
+
+    void SoftwareRendererAPI::UnregisterFramebuffer(FramebufferID buffer_id)
+    {
+        if (m_BoundFramebuffer == buffer_id) {
+            BindFramebuffer(0);
+        }
+        m_Framebuffers.erase(buffer_id);
+    }
+
+}  // namespace JE::detail
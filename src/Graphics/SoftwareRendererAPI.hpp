@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+#include "Graphics/IRendererAPI.hpp"
+#include "Graphics/SoftwareRasterizer.hpp"
+#include "Memory.hpp"
+#include "Types.hpp"
+
+namespace JE
+{
+    struct RGBA;
+}  // namespace JE
+
+namespace JE::detail
+{
+
+    class SoftwareVertexArray;
+
+    /// CPU backend for headless servers and golden image tests, draws are rasterized by the SoftwareRasterizer when
+    /// the target changes or the GPU would be synchronized with. GLSL can't run here, programs use the C++ shader
+    /// registered under their debug name instead
+    class SoftwareRendererAPI final : public IRendererAPI
+    {
+      public:
+        static constexpr Size2D DEFAULT_FRAMEBUFFER_SIZE{1280, 720};
+
+        explicit SoftwareRendererAPI(const Size2D& default_framebuffer_size = DEFAULT_FRAMEBUFFER_SIZE,
+                                     std::uint32_t worker_count = 0);
+
+        auto Name() const -> std::string_view override;
+
+        auto SetClearColor(const RGBA& color) -> bool override;
+        auto ClearFramebuffer(AttachmentFlags flags) -> bool override;
+        auto BindFramebuffer(FramebufferID buffer_id) -> bool override;
+        auto DrawIndexed(Primitive primitive_type,
+                         std::uint32_t index_count,
+                         Type index_type,
+                         std::uint32_t first_index,
+                         std::int32_t base_vertex) -> bool override;
+        /// The rasterizer only has a less depth test with depth writes, the rest of the state is ignored
+        auto SetRenderState(const RenderState& state) -> bool override;
+
+        auto CreateVertexBuffer(const AttributeLayout& layout) -> Scope<IVertexBuffer> override;
+        auto CreateElementBuffer() -> Scope<IElementBuffer> override;
+        auto CreateVertexArray() -> Scope<IVertexArray> override;
+        auto CreateShader(std::string_view debug_name,
+                          std::string_view vertex_source,
+                          std::string_view fragment_source) -> Scope<IShaderProgram> override;
+        auto CreateTexture2D(const TextureDescription& description) -> Scope<ITexture2D> override;
+        auto CreateTextureUploader(std::size_t frame_budget) -> Scope<ITextureUploader> override;
+        auto CreateFramebuffer(const FramebufferDescription& description) -> Scope<IFramebuffer> override;
+
+        /// Draws are rasterized in order, so waiting for a fence is a flush
+        auto InsertFence() -> FenceID override;
+        auto WaitFence(FenceID fence, std::uint64_t timeout_ns) -> bool override;
+        void DeleteFence(FenceID fence) override;
+        auto Finish() -> bool override;
+        void EndFrame() override;
+
+        /// The rasterizer runs on the CPU, queries measure the wall time of the rasterization between them
+        auto BeginTimerQuery() -> TimerQueryID override;
+        auto EndTimerQuery(TimerQueryID query) -> bool override;
+        auto TimerQueryResult(TimerQueryID query) -> std::optional<std::uint64_t> override;
+        void DeleteTimerQuery(TimerQueryID query) override;
+
+        /// Programs created afterwards with this debug name use the shader
+        void RegisterShader(std::string_view debug_name, SoftwareShader shader);
+        /// Used by programs without a registered shader, passes attribute 0 through as the position and samples
+        /// slot 0 at attribute 1, unbound slots draw white
+        static auto DefaultShader() -> SoftwareShader;
+        /// Registered for Renderer::QUAD_SHADER_NAME, like DefaultShader but tints the texels with attribute 2
+        static auto QuadShader() -> SoftwareShader;
+
+        /// Depth test is off by default like in the OpenGL backend
+        inline void SetDepthTest(bool enabled) { m_Rasterizer.SetDepthTest(enabled); }
+        inline void SetSIMDLevel(SIMDLevel level) { m_Rasterizer.SetSIMDLevel(level); }
+
+        /// RGBA8 rows from bottom to top like glReadPixels returns them, flushes the pending draws
+        auto DefaultFramebufferPixels() -> std::span<const std::byte>;
+        inline auto DefaultFramebufferSize() const -> const Size2D& { return m_DefaultSize; }
+
+        // Called by the software objects while they're bound, created or destroyed
+        inline void Flush() { m_Rasterizer.Flush(); }
+        inline void BindVertexArray(SoftwareVertexArray* vertex_array) { m_BoundVertexArray = vertex_array; }
+        inline void BindShader(const SoftwareShader* shader) { m_BoundShader = shader; }
+        inline auto Samplers() -> SoftwareSamplers& { return m_Samplers; }
+        auto RegisterFramebuffer(const SoftwareSurface& surface) -> FramebufferID;
+        void UnregisterFramebuffer(FramebufferID buffer_id);
+
+      private:
+        auto FetchVertices(const SoftwareVertexArray& vertex_array, std::uint32_t first, std::uint32_t last) -> bool;
+
+        SoftwareRasterizer m_Rasterizer;
+        glm::vec4 m_ClearColor{0, 0, 0, 1};
+
+        Size2D m_DefaultSize;
+        Vector<std::byte> m_DefaultColor;
+        Vector<float> m_DefaultDepth;
+        std::unordered_map<FramebufferID, SoftwareSurface> m_Framebuffers;
+        FramebufferID m_NextFramebufferID = 1;
+        FramebufferID m_BoundFramebuffer = 0;
+
+        std::unordered_map<std::string, SoftwareShader> m_Shaders;
+        SoftwareShader m_DefaultShader = DefaultShader();
+        const SoftwareShader* m_BoundShader = nullptr;
+        SoftwareVertexArray* m_BoundVertexArray = nullptr;
+        SoftwareSamplers m_Samplers;
+        FenceID m_LastFence = 0;
+        std::unordered_map<TimerQueryID, std::chrono::steady_clock::time_point> m_TimerQueryStarts;
+        std::unordered_map<TimerQueryID, std::uint64_t> m_TimerQueryResults;
+        TimerQueryID m_LastTimerQuery = 0;
+
+        Vector<SoftwareShader::Attributes> m_Vertices;
+        Vector<std::uint32_t> m_Indices;
+    };
+
+}  // namespace JE::detail
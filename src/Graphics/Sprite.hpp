@@ -0,0 +1,18 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace JE
+{
+
+    class ITexture2D;
+
+    /// What DrawQuad needs to draw part of a texture, quads sharing a texture are drawn in the same batch
+    struct Sprite
+    {
+        ITexture2D* Texture = nullptr;
+        glm::vec2 UVMin{0.f};
+        glm::vec2 UVMax{1.f};
+    };
+
+}  // namespace JE
@@ -0,0 +1,110 @@
+#include <cstring>
+
+#include "Texture.hpp"
+
+#include "Assert.hpp"
+#include "IRendererAPI.hpp"
+#include "Logger.hpp"
+
+namespace JE
+{
+
+    // cppcheck-suppress unusedFunction
+    auto CreateTexture2D(const TextureDescription& description) -> Scope<ITexture2D>
+    {
+        return RendererAPI().CreateTexture2D(description);
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto CreateTextureUploader(std::size_t frame_budget) -> Scope<ITextureUploader>
+    {
+        return RendererAPI().CreateTextureUploader(frame_budget);
+    }
+
+    // cppcheck-suppress unusedFunction
+    void ITextureUploader::Upload(Ref<ITexture2D> texture, std::uint32_t level, Vector<std::byte> pixels)
+    {
+        ASSERT(texture != nullptr);
+        ASSERT(level < texture->MipLevels());
+
+        if (pixels.size() != texture->LevelByteSize(level)) {
+            EngineLogger()->error("Texture upload of level {} is {} bytes, expected {}",
+                                  level,
+                                  pixels.size(),
+                                  texture->LevelByteSize(level));
+            return;
+        }
+
+        ++texture->m_PendingUploads;
+        m_PendingBytes += pixels.size();
+        m_Queue.push_back({std::move(texture), level, std::move(pixels)});
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto ITextureUploader::Process() -> std::size_t
+    {
+        if (m_Queue.empty()) {
+            return 0;
+        }
+
+        // Plan the row ranges that fit into this frame's budget, in queue order
+        m_Regions.clear();
+        std::size_t staged_bytes = 0;
+        for (const auto& upload : m_Queue) {
+            const auto ROW_BYTES = upload.Texture->LevelRowBytes(upload.Level);
+            const auto ROWS_LEFT = upload.Texture->LevelRowCount(upload.Level) - upload.RowsUploaded;
+
+            const auto BUDGET_LEFT = staged_bytes < m_FrameBudget ? m_FrameBudget - staged_bytes : 0;
+
+            auto rows = static_cast<std::uint32_t>(std::min<std::size_t>(ROWS_LEFT, BUDGET_LEFT / ROW_BYTES));
+            if (rows == 0) {
+                if (!m_Regions.empty()) {
+                    break;
+                }
+                // A single row larger than the budget still has to make progress
+                rows = 1;
+            }
+
+            m_Regions.push_back(
+                {upload.Texture.get(), upload.Level, upload.RowsUploaded, rows, staged_bytes, rows * ROW_BYTES});
+            staged_bytes += rows * ROW_BYTES;
+
+            if (rows < ROWS_LEFT) {
+                break;
+            }
+        }
+
+        auto staging = MapStaging(staged_bytes);
+        if (staging.empty()) {
+            return 0;
+        }
+
+        for (std::size_t i = 0; i < m_Regions.size(); ++i) {
+            const auto& region = m_Regions[i];
+            const auto& upload = m_Queue[i];
+            const auto SOURCE_OFFSET = region.FirstRow * region.Texture->LevelRowBytes(region.Level);
+
+            std::memcpy(&staging[region.StagingOffset], &upload.Pixels[SOURCE_OFFSET], region.ByteSize);
+        }
+
+        // The rows stay queued and are staged again next frame
+        if (!SubmitStaging(m_Regions)) {
+            EngineLogger()->error("Failed to submit {} staged texture bytes", staged_bytes);
+            return 0;
+        }
+
+        for (const auto& region : m_Regions) {
+            auto& upload = m_Queue.front();
+            upload.RowsUploaded += region.RowCount;
+            m_PendingBytes -= region.ByteSize;
+
+            if (upload.RowsUploaded == upload.Texture->LevelRowCount(upload.Level)) {
+                --upload.Texture->m_PendingUploads;
+                m_Queue.pop_front();
+            }
+        }
+
+        return staged_bytes;
+    }
+
+}  // namespace JE
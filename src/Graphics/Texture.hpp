@@ -0,0 +1,287 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+
+#include "Assert.hpp"
+#include "IRendererAPI.hpp"
+#include "Memory.hpp"
+#include "ResourceTracker.hpp"
+#include "Types.hpp"
+
+namespace JE
+{
+
+    enum class TextureFormat
+    {
+        R8,
+        RG8,
+        RGBA8,
+        SRGB8_ALPHA8,
+        RGBA16F,
+        RGBA32F,
+        BC1_RGBA,
+        BC1_SRGB_ALPHA,
+        BC3_RGBA,
+        BC3_SRGB_ALPHA
+    };
+
+    /// Textures are stored as rows of blocks, uncompressed formats use 1x1 blocks of one pixel
+    struct TextureFormatInfo
+    {
+        std::uint32_t BlockWidth = 1;
+        std::uint32_t BlockHeight = 1;
+        std::uint32_t BlockBytes = 0;
+    };
+
+    constexpr auto GetTextureFormatInfo(TextureFormat format) -> TextureFormatInfo
+    {
+        switch (format) {
+            case TextureFormat::R8:
+                return {1, 1, 1};
+            case TextureFormat::RG8:
+                return {1, 1, 2};
+            case TextureFormat::RGBA8:
+            case TextureFormat::SRGB8_ALPHA8:
+                return {1, 1, 4};
+            case TextureFormat::RGBA16F:
+                return {1, 1, 8};  // NOLINT(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+            case TextureFormat::RGBA32F:
+                return {1, 1, 16};  // NOLINT(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+            case TextureFormat::BC1_RGBA:
+            case TextureFormat::BC1_SRGB_ALPHA:
+                return {4, 4, 8};  // NOLINT(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+            case TextureFormat::BC3_RGBA:
+            case TextureFormat::BC3_SRGB_ALPHA:
+                return {4, 4, 16};  // NOLINT(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+            default:
+                return {};
+        }
+    }
+
+    constexpr auto IsCompressedFormat(TextureFormat format) -> bool
+    {
+        return GetTextureFormatInfo(format).BlockWidth > 1;
+    }
+
+    constexpr auto IsSRGBFormat(TextureFormat format) -> bool
+    {
+        return format == TextureFormat::SRGB8_ALPHA8 || format == TextureFormat::BC1_SRGB_ALPHA
+               || format == TextureFormat::BC3_SRGB_ALPHA;
+    }
+
+    enum class TextureFilter
+    {
+        NEAREST,
+        LINEAR
+    };
+
+    enum class TextureWrap
+    {
+        REPEAT,
+        MIRRORED_REPEAT,
+        CLAMP_TO_EDGE
+    };
+
+    struct SamplerState
+    {
+        TextureFilter MinFilter = TextureFilter::LINEAR;
+        TextureFilter MagFilter = TextureFilter::LINEAR;
+        /// Filter between mip levels, ignored for textures with a single level
+        TextureFilter MipFilter = TextureFilter::LINEAR;
+        TextureWrap WrapU = TextureWrap::REPEAT;
+        TextureWrap WrapV = TextureWrap::REPEAT;
+    };
+
+    constexpr auto MipLevelCount(const Size2D& size) -> std::uint32_t
+    {
+        const auto LARGEST = static_cast<std::uint32_t>(std::max({size.X, size.Y, 1}));
+        // countl_zero returns int on every standard library while bit_width doesn't
+        return 32U - static_cast<std::uint32_t>(std::countl_zero(LARGEST));
+    }
+
+    constexpr auto MipLevelSize(const Size2D& size, std::uint32_t level) -> Size2D
+    {
+        return {std::max(size.X >> level, 1), std::max(size.Y >> level, 1)};
+    }
+
+    struct TextureDescription
+    {
+        static constexpr std::uint32_t FULL_MIP_CHAIN = 0;
+
+        Size2D Size;
+        TextureFormat Format = TextureFormat::RGBA8;
+        std::uint32_t MipLevels = 1;
+    };
+
+    /// CPU side texture contents, one tightly packed buffer of block rows per mip level
+    struct TextureData
+    {
+        TextureDescription Description;
+        Vector<Vector<std::byte>> Levels;
+    };
+
+    class ITexture2D
+    {
+        friend class ITextureUploader;
+
+      public:
+        ITexture2D(const ITexture2D& other) = delete;
+        ITexture2D(ITexture2D&& other) = delete;
+        auto operator=(const ITexture2D& other) -> ITexture2D& = delete;
+        auto operator=(ITexture2D&& other) -> ITexture2D& = delete;
+
+        explicit ITexture2D(const TextureDescription& description)
+            : m_Description(description)
+        {
+            ASSERT(description.Size.X > 0 && description.Size.Y > 0);
+
+            const auto MAX_LEVELS = MipLevelCount(description.Size);
+            if (m_Description.MipLevels == TextureDescription::FULL_MIP_CHAIN) {
+                m_Description.MipLevels = MAX_LEVELS;
+            }
+            m_Description.MipLevels = std::min(m_Description.MipLevels, MAX_LEVELS);
+        }
+        virtual ~ITexture2D() = default;
+
+        inline auto ID() const -> IRendererAPI::TextureID { return m_TextureID; }
+
+        inline auto Description() const -> const TextureDescription& { return m_Description; }
+        inline auto Size() const -> const Size2D& { return m_Description.Size; }
+        inline auto Format() const -> TextureFormat { return m_Description.Format; }
+        inline auto MipLevels() const -> std::uint32_t { return m_Description.MipLevels; }
+
+        inline auto LevelSize(std::uint32_t level) const -> Size2D { return MipLevelSize(m_Description.Size, level); }
+
+        /// Rows of blocks in a mip level, a row is one pixel high for uncompressed formats
+        inline auto LevelRowCount(std::uint32_t level) const -> std::uint32_t
+        {
+            const auto INFO = GetTextureFormatInfo(m_Description.Format);
+            return (static_cast<std::uint32_t>(LevelSize(level).Y) + INFO.BlockHeight - 1) / INFO.BlockHeight;
+        }
+
+        inline auto LevelRowBytes(std::uint32_t level) const -> std::size_t
+        {
+            const auto INFO = GetTextureFormatInfo(m_Description.Format);
+            const auto WIDTH = static_cast<std::uint32_t>(LevelSize(level).X);
+            return std::size_t{(WIDTH + INFO.BlockWidth - 1) / INFO.BlockWidth} * INFO.BlockBytes;
+        }
+
+        inline auto LevelByteSize(std::uint32_t level) const -> std::size_t
+        {
+            return LevelRowBytes(level) * LevelRowCount(level);
+        }
+
+        /// Bytes of every mip level together
+        inline auto ByteSize() const -> std::size_t
+        {
+            std::size_t bytes = 0;
+            for (std::uint32_t level = 0; level < m_Description.MipLevels; ++level) {
+                bytes += LevelByteSize(level);
+            }
+            return bytes;
+        }
+
+        inline auto Sampler() const -> const SamplerState& { return m_Sampler; }
+
+        /// False while streamed uploads of this texture are still queued
+        inline auto Ready() const -> bool { return m_PendingUploads == 0; }
+
+        virtual auto Bind(std::uint32_t slot) -> bool = 0;
+
+        virtual auto Unbind(std::uint32_t slot) -> bool = 0;
+
+        virtual auto SetSampler(const SamplerState& sampler) -> bool = 0;
+
+        /// Synchronous upload of a whole mip level, large textures should go through the ITextureUploader instead
+        virtual auto SetData(std::uint32_t level, std::span<const std::byte> data) -> bool = 0;
+
+        /// Synchronous upload of whole rows of a mip level starting at first_row, data holds tightly packed rows
+        virtual auto SetRows(std::uint32_t level, std::uint32_t first_row, std::span<const std::byte> data) -> bool = 0;
+
+        virtual auto GenerateMipmaps() -> bool = 0;
+
+      protected:
+        IRendererAPI::TextureID m_TextureID = 0;
+        TextureDescription m_Description;
+        SamplerState m_Sampler;
+        TrackedResource m_Resource{ResourceType::TEXTURE};
+
+      private:
+        std::uint32_t m_PendingUploads = 0;
+    };
+
+    auto CreateTexture2D(const TextureDescription& description) -> Scope<ITexture2D>;
+
+    /// Streams texture data to the GPU through staging memory, at most FrameBudget bytes are staged every frame and
+    /// large mip levels are split into row ranges across frames
+    class ITextureUploader
+    {
+      public:
+        static constexpr std::size_t DEFAULT_FRAME_BUDGET = std::size_t{8} * 1024 * 1024;
+
+        ITextureUploader(const ITextureUploader& other) = delete;
+        ITextureUploader(ITextureUploader&& other) = delete;
+        auto operator=(const ITextureUploader& other) -> ITextureUploader& = delete;
+        auto operator=(ITextureUploader&& other) -> ITextureUploader& = delete;
+
+        explicit ITextureUploader(std::size_t frame_budget = DEFAULT_FRAME_BUDGET)
+            : m_FrameBudget(frame_budget)
+        {
+        }
+        virtual ~ITextureUploader() = default;
+
+        /// Queues a whole mip level, pixels are tightly packed rows
+        void Upload(Ref<ITexture2D> texture, std::uint32_t level, Vector<std::byte> pixels);
+
+        /// Stages and submits queued uploads within the frame budget, called once per frame
+        /// \returns bytes submitted this frame
+        auto Process() -> std::size_t;
+
+        inline void SetFrameBudget(std::size_t frame_budget) { m_FrameBudget = frame_budget; }
+        inline auto FrameBudget() const -> std::size_t { return m_FrameBudget; }
+
+        inline auto PendingUploads() const -> std::size_t { return m_Queue.size(); }
+        inline auto PendingBytes() const -> std::size_t { return m_PendingBytes; }
+        inline auto Idle() const -> bool { return m_Queue.empty(); }
+
+      protected:
+        struct StagedRegion
+        {
+            ITexture2D* Texture = nullptr;
+            std::uint32_t Level = 0;
+            std::uint32_t FirstRow = 0;
+            std::uint32_t RowCount = 0;
+            std::size_t StagingOffset = 0;
+            std::size_t ByteSize = 0;
+        };
+
+        /// Staging memory for this frame, an empty span skips the frame (e.g. the staging buffer is still in use)
+        virtual auto MapStaging(std::size_t size) -> std::span<std::byte> = 0;
+
+        /// Copies the staged regions into their textures and releases the staging memory
+        virtual auto SubmitStaging(std::span<const StagedRegion> regions) -> bool = 0;
+
+      private:
+        struct PendingUpload
+        {
+            Ref<ITexture2D> Texture;
+            std::uint32_t Level = 0;
+            Vector<std::byte> Pixels;
+            std::uint32_t RowsUploaded = 0;
+        };
+
+        std::size_t m_FrameBudget = DEFAULT_FRAME_BUDGET;
+        std::deque<PendingUpload> m_Queue;
+        std::size_t m_PendingBytes = 0;
+        Vector<StagedRegion> m_Regions;
+    };
+
+    auto CreateTextureUploader(std::size_t frame_budget = ITextureUploader::DEFAULT_FRAME_BUDGET)
+        -> Scope<ITextureUploader>;
+
+}  // namespace JE
@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "TextureAtlas.hpp"
+
+#include "Assert.hpp"
+#include "Logger.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        constexpr std::size_t RGBA8_CHANNELS = 4;
+
+        auto AlignUp(std::int32_t value, std::int32_t alignment) -> std::int32_t
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        /// Size taken in a page, the image plus padding on every side rounded up to the alignment
+        auto PackedSize(const Size2D& size, const AtlasOptions& options) -> Size2D
+        {
+            return {AlignUp(size.X + 2 * options.Padding, options.Alignment),
+                    AlignUp(size.Y + 2 * options.Padding, options.Alignment)};
+        }
+
+        auto MakeRegion(std::uint32_t page, const AtlasRect& packed, const Size2D& size, const AtlasOptions& options)
+            -> AtlasRegion
+        {
+            AtlasRegion region;
+            region.Page = page;
+            region.Rect = {packed.X + options.Padding, packed.Y + options.Padding, size.X, size.Y};
+
+            const glm::vec2 PAGE_SIZE{static_cast<float>(options.PageSize.X), static_cast<float>(options.PageSize.Y)};
+            region.UVMin = glm::vec2{static_cast<float>(region.Rect.X), static_cast<float>(region.Rect.Y)} / PAGE_SIZE;
+            region.UVMax = glm::vec2{static_cast<float>(region.Rect.X + region.Rect.Width),
+                                     static_cast<float>(region.Rect.Y + region.Rect.Height)}
+                           / PAGE_SIZE;
+            return region;
+        }
+
+        /// Copies the image into its region, the padding is filled by clamping to the nearest edge pixel when extruding
+        template<std::size_t CHANNELS, typename T>
+        void CopyToPage(std::span<const T> source,
+                        const Size2D& size,
+                        std::span<T> page,
+                        std::int32_t page_width,
+                        const AtlasRect& rect,
+                        const AtlasOptions& options)
+        {
+            const auto BORDER = options.Extrude ? options.Padding : 0;
+            for (std::int32_t y = -BORDER; y < size.Y + BORDER; ++y) {
+                const auto SOURCE_Y = static_cast<std::size_t>(std::clamp(y, 0, size.Y - 1));
+                const auto PAGE_Y = static_cast<std::size_t>(rect.Y + y);
+                for (std::int32_t x = -BORDER; x < size.X + BORDER; ++x) {
+                    const auto SOURCE_X = static_cast<std::size_t>(std::clamp(x, 0, size.X - 1));
+                    const auto PAGE_X = static_cast<std::size_t>(rect.X + x);
+
+                    const auto SOURCE_INDEX = (SOURCE_Y * static_cast<std::size_t>(size.X) + SOURCE_X) * CHANNELS;
+                    const auto PAGE_INDEX = (PAGE_Y * static_cast<std::size_t>(page_width) + PAGE_X) * CHANNELS;
+                    std::copy_n(source.begin() + static_cast<std::ptrdiff_t>(SOURCE_INDEX),
+                                CHANNELS,
+                                page.begin() + static_cast<std::ptrdiff_t>(PAGE_INDEX));
+                }
+            }
+        }
+
+    }  // namespace
+
+    SkylinePacker::SkylinePacker(const Size2D& size)
+        : m_Size(size)
+    {
+        ASSERT(size.X > 0 && size.Y > 0);
+        Clear();
+    }
+
+    void SkylinePacker::Clear()
+    {
+        m_Skyline.clear();
+        m_Skyline.push_back({0, 0, m_Size.X});
+        m_UsedArea = 0;
+    }
+
+    auto SkylinePacker::Fit(std::size_t index, const Size2D& size) const -> std::optional<std::int32_t>
+    {
+        if (m_Skyline[index].X + size.X > m_Size.X) {
+            return std::nullopt;
+        }
+
+        // The rectangle rests on the highest segment it spans
+        std::int32_t y = 0;
+        std::int32_t width_left = size.X;
+        for (auto i = index; width_left > 0; ++i) {
+            y = std::max(y, m_Skyline[i].Y);
+            if (y + size.Y > m_Size.Y) {
+                return std::nullopt;
+            }
+            width_left -= m_Skyline[i].Width;
+        }
+        return y;
+    }
+
+    void SkylinePacker::AddSegment(std::size_t index, const AtlasRect& rect)
+    {
+        const auto NEW_SEGMENT = m_Skyline.begin() + static_cast<std::ptrdiff_t>(index);
+        m_Skyline.insert(NEW_SEGMENT, {rect.X, rect.Y + rect.Height, rect.Width});
+
+        // Shrink or drop the segments now covered by the new one
+        const auto RIGHT_EDGE = rect.X + rect.Width;
+        while (index + 1 < m_Skyline.size() && m_Skyline[index + 1].X < RIGHT_EDGE) {
+            auto& segment = m_Skyline[index + 1];
+            const auto OVERLAP = RIGHT_EDGE - segment.X;
+            if (OVERLAP < segment.Width) {
+                segment.X += OVERLAP;
+                segment.Width -= OVERLAP;
+                break;
+            }
+            m_Skyline.erase(m_Skyline.begin() + static_cast<std::ptrdiff_t>(index + 1));
+        }
+
+        // Merge neighbours at the same height
+        for (std::size_t i = 0; i + 1 < m_Skyline.size();) {
+            if (m_Skyline[i].Y == m_Skyline[i + 1].Y) {
+                m_Skyline[i].Width += m_Skyline[i + 1].Width;
+                m_Skyline.erase(m_Skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    auto SkylinePacker::Insert(const Size2D& size) -> std::optional<AtlasRect>
+    {
+        ASSERT(size.X > 0 && size.Y > 0);
+
+        auto best_bottom = std::numeric_limits<std::int32_t>::max();
+        auto best_width = std::numeric_limits<std::int32_t>::max();
+        std::optional<std::size_t> best_index;
+        AtlasRect best_rect;
+
+        for (std::size_t i = 0; i < m_Skyline.size(); ++i) {
+            const auto Y = Fit(i, size);
+            if (!Y) {
+                continue;
+            }
+
+            // Lowest bottom edge first, the narrowest segment breaks ties so wide gaps stay open for wide images
+            const auto BOTTOM = *Y + size.Y;
+            if (BOTTOM < best_bottom || (BOTTOM == best_bottom && m_Skyline[i].Width < best_width)) {
+                best_bottom = BOTTOM;
+                best_width = m_Skyline[i].Width;
+                best_index = i;
+                best_rect = {m_Skyline[i].X, *Y, size.X, size.Y};
+            }
+        }
+
+        if (!best_index) {
+            return std::nullopt;
+        }
+
+        AddSegment(*best_index, best_rect);
+        m_UsedArea += static_cast<std::size_t>(size.X) * static_cast<std::size_t>(size.Y);
+        return best_rect;
+    }
+
+    TextureAtlas::TextureAtlas(const AtlasOptions& options)
+        : m_Options(options)
+    {
+        ASSERT(options.Format == TextureFormat::RGBA8 || options.Format == TextureFormat::SRGB8_ALPHA8);
+        ASSERT(options.Padding >= 0 && options.Alignment > 0);
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto TextureAtlas::Add(const Size2D& size, std::span<const std::byte> pixels) -> std::optional<AtlasRegion>
+    {
+        ASSERT(pixels.size() == static_cast<std::size_t>(size.X) * static_cast<std::size_t>(size.Y) * RGBA8_CHANNELS);
+
+        const auto PACKED_SIZE = PackedSize(size, m_Options);
+        if (PACKED_SIZE.X > m_Options.PageSize.X || PACKED_SIZE.Y > m_Options.PageSize.Y) {
+            EngineLogger()->error("Image of {} does not fit into an atlas page of {}", size, m_Options.PageSize);
+            return std::nullopt;
+        }
+
+        std::optional<AtlasRect> packed;
+        std::size_t page_index = 0;
+        for (std::size_t i = 0; i < m_Pages.size() && !packed; ++i) {
+            packed = m_Pages[i].Packer.Insert(PACKED_SIZE);
+            page_index = i;
+        }
+
+        if (!packed) {
+            page_index = m_Pages.size();
+            const auto PAGE_BYTES = static_cast<std::size_t>(m_Options.PageSize.X)
+                                    * static_cast<std::size_t>(m_Options.PageSize.Y) * RGBA8_CHANNELS;
+
+            // Mips would blend neighbouring images, atlas pages only have a single level
+            Ref<ITexture2D> texture = CreateTexture2D({m_Options.PageSize, m_Options.Format, 1});
+            texture->SetSampler({TextureFilter::LINEAR,
+                                 TextureFilter::LINEAR,
+                                 TextureFilter::LINEAR,
+                                 TextureWrap::CLAMP_TO_EDGE,
+                                 TextureWrap::CLAMP_TO_EDGE});
+
+            auto& page = m_Pages.emplace_back(
+                AtlasPage{SkylinePacker{m_Options.PageSize}, Vector<std::byte>(PAGE_BYTES), std::move(texture)});
+            packed = page.Packer.Insert(PACKED_SIZE);
+            ASSERT(packed.has_value());
+        }
+
+        const auto REGION = MakeRegion(static_cast<std::uint32_t>(page_index), *packed, size, m_Options);
+
+        auto& page = m_Pages[page_index];
+        CopyToPage<RGBA8_CHANNELS>(pixels, size, std::span{page.Pixels}, m_Options.PageSize.X, REGION.Rect, m_Options);
+
+        if (page.DirtyBegin == page.DirtyEnd) {
+            page.DirtyBegin = packed->Y;
+            page.DirtyEnd = packed->Y + packed->Height;
+        } else {
+            page.DirtyBegin = std::min(page.DirtyBegin, packed->Y);
+            page.DirtyEnd = std::max(page.DirtyEnd, packed->Y + packed->Height);
+        }
+
+        return REGION;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto TextureAtlas::Commit() -> bool
+    {
+        bool success = true;
+        for (auto& page : m_Pages) {
+            if (page.DirtyBegin == page.DirtyEnd) {
+                continue;
+            }
+
+            const auto ROW_BYTES = page.Texture->LevelRowBytes(0);
+            const auto ROWS = std::span{page.Pixels}.subspan(static_cast<std::size_t>(page.DirtyBegin) * ROW_BYTES,
+                                                             static_cast<std::size_t>(page.DirtyEnd - page.DirtyBegin)
+                                                                 * ROW_BYTES);
+            success = page.Texture->SetRows(0, static_cast<std::uint32_t>(page.DirtyBegin), ROWS) && success;
+            page.DirtyBegin = 0;
+            page.DirtyEnd = 0;
+        }
+        return success;
+    }
+
+    // cppcheck-suppress unusedFunction
+    void TextureAtlas::Clear() { m_Pages.clear(); }
+
+    // cppcheck-suppress unusedFunction
+    auto BuildAtlas(std::span<const Image> images, const AtlasOptions& options) -> std::optional<AtlasBuild>
+    {
+        ASSERT(options.Padding >= 0 && options.Alignment > 0);
+
+        Vector<std::size_t> order(images.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        const auto TALLEST_FIRST = [&](std::size_t lhs, std::size_t rhs)
+        {
+            const auto& lhs_size = images[lhs].Size;
+            const auto& rhs_size = images[rhs].Size;
+            return lhs_size.Y != rhs_size.Y ? lhs_size.Y > rhs_size.Y : lhs_size.X > rhs_size.X;
+        };
+        std::ranges::stable_sort(order, TALLEST_FIRST);
+
+        AtlasBuild build;
+        build.Regions.resize(images.size());
+        Vector<SkylinePacker> packers;
+
+        const auto PAGE_PIXELS =
+            static_cast<std::size_t>(options.PageSize.X) * static_cast<std::size_t>(options.PageSize.Y);
+        for (const auto INDEX : order) {
+            const auto& image = images[INDEX];
+            const auto PACKED_SIZE = PackedSize(image.Size, options);
+            if (PACKED_SIZE.X > options.PageSize.X || PACKED_SIZE.Y > options.PageSize.Y) {
+                EngineLogger()->error("Image {} of {} does not fit into an atlas page of {}",
+                                      INDEX,
+                                      image.Size,
+                                      options.PageSize);
+                return std::nullopt;
+            }
+
+            std::optional<AtlasRect> packed;
+            std::size_t page_index = 0;
+            for (std::size_t i = 0; i < packers.size() && !packed; ++i) {
+                packed = packers[i].Insert(PACKED_SIZE);
+                page_index = i;
+            }
+
+            if (!packed) {
+                page_index = packers.size();
+                packed = packers.emplace_back(options.PageSize).Insert(PACKED_SIZE);
+                build.Pages.push_back({options.PageSize, Vector<glm::vec4>(PAGE_PIXELS, glm::vec4{0.f})});
+            }
+
+            build.Regions[INDEX] = MakeRegion(static_cast<std::uint32_t>(page_index), *packed, image.Size, options);
+            CopyToPage<1>(std::span{image.Pixels},
+                          image.Size,
+                          std::span{build.Pages[page_index].Pixels},
+                          options.PageSize.X,
+                          build.Regions[INDEX].Rect,
+                          options);
+        }
+
+        return build;
+    }
+
+}  // namespace JE
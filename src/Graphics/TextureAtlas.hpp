@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "Memory.hpp"
+#include "Sprite.hpp"
+#include "Texture.hpp"
+#include "TextureProcessing.hpp"
+#include "Types.hpp"
+
+namespace JE
+{
+
+    struct AtlasRect
+    {
+        std::int32_t X = 0;
+        std::int32_t Y = 0;
+        std::int32_t Width = 0;
+        std::int32_t Height = 0;
+    };
+
+    /// Skyline bottom-left rectangle packer, every insertion lands where its bottom edge stays lowest so rectangles
+    /// can be added incrementally without repacking, space below the skyline is not reused
+    class SkylinePacker
+    {
+      public:
+        explicit SkylinePacker(const Size2D& size);
+
+        auto Insert(const Size2D& size) -> std::optional<AtlasRect>;
+        void Clear();
+
+        inline auto Size() const -> const Size2D& { return m_Size; }
+        inline auto UsedArea() const -> std::size_t { return m_UsedArea; }
+        inline auto Occupancy() const -> float
+        {
+            return static_cast<float>(m_UsedArea) / (static_cast<float>(m_Size.X) * static_cast<float>(m_Size.Y));
+        }
+
+      private:
+        struct Segment
+        {
+            std::int32_t X = 0;
+            std::int32_t Y = 0;
+            std::int32_t Width = 0;
+        };
+
+        /// Lowest y a rectangle of size can be placed at when its left edge starts at the segment
+        auto Fit(std::size_t index, const Size2D& size) const -> std::optional<std::int32_t>;
+        void AddSegment(std::size_t index, const AtlasRect& rect);
+
+        Size2D m_Size;
+        Vector<Segment> m_Skyline;
+        std::size_t m_UsedArea = 0;
+    };
+
+    struct AtlasOptions
+    {
+        static constexpr std::int32_t DEFAULT_PAGE_SIZE = 2048;
+
+        Size2D PageSize{DEFAULT_PAGE_SIZE, DEFAULT_PAGE_SIZE};
+        /// Border around every image so bilinear filtering never reads a neighbour
+        std::int32_t Padding = 1;
+        /// Fill the border with the image's edge pixels instead of leaving it transparent
+        bool Extrude = true;
+        /// Packed rectangles are rounded up to a multiple of this, use 4 for pages that get block compressed
+        std::int32_t Alignment = 1;
+        TextureFormat Format = TextureFormat::RGBA8;
+    };
+
+    /// Image location inside the atlas, Rect excludes the padding
+    struct AtlasRegion
+    {
+        std::uint32_t Page = 0;
+        AtlasRect Rect;
+        glm::vec2 UVMin{0.f};
+        glm::vec2 UVMax{1.f};
+    };
+
+    /// Runtime atlas of RGBA8 (or sRGB) pages, images can be added at any time and a new page is created once no
+    /// existing page has room left
+    class TextureAtlas
+    {
+      public:
+        explicit TextureAtlas(const AtlasOptions& options = {});
+
+        /// Copies tightly packed 4 byte pixels into a page, the page is uploaded on the next Commit
+        /// \returns std::nullopt if the image (plus padding) is larger than a page
+        auto Add(const Size2D& size, std::span<const std::byte> pixels) -> std::optional<AtlasRegion>;
+
+        /// Uploads the rows of every page that changed since the last commit
+        auto Commit() -> bool;
+
+        void Clear();
+
+        inline auto Options() const -> const AtlasOptions& { return m_Options; }
+        inline auto PageCount() const -> std::size_t { return m_Pages.size(); }
+        inline auto Page(std::size_t index) const -> const Ref<ITexture2D>& { return m_Pages[index].Texture; }
+        inline auto PagePixels(std::size_t index) const -> std::span<const std::byte> { return m_Pages[index].Pixels; }
+        inline auto PageOccupancy(std::size_t index) const -> float { return m_Pages[index].Packer.Occupancy(); }
+
+        inline auto GetSprite(const AtlasRegion& region) const -> Sprite
+        {
+            return {m_Pages[region.Page].Texture.get(), region.UVMin, region.UVMax};
+        }
+
+      private:
+        struct AtlasPage
+        {
+            SkylinePacker Packer;
+            Vector<std::byte> Pixels;
+            Ref<ITexture2D> Texture;
+            /// Row range [DirtyBegin, DirtyEnd) not uploaded yet
+            std::int32_t DirtyBegin = 0;
+            std::int32_t DirtyEnd = 0;
+        };
+
+        AtlasOptions m_Options;
+        Vector<AtlasPage> m_Pages;
+    };
+
+    struct AtlasBuild
+    {
+        Vector<Image> Pages;
+        /// One region per source image, in the order of the source images
+        Vector<AtlasRegion> Regions;
+    };
+
+    /// Offline packing, images are inserted tallest first which keeps the skyline flat and the pages dense
+    /// \returns std::nullopt if an image (plus padding) is larger than a page
+    auto BuildAtlas(std::span<const Image> images, const AtlasOptions& options) -> std::optional<AtlasBuild>;
+
+}  // namespace JE
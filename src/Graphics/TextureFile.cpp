@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+#include "TextureFile.hpp"
+
+#include "Logger.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        constexpr auto MakeFourCC(char a, char b, char c, char d) -> std::uint32_t
+        {
+            constexpr std::uint32_t SECOND_SHIFT = 8;
+            constexpr std::uint32_t THIRD_SHIFT = 16;
+            constexpr std::uint32_t FOURTH_SHIFT = 24;
+
+            return static_cast<std::uint32_t>(static_cast<std::uint8_t>(a))
+                   | (static_cast<std::uint32_t>(static_cast<std::uint8_t>(b)) << SECOND_SHIFT)
+                   | (static_cast<std::uint32_t>(static_cast<std::uint8_t>(c)) << THIRD_SHIFT)
+                   | (static_cast<std::uint32_t>(static_cast<std::uint8_t>(d)) << FOURTH_SHIFT);
+        }
+
+        constexpr std::uint32_t DDS_MAGIC = MakeFourCC('D', 'D', 'S', ' ');
+        constexpr std::uint32_t FOURCC_DX10 = MakeFourCC('D', 'X', '1', '0');
+        constexpr std::uint32_t FOURCC_DXT1 = MakeFourCC('D', 'X', 'T', '1');
+        constexpr std::uint32_t FOURCC_DXT5 = MakeFourCC('D', 'X', 'T', '5');
+
+        constexpr std::uint32_t DDSD_CAPS = 0x1;
+        constexpr std::uint32_t DDSD_HEIGHT = 0x2;
+        constexpr std::uint32_t DDSD_WIDTH = 0x4;
+        constexpr std::uint32_t DDSD_PITCH = 0x8;
+        constexpr std::uint32_t DDSD_PIXELFORMAT = 0x1000;
+        constexpr std::uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+        constexpr std::uint32_t DDSD_LINEARSIZE = 0x80000;
+        constexpr std::uint32_t DDPF_FOURCC = 0x4;
+        constexpr std::uint32_t DDSCAPS_COMPLEX = 0x8;
+        constexpr std::uint32_t DDSCAPS_TEXTURE = 0x1000;
+        constexpr std::uint32_t DDSCAPS_MIPMAP = 0x400000;
+        constexpr std::uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+
+        struct DDSPixelFormat
+        {
+            std::uint32_t Size = sizeof(DDSPixelFormat);
+            std::uint32_t Flags = 0;
+            std::uint32_t FourCC = 0;
+            std::uint32_t RGBBitCount = 0;
+            std::array<std::uint32_t, 4> BitMasks{};
+        };
+
+        struct DDSHeader
+        {
+            std::uint32_t Size = sizeof(DDSHeader);
+            std::uint32_t Flags = 0;
+            std::uint32_t Height = 0;
+            std::uint32_t Width = 0;
+            std::uint32_t PitchOrLinearSize = 0;
+            std::uint32_t Depth = 0;
+            std::uint32_t MipMapCount = 0;
+            std::array<std::uint32_t, 11> Reserved1{};  // NOLINT(readability-magic-numbers)
+            DDSPixelFormat PixelFormat;
+            std::uint32_t Caps = 0;
+            std::uint32_t Caps2 = 0;
+            std::uint32_t Caps3 = 0;
+            std::uint32_t Caps4 = 0;
+            std::uint32_t Reserved2 = 0;
+        };
+
+        struct DDSHeaderDX10
+        {
+            std::uint32_t DXGIFormat = 0;
+            std::uint32_t ResourceDimension = D3D10_RESOURCE_DIMENSION_TEXTURE2D;
+            std::uint32_t MiscFlag = 0;
+            std::uint32_t ArraySize = 1;
+            std::uint32_t MiscFlags2 = 0;
+        };
+
+        static_assert(sizeof(DDSPixelFormat) == 32);
+        static_assert(sizeof(DDSHeader) == 124);
+        static_assert(sizeof(DDSHeaderDX10) == 20);
+
+        struct DXGIFormatMapping
+        {
+            TextureFormat Format;
+            std::uint32_t DXGIFormat;
+        };
+
+        constexpr std::array DXGI_FORMATS = {
+            DXGIFormatMapping{TextureFormat::R8, 61},  // DXGI_FORMAT_R8_UNORM
+            DXGIFormatMapping{TextureFormat::RG8, 49},  // DXGI_FORMAT_R8G8_UNORM
+            DXGIFormatMapping{TextureFormat::RGBA8, 28},  // DXGI_FORMAT_R8G8B8A8_UNORM
+            DXGIFormatMapping{TextureFormat::SRGB8_ALPHA8, 29},  // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+            DXGIFormatMapping{TextureFormat::RGBA16F, 10},  // DXGI_FORMAT_R16G16B16A16_FLOAT
+            DXGIFormatMapping{TextureFormat::RGBA32F, 2},  // DXGI_FORMAT_R32G32B32A32_FLOAT
+            DXGIFormatMapping{TextureFormat::BC1_RGBA, 71},  // DXGI_FORMAT_BC1_UNORM
+            DXGIFormatMapping{TextureFormat::BC1_SRGB_ALPHA, 72},  // DXGI_FORMAT_BC1_UNORM_SRGB
+            DXGIFormatMapping{TextureFormat::BC3_RGBA, 77},  // DXGI_FORMAT_BC3_UNORM
+            DXGIFormatMapping{TextureFormat::BC3_SRGB_ALPHA, 78},  // DXGI_FORMAT_BC3_UNORM_SRGB
+        };
+
+        auto ToDXGIFormat(TextureFormat format) -> std::uint32_t
+        {
+            for (const auto& mapping : DXGI_FORMATS) {
+                if (mapping.Format == format) {
+                    return mapping.DXGIFormat;
+                }
+            }
+            return 0;
+        }
+
+        auto FromDXGIFormat(std::uint32_t dxgi_format) -> std::optional<TextureFormat>
+        {
+            for (const auto& mapping : DXGI_FORMATS) {
+                if (mapping.DXGIFormat == dxgi_format) {
+                    return mapping.Format;
+                }
+            }
+            return std::nullopt;
+        }
+
+        template<typename T>
+        void Write(std::ofstream& file, const T& value)
+        {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(T));  // NOLINT
+        }
+
+        template<typename T>
+        auto Read(std::ifstream& file, T& value) -> bool
+        {
+            file.read(reinterpret_cast<char*>(&value), sizeof(T));  // NOLINT
+            return file.good();
+        }
+
+    }  // namespace
+
+    // cppcheck-suppress unusedFunction
+    auto WriteTextureFile(const std::filesystem::path& path, const TextureData& data) -> bool
+    {
+        const auto& description = data.Description;
+        if (data.Levels.size() != description.MipLevels) {
+            EngineLogger()->error("Texture data has {} levels, expected {}", data.Levels.size(), description.MipLevels);
+            return false;
+        }
+
+        std::ofstream file{path, std::ios::binary};
+        if (!file) {
+            EngineLogger()->error("Failed to open texture file {} for writing", path.string());
+            return false;
+        }
+
+        const auto COMPRESSED = IsCompressedFormat(description.Format);
+
+        DDSHeader header;
+        header.Flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT
+                       | (COMPRESSED ? DDSD_LINEARSIZE : DDSD_PITCH);
+        header.Height = static_cast<std::uint32_t>(description.Size.Y);
+        header.Width = static_cast<std::uint32_t>(description.Size.X);
+        // Compressed files store the size of the top level, uncompressed files the size of one of its rows
+        const auto TOP_LEVEL_BYTES = data.Levels.front().size();
+        header.PitchOrLinearSize =
+            static_cast<std::uint32_t>(COMPRESSED ? TOP_LEVEL_BYTES : TOP_LEVEL_BYTES / header.Height);
+        header.MipMapCount = description.MipLevels;
+        header.PixelFormat.Flags = DDPF_FOURCC;
+        header.PixelFormat.FourCC = FOURCC_DX10;
+        header.Caps = DDSCAPS_TEXTURE | (description.MipLevels > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+        DDSHeaderDX10 header_dx10;
+        header_dx10.DXGIFormat = ToDXGIFormat(description.Format);
+
+        Write(file, DDS_MAGIC);
+        Write(file, header);
+        Write(file, header_dx10);
+        for (const auto& level : data.Levels) {
+            file.write(reinterpret_cast<const char*>(level.data()),  // NOLINT
+                       static_cast<std::streamsize>(level.size()));
+        }
+
+        return file.good();
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto ReadTextureFile(const std::filesystem::path& path) -> std::optional<TextureData>
+    {
+        std::ifstream file{path, std::ios::binary};
+        if (!file) {
+            EngineLogger()->error("Failed to open texture file {}", path.string());
+            return std::nullopt;
+        }
+
+        std::uint32_t magic = 0;
+        DDSHeader header;
+        if (!Read(file, magic) || !Read(file, header) || magic != DDS_MAGIC || header.Size != sizeof(DDSHeader)) {
+            EngineLogger()->error("Texture file {} is not a DDS file", path.string());
+            return std::nullopt;
+        }
+
+        std::optional<TextureFormat> format;
+        if ((header.PixelFormat.Flags & DDPF_FOURCC) != 0) {
+            switch (header.PixelFormat.FourCC) {
+                case FOURCC_DX10: {
+                    DDSHeaderDX10 header_dx10;
+                    if (Read(file, header_dx10)
+                        && header_dx10.ResourceDimension == D3D10_RESOURCE_DIMENSION_TEXTURE2D
+                        && header_dx10.ArraySize == 1) {
+                        format = FromDXGIFormat(header_dx10.DXGIFormat);
+                    }
+                    break;
+                }
+                case FOURCC_DXT1:
+                    format = TextureFormat::BC1_RGBA;
+                    break;
+                case FOURCC_DXT5:
+                    format = TextureFormat::BC3_RGBA;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (!format) {
+            EngineLogger()->error("Texture file {} has an unsupported format", path.string());
+            return std::nullopt;
+        }
+
+        // Sizes are validated against the file before anything is allocated, the header can't be trusted
+        constexpr auto MAX_DIMENSION = static_cast<std::uint32_t>(std::numeric_limits<std::int32_t>::max());
+        if (header.Width == 0 || header.Height == 0 || header.Width > MAX_DIMENSION || header.Height > MAX_DIMENSION) {
+            EngineLogger()->error(
+                "Texture file {} has an invalid size {}x{}", path.string(), header.Width, header.Height);
+            return std::nullopt;
+        }
+
+        TextureData data;
+        data.Description.Size = {static_cast<std::int32_t>(header.Width), static_cast<std::int32_t>(header.Height)};
+        data.Description.Format = *format;
+        data.Description.MipLevels = (header.Flags & DDSD_MIPMAPCOUNT) != 0 ? std::max(header.MipMapCount, 1U) : 1U;
+
+        const auto MAX_MIP_LEVELS = MipLevelCount(data.Description.Size);
+        if (data.Description.MipLevels > MAX_MIP_LEVELS) {
+            EngineLogger()->error("Texture file {} has {} mip levels, its size allows at most {}",
+                                  path.string(),
+                                  data.Description.MipLevels,
+                                  MAX_MIP_LEVELS);
+            return std::nullopt;
+        }
+
+        const auto PAYLOAD_START = file.tellg();
+        file.seekg(0, std::ios::end);
+        const auto PAYLOAD_BYTES = static_cast<std::uint64_t>(file.tellg() - PAYLOAD_START);
+        file.seekg(PAYLOAD_START);
+
+        // At most 2^31 blocks per side, a level's block count can't overflow but its byte size could
+        const auto INFO = GetTextureFormatInfo(*format);
+        const auto LEVEL_BLOCKS = [&INFO, &data](std::uint32_t level)
+        {
+            const auto SIZE = MipLevelSize(data.Description.Size, level);
+            const auto ROWS = (static_cast<std::uint64_t>(SIZE.Y) + INFO.BlockHeight - 1) / INFO.BlockHeight;
+            const auto BLOCKS = (static_cast<std::uint64_t>(SIZE.X) + INFO.BlockWidth - 1) / INFO.BlockWidth;
+            return std::pair{ROWS, BLOCKS};
+        };
+
+        std::uint64_t expected_bytes = 0;
+        for (std::uint32_t level = 0; level < data.Description.MipLevels; ++level) {
+            const auto [ROWS, BLOCKS] = LEVEL_BLOCKS(level);
+            if (ROWS * BLOCKS > (PAYLOAD_BYTES - expected_bytes) / INFO.BlockBytes) {
+                EngineLogger()->error("Texture file {} is truncated at level {}", path.string(), level);
+                return std::nullopt;
+            }
+            expected_bytes += ROWS * BLOCKS * INFO.BlockBytes;
+        }
+        if (expected_bytes != PAYLOAD_BYTES) {
+            EngineLogger()->error(
+                "Texture file {} has {} bytes of levels, expected {}", path.string(), PAYLOAD_BYTES, expected_bytes);
+            return std::nullopt;
+        }
+
+        // Compressed files store the size of the top level, uncompressed files the size of one of its rows
+        const auto [TOP_ROWS, TOP_BLOCKS] = LEVEL_BLOCKS(0);
+        const auto TOP_ROW_BYTES = TOP_BLOCKS * INFO.BlockBytes;
+        const auto PITCH_FLAG = IsCompressedFormat(*format) ? DDSD_LINEARSIZE : DDSD_PITCH;
+        const auto EXPECTED_PITCH = IsCompressedFormat(*format) ? TOP_ROWS * TOP_ROW_BYTES : TOP_ROW_BYTES;
+        if ((header.Flags & PITCH_FLAG) != 0 && header.PitchOrLinearSize != EXPECTED_PITCH) {
+            EngineLogger()->error("Texture file {} has a pitch or linear size of {}, expected {}",
+                                  path.string(),
+                                  header.PitchOrLinearSize,
+                                  EXPECTED_PITCH);
+            return std::nullopt;
+        }
+
+        for (std::uint32_t level = 0; level < data.Description.MipLevels; ++level) {
+            const auto [ROWS, BLOCKS] = LEVEL_BLOCKS(level);
+
+            auto& pixels = data.Levels.emplace_back(ROWS * BLOCKS * INFO.BlockBytes);
+            file.read(reinterpret_cast<char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));  // NOLINT
+            if (!file.good()) {
+                EngineLogger()->error("Failed to read level {} of texture file {}", level, path.string());
+                return std::nullopt;
+            }
+        }
+
+        return data;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto LoadTexture(const std::filesystem::path& path, ITextureUploader& uploader) -> Ref<ITexture2D>
+    {
+        auto data = ReadTextureFile(path);
+        if (!data) {
+            return nullptr;
+        }
+
+        Ref<ITexture2D> texture = CreateTexture2D(data->Description);
+        for (std::uint32_t level = 0; level < texture->MipLevels(); ++level) {
+            uploader.Upload(texture, level, std::move(data->Levels[level]));
+        }
+        return texture;
+    }
+
+}  // namespace JE
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+
+#include "Memory.hpp"
+#include "Texture.hpp"
+
+namespace JE
+{
+
+    /// Writes a DDS file with a DX10 header, levels are stored exactly as they are uploaded
+    auto WriteTextureFile(const std::filesystem::path& path, const TextureData& data) -> bool;
+
+    /// Reads DDS files written by WriteTextureFile, plus legacy DXT1/DXT5 files
+    auto ReadTextureFile(const std::filesystem::path& path) -> std::optional<TextureData>;
+
+    /// Creates the texture and queues every level on the uploader, the texture is Ready() once all levels are uploaded
+    /// \returns nullptr if the file could not be read
+    auto LoadTexture(const std::filesystem::path& path, ITextureUploader& uploader) -> Ref<ITexture2D>;
+
+}  // namespace JE
@@ -0,0 +1,769 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+
+#include "TextureProcessing.hpp"
+
+#include "Assert.hpp"
+#include "Parallel.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        constexpr float COLOR8_MAX = 255.f;
+        constexpr std::int32_t BLOCK_SIZE = 4;
+        constexpr std::size_t BITS_PER_BYTE = 8;
+
+        auto SRGBToLinear(float value) -> float
+        {
+            constexpr float THRESHOLD = 0.04045f;
+            constexpr float LINEAR_SCALE = 12.92f;
+            constexpr float OFFSET = 0.055f;
+            constexpr float GAMMA = 2.4f;
+
+            if (value <= THRESHOLD) {
+                return value / LINEAR_SCALE;
+            }
+            return std::pow((value + OFFSET) / (1.f + OFFSET), GAMMA);
+        }
+
+        auto LinearToSRGB(float value) -> float
+        {
+            constexpr float THRESHOLD = 0.0031308f;
+            constexpr float LINEAR_SCALE = 12.92f;
+            constexpr float OFFSET = 0.055f;
+            constexpr float INVERSE_GAMMA = 1.f / 2.4f;
+
+            if (value <= THRESHOLD) {
+                return value * LINEAR_SCALE;
+            }
+            return (1.f + OFFSET) * std::pow(value, INVERSE_GAMMA) - OFFSET;
+        }
+
+        auto Sinc(float x) -> float
+        {
+            constexpr float EPSILON = 1e-5f;
+            if (std::abs(x) < EPSILON) {
+                return 1.f;
+            }
+            const auto PI_X = std::numbers::pi_v<float> * x;
+            return std::sin(PI_X) / PI_X;
+        }
+
+        /// Zeroth order modified Bessel function of the first kind
+        auto BesselI0(float x) -> float
+        {
+            constexpr std::int32_t TERMS = 20;
+
+            float sum = 1.f;
+            float term = 1.f;
+            const auto HALF_X_SQUARED = x * x / 4.f;
+            for (std::int32_t k = 1; k < TERMS; ++k) {
+                term *= HALF_X_SQUARED / static_cast<float>(k * k);
+                sum += term;
+            }
+            return sum;
+        }
+
+        auto FilterWidth(MipFilter filter) -> float
+        {
+            constexpr float BOX_WIDTH = 0.5f;
+            constexpr float SINC_WIDTH = 3.f;
+            return filter == MipFilter::BOX ? BOX_WIDTH : SINC_WIDTH;
+        }
+
+        auto EvaluateFilter(MipFilter filter, float x) -> float
+        {
+            constexpr float KAISER_ALPHA = 4.f;
+
+            const auto WIDTH = FilterWidth(filter);
+            if (std::abs(x) >= WIDTH) {
+                return 0.f;
+            }
+
+            switch (filter) {
+                case MipFilter::BOX:
+                    return 1.f;
+                case MipFilter::LANCZOS3:
+                    return Sinc(x) * Sinc(x / WIDTH);
+                case MipFilter::KAISER: {
+                    const auto T = x / WIDTH;
+                    return Sinc(x) * BesselI0(KAISER_ALPHA * std::sqrt(1.f - T * T)) / BesselI0(KAISER_ALPHA);
+                }
+                default:
+                    return 0.f;
+            }
+        }
+
+        auto WrapCoordinate(std::int32_t coordinate, std::int32_t size, TextureWrap wrap) -> std::int32_t
+        {
+            switch (wrap) {
+                case TextureWrap::REPEAT:
+                    return ((coordinate % size) + size) % size;
+                case TextureWrap::MIRRORED_REPEAT: {
+                    const auto PERIOD = 2 * size;
+                    const auto WRAPPED = ((coordinate % PERIOD) + PERIOD) % PERIOD;
+                    return WRAPPED < size ? WRAPPED : PERIOD - 1 - WRAPPED;
+                }
+                case TextureWrap::CLAMP_TO_EDGE:
+                default:
+                    return std::clamp(coordinate, 0, size - 1);
+            }
+        }
+
+        struct FilterTap
+        {
+            std::int32_t Index = 0;
+            float Weight = 0;
+        };
+
+        /// Normalized taps of every destination pixel along one axis, shared by all rows (or columns)
+        auto ComputeFilterTaps(std::int32_t source_size, std::int32_t size, MipFilter filter, TextureWrap wrap)
+            -> Vector<Vector<FilterTap>>
+        {
+            const auto SCALE = static_cast<float>(source_size) / static_cast<float>(size);
+            const auto SUPPORT = FilterWidth(filter) * std::max(SCALE, 1.f);
+
+            Vector<Vector<FilterTap>> taps(static_cast<std::size_t>(size));
+            for (std::int32_t i = 0; i < size; ++i) {
+                const auto CENTER = (static_cast<float>(i) + 0.5f) * SCALE;
+                const auto FIRST = static_cast<std::int32_t>(std::floor(CENTER - SUPPORT));
+                const auto LAST = static_cast<std::int32_t>(std::ceil(CENTER + SUPPORT));
+
+                auto& pixel_taps = taps[static_cast<std::size_t>(i)];
+                float total_weight = 0;
+                for (auto source = FIRST; source <= LAST; ++source) {
+                    const auto X = (static_cast<float>(source) + 0.5f - CENTER) / std::max(SCALE, 1.f);
+                    if (std::abs(X) >= FilterWidth(filter)) {
+                        continue;
+                    }
+                    const auto WEIGHT = EvaluateFilter(filter, X);
+                    pixel_taps.push_back({WrapCoordinate(source, source_size, wrap), WEIGHT});
+                    total_weight += WEIGHT;
+                }
+
+                for (auto& tap : pixel_taps) {
+                    tap.Weight /= total_weight;
+                }
+            }
+            return taps;
+        }
+
+        struct ColorBlock
+        {
+            std::uint16_t Color0 = 0;
+            std::uint16_t Color1 = 0;
+            std::uint32_t Indices = 0;
+        };
+
+        constexpr std::uint32_t RED_BITS_MAX = 31;
+        constexpr std::uint32_t GREEN_BITS_MAX = 63;
+        constexpr std::uint32_t BLUE_BITS_MAX = 31;
+        constexpr std::uint32_t RED_SHIFT = 11;
+        constexpr std::uint32_t GREEN_SHIFT = 5;
+
+        auto PackRGB565(const glm::vec3& color) -> std::uint16_t
+        {
+            const auto CLAMPED = glm::clamp(color, 0.f, 1.f);
+            const auto RED = static_cast<std::uint32_t>(std::lround(CLAMPED.r * RED_BITS_MAX));
+            const auto GREEN = static_cast<std::uint32_t>(std::lround(CLAMPED.g * GREEN_BITS_MAX));
+            const auto BLUE = static_cast<std::uint32_t>(std::lround(CLAMPED.b * BLUE_BITS_MAX));
+            return static_cast<std::uint16_t>((RED << RED_SHIFT) | (GREEN << GREEN_SHIFT) | BLUE);
+        }
+
+        /// Expands the same way the hardware does, by replicating the high bits into the low bits
+        auto UnpackRGB565(std::uint16_t color) -> glm::vec3
+        {
+            const auto RED = (static_cast<std::uint32_t>(color) >> RED_SHIFT) & RED_BITS_MAX;
+            const auto GREEN = (static_cast<std::uint32_t>(color) >> GREEN_SHIFT) & GREEN_BITS_MAX;
+            const auto BLUE = static_cast<std::uint32_t>(color) & BLUE_BITS_MAX;
+            return glm::vec3{static_cast<float>((RED << 3U) | (RED >> 2U)),
+                             static_cast<float>((GREEN << 2U) | (GREEN >> 4U)),
+                             static_cast<float>((BLUE << 3U) | (BLUE >> 2U))}
+                   / COLOR8_MAX;
+        }
+
+        auto ColorPalette(std::uint16_t color0, std::uint16_t color1, bool four_color_mode) -> std::array<glm::vec3, 4>
+        {
+            const auto FIRST = UnpackRGB565(color0);
+            const auto SECOND = UnpackRGB565(color1);
+            if (four_color_mode) {
+                return {FIRST, SECOND, (FIRST * 2.f + SECOND) / 3.f, (FIRST + SECOND * 2.f) / 3.f};
+            }
+            return {FIRST, SECOND, (FIRST + SECOND) * 0.5f, glm::vec3{0}};
+        }
+
+        auto ColorRGB(const glm::vec4& color) -> glm::vec3 { return {color.r, color.g, color.b}; }
+
+        constexpr float TRANSPARENT_THRESHOLD = 0.5f;
+        constexpr std::uint32_t TRANSPARENT_INDEX = 3;
+
+        /// Chooses the closest palette entry per pixel
+        /// \returns the sum of squared errors
+        auto FitColorIndices(const BlockPixels& pixels,
+                             std::uint16_t color0,
+                             std::uint16_t color1,
+                             bool four_color_mode,
+                             std::uint32_t& indices) -> float
+        {
+            const auto PALETTE = ColorPalette(color0, color1, four_color_mode);
+            const auto PALETTE_SIZE = four_color_mode ? 4U : 3U;
+
+            float error = 0;
+            indices = 0;
+            for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i) {
+                std::uint32_t index = TRANSPARENT_INDEX;
+                if (four_color_mode || pixels[i].a >= TRANSPARENT_THRESHOLD) {
+                    auto best_error = std::numeric_limits<float>::max();
+                    for (std::uint32_t entry = 0; entry < PALETTE_SIZE; ++entry) {
+                        const auto DIFFERENCE = ColorRGB(pixels[i]) - PALETTE[entry];
+                        const auto ENTRY_ERROR = glm::dot(DIFFERENCE, DIFFERENCE);
+                        if (ENTRY_ERROR < best_error) {
+                            best_error = ENTRY_ERROR;
+                            index = entry;
+                        }
+                    }
+                    error += best_error;
+                }
+                indices |= index << (i * 2);
+            }
+            return error;
+        }
+
+        /// Least squares endpoints for the palette weights the current indices select
+        auto RefineEndpoints(const BlockPixels& pixels,
+                             std::uint32_t indices,
+                             bool four_color_mode,
+                             glm::vec3& endpoint0,
+                             glm::vec3& endpoint1) -> bool
+        {
+            constexpr std::array<float, 4> FOUR_COLOR_WEIGHTS = {0.f, 1.f, 1.f / 3.f, 2.f / 3.f};
+            constexpr std::array<float, 4> THREE_COLOR_WEIGHTS = {0.f, 1.f, 0.5f, 0.f};
+            constexpr float DETERMINANT_EPSILON = 1e-6f;
+
+            const auto& weights = four_color_mode ? FOUR_COLOR_WEIGHTS : THREE_COLOR_WEIGHTS;
+
+            float alpha_alpha = 0;
+            float alpha_beta = 0;
+            float beta_beta = 0;
+            glm::vec3 alpha_x{0};
+            glm::vec3 beta_x{0};
+            for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i) {
+                const auto INDEX = (indices >> (i * 2)) & 3U;
+                if (!four_color_mode && INDEX == TRANSPARENT_INDEX) {
+                    continue;
+                }
+
+                const auto BETA = weights[INDEX];
+                const auto ALPHA = 1.f - BETA;
+                alpha_alpha += ALPHA * ALPHA;
+                alpha_beta += ALPHA * BETA;
+                beta_beta += BETA * BETA;
+                alpha_x += ColorRGB(pixels[i]) * ALPHA;
+                beta_x += ColorRGB(pixels[i]) * BETA;
+            }
+
+            const auto DETERMINANT = alpha_alpha * beta_beta - alpha_beta * alpha_beta;
+            if (std::abs(DETERMINANT) < DETERMINANT_EPSILON) {
+                return false;
+            }
+
+            const auto INVERSE = 1.f / DETERMINANT;
+            endpoint0 = (alpha_x * beta_beta - beta_x * alpha_beta) * INVERSE;
+            endpoint1 = (beta_x * alpha_alpha - alpha_x * alpha_beta) * INVERSE;
+            return true;
+        }
+
+        /// Endpoints along the principal axis of the block's colors
+        void PrincipalAxisEndpoints(const BlockPixels& pixels,
+                                    bool skip_transparent,
+                                    glm::vec3& endpoint0,
+                                    glm::vec3& endpoint1)
+        {
+            constexpr std::int32_t POWER_ITERATIONS = 8;
+            constexpr float AXIS_EPSILON = 1e-8f;
+
+            glm::vec3 mean{0};
+            std::int32_t count = 0;
+            for (const auto& pixel : pixels) {
+                if (skip_transparent && pixel.a < TRANSPARENT_THRESHOLD) {
+                    continue;
+                }
+                mean += ColorRGB(pixel);
+                ++count;
+            }
+            if (count == 0) {
+                endpoint0 = endpoint1 = glm::vec3{0};
+                return;
+            }
+            mean = mean / static_cast<float>(count);
+
+            // Covariance matrix, symmetric so only the upper triangle is accumulated
+            glm::vec3 diagonal{0};
+            glm::vec3 off_diagonal{0};
+            for (const auto& pixel : pixels) {
+                if (skip_transparent && pixel.a < TRANSPARENT_THRESHOLD) {
+                    continue;
+                }
+                const auto D = ColorRGB(pixel) - mean;
+                diagonal += D * D;
+                off_diagonal += glm::vec3{D.r * D.g, D.r * D.b, D.g * D.b};
+            }
+
+            // Start from the covariance row of the channel with the largest variance, a fixed start vector can be
+            // orthogonal to the principal axis (e.g. red and blue gradients in opposite directions)
+            glm::vec3 axis{diagonal.r, off_diagonal.x, off_diagonal.y};
+            if (diagonal.g > diagonal.r && diagonal.g >= diagonal.b) {
+                axis = glm::vec3{off_diagonal.x, diagonal.g, off_diagonal.z};
+            } else if (diagonal.b > diagonal.r && diagonal.b > diagonal.g) {
+                axis = glm::vec3{off_diagonal.y, off_diagonal.z, diagonal.b};
+            }
+
+            for (std::int32_t i = 0; i < POWER_ITERATIONS; ++i) {
+                const glm::vec3 NEXT{diagonal.r * axis.r + off_diagonal.x * axis.g + off_diagonal.y * axis.b,
+                                     off_diagonal.x * axis.r + diagonal.g * axis.g + off_diagonal.z * axis.b,
+                                     off_diagonal.y * axis.r + off_diagonal.z * axis.g + diagonal.b * axis.b};
+                const auto LENGTH_SQUARED = glm::dot(NEXT, NEXT);
+                if (LENGTH_SQUARED < AXIS_EPSILON) {
+                    break;
+                }
+                axis = NEXT / std::sqrt(LENGTH_SQUARED);
+            }
+
+            auto min_projection = std::numeric_limits<float>::max();
+            auto max_projection = std::numeric_limits<float>::lowest();
+            for (const auto& pixel : pixels) {
+                if (skip_transparent && pixel.a < TRANSPARENT_THRESHOLD) {
+                    continue;
+                }
+                const auto PROJECTION = glm::dot(ColorRGB(pixel) - mean, axis);
+                min_projection = std::min(min_projection, PROJECTION);
+                max_projection = std::max(max_projection, PROJECTION);
+            }
+
+            endpoint0 = mean + axis * max_projection;
+            endpoint1 = mean + axis * min_projection;
+        }
+
+        /// Puts the endpoints into the order that selects the requested mode, remapping the indices to match
+        void OrderEndpoints(ColorBlock& block, bool four_color_mode)
+        {
+            const auto SWAP = four_color_mode ? block.Color0 < block.Color1 : block.Color0 > block.Color1;
+            if (!SWAP) {
+                return;
+            }
+
+            std::swap(block.Color0, block.Color1);
+
+            // 0 <-> 1 in both modes, 2 <-> 3 only when both are interpolated colors
+            constexpr std::uint32_t LOW_BITS = 0x55555555U;
+            const auto ENDPOINT_MASK = ~(block.Indices >> 1U) & LOW_BITS;
+            if (four_color_mode) {
+                block.Indices ^= LOW_BITS;
+            } else {
+                block.Indices ^= ENDPOINT_MASK;
+            }
+        }
+
+        auto EncodeColorBlock(const BlockPixels& pixels, bool allow_transparent) -> ColorBlock
+        {
+            const auto IS_TRANSPARENT = [](const glm::vec4& pixel) { return pixel.a < TRANSPARENT_THRESHOLD; };
+            const auto HAS_TRANSPARENT = allow_transparent && std::ranges::any_of(pixels, IS_TRANSPARENT);
+            const auto FOUR_COLOR_MODE = !HAS_TRANSPARENT;
+
+            glm::vec3 endpoint0{0};
+            glm::vec3 endpoint1{0};
+            PrincipalAxisEndpoints(pixels, HAS_TRANSPARENT, endpoint0, endpoint1);
+
+            ColorBlock best{PackRGB565(endpoint0), PackRGB565(endpoint1), 0};
+            auto best_error = FitColorIndices(pixels, best.Color0, best.Color1, FOUR_COLOR_MODE, best.Indices);
+
+            if (RefineEndpoints(pixels, best.Indices, FOUR_COLOR_MODE, endpoint0, endpoint1)) {
+                ColorBlock refined{PackRGB565(endpoint0), PackRGB565(endpoint1), 0};
+                const auto REFINED_ERROR =
+                    FitColorIndices(pixels, refined.Color0, refined.Color1, FOUR_COLOR_MODE, refined.Indices);
+                if (REFINED_ERROR < best_error) {
+                    best = refined;
+                }
+            }
+
+            // Equal endpoints can not express 4 color mode, every opaque index points at the endpoint anyway
+            if (best.Color0 == best.Color1 && FOUR_COLOR_MODE) {
+                best.Indices = 0;
+            }
+
+            OrderEndpoints(best, FOUR_COLOR_MODE);
+            return best;
+        }
+
+        void WriteColorBlock(const ColorBlock& block, std::span<std::byte, BC1_BLOCK_BYTES> output)
+        {
+            std::memcpy(&output[0], &block.Color0, sizeof(block.Color0));
+            std::memcpy(&output[2], &block.Color1, sizeof(block.Color1));
+            std::memcpy(&output[4], &block.Indices, sizeof(block.Indices));
+        }
+
+        auto ReadColorBlock(std::span<const std::byte, BC1_BLOCK_BYTES> input) -> ColorBlock
+        {
+            ColorBlock block;
+            std::memcpy(&block.Color0, &input[0], sizeof(block.Color0));
+            std::memcpy(&block.Color1, &input[2], sizeof(block.Color1));
+            std::memcpy(&block.Indices, &input[4], sizeof(block.Indices));
+            return block;
+        }
+
+        constexpr std::uint32_t ALPHA_PALETTE_SIZE = 8;
+        constexpr std::uint32_t ALPHA_INDEX_BITS = 3;
+
+        auto AlphaPalette(std::uint32_t alpha0, std::uint32_t alpha1) -> std::array<std::uint32_t, ALPHA_PALETTE_SIZE>
+        {
+            constexpr std::uint32_t EIGHT_ALPHA_STEPS = 7;
+            constexpr std::uint32_t SIX_ALPHA_STEPS = 5;
+
+            // Without alpha0 > alpha1 the last two entries are fixed to fully transparent and fully opaque
+            std::array<std::uint32_t, ALPHA_PALETTE_SIZE> palette{alpha0, alpha1};
+            if (alpha0 > alpha1) {
+                for (std::uint32_t i = 1; i < EIGHT_ALPHA_STEPS; ++i) {
+                    palette[i + 1] = ((EIGHT_ALPHA_STEPS - i) * alpha0 + i * alpha1) / EIGHT_ALPHA_STEPS;
+                }
+            } else {
+                for (std::uint32_t i = 1; i < SIX_ALPHA_STEPS; ++i) {
+                    palette[i + 1] = ((SIX_ALPHA_STEPS - i) * alpha0 + i * alpha1) / SIX_ALPHA_STEPS;
+                }
+                palette[ALPHA_PALETTE_SIZE - 2] = 0;
+                palette[ALPHA_PALETTE_SIZE - 1] = static_cast<std::uint32_t>(COLOR8_MAX);
+            }
+            return palette;
+        }
+
+        auto ToColor8(float value) -> std::uint32_t
+        {
+            return static_cast<std::uint32_t>(std::lround(std::clamp(value, 0.f, 1.f) * COLOR8_MAX));
+        }
+
+        void EncodeAlphaBlock(const BlockPixels& pixels, std::span<std::byte, BC1_BLOCK_BYTES> output)
+        {
+            std::array<std::uint32_t, BLOCK_PIXEL_COUNT> alphas{};
+            std::ranges::transform(pixels, alphas.begin(), [](const glm::vec4& pixel) { return ToColor8(pixel.a); });
+
+            const auto [MIN_ALPHA, MAX_ALPHA] = std::ranges::minmax(alphas);
+            const auto PALETTE = AlphaPalette(MAX_ALPHA, MIN_ALPHA);
+
+            std::uint64_t indices = 0;
+            if (MAX_ALPHA != MIN_ALPHA) {
+                for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i) {
+                    std::uint64_t best_index = 0;
+                    auto best_error = std::numeric_limits<std::uint32_t>::max();
+                    for (std::uint32_t entry = 0; entry < ALPHA_PALETTE_SIZE; ++entry) {
+                        const auto ENTRY_ERROR = alphas[i] > PALETTE[entry] ? alphas[i] - PALETTE[entry]
+                                                                            : PALETTE[entry] - alphas[i];
+                        if (ENTRY_ERROR < best_error) {
+                            best_error = ENTRY_ERROR;
+                            best_index = entry;
+                        }
+                    }
+                    indices |= best_index << (i * ALPHA_INDEX_BITS);
+                }
+            }
+
+            output[0] = static_cast<std::byte>(MAX_ALPHA);
+            output[1] = static_cast<std::byte>(MIN_ALPHA);
+            for (std::size_t i = 0; i < BC1_BLOCK_BYTES - 2; ++i) {
+                output[i + 2] = static_cast<std::byte>(indices >> (i * BITS_PER_BYTE));
+            }
+        }
+
+        void DecodeAlphaBlock(std::span<const std::byte, BC1_BLOCK_BYTES> input, BlockPixels& pixels)
+        {
+            const auto PALETTE = AlphaPalette(std::to_integer<std::uint32_t>(input[0]),
+                                              std::to_integer<std::uint32_t>(input[1]));
+
+            std::uint64_t indices = 0;
+            for (std::size_t i = 0; i < BC1_BLOCK_BYTES - 2; ++i) {
+                indices |= std::to_integer<std::uint64_t>(input[i + 2]) << (i * BITS_PER_BYTE);
+            }
+
+            for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i) {
+                const auto INDEX = (indices >> (i * ALPHA_INDEX_BITS)) & (ALPHA_PALETTE_SIZE - 1);
+                pixels[i].a = static_cast<float>(PALETTE[INDEX]) / COLOR8_MAX;
+            }
+        }
+
+        auto GatherBlock(const Image& image, std::int32_t block_x, std::int32_t block_y) -> BlockPixels
+        {
+            // Partial blocks at the edges repeat the last row and column
+            BlockPixels pixels;
+            for (std::int32_t y = 0; y < BLOCK_SIZE; ++y) {
+                for (std::int32_t x = 0; x < BLOCK_SIZE; ++x) {
+                    const auto SOURCE_X = std::min(block_x * BLOCK_SIZE + x, image.Size.X - 1);
+                    const auto SOURCE_Y = std::min(block_y * BLOCK_SIZE + y, image.Size.Y - 1);
+                    pixels[static_cast<std::size_t>(y * BLOCK_SIZE + x)] = image.At(SOURCE_X, SOURCE_Y);
+                }
+            }
+            return pixels;
+        }
+
+        auto FloatToHalf(float value) -> std::uint16_t
+        {
+            constexpr std::uint32_t SIGN_SHIFT = 16;
+            constexpr std::uint32_t MANTISSA_SHIFT = 13;
+            constexpr std::uint32_t HALF_EXPONENT_SHIFT = 10;
+            constexpr std::int32_t EXPONENT_BIAS_DIFFERENCE = 127 - 15;
+            constexpr std::int32_t MAX_HALF_EXPONENT = 31;
+            constexpr std::uint32_t HALF_INFINITY = 0x7C00U;
+            constexpr std::uint32_t SIGN_MASK = 0x8000U;
+            constexpr std::uint32_t MANTISSA_MASK = 0x7FFFFFU;
+            constexpr std::uint32_t EXPONENT_SHIFT = 23;
+            constexpr std::uint32_t EXPONENT_MASK = 0xFFU;
+
+            const auto BITS = std::bit_cast<std::uint32_t>(value);
+            const auto SIGN = (BITS >> SIGN_SHIFT) & SIGN_MASK;
+            const auto EXPONENT = static_cast<std::int32_t>((BITS >> EXPONENT_SHIFT) & EXPONENT_MASK)
+                                  - EXPONENT_BIAS_DIFFERENCE;
+
+            // Values too small for a normal half flush to zero
+            if (EXPONENT <= 0) {
+                return static_cast<std::uint16_t>(SIGN);
+            }
+            if (EXPONENT >= MAX_HALF_EXPONENT) {
+                return static_cast<std::uint16_t>(SIGN | HALF_INFINITY);
+            }
+            return static_cast<std::uint16_t>(SIGN | (static_cast<std::uint32_t>(EXPONENT) << HALF_EXPONENT_SHIFT)
+                                              | ((BITS & MANTISSA_MASK) >> MANTISSA_SHIFT));
+        }
+
+        template<typename T, std::size_t CHANNELS, typename Convert>
+        auto EncodeUncompressed(const Image& image, Convert convert) -> Vector<std::byte>
+        {
+            Vector<std::byte> output(image.Pixels.size() * CHANNELS * sizeof(T));
+            for (std::size_t i = 0; i < image.Pixels.size(); ++i) {
+                for (std::size_t channel = 0; channel < CHANNELS; ++channel) {
+                    const T VALUE = convert(image.Pixels[i][static_cast<glm::length_t>(channel)]);
+                    std::memcpy(&output[(i * CHANNELS + channel) * sizeof(T)], &VALUE, sizeof(T));
+                }
+            }
+            return output;
+        }
+
+        auto ToUnorm8(float value) -> std::uint8_t { return static_cast<std::uint8_t>(ToColor8(value)); }
+
+    }  // namespace
+
+    auto ImageFromRGBA8(const Size2D& size, std::span<const std::uint8_t> pixels) -> Image
+    {
+        constexpr std::size_t CHANNELS = 4;
+        ASSERT(pixels.size() == static_cast<std::size_t>(size.X) * static_cast<std::size_t>(size.Y) * CHANNELS);
+
+        Image image{size, Vector<glm::vec4>(pixels.size() / CHANNELS)};
+        for (std::size_t i = 0; i < image.Pixels.size(); ++i) {
+            image.Pixels[i] = glm::vec4{static_cast<float>(pixels[i * CHANNELS]),
+                                        static_cast<float>(pixels[i * CHANNELS + 1]),
+                                        static_cast<float>(pixels[i * CHANNELS + 2]),
+                                        static_cast<float>(pixels[i * CHANNELS + 3])}
+                              / COLOR8_MAX;
+        }
+        return image;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto SRGBToLinear(const Image& image) -> Image
+    {
+        auto linear = image;
+        for (auto& pixel : linear.Pixels) {
+            pixel = glm::vec4{SRGBToLinear(pixel.r), SRGBToLinear(pixel.g), SRGBToLinear(pixel.b), pixel.a};
+        }
+        return linear;
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto LinearToSRGB(const Image& image) -> Image
+    {
+        auto srgb = image;
+        for (auto& pixel : srgb.Pixels) {
+            pixel = glm::vec4{LinearToSRGB(pixel.r), LinearToSRGB(pixel.g), LinearToSRGB(pixel.b), pixel.a};
+        }
+        return srgb;
+    }
+
+    auto DownsampleImage(const Image& image,
+                         const Size2D& size,
+                         MipFilter filter,
+                         TextureWrap wrap,
+                         std::uint32_t worker_count) -> Image
+    {
+        ASSERT(size.X > 0 && size.Y > 0);
+
+        const auto HORIZONTAL_TAPS = ComputeFilterTaps(image.Size.X, size.X, filter, wrap);
+        const auto VERTICAL_TAPS = ComputeFilterTaps(image.Size.Y, size.Y, filter, wrap);
+
+        // Horizontal pass into an intermediate of the destination width and the source height
+        Image horizontal{{size.X, image.Size.Y},
+                         Vector<glm::vec4>(static_cast<std::size_t>(size.X) * static_cast<std::size_t>(image.Size.Y))};
+        const auto FILTER_HORIZONTAL = [&](std::size_t row)
+        {
+            const auto Y = static_cast<std::int32_t>(row);
+            for (std::int32_t x = 0; x < size.X; ++x) {
+                glm::vec4 sum{0};
+                for (const auto& tap : HORIZONTAL_TAPS[static_cast<std::size_t>(x)]) {
+                    sum += image.At(tap.Index, Y) * tap.Weight;
+                }
+                horizontal.Pixels[row * static_cast<std::size_t>(size.X) + static_cast<std::size_t>(x)] = sum;
+            }
+        };
+        ParallelFor(static_cast<std::size_t>(image.Size.Y), worker_count, FILTER_HORIZONTAL);
+
+        Image result{size, Vector<glm::vec4>(static_cast<std::size_t>(size.X) * static_cast<std::size_t>(size.Y))};
+        const auto FILTER_VERTICAL = [&](std::size_t row)
+        {
+            for (std::int32_t x = 0; x < size.X; ++x) {
+                glm::vec4 sum{0};
+                for (const auto& tap : VERTICAL_TAPS[row]) {
+                    sum += horizontal.At(x, tap.Index) * tap.Weight;
+                }
+                // Negative lobes can overshoot
+                result.Pixels[row * static_cast<std::size_t>(size.X) + static_cast<std::size_t>(x)] =
+                    glm::clamp(sum, 0.f, 1.f);
+            }
+        };
+        ParallelFor(static_cast<std::size_t>(size.Y), worker_count, FILTER_VERTICAL);
+
+        return result;
+    }
+
+    auto GenerateMipChain(const Image& image, MipFilter filter, TextureWrap wrap, std::uint32_t worker_count)
+        -> Vector<Image>
+    {
+        const auto LEVEL_COUNT = MipLevelCount(image.Size);
+
+        Vector<Image> levels;
+        levels.reserve(LEVEL_COUNT);
+        levels.push_back(image);
+        for (std::uint32_t level = 1; level < LEVEL_COUNT; ++level) {
+            levels.push_back(
+                DownsampleImage(levels.back(), MipLevelSize(image.Size, level), filter, wrap, worker_count));
+        }
+        return levels;
+    }
+
+    auto EncodeBC1Block(const BlockPixels& pixels) -> std::array<std::byte, BC1_BLOCK_BYTES>
+    {
+        std::array<std::byte, BC1_BLOCK_BYTES> block{};
+        WriteColorBlock(EncodeColorBlock(pixels, true), block);
+        return block;
+    }
+
+    auto EncodeBC3Block(const BlockPixels& pixels) -> std::array<std::byte, BC3_BLOCK_BYTES>
+    {
+        std::array<std::byte, BC3_BLOCK_BYTES> block{};
+        EncodeAlphaBlock(pixels, std::span{block}.first<BC1_BLOCK_BYTES>());
+        WriteColorBlock(EncodeColorBlock(pixels, false), std::span{block}.last<BC1_BLOCK_BYTES>());
+        return block;
+    }
+
+    auto DecodeBC1Block(std::span<const std::byte, BC1_BLOCK_BYTES> block) -> BlockPixels
+    {
+        const auto COLOR_BLOCK = ReadColorBlock(block);
+        const auto FOUR_COLOR_MODE = COLOR_BLOCK.Color0 > COLOR_BLOCK.Color1;
+        const auto PALETTE = ColorPalette(COLOR_BLOCK.Color0, COLOR_BLOCK.Color1, FOUR_COLOR_MODE);
+
+        BlockPixels pixels;
+        for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i) {
+            const auto INDEX = (COLOR_BLOCK.Indices >> (i * 2)) & 3U;
+            const auto IS_TRANSPARENT = !FOUR_COLOR_MODE && INDEX == TRANSPARENT_INDEX;
+            pixels[i] = glm::vec4{PALETTE[INDEX], IS_TRANSPARENT ? 0.f : 1.f};
+        }
+        return pixels;
+    }
+
+    auto DecodeBC3Block(std::span<const std::byte, BC3_BLOCK_BYTES> block) -> BlockPixels
+    {
+        // The color half of a BC3 block is always decoded in 4 color mode
+        const auto COLOR_BLOCK = ReadColorBlock(block.last<BC1_BLOCK_BYTES>());
+        const auto PALETTE = ColorPalette(COLOR_BLOCK.Color0, COLOR_BLOCK.Color1, true);
+
+        BlockPixels pixels;
+        for (std::size_t i = 0; i < BLOCK_PIXEL_COUNT; ++i) {
+            pixels[i] = glm::vec4{PALETTE[(COLOR_BLOCK.Indices >> (i * 2)) & 3U], 1.f};
+        }
+        DecodeAlphaBlock(block.first<BC1_BLOCK_BYTES>(), pixels);
+        return pixels;
+    }
+
+    auto EncodeImage(const Image& image, TextureFormat format, std::uint32_t worker_count) -> Vector<std::byte>
+    {
+        switch (format) {
+            case TextureFormat::R8:
+                return EncodeUncompressed<std::uint8_t, 1>(image, ToUnorm8);
+            case TextureFormat::RG8:
+                return EncodeUncompressed<std::uint8_t, 2>(image, ToUnorm8);
+            case TextureFormat::RGBA8:
+            case TextureFormat::SRGB8_ALPHA8:
+                return EncodeUncompressed<std::uint8_t, 4>(image, ToUnorm8);
+            case TextureFormat::RGBA16F:
+                return EncodeUncompressed<std::uint16_t, 4>(image, FloatToHalf);
+            case TextureFormat::RGBA32F:
+                return EncodeUncompressed<float, 4>(image, [](float value) { return value; });
+            default:
+                break;
+        }
+
+        ASSERT(IsCompressedFormat(format));
+
+        const auto INFO = GetTextureFormatInfo(format);
+        const auto BLOCKS_X = (image.Size.X + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const auto BLOCKS_Y = (image.Size.Y + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        const auto ROW_BYTES = static_cast<std::size_t>(BLOCKS_X) * INFO.BlockBytes;
+        const auto IS_BC1 = format == TextureFormat::BC1_RGBA || format == TextureFormat::BC1_SRGB_ALPHA;
+
+        // Rows of blocks are independent, encode them on every worker
+        Vector<std::byte> output(ROW_BYTES * static_cast<std::size_t>(BLOCKS_Y));
+        const auto ENCODE_ROW = [&](std::size_t row)
+        {
+            for (std::int32_t block_x = 0; block_x < BLOCKS_X; ++block_x) {
+                const auto PIXELS = GatherBlock(image, block_x, static_cast<std::int32_t>(row));
+                auto* destination = &output[row * ROW_BYTES + static_cast<std::size_t>(block_x) * INFO.BlockBytes];
+                if (IS_BC1) {
+                    const auto BLOCK = EncodeBC1Block(PIXELS);
+                    std::memcpy(destination, BLOCK.data(), BLOCK.size());
+                } else {
+                    const auto BLOCK = EncodeBC3Block(PIXELS);
+                    std::memcpy(destination, BLOCK.data(), BLOCK.size());
+                }
+            }
+        };
+        ParallelFor(static_cast<std::size_t>(BLOCKS_Y), worker_count, ENCODE_ROW);
+        return output;
+    }
+
+    auto ProcessTexture(const Image& image, const TextureProcessingOptions& options) -> TextureData
+    {
+        const auto SRGB = IsSRGBFormat(options.Format);
+
+        TextureData data;
+        data.Description.Size = image.Size;
+        data.Description.Format = options.Format;
+        data.Levels.push_back(EncodeImage(image, options.Format, options.WorkerCount));
+
+        if (!options.GenerateMipmaps) {
+            return data;
+        }
+
+        const auto LEVELS =
+            GenerateMipChain(SRGB ? SRGBToLinear(image) : image, options.Filter, options.Wrap, options.WorkerCount);
+        data.Description.MipLevels = static_cast<std::uint32_t>(LEVELS.size());
+
+        // Level 0 was encoded from the source directly, so it does not go through a color space round trip
+        for (std::size_t level = 1; level < LEVELS.size(); ++level) {
+            const auto& mip = LEVELS[level];
+            data.Levels.push_back(EncodeImage(SRGB ? LinearToSRGB(mip) : mip, options.Format, options.WorkerCount));
+        }
+        return data;
+    }
+
+}  // namespace JE
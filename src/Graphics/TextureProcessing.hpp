@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "Memory.hpp"
+#include "Texture.hpp"
+#include "Types.hpp"
+
+namespace JE
+{
+
+    /// Working format of the texture pipeline, RGBA with float channels in [0, 1]
+    struct Image
+    {
+        Size2D Size;
+        Vector<glm::vec4> Pixels;
+
+        inline auto At(std::int32_t x, std::int32_t y) const -> const glm::vec4&
+        {
+            return Pixels[static_cast<std::size_t>(y) * static_cast<std::size_t>(Size.X) + static_cast<std::size_t>(x)];
+        }
+    };
+
+    auto ImageFromRGBA8(const Size2D& size, std::span<const std::uint8_t> pixels) -> Image;
+
+    auto SRGBToLinear(const Image& image) -> Image;
+    auto LinearToSRGB(const Image& image) -> Image;
+
+    enum class MipFilter
+    {
+        BOX,
+        LANCZOS3,
+        /// Kaiser windowed sinc, sharper than a box filter without Lanczos' ringing
+        KAISER
+    };
+
+    /// Resamples to a smaller size with a separable filter, pixels outside the image are addressed with wrap
+    auto DownsampleImage(const Image& image,
+                         const Size2D& size,
+                         MipFilter filter,
+                         TextureWrap wrap,
+                         std::uint32_t worker_count = 0) -> Image;
+
+    /// Full mip chain down to 1x1, level 0 is the source image, filtering should happen on linear data
+    auto GenerateMipChain(const Image& image, MipFilter filter, TextureWrap wrap, std::uint32_t worker_count = 0)
+        -> Vector<Image>;
+
+    constexpr std::size_t BLOCK_PIXEL_COUNT = 16;
+    constexpr std::size_t BC1_BLOCK_BYTES = 8;
+    constexpr std::size_t BC3_BLOCK_BYTES = 16;
+
+    using BlockPixels = std::array<glm::vec4, BLOCK_PIXEL_COUNT>;
+
+    /// Pixels with alpha below one half are encoded as transparent using BC1's 3 color mode
+    auto EncodeBC1Block(const BlockPixels& pixels) -> std::array<std::byte, BC1_BLOCK_BYTES>;
+    auto EncodeBC3Block(const BlockPixels& pixels) -> std::array<std::byte, BC3_BLOCK_BYTES>;
+
+    auto DecodeBC1Block(std::span<const std::byte, BC1_BLOCK_BYTES> block) -> BlockPixels;
+    auto DecodeBC3Block(std::span<const std::byte, BC3_BLOCK_BYTES> block) -> BlockPixels;
+
+    /// Encodes a single level into the tightly packed layout of format, the image is expected in the format's color
+    /// space, block compression is spread over worker_count threads (0 uses every hardware thread)
+    auto EncodeImage(const Image& image, TextureFormat format, std::uint32_t worker_count = 0) -> Vector<std::byte>;
+
+    struct TextureProcessingOptions
+    {
+        TextureFormat Format = TextureFormat::BC3_RGBA;
+        bool GenerateMipmaps = true;
+        MipFilter Filter = MipFilter::KAISER;
+        TextureWrap Wrap = TextureWrap::REPEAT;
+        std::uint32_t WorkerCount = 0;
+    };
+
+    /// Offline processing of a source image (in the target format's color space) into uploadable levels, mips of
+    /// sRGB formats are filtered in linear space
+    auto ProcessTexture(const Image& image, const TextureProcessingOptions& options) -> TextureData;
+
+}  // namespace JE
@@ -0,0 +1,424 @@
+#include "VulkanDevice.hpp"
+
+#include "Logger.hpp"
+#include "Memory.hpp"
+
+namespace JE
+{
+
+    namespace
+    {
+
+        constexpr auto APPLICATION_NAME = "JEngine-Reformed";
+
+        /// Higher is better, CPU implementations like lavapipe are only picked when nothing else is available
+        constexpr auto DeviceTypeScore(VkPhysicalDeviceType type) -> std::int32_t
+        {
+            switch (type) {
+                case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+                    return 4;
+                case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+                    return 3;
+                case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+                    return 2;
+                case VK_PHYSICAL_DEVICE_TYPE_CPU:
+                    return 1;
+                default:
+                    return 0;
+            }
+        }
+
+        auto FindGraphicsQueueFamily(VkPhysicalDevice physical_device) -> std::optional<std::uint32_t>
+        {
+            std::uint32_t family_count = 0;
+            vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, nullptr);
+            Vector<VkQueueFamilyProperties> families(family_count);
+            vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, families.data());
+
+            for (std::uint32_t family = 0; family < family_count; ++family) {
+                if ((families[family].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0u) {
+                    return family;
+                }
+            }
+            return std::nullopt;
+        }
+
+    }  // namespace
+
+    auto VulkanResultToString(VkResult result) -> std::string_view
+    {
+        switch (result) {
+            case VK_SUCCESS:
+                return "SUCCESS";
+            case VK_NOT_READY:
+                return "NOT_READY";
+            case VK_TIMEOUT:
+                return "TIMEOUT";
+            case VK_ERROR_OUT_OF_HOST_MEMORY:
+                return "ERROR_OUT_OF_HOST_MEMORY";
+            case VK_ERROR_OUT_OF_DEVICE_MEMORY:
+                return "ERROR_OUT_OF_DEVICE_MEMORY";
+            case VK_ERROR_INITIALIZATION_FAILED:
+                return "ERROR_INITIALIZATION_FAILED";
+            case VK_ERROR_DEVICE_LOST:
+                return "ERROR_DEVICE_LOST";
+            case VK_ERROR_MEMORY_MAP_FAILED:
+                return "ERROR_MEMORY_MAP_FAILED";
+            case VK_ERROR_LAYER_NOT_PRESENT:
+                return "ERROR_LAYER_NOT_PRESENT";
+            case VK_ERROR_EXTENSION_NOT_PRESENT:
+                return "ERROR_EXTENSION_NOT_PRESENT";
+            case VK_ERROR_FEATURE_NOT_PRESENT:
+                return "ERROR_FEATURE_NOT_PRESENT";
+            case VK_ERROR_INCOMPATIBLE_DRIVER:
+                return "ERROR_INCOMPATIBLE_DRIVER";
+            case VK_ERROR_FORMAT_NOT_SUPPORTED:
+                return "ERROR_FORMAT_NOT_SUPPORTED";
+            default:
+                return "UNKNOWN_VULKAN_ERROR";
+        }
+    }
+
+    auto VulkanSucceeded(VkResult result, std::string_view call) -> bool
+    {
+        if (result == VK_SUCCESS) {
+            return true;
+        }
+        EngineLogger()->error("Vulkan API Error: {} - {}", call, VulkanResultToString(result));
+        return false;
+    }
+
+    VulkanDevice::VulkanDevice()
+    {
+        if (!CreateInstance() || !PickPhysicalDevice() || !CreateLogicalDevice()) {
+            EngineLogger()->error("Failed to create a Vulkan device");
+            return;
+        }
+        EngineLogger()->info("Vulkan device - {}", m_Name);
+    }
+
+    VulkanDevice::~VulkanDevice()
+    {
+        if (m_Device != VK_NULL_HANDLE) {
+            vkDeviceWaitIdle(m_Device);
+            for (const auto& [THREAD, POOL] : m_CommandPools) {
+                vkDestroyCommandPool(m_Device, POOL, nullptr);
+            }
+            vkDestroyDevice(m_Device, nullptr);
+        }
+        if (m_Instance != VK_NULL_HANDLE) {
+            vkDestroyInstance(m_Instance, nullptr);
+        }
+    }
+
+    auto VulkanDevice::CreateInstance() -> bool
+    {
+        VkApplicationInfo application_info{};
+        application_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        application_info.pApplicationName = APPLICATION_NAME;
+        application_info.pEngineName = APPLICATION_NAME;
+        application_info.apiVersion = VK_API_VERSION_1_1;
+
+        VkInstanceCreateInfo create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        create_info.pApplicationInfo = &application_info;
+
+        return VulkanSucceeded(vkCreateInstance(&create_info, nullptr, &m_Instance), "vkCreateInstance");
+    }
+
+    auto VulkanDevice::PickPhysicalDevice() -> bool
+    {
+        std::uint32_t device_count = 0;
+        if (!VulkanSucceeded(vkEnumeratePhysicalDevices(m_Instance, &device_count, nullptr),
+                             "vkEnumeratePhysicalDevices")) {
+            return false;
+        }
+        Vector<VkPhysicalDevice> devices(device_count);
+        vkEnumeratePhysicalDevices(m_Instance, &device_count, devices.data());
+
+        std::int32_t best_score = -1;
+        for (auto* device : devices) {
+            VkPhysicalDeviceProperties properties{};
+            vkGetPhysicalDeviceProperties(device, &properties);
+            const auto SCORE = DeviceTypeScore(properties.deviceType);
+            if (SCORE > best_score && FindGraphicsQueueFamily(device)) {
+                best_score = SCORE;
+                m_PhysicalDevice = device;
+                m_Name = properties.deviceName;
+            }
+        }
+
+        if (m_PhysicalDevice == VK_NULL_HANDLE) {
+            EngineLogger()->error("No Vulkan device with a graphics queue found");
+            return false;
+        }
+
+        m_QueueFamily = *FindGraphicsQueueFamily(m_PhysicalDevice);
+        vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &m_MemoryProperties);
+
+        // Every device supports at least one of these as a depth attachment
+        for (const auto FORMAT :
+             {VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D32_SFLOAT}) {
+            VkFormatProperties properties{};
+            vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, FORMAT, &properties);
+            if ((properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) != 0u) {
+                m_DepthFormat = FORMAT;
+                break;
+            }
+        }
+        return true;
+    }
+
+    auto VulkanDevice::CreateLogicalDevice() -> bool
+    {
+        const float QUEUE_PRIORITY = 1.0f;
+        VkDeviceQueueCreateInfo queue_info{};
+        queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queue_info.queueFamilyIndex = m_QueueFamily;
+        queue_info.queueCount = 1;
+        queue_info.pQueuePriorities = &QUEUE_PRIORITY;
+
+        VkDeviceCreateInfo create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        create_info.queueCreateInfoCount = 1;
+        create_info.pQueueCreateInfos = &queue_info;
+
+        if (!VulkanSucceeded(vkCreateDevice(m_PhysicalDevice, &create_info, nullptr, &m_Device), "vkCreateDevice")) {
+            m_Device = VK_NULL_HANDLE;
+            return false;
+        }
+        vkGetDeviceQueue(m_Device, m_QueueFamily, 0, &m_Queue);
+        return true;
+    }
+
+    auto VulkanDevice::FormatProperties(VkFormat format) const -> VkFormatProperties
+    {
+        VkFormatProperties properties{};
+        vkGetPhysicalDeviceFormatProperties(m_PhysicalDevice, format, &properties);
+        return properties;
+    }
+
+    auto VulkanDevice::ThreadCommandPool() -> VkCommandPool
+    {
+        const std::scoped_lock LOCK{m_PoolMutex};
+
+        const auto POOL = m_CommandPools.find(std::this_thread::get_id());
+        if (POOL != m_CommandPools.end()) {
+            return POOL->second;
+        }
+
+        VkCommandPoolCreateInfo create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        create_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        create_info.queueFamilyIndex = m_QueueFamily;
+
+        VkCommandPool pool = VK_NULL_HANDLE;
+        if (!VulkanSucceeded(vkCreateCommandPool(m_Device, &create_info, nullptr, &pool), "vkCreateCommandPool")) {
+            return VK_NULL_HANDLE;
+        }
+        m_CommandPools.emplace(std::this_thread::get_id(), pool);
+        return pool;
+    }
+
+    auto VulkanDevice::AllocateCommandBuffer() -> VkCommandBuffer
+    {
+        const auto POOL = ThreadCommandPool();
+        if (POOL == VK_NULL_HANDLE) {
+            return VK_NULL_HANDLE;
+        }
+
+        VkCommandBufferAllocateInfo allocate_info{};
+        allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocate_info.commandPool = POOL;
+        allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocate_info.commandBufferCount = 1;
+
+        VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+        if (!VulkanSucceeded(vkAllocateCommandBuffers(m_Device, &allocate_info, &command_buffer),
+                             "vkAllocateCommandBuffers")) {
+            return VK_NULL_HANDLE;
+        }
+
+        const std::scoped_lock LOCK{m_PoolMutex};
+        m_CommandBufferPools.emplace(command_buffer, POOL);
+        return command_buffer;
+    }
+
+    void VulkanDevice::FreeCommandBuffer(VkCommandBuffer command_buffer)
+    {
+        const std::scoped_lock LOCK{m_PoolMutex};
+
+        const auto POOL = m_CommandBufferPools.find(command_buffer);
+        if (POOL == m_CommandBufferPools.end()) {
+            return;
+        }
+        vkFreeCommandBuffers(m_Device, POOL->second, 1, &command_buffer);
+        m_CommandBufferPools.erase(POOL);
+    }
+
+    auto VulkanDevice::Submit(std::span<const VkCommandBuffer> command_buffers, VkFence fence) -> bool
+    {
+        VkSubmitInfo submit_info{};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount = static_cast<std::uint32_t>(command_buffers.size());
+        submit_info.pCommandBuffers = command_buffers.data();
+
+        const std::scoped_lock LOCK{m_QueueMutex};
+        // An empty submission only signals the fence once the work before it is done
+        return VulkanSucceeded(vkQueueSubmit(m_Queue, command_buffers.empty() ? 0 : 1, &submit_info, fence),
+                               "vkQueueSubmit");
+    }
+
+    auto VulkanDevice::WaitIdle() -> bool
+    {
+        const std::scoped_lock LOCK{m_QueueMutex};
+        return VulkanSucceeded(vkQueueWaitIdle(m_Queue), "vkQueueWaitIdle");
+    }
+
+    auto VulkanDevice::FindMemoryType(std::uint32_t type_bits, VkMemoryPropertyFlags properties) const
+        -> std::optional<std::uint32_t>
+    {
+        for (std::uint32_t type = 0; type < m_MemoryProperties.memoryTypeCount; ++type) {
+            if ((type_bits & (1u << type)) != 0u
+                && (m_MemoryProperties.memoryTypes[type].propertyFlags & properties) == properties) {
+                return type;
+            }
+        }
+        return std::nullopt;
+    }
+
+    auto VulkanDevice::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties)
+        -> VkDeviceMemory
+    {
+        // Device local memory is preferred, but any compatible type works on unified memory and CPU devices
+        auto memory_type = FindMemoryType(requirements.memoryTypeBits, properties);
+        if (!memory_type) {
+            const VkMemoryPropertyFlags DEVICE_LOCAL = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            memory_type = FindMemoryType(requirements.memoryTypeBits, properties & ~DEVICE_LOCAL);
+        }
+        if (!memory_type) {
+            EngineLogger()->error("No Vulkan memory type with properties {:#x}", properties);
+            return VK_NULL_HANDLE;
+        }
+
+        VkMemoryAllocateInfo allocate_info{};
+        allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocate_info.allocationSize = requirements.size;
+        allocate_info.memoryTypeIndex = *memory_type;
+
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        if (!VulkanSucceeded(vkAllocateMemory(m_Device, &allocate_info, nullptr, &memory), "vkAllocateMemory")) {
+            return VK_NULL_HANDLE;
+        }
+        return memory;
+    }
+
+    auto VulkanDevice::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
+        -> std::optional<VulkanBuffer>
+    {
+        VulkanBuffer buffer;
+        buffer.Size = size;
+
+        VkBufferCreateInfo create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        create_info.size = size;
+        create_info.usage = usage;
+        create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (!VulkanSucceeded(vkCreateBuffer(m_Device, &create_info, nullptr, &buffer.Buffer), "vkCreateBuffer")) {
+            return std::nullopt;
+        }
+
+        VkMemoryRequirements requirements{};
+        vkGetBufferMemoryRequirements(m_Device, buffer.Buffer, &requirements);
+        buffer.Memory = Allocate(requirements, properties);
+        if (buffer.Memory == VK_NULL_HANDLE
+            || !VulkanSucceeded(vkBindBufferMemory(m_Device, buffer.Buffer, buffer.Memory, 0), "vkBindBufferMemory")) {
+            DestroyBuffer(buffer);
+            return std::nullopt;
+        }
+
+        if ((properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0u) {
+            void* mapped = nullptr;
+            if (!VulkanSucceeded(vkMapMemory(m_Device, buffer.Memory, 0, VK_WHOLE_SIZE, 0, &mapped), "vkMapMemory")) {
+                DestroyBuffer(buffer);
+                return std::nullopt;
+            }
+            buffer.Mapped = static_cast<std::byte*>(mapped);
+        }
+        return buffer;
+    }
+
+    void VulkanDevice::DestroyBuffer(const VulkanBuffer& buffer)
+    {
+        if (buffer.Buffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(m_Device, buffer.Buffer, nullptr);
+        }
+        if (buffer.Memory != VK_NULL_HANDLE) {
+            vkFreeMemory(m_Device, buffer.Memory, nullptr);
+        }
+    }
+
+    auto VulkanDevice::CreateImage(const Size2D& size,
+                                   VkFormat format,
+                                   std::uint32_t mip_levels,
+                                   VkImageUsageFlags usage,
+                                   VkImageAspectFlags aspect) -> std::optional<VulkanImage>
+    {
+        VulkanImage image;
+        image.Format = format;
+        image.Aspect = aspect;
+        image.Size = size;
+        image.MipLevels = mip_levels;
+
+        VkImageCreateInfo create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        create_info.imageType = VK_IMAGE_TYPE_2D;
+        create_info.format = format;
+        create_info.extent = {static_cast<std::uint32_t>(size.X), static_cast<std::uint32_t>(size.Y), 1};
+        create_info.mipLevels = mip_levels;
+        create_info.arrayLayers = 1;
+        create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+        create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        create_info.usage = usage;
+        create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        if (!VulkanSucceeded(vkCreateImage(m_Device, &create_info, nullptr, &image.Image), "vkCreateImage")) {
+            return std::nullopt;
+        }
+
+        VkMemoryRequirements requirements{};
+        vkGetImageMemoryRequirements(m_Device, image.Image, &requirements);
+        image.Memory = Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (image.Memory == VK_NULL_HANDLE
+            || !VulkanSucceeded(vkBindImageMemory(m_Device, image.Image, image.Memory, 0), "vkBindImageMemory")) {
+            DestroyImage(image);
+            return std::nullopt;
+        }
+
+        VkImageViewCreateInfo view_info{};
+        view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        view_info.image = image.Image;
+        view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        view_info.format = format;
+        view_info.subresourceRange = {aspect, 0, mip_levels, 0, 1};
+        if (!VulkanSucceeded(vkCreateImageView(m_Device, &view_info, nullptr, &image.View), "vkCreateImageView")) {
+            DestroyImage(image);
+            return std::nullopt;
+        }
+        return image;
+    }
+
+    void VulkanDevice::DestroyImage(const VulkanImage& image)
+    {
+        if (image.View != VK_NULL_HANDLE) {
+            vkDestroyImageView(m_Device, image.View, nullptr);
+        }
+        if (image.Image != VK_NULL_HANDLE) {
+            vkDestroyImage(m_Device, image.Image, nullptr);
+        }
+        if (image.Memory != VK_NULL_HANDLE) {
+            vkFreeMemory(m_Device, image.Memory, nullptr);
+        }
+    }
+
+}  // namespace JE
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include "Types.hpp"
+
+namespace JE
+{
+
+    auto VulkanResultToString(VkResult result) -> std::string_view;
+
+    /// Logs failed calls like the OpenGL backend's error wrapper does, returns whether the call succeeded
+    auto VulkanSucceeded(VkResult result, std::string_view call) -> bool;
+
+    struct VulkanBuffer
+    {
+        VkBuffer Buffer = VK_NULL_HANDLE;
+        VkDeviceMemory Memory = VK_NULL_HANDLE;
+        VkDeviceSize Size = 0;
+        /// Persistently mapped for host visible buffers
+        std::byte* Mapped = nullptr;
+    };
+
+    struct VulkanImage
+    {
+        VkImage Image = VK_NULL_HANDLE;
+        VkDeviceMemory Memory = VK_NULL_HANDLE;
+        VkImageView View = VK_NULL_HANDLE;
+        VkFormat Format = VK_FORMAT_UNDEFINED;
+        VkImageAspectFlags Aspect = 0;
+        Size2D Size;
+        std::uint32_t MipLevels = 1;
+    };
+
+    /// Instance, device and graphics queue without a surface, so it runs on headless servers and on Mesa's lavapipe
+    /// when there's no GPU. Hardware devices are preferred over CPU implementations
+    class VulkanDevice
+    {
+      public:
+        VulkanDevice(const VulkanDevice& other) = delete;
+        VulkanDevice(VulkanDevice&& other) = delete;
+        auto operator=(const VulkanDevice& other) -> VulkanDevice& = delete;
+        auto operator=(VulkanDevice&& other) -> VulkanDevice& = delete;
+
+        VulkanDevice();
+        ~VulkanDevice();
+
+        inline auto Initialized() const -> bool { return m_Device != VK_NULL_HANDLE; }
+        inline auto Name() const -> std::string_view { return m_Name; }
+        inline auto Handle() const -> VkDevice { return m_Device; }
+        inline auto DepthFormat() const -> VkFormat { return m_DepthFormat; }
+        auto FormatProperties(VkFormat format) const -> VkFormatProperties;
+
+        /// Command pools are externally synchronized, every recording thread gets its own so command buffers can
+        /// be recorded on all cores. Command buffers have to be freed by the thread that allocated them
+        auto ThreadCommandPool() -> VkCommandPool;
+        auto AllocateCommandBuffer() -> VkCommandBuffer;
+        void FreeCommandBuffer(VkCommandBuffer command_buffer);
+
+        /// The queue is shared by every thread, submissions are serialized
+        auto Submit(std::span<const VkCommandBuffer> command_buffers, VkFence fence) -> bool;
+        auto WaitIdle() -> bool;
+
+        auto CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
+            -> std::optional<VulkanBuffer>;
+        void DestroyBuffer(const VulkanBuffer& buffer);
+
+        auto CreateImage(const Size2D& size,
+                         VkFormat format,
+                         std::uint32_t mip_levels,
+                         VkImageUsageFlags usage,
+                         VkImageAspectFlags aspect) -> std::optional<VulkanImage>;
+        void DestroyImage(const VulkanImage& image);
+
+      private:
+        auto CreateInstance() -> bool;
+        auto PickPhysicalDevice() -> bool;
+        auto CreateLogicalDevice() -> bool;
+        auto FindMemoryType(std::uint32_t type_bits, VkMemoryPropertyFlags properties) const
+            -> std::optional<std::uint32_t>;
+        auto Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties)
+            -> VkDeviceMemory;
+
+        VkInstance m_Instance = VK_NULL_HANDLE;
+        VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
+        VkPhysicalDeviceMemoryProperties m_MemoryProperties{};
+        VkDevice m_Device = VK_NULL_HANDLE;
+        VkQueue m_Queue = VK_NULL_HANDLE;
+        std::uint32_t m_QueueFamily = 0;
+        VkFormat m_DepthFormat = VK_FORMAT_UNDEFINED;
+        std::string m_Name;
+
+        std::mutex m_QueueMutex;
+        std::mutex m_PoolMutex;
+        std::unordered_map<std::thread::id, VkCommandPool> m_CommandPools;
+        std::unordered_map<VkCommandBuffer, VkCommandPool> m_CommandBufferPools;
+    };
+
+}  // namespace JE
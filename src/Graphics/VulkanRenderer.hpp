@@ -0,0 +1,594 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include <vulkan/vulkan.h>
+
+#include "Graphics/IRendererAPI.hpp"
+#include "Graphics/Renderer.hpp"
+#include "Graphics/Texture.hpp"
+#include "Graphics/VulkanDevice.hpp"
+#include "Graphics/VulkanRendererAPI.hpp"
+#include "Logger.hpp"
+#include "Memory.hpp"
+
+namespace JE
+{
+
+    constexpr auto TextureFormatToVkFormat(TextureFormat format) -> VkFormat
+    {
+        switch (format) {
+            case TextureFormat::R8:
+                return VK_FORMAT_R8_UNORM;
+            case TextureFormat::RG8:
+                return VK_FORMAT_R8G8_UNORM;
+            case TextureFormat::RGBA8:
+                return VK_FORMAT_R8G8B8A8_UNORM;
+            case TextureFormat::SRGB8_ALPHA8:
+                return VK_FORMAT_R8G8B8A8_SRGB;
+            case TextureFormat::RGBA16F:
+                return VK_FORMAT_R16G16B16A16_SFLOAT;
+            case TextureFormat::RGBA32F:
+                return VK_FORMAT_R32G32B32A32_SFLOAT;
+            case TextureFormat::BC1_RGBA:
+                return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case TextureFormat::BC1_SRGB_ALPHA:
+                return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+            case TextureFormat::BC3_RGBA:
+                return VK_FORMAT_BC3_UNORM_BLOCK;
+            case TextureFormat::BC3_SRGB_ALPHA:
+                return VK_FORMAT_BC3_SRGB_BLOCK;
+            default:
+                return VK_FORMAT_UNDEFINED;
+        }
+    }
+
+    /// Buffers are never written in place, SetData creates a new buffer and the old one is destroyed once the draws
+    /// recorded with it are done, like orphaning a buffer with glBufferData
+    inline void ReleaseVulkanBuffer(detail::VulkanRendererAPI& api, VulkanBuffer& buffer)
+    {
+        if (buffer.Buffer == VK_NULL_HANDLE) {
+            return;
+        }
+        api.Release([&device = api.Device(), buffer]() { device.DestroyBuffer(buffer); });
+        buffer = {};
+    }
+
+    class VulkanVertexBuffer : public IVertexBuffer
+    {
+      public:
+        VulkanVertexBuffer(const VulkanVertexBuffer& other) = delete;
+        VulkanVertexBuffer(VulkanVertexBuffer&& other) = delete;
+        auto operator=(const VulkanVertexBuffer& other) -> VulkanVertexBuffer& = delete;
+        auto operator=(VulkanVertexBuffer&& other) -> VulkanVertexBuffer& = delete;
+
+        VulkanVertexBuffer(AttributeLayout layout, detail::VulkanRendererAPI& api)
+            : IVertexBuffer(std::move(layout))
+            , m_API(api)
+        {
+        }
+        ~VulkanVertexBuffer() override { ReleaseVulkanBuffer(m_API, m_Buffer); }
+
+        inline auto Bind() -> bool override { return true; }
+        inline auto Unbind() -> bool override { return true; }
+
+        inline auto SetData(std::span<const std::byte> data) -> bool override
+        {
+            if (!m_Resource.Allocate(data.size())) {
+                return false;
+            }
+            ReleaseVulkanBuffer(m_API, m_Buffer);
+            m_Storage.clear();
+            if (data.empty()) {
+                return true;
+            }
+
+            auto buffer = m_API.CreateBuffer(data, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+            if (!buffer) {
+                m_Resource.Allocate(0);
+                return false;
+            }
+            m_Buffer = *buffer;
+            m_Resource.Uploaded(data.size());
+            return true;
+        }
+
+        // Buffers aren't written in place, partial updates change a copy of the storage and recreate the buffer
+        inline auto AllocateStorage(std::size_t size) -> bool override
+        {
+            if (!m_Resource.Allocate(size)) {
+                return false;
+            }
+            m_Storage.assign(size, std::byte{0});
+            return RecreateFromStorage();
+        }
+
+        inline auto SetSubData(std::size_t offset, std::span<const std::byte> data) -> bool override
+        {
+            if (offset + data.size() > m_Storage.size()) {
+                return false;
+            }
+            std::ranges::copy(data, m_Storage.begin() + static_cast<std::ptrdiff_t>(offset));
+            return RecreateFromStorage();
+        }
+
+        /// The source has to be allocated with AllocateStorage, SetData doesn't keep a copy
+        inline auto CopySubData(const IVertexBuffer& source,
+                                std::size_t source_offset,
+                                std::size_t offset,
+                                std::size_t size) -> bool override
+        {
+            const auto& source_storage = static_cast<const VulkanVertexBuffer&>(source).m_Storage;
+            if (source_offset + size > source_storage.size() || offset + size > m_Storage.size()) {
+                return false;
+            }
+            std::copy_n(source_storage.begin() + static_cast<std::ptrdiff_t>(source_offset),
+                        size,
+                        m_Storage.begin() + static_cast<std::ptrdiff_t>(offset));
+            return RecreateFromStorage();
+        }
+
+        inline auto Handle() const -> VkBuffer { return m_Buffer.Buffer; }
+
+      private:
+        // The vertex input state of the pipelines is created from the layout
+        inline auto UploadLayout([[maybe_unused]] std::uint32_t first_location) -> bool override { return true; }
+
+        inline auto RecreateFromStorage() -> bool
+        {
+            ReleaseVulkanBuffer(m_API, m_Buffer);
+            if (m_Storage.empty()) {
+                return true;
+            }
+
+            auto buffer = m_API.CreateBuffer(m_Storage, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+            if (!buffer) {
+                return false;
+            }
+            m_Buffer = *buffer;
+            m_Resource.Uploaded(m_Storage.size());
+            return true;
+        }
+
+        detail::VulkanRendererAPI& m_API;
+        VulkanBuffer m_Buffer;
+        Vector<std::byte> m_Storage;
+    };
+
+    class VulkanElementBuffer : public IElementBuffer
+    {
+      public:
+        VulkanElementBuffer(const VulkanElementBuffer& other) = delete;
+        VulkanElementBuffer(VulkanElementBuffer&& other) = delete;
+        auto operator=(const VulkanElementBuffer& other) -> VulkanElementBuffer& = delete;
+        auto operator=(VulkanElementBuffer&& other) -> VulkanElementBuffer& = delete;
+
+        explicit VulkanElementBuffer(detail::VulkanRendererAPI& api)
+            : m_API(api)
+        {
+        }
+        ~VulkanElementBuffer() override { ReleaseVulkanBuffer(m_API, m_Buffer); }
+
+        inline auto Bind() -> bool override { return true; }
+        inline auto Unbind() -> bool override { return true; }
+
+        inline auto SetData(std::span<const std::byte> data) -> bool override
+        {
+            if (!m_Resource.Allocate(data.size())) {
+                return false;
+            }
+            ReleaseVulkanBuffer(m_API, m_Buffer);
+            m_Storage.clear();
+            if (data.empty()) {
+                return true;
+            }
+
+            auto buffer = m_API.CreateBuffer(data, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+            if (!buffer) {
+                m_Resource.Allocate(0);
+                return false;
+            }
+            m_Buffer = *buffer;
+            m_Resource.Uploaded(data.size());
+            return true;
+        }
+
+        // Buffers aren't written in place, partial updates change a copy of the storage and recreate the buffer
+        inline auto AllocateStorage(std::size_t size) -> bool override
+        {
+            if (!m_Resource.Allocate(size)) {
+                return false;
+            }
+            m_Storage.assign(size, std::byte{0});
+            return RecreateFromStorage();
+        }
+
+        inline auto SetSubData(std::size_t offset, std::span<const std::byte> data) -> bool override
+        {
+            if (offset + data.size() > m_Storage.size()) {
+                return false;
+            }
+            std::ranges::copy(data, m_Storage.begin() + static_cast<std::ptrdiff_t>(offset));
+            return RecreateFromStorage();
+        }
+
+        /// The source has to be allocated with AllocateStorage, SetData doesn't keep a copy
+        inline auto CopySubData(const IElementBuffer& source,
+                                std::size_t source_offset,
+                                std::size_t offset,
+                                std::size_t size) -> bool override
+        {
+            const auto& source_storage = static_cast<const VulkanElementBuffer&>(source).m_Storage;
+            if (source_offset + size > source_storage.size() || offset + size > m_Storage.size()) {
+                return false;
+            }
+            std::copy_n(source_storage.begin() + static_cast<std::ptrdiff_t>(source_offset),
+                        size,
+                        m_Storage.begin() + static_cast<std::ptrdiff_t>(offset));
+            return RecreateFromStorage();
+        }
+
+        inline auto Handle() const -> VkBuffer { return m_Buffer.Buffer; }
+        inline auto Size() const -> VkDeviceSize { return m_Buffer.Size; }
+
+      private:
+        inline auto RecreateFromStorage() -> bool
+        {
+            ReleaseVulkanBuffer(m_API, m_Buffer);
+            if (m_Storage.empty()) {
+                return true;
+            }
+
+            auto buffer = m_API.CreateBuffer(m_Storage, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+            if (!buffer) {
+                return false;
+            }
+            m_Buffer = *buffer;
+            m_Resource.Uploaded(m_Storage.size());
+            return true;
+        }
+
+        detail::VulkanRendererAPI& m_API;
+        VulkanBuffer m_Buffer;
+        Vector<std::byte> m_Storage;
+    };
+
+    class VulkanVertexArray : public IVertexArray
+    {
+      public:
+        VulkanVertexArray(const VulkanVertexArray& other) = delete;
+        VulkanVertexArray(VulkanVertexArray&& other) = delete;
+        auto operator=(const VulkanVertexArray& other) -> VulkanVertexArray& = delete;
+        auto operator=(VulkanVertexArray&& other) -> VulkanVertexArray& = delete;
+
+        explicit VulkanVertexArray(detail::VulkanRendererAPI& api)
+            : m_API(api)
+        {
+        }
+        ~VulkanVertexArray() override { m_API.BindVertexArray(nullptr); }
+
+        /// Pipelines are cached per layout signature, vertex arrays with the same layout share them
+        inline auto Build() -> bool override
+        {
+            m_LayoutSignature.clear();
+            for (const auto& buffer : m_VertexBuffers) {
+                const auto& layout = buffer->Layout();
+                m_LayoutSignature.push_back(static_cast<std::uint32_t>(layout.Stride()));
+                m_LayoutSignature.push_back(static_cast<std::uint32_t>(layout.Count()));
+                for (const auto& attribute : layout) {
+                    m_LayoutSignature.push_back(static_cast<std::uint32_t>(attribute.ComponentCount));
+                    m_LayoutSignature.push_back(static_cast<std::uint32_t>(attribute.Offset));
+                }
+            }
+            return m_IndexBuffer != nullptr;
+        }
+
+        inline auto Bind() -> bool override
+        {
+            m_API.BindVertexArray(this);
+            return true;
+        }
+
+        inline auto Unbind() -> bool override
+        {
+            m_API.BindVertexArray(nullptr);
+            return true;
+        }
+
+        inline auto LayoutSignature() const -> const Vector<std::uint32_t>& { return m_LayoutSignature; }
+        inline auto VertexBuffer(std::size_t index) const -> const VulkanVertexBuffer&
+        {
+            return static_cast<const VulkanVertexBuffer&>(*m_VertexBuffers[index]);
+        }
+        inline auto Indices() const -> const VulkanElementBuffer*
+        {
+            return static_cast<const VulkanElementBuffer*>(m_IndexBuffer.get());
+        }
+
+      private:
+        detail::VulkanRendererAPI& m_API;
+        Vector<std::uint32_t> m_LayoutSignature;
+    };
+
+    class VulkanShaderProgram : public IShaderProgram
+    {
+      public:
+        VulkanShaderProgram(const VulkanShaderProgram& other) = delete;
+        VulkanShaderProgram(VulkanShaderProgram&& other) = delete;
+        auto operator=(const VulkanShaderProgram& other) -> VulkanShaderProgram& = delete;
+        auto operator=(VulkanShaderProgram&& other) -> VulkanShaderProgram& = delete;
+
+        /// The GLSL sources are compiled to SPIR-V, pipelines are created when the program is first drawn with
+        VulkanShaderProgram(std::string_view debug_name,
+                            std::string_view vertex_source,
+                            std::string_view fragment_source,
+                            detail::VulkanRendererAPI& api)
+            : IShaderProgram(debug_name)
+            , m_API(api)
+        {
+            m_ProgramID = m_API.CompileProgram(debug_name, vertex_source, fragment_source);
+            m_Valid = m_ProgramID != 0;
+        }
+        ~VulkanShaderProgram() override { m_API.DestroyProgram(m_ProgramID); }
+
+        inline auto Bind() -> bool override
+        {
+            m_API.BindProgram(m_ProgramID);
+            return m_Valid;
+        }
+
+        inline auto Unbind() -> bool override
+        {
+            m_API.BindProgram(0);
+            return true;
+        }
+
+      private:
+        detail::VulkanRendererAPI& m_API;
+    };
+
+    class VulkanTexture2D : public ITexture2D
+    {
+      public:
+        VulkanTexture2D(const VulkanTexture2D& other) = delete;
+        VulkanTexture2D(VulkanTexture2D&& other) = delete;
+        auto operator=(const VulkanTexture2D& other) -> VulkanTexture2D& = delete;
+        auto operator=(VulkanTexture2D&& other) -> VulkanTexture2D& = delete;
+
+        /// Single level uncompressed textures can be framebuffer attachments
+        VulkanTexture2D(const TextureDescription& description, detail::VulkanRendererAPI& api)
+            : ITexture2D(description)
+            , m_API(api)
+        {
+            VkImageUsageFlags usage =
+                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+            if (!IsCompressedFormat(Format()) && MipLevels() == 1) {
+                usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            }
+
+            if (!m_Resource.Allocate(ByteSize())) {
+                return;
+            }
+
+            auto image = m_API.CreateImage(Size(), TextureFormatToVkFormat(Format()), MipLevels(), usage);
+            if (!image) {
+                EngineLogger()->error("Failed to create a {}x{} Vulkan texture", Size().X, Size().Y);
+                m_Resource.Allocate(0);
+                return;
+            }
+            m_Image = *image;
+            m_VkSampler = m_API.Sampler(m_Sampler, MipLevels());
+        }
+        ~VulkanTexture2D() override
+        {
+            m_API.UnbindTexture(this);
+            if (m_Image.Image != VK_NULL_HANDLE) {
+                m_API.Release([&device = m_API.Device(), image = m_Image]() { device.DestroyImage(image); });
+            }
+        }
+
+        inline auto Bind(std::uint32_t slot) -> bool override
+        {
+            if (slot >= detail::VulkanRendererAPI::MAX_TEXTURE_SLOTS || m_Image.Image == VK_NULL_HANDLE) {
+                return false;
+            }
+            m_API.BindTexture(slot, this);
+            return true;
+        }
+
+        inline auto Unbind(std::uint32_t slot) -> bool override
+        {
+            if (slot >= detail::VulkanRendererAPI::MAX_TEXTURE_SLOTS) {
+                return false;
+            }
+            m_API.BindTexture(slot, nullptr);
+            return true;
+        }
+
+        inline auto SetSampler(const SamplerState& sampler) -> bool override
+        {
+            m_Sampler = sampler;
+            m_VkSampler = m_API.Sampler(m_Sampler, MipLevels());
+            return m_VkSampler != VK_NULL_HANDLE;
+        }
+
+        inline auto SetData(std::uint32_t level, std::span<const std::byte> data) -> bool override
+        {
+            return SetRows(level, 0, data);
+        }
+
+        inline auto SetRows(std::uint32_t level, std::uint32_t first_row, std::span<const std::byte> data)
+            -> bool override
+        {
+            if (level >= MipLevels() || data.size() % LevelRowBytes(level) != 0) {
+                return false;
+            }
+
+            auto staging = m_API.AllocateStaging(data.size());
+            if (!staging) {
+                return false;
+            }
+            std::memcpy(staging->Memory.data(), data.data(), data.size());
+            return CopyRows(*staging, level, first_row, static_cast<std::uint32_t>(data.size() / LevelRowBytes(level)));
+        }
+
+        inline auto GenerateMipmaps() -> bool override { return m_API.GenerateMipmaps(*this); }
+
+        /// Copies tightly packed rows of blocks from the staging memory
+        inline auto CopyRows(const detail::VulkanStaging& staging,
+                             std::uint32_t level,
+                             std::uint32_t first_row,
+                             std::uint32_t row_count) -> bool
+        {
+            if (m_Image.Image == VK_NULL_HANDLE || first_row + row_count > LevelRowCount(level)) {
+                return false;
+            }
+
+            // Copies have to start at a multiple of the block size, the uploader packs regions of any row size
+            const auto INFO = GetTextureFormatInfo(Format());
+            const VkDeviceSize ALIGNMENT = std::max<VkDeviceSize>(INFO.BlockBytes, 4);
+            if (staging.Offset % ALIGNMENT != 0) {
+                auto aligned = m_API.AllocateStaging(staging.Memory.size());
+                if (!aligned) {
+                    return false;
+                }
+                std::memcpy(aligned->Memory.data(), staging.Memory.data(), staging.Memory.size());
+                return CopyRows(*aligned, level, first_row, row_count);
+            }
+
+            const auto LEVEL_SIZE = LevelSize(level);
+            const auto FIRST_Y = static_cast<std::int32_t>(first_row * INFO.BlockHeight);
+            const auto HEIGHT =
+                std::min(static_cast<std::int32_t>(row_count * INFO.BlockHeight), LEVEL_SIZE.Y - FIRST_Y);
+            if (!m_API.CopyToImage(staging, *this, level, {0, FIRST_Y}, {LEVEL_SIZE.X, HEIGHT})) {
+                return false;
+            }
+            m_Resource.Uploaded(row_count * LevelRowBytes(level));
+            return true;
+        }
+
+        inline auto Image() const -> const VulkanImage& { return m_Image; }
+        inline auto VkSamplerHandle() const -> VkSampler { return m_VkSampler; }
+
+        /// Submission that last drew with or into the texture
+        inline auto LastUse() const -> std::uint64_t { return m_LastUse; }
+        inline void MarkUsed(std::uint64_t submission) { m_LastUse = submission; }
+
+      private:
+        detail::VulkanRendererAPI& m_API;
+        VulkanImage m_Image;
+        VkSampler m_VkSampler = VK_NULL_HANDLE;
+        std::uint64_t m_LastUse = 0;
+    };
+
+    class VulkanTextureUploader : public ITextureUploader
+    {
+      public:
+        VulkanTextureUploader(const VulkanTextureUploader& other) = delete;
+        VulkanTextureUploader(VulkanTextureUploader&& other) = delete;
+        auto operator=(const VulkanTextureUploader& other) -> VulkanTextureUploader& = delete;
+        auto operator=(VulkanTextureUploader&& other) -> VulkanTextureUploader& = delete;
+
+        VulkanTextureUploader(std::size_t frame_budget, detail::VulkanRendererAPI& api)
+            : ITextureUploader(frame_budget)
+            , m_API(api)
+        {
+        }
+        ~VulkanTextureUploader() override = default;
+
+      private:
+        /// Pixels are written straight into the staging memory the copies read from
+        inline auto MapStaging(std::size_t size) -> std::span<std::byte> override
+        {
+            auto staging = m_API.AllocateStaging(size);
+            if (!staging) {
+                return {};
+            }
+            m_Staging = *staging;
+            return m_Staging.Memory;
+        }
+
+        inline auto SubmitStaging(std::span<const StagedRegion> regions) -> bool override
+        {
+            bool success = true;
+            for (const auto& region : regions) {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+                auto& texture = static_cast<VulkanTexture2D&>(*region.Texture);
+                const detail::VulkanStaging STAGING{m_Staging.Buffer,
+                                            m_Staging.Offset + region.StagingOffset,
+                                            m_Staging.Memory.subspan(region.StagingOffset, region.ByteSize)};
+                success = texture.CopyRows(STAGING, region.Level, region.FirstRow, region.RowCount) && success;
+            }
+            m_Staging = {};
+            return success;
+        }
+
+        detail::VulkanRendererAPI& m_API;
+        detail::VulkanStaging m_Staging;
+    };
+
+    class VulkanFramebuffer : public IFramebuffer
+    {
+      public:
+        VulkanFramebuffer(const VulkanFramebuffer& other) = delete;
+        VulkanFramebuffer(VulkanFramebuffer&& other) = delete;
+        auto operator=(const VulkanFramebuffer& other) -> VulkanFramebuffer& = delete;
+        auto operator=(VulkanFramebuffer&& other) -> VulkanFramebuffer& = delete;
+
+        VulkanFramebuffer(const FramebufferDescription& description, detail::VulkanRendererAPI& api)
+            : IFramebuffer(description)
+            , m_API(api)
+        {
+            Vector<VulkanTexture2D*> attachments;
+            for (const auto& attachment : m_ColorAttachments) {
+                // Attachments are created by the global RendererAPI, which doesn't have to be this one
+                auto* texture = dynamic_cast<VulkanTexture2D*>(attachment.get());
+                if (texture == nullptr || texture->Image().Image == VK_NULL_HANDLE) {
+                    EngineLogger()->error("Vulkan framebuffer attachments have to be Vulkan textures");
+                    return;
+                }
+                attachments.push_back(texture);
+            }
+
+            if (description.DepthStencil) {
+                // Accounted like the OpenGL backend's GL_DEPTH24_STENCIL8, the device may pick a wider format
+                constexpr std::size_t DEPTH_STENCIL_PIXEL_BYTES = 4;
+                const auto PIXEL_COUNT = static_cast<std::size_t>(Size().X) * static_cast<std::size_t>(Size().Y);
+                if (!m_Resource.Allocate(DEPTH_STENCIL_PIXEL_BYTES * PIXEL_COUNT)) {
+                    return;
+                }
+
+                auto depth = m_API.CreateImage(
+                    Size(), m_API.Device().DepthFormat(), 1, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+                if (!depth) {
+                    m_Resource.Allocate(0);
+                    return;
+                }
+                m_Depth = *depth;
+            }
+            m_FramebufferID =
+                m_API.RegisterFramebuffer(std::move(attachments), description.DepthStencil ? &m_Depth : nullptr);
+        }
+        ~VulkanFramebuffer() override
+        {
+            m_API.UnregisterFramebuffer(m_FramebufferID);
+            if (m_Depth.Image != VK_NULL_HANDLE) {
+                m_API.Release([&device = m_API.Device(), image = m_Depth]() { device.DestroyImage(image); });
+            }
+        }
+
+        inline void Bind() override { m_API.BindFramebuffer(m_FramebufferID); }
+        inline void Unbind() override { m_API.BindFramebuffer(0); }
+
+      private:
+        detail::VulkanRendererAPI& m_API;
+        VulkanImage m_Depth;
+    };
+
+}  // namespace JE
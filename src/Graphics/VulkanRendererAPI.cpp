@@ -0,0 +1,1483 @@
+#include "VulkanRendererAPI.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <regex>
+#include <string>
+
+#include <SPIRV/GlslangToSpv.h>
+#include <glslang/Public/ResourceLimits.h>
+#include <glslang/Public/ShaderLang.h>
+
+#include "Graphics/Renderer.hpp"
+#include "Graphics/VulkanRenderer.hpp"
+#include "Logger.hpp"
+#include "Types.hpp"
+
+namespace JE::detail
+{
+
+    namespace
+    {
+
+        constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+        constexpr int GLSLANG_DEFAULT_VERSION = 100;
+        constexpr std::array<std::byte, 4> WHITE_PIXEL{
+            std::byte{0xFF}, std::byte{0xFF}, std::byte{0xFF}, std::byte{0xFF}};
+
+        using SPIRV = Vector<std::uint32_t>;
+
+        /// Vulkan clips depth to [0, 1] instead of OpenGL's [-1, 1], the vertex main is wrapped so both backends
+        /// share the GLSL sources
+        auto RemapDepth(std::string_view vertex_source) -> std::string
+        {
+            static const std::regex MAIN{R"(\bvoid\s+main\s*\()"};
+
+            auto source = std::regex_replace(std::string{vertex_source}, MAIN, "void je_Main(");
+            source += "\nvoid main()\n{\n    je_Main();\n"
+                      "    gl_Position.z = (gl_Position.z + gl_Position.w) * 0.5;\n}\n";
+            return source;
+        }
+
+        /// Locations and bindings the sources don't declare are assigned in order, sampler N samples slot N
+        auto CompileSPIRV(std::string_view debug_name,
+                          const std::string& vertex_source,
+                          std::string_view fragment_source) -> std::optional<std::array<SPIRV, 2>>
+        {
+            static const bool INITIALIZED = glslang::InitializeProcess();
+            if (!INITIALIZED) {
+                return std::nullopt;
+            }
+
+            const auto MESSAGES = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+            const std::string FRAGMENT_SOURCE{fragment_source};
+            glslang::TShader vertex{EShLangVertex};
+            glslang::TShader fragment{EShLangFragment};
+            glslang::TProgram program;
+
+            for (auto [shader, source] : {std::pair{&vertex, &vertex_source}, std::pair{&fragment, &FRAGMENT_SOURCE}}) {
+                const char* text = source->c_str();
+                const auto STAGE = shader == &vertex ? EShLangVertex : EShLangFragment;
+                shader->setStrings(&text, 1);
+                shader->setEnvInput(glslang::EShSourceGlsl, STAGE, glslang::EShClientVulkan, GLSLANG_DEFAULT_VERSION);
+                shader->setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_1);
+                shader->setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_3);
+                shader->setAutoMapLocations(true);
+                shader->setAutoMapBindings(true);
+                if (!shader->parse(GetDefaultResources(), GLSLANG_DEFAULT_VERSION, false, MESSAGES)) {
+                    EngineLogger()->error("Failed to compile {} for Vulkan - {}", debug_name, shader->getInfoLog());
+                    return std::nullopt;
+                }
+                program.addShader(shader);
+            }
+
+            if (!program.link(MESSAGES) || !program.mapIO()) {
+                EngineLogger()->error("Failed to link {} for Vulkan - {}", debug_name, program.getInfoLog());
+                return std::nullopt;
+            }
+
+            std::array<SPIRV, 2> spirv;
+            glslang::GlslangToSpv(*program.getIntermediate(EShLangVertex), spirv[0]);
+            glslang::GlslangToSpv(*program.getIntermediate(EShLangFragment), spirv[1]);
+            return spirv;
+        }
+
+        constexpr auto IsDepthFormat(VkFormat format) -> bool
+        {
+            return format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_D32_SFLOAT
+                   || format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT
+                   || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+        }
+
+        constexpr auto HasStencil(VkFormat format) -> bool
+        {
+            return IsDepthFormat(format) && format != VK_FORMAT_D16_UNORM && format != VK_FORMAT_D32_SFLOAT;
+        }
+
+        /// Color images stay readable by shaders between passes, depth images stay attachments
+        constexpr auto ResidentLayout(const VulkanImage& image) -> VkImageLayout
+        {
+            return (image.Aspect & VK_IMAGE_ASPECT_COLOR_BIT) != 0u ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                                                                     : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        }
+
+        constexpr auto AttributeFormat(std::size_t component_count) -> VkFormat
+        {
+            switch (component_count) {
+                case 1:
+                    return VK_FORMAT_R32_SFLOAT;
+                case 2:
+                    return VK_FORMAT_R32G32_SFLOAT;
+                case 3:
+                    return VK_FORMAT_R32G32B32_SFLOAT;
+                default:
+                    return VK_FORMAT_R32G32B32A32_SFLOAT;
+            }
+        }
+
+        constexpr auto ToVkFilter(TextureFilter filter) -> VkFilter
+        {
+            return filter == TextureFilter::NEAREST ? VK_FILTER_NEAREST : VK_FILTER_LINEAR;
+        }
+
+        constexpr auto ToVkAddressMode(TextureWrap wrap) -> VkSamplerAddressMode
+        {
+            switch (wrap) {
+                case TextureWrap::MIRRORED_REPEAT:
+                    return VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT;
+                case TextureWrap::CLAMP_TO_EDGE:
+                    return VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+                default:
+                    return VK_SAMPLER_ADDRESS_MODE_REPEAT;
+            }
+        }
+
+        constexpr auto ToVkBlendFactor(BlendFactor factor) -> VkBlendFactor
+        {
+            switch (factor) {
+                case BlendFactor::ZERO:
+                    return VK_BLEND_FACTOR_ZERO;
+                case BlendFactor::SOURCE_ALPHA:
+                    return VK_BLEND_FACTOR_SRC_ALPHA;
+                case BlendFactor::ONE_MINUS_SOURCE_ALPHA:
+                    return VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+                case BlendFactor::DESTINATION_ALPHA:
+                    return VK_BLEND_FACTOR_DST_ALPHA;
+                case BlendFactor::ONE_MINUS_DESTINATION_ALPHA:
+                    return VK_BLEND_FACTOR_ONE_MINUS_DST_ALPHA;
+                default:
+                    return VK_BLEND_FACTOR_ONE;
+            }
+        }
+
+        constexpr auto ToVkCompareOp(CompareFunction function) -> VkCompareOp
+        {
+            switch (function) {
+                case CompareFunction::NEVER:
+                    return VK_COMPARE_OP_NEVER;
+                case CompareFunction::LESS:
+                    return VK_COMPARE_OP_LESS;
+                case CompareFunction::LESS_EQUAL:
+                    return VK_COMPARE_OP_LESS_OR_EQUAL;
+                case CompareFunction::EQUAL:
+                    return VK_COMPARE_OP_EQUAL;
+                case CompareFunction::NOT_EQUAL:
+                    return VK_COMPARE_OP_NOT_EQUAL;
+                case CompareFunction::GREATER_EQUAL:
+                    return VK_COMPARE_OP_GREATER_OR_EQUAL;
+                case CompareFunction::GREATER:
+                    return VK_COMPARE_OP_GREATER;
+                default:
+                    return VK_COMPARE_OP_ALWAYS;
+            }
+        }
+
+        constexpr auto ToVkCullMode(CullMode mode) -> VkCullModeFlags
+        {
+            switch (mode) {
+                case CullMode::FRONT:
+                    return VK_CULL_MODE_FRONT_BIT;
+                case CullMode::BACK:
+                    return VK_CULL_MODE_BACK_BIT;
+                default:
+                    return VK_CULL_MODE_NONE;
+            }
+        }
+
+        // Barriers cover all stages, uploads and layout changes happen a few times per frame at most
+        void TransitionImage(VkCommandBuffer commands,
+                             const VulkanImage& image,
+                             VkImageLayout old_layout,
+                             VkImageLayout new_layout,
+                             std::uint32_t first_level,
+                             std::uint32_t level_count)
+        {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            barrier.oldLayout = old_layout;
+            barrier.newLayout = new_layout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image.Image;
+            barrier.subresourceRange = {image.Aspect, first_level, level_count, 0, 1};
+            vkCmdPipelineBarrier(commands,
+                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 0,
+                                 0,
+                                 nullptr,
+                                 0,
+                                 nullptr,
+                                 1,
+                                 &barrier);
+        }
+
+        void GlobalBarrier(VkCommandBuffer commands, VkPipelineStageFlags destination_stage, VkAccessFlags destination)
+        {
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+            barrier.dstAccessMask = destination;
+            vkCmdPipelineBarrier(commands,
+                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 destination_stage,
+                                 0,
+                                 1,
+                                 &barrier,
+                                 0,
+                                 nullptr,
+                                 0,
+                                 nullptr);
+        }
+
+    }  // namespace
+
+    VulkanRendererAPI::VulkanRendererAPI(const Size2D& default_framebuffer_size,
+                                         std::span<const std::byte> pipeline_cache_data)
+    {
+        m_DefaultColor.Size = default_framebuffer_size;
+        if (!m_Device.Initialized()) {
+            return;
+        }
+
+        VkPipelineCacheCreateInfo cache_info{};
+        cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        cache_info.initialDataSize = pipeline_cache_data.size();
+        cache_info.pInitialData = pipeline_cache_data.data();
+        if (!VulkanSucceeded(vkCreatePipelineCache(m_Device.Handle(), &cache_info, nullptr, &m_PipelineCache),
+                             "vkCreatePipelineCache")) {
+            return;
+        }
+
+        m_Initialized = CreateDefaultResources(default_framebuffer_size) && SubmitPending();
+    }
+
+    VulkanRendererAPI::~VulkanRendererAPI()
+    {
+        if (!m_Device.Initialized()) {
+            return;
+        }
+
+        auto* device = m_Device.Handle();
+        SubmitPending();
+        m_Device.WaitIdle();
+        RetireSubmissions(true);
+        Retire(m_Recording);
+
+        for (const auto& [ID, FENCE] : m_Fences) {
+            vkDestroyFence(device, FENCE, nullptr);
+        }
+        for (const auto& [ID, TARGET] : m_RenderTargets) {
+            vkDestroyFramebuffer(device, TARGET.Framebuffer, nullptr);
+        }
+        for (const auto& [KEY, PIPELINE] : m_Pipelines) {
+            vkDestroyPipeline(device, PIPELINE, nullptr);
+        }
+        for (const auto& [KEY, RENDER_PASS] : m_RenderPasses) {
+            vkDestroyRenderPass(device, RENDER_PASS, nullptr);
+        }
+        for (const auto& [KEY, SAMPLER] : m_Samplers) {
+            vkDestroySampler(device, SAMPLER, nullptr);
+        }
+        for (const auto& [ID, PROGRAM] : m_Programs) {
+            vkDestroyShaderModule(device, PROGRAM.Vertex, nullptr);
+            vkDestroyShaderModule(device, PROGRAM.Fragment, nullptr);
+        }
+        for (const auto& buffer : m_FreeStaging) {
+            m_Device.DestroyBuffer(buffer);
+        }
+        for (const auto POOL : m_FreeDescriptorPools) {
+            vkDestroyDescriptorPool(device, POOL, nullptr);
+        }
+
+        m_Device.DestroyImage(m_DefaultColor);
+        m_Device.DestroyImage(m_DefaultDepth);
+        m_Device.DestroyImage(m_WhiteTexture);
+        vkDestroyPipelineLayout(device, m_PipelineLayout, nullptr);
+        vkDestroyDescriptorSetLayout(device, m_DescriptorSetLayout, nullptr);
+        vkDestroyPipelineCache(device, m_PipelineCache, nullptr);
+    }
+
+    auto VulkanRendererAPI::CreateDefaultResources(const Size2D& default_framebuffer_size) -> bool
+    {
+        auto* device = m_Device.Handle();
+
+        std::array<VkDescriptorSetLayoutBinding, MAX_TEXTURE_SLOTS> bindings{};
+        for (std::uint32_t slot = 0; slot < MAX_TEXTURE_SLOTS; ++slot) {
+            bindings[slot].binding = slot;
+            bindings[slot].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            bindings[slot].descriptorCount = 1;
+            bindings[slot].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo set_layout_info{};
+        set_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        set_layout_info.bindingCount = MAX_TEXTURE_SLOTS;
+        set_layout_info.pBindings = bindings.data();
+        if (!VulkanSucceeded(vkCreateDescriptorSetLayout(device, &set_layout_info, nullptr, &m_DescriptorSetLayout),
+                             "vkCreateDescriptorSetLayout")) {
+            return false;
+        }
+
+        VkPipelineLayoutCreateInfo pipeline_layout_info{};
+        pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_info.setLayoutCount = 1;
+        pipeline_layout_info.pSetLayouts = &m_DescriptorSetLayout;
+        if (!VulkanSucceeded(vkCreatePipelineLayout(device, &pipeline_layout_info, nullptr, &m_PipelineLayout),
+                             "vkCreatePipelineLayout")) {
+            return false;
+        }
+
+        auto color = CreateImage(default_framebuffer_size,
+                                 VK_FORMAT_R8G8B8A8_UNORM,
+                                 1,
+                                 VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
+                                     | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+        auto depth = CreateImage(
+            default_framebuffer_size, m_Device.DepthFormat(), 1, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+        auto white = CreateImage({1, 1}, VK_FORMAT_R8G8B8A8_UNORM, 1, VK_IMAGE_USAGE_SAMPLED_BIT);
+        auto staging = AllocateStaging(WHITE_PIXEL.size());
+        if (!color || !depth || !white || !staging) {
+            return false;
+        }
+        m_DefaultColor = *color;
+        m_DefaultDepth = *depth;
+        m_WhiteTexture = *white;
+
+        // Unbound slots sample white like the software backend's default shader
+        std::ranges::copy(WHITE_PIXEL, staging->Memory.begin());
+        auto* commands = UploadCommands();
+        TransitionImage(commands,
+                        m_WhiteTexture,
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        0,
+                        1);
+        VkBufferImageCopy region{};
+        region.bufferOffset = staging->Offset;
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageExtent = {1, 1, 1};
+        vkCmdCopyBufferToImage(
+            commands, staging->Buffer, m_WhiteTexture.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+        TransitionImage(commands,
+                        m_WhiteTexture,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        0,
+                        1);
+        m_DefaultSampler = Sampler({}, 1);
+
+        auto target =
+            CreateRenderTarget({m_DefaultColor.View}, {m_DefaultColor.Format}, &m_DefaultDepth, m_DefaultColor.Size);
+        if (!target || m_DefaultSampler == VK_NULL_HANDLE) {
+            return false;
+        }
+        m_RenderTargets.emplace(0, std::move(*target));
+        return true;
+    }
+
+    auto VulkanRendererAPI::Name() const -> std::string_view { return "Vulkan"; }
+
+    auto VulkanRendererAPI::SetClearColor(const RGBA& color) -> bool
+    {
+        m_ClearColor.float32[0] = color.R();
+        m_ClearColor.float32[1] = color.G();
+        m_ClearColor.float32[2] = color.B();
+        m_ClearColor.float32[3] = color.A();
+        return true;
+    }
+
+    auto VulkanRendererAPI::ClearFramebuffer(AttachmentFlags flags) -> bool
+    {
+        if (!m_Initialized || !BeginRenderPass()) {
+            return false;
+        }
+
+        // Clears are recorded inside the render pass, so clearing and drawing doesn't need a second pass
+        const auto& target = m_RenderTargets.at(m_BoundFramebuffer);
+        Vector<VkClearAttachment> clears;
+        if ((flags & AttachmentFlag::COLOR) != 0u) {
+            for (std::uint32_t attachment = 0; attachment < target.ColorCount; ++attachment) {
+                VkClearAttachment clear{};
+                clear.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                clear.colorAttachment = attachment;
+                clear.clearValue.color = m_ClearColor;
+                clears.push_back(clear);
+            }
+        }
+
+        VkImageAspectFlags depth_aspects = 0;
+        if (target.HasDepth && (flags & AttachmentFlag::DEPTH) != 0u) {
+            depth_aspects |= VK_IMAGE_ASPECT_DEPTH_BIT;
+        }
+        if (target.HasDepth && (flags & AttachmentFlag::STENCIL) != 0u && HasStencil(m_Device.DepthFormat())) {
+            depth_aspects |= VK_IMAGE_ASPECT_STENCIL_BIT;
+        }
+        if (depth_aspects != 0) {
+            VkClearAttachment clear{};
+            clear.aspectMask = depth_aspects;
+            clear.clearValue.depthStencil = {1.0f, 0};
+            clears.push_back(clear);
+        }
+        if (clears.empty()) {
+            return true;
+        }
+
+        const VkClearRect RECT{
+            {{0, 0}, {static_cast<std::uint32_t>(target.Size.X), static_cast<std::uint32_t>(target.Size.Y)}}, 0, 1};
+        vkCmdClearAttachments(m_FrameCommands, static_cast<std::uint32_t>(clears.size()), clears.data(), 1, &RECT);
+        return true;
+    }
+
+    auto VulkanRendererAPI::BindFramebuffer(FramebufferID buffer_id) -> bool
+    {
+        if (!m_RenderTargets.contains(buffer_id)) {
+            EngineLogger()->error("Vulkan framebuffer {} doesn't exist", buffer_id);
+            return false;
+        }
+        if (buffer_id != m_BoundFramebuffer) {
+            EndRenderPass();
+            m_BoundFramebuffer = buffer_id;
+        }
+        return true;
+    }
+
+    auto VulkanRendererAPI::SetRenderState(const RenderState& state) -> bool
+    {
+        m_RenderState = state;
+        return true;
+    }
+
+    auto VulkanRendererAPI::DrawIndexed(Primitive primitive_type,
+                                        std::uint32_t index_count,
+                                        Type index_type,
+                                        std::uint32_t first_index,
+                                        std::int32_t base_vertex) -> bool
+    {
+        if (!m_Initialized || m_BoundVertexArray == nullptr || primitive_type != Primitive::TRIANGLES
+            || index_type == Type::FLOAT) {
+            return false;
+        }
+
+        const auto* indices = m_BoundVertexArray->Indices();
+        if (indices == nullptr
+            || (std::size_t{first_index} + index_count) * TypeByteCount(index_type) > indices->Size()) {
+            EngineLogger()->error("Vulkan draw of {} indices reads past the element buffer", index_count);
+            return false;
+        }
+        if (index_count == 0) {
+            return true;
+        }
+
+        const auto BUFFER_COUNT = m_BoundVertexArray->Buffers().size();
+        Vector<VkBuffer> vertex_buffers(BUFFER_COUNT);
+        const Vector<VkDeviceSize> OFFSETS(BUFFER_COUNT, 0);
+        for (std::size_t buffer = 0; buffer < BUFFER_COUNT; ++buffer) {
+            vertex_buffers[buffer] = m_BoundVertexArray->VertexBuffer(buffer).Handle();
+            if (vertex_buffers[buffer] == VK_NULL_HANDLE) {
+                EngineLogger()->error("Vulkan draw with an empty vertex buffer");
+                return false;
+            }
+        }
+
+        if (!BeginRenderPass()) {
+            return false;
+        }
+        const auto& target = m_RenderTargets.at(m_BoundFramebuffer);
+        const auto PIPELINE = Pipeline(*m_BoundVertexArray, target);
+        auto descriptor_set = AllocateDescriptorSet();
+        if (PIPELINE == VK_NULL_HANDLE || descriptor_set == VK_NULL_HANDLE) {
+            return false;
+        }
+
+        std::array<VkDescriptorImageInfo, MAX_TEXTURE_SLOTS> images{};
+        for (std::uint32_t slot = 0; slot < MAX_TEXTURE_SLOTS; ++slot) {
+            auto* texture = m_BoundTextures[slot];
+            if (texture == nullptr) {
+                images[slot] = {m_DefaultSampler, m_WhiteTexture.View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+                continue;
+            }
+            images[slot] = {
+                texture->VkSamplerHandle(), texture->Image().View, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+            texture->MarkUsed(m_SubmissionSerial);
+        }
+
+        // The bindings are consecutive, one write fills all slots
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = descriptor_set;
+        write.descriptorCount = MAX_TEXTURE_SLOTS;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = images.data();
+        vkUpdateDescriptorSets(m_Device.Handle(), 1, &write, 0, nullptr);
+
+        if (PIPELINE != m_BoundPipeline) {
+            vkCmdBindPipeline(m_FrameCommands, VK_PIPELINE_BIND_POINT_GRAPHICS, PIPELINE);
+            m_BoundPipeline = PIPELINE;
+        }
+        vkCmdBindDescriptorSets(
+            m_FrameCommands, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &descriptor_set, 0, nullptr);
+        if (BUFFER_COUNT > 0) {
+            vkCmdBindVertexBuffers(
+                m_FrameCommands, 0, static_cast<std::uint32_t>(BUFFER_COUNT), vertex_buffers.data(), OFFSETS.data());
+        }
+        vkCmdBindIndexBuffer(m_FrameCommands,
+                             indices->Handle(),
+                             0,
+                             index_type == Type::UNSIGNED_SHORT ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
+        vkCmdDrawIndexed(m_FrameCommands, index_count, 1, first_index, base_vertex, 0);
+        return true;
+    }
+
+    auto VulkanRendererAPI::CreateVertexBuffer(const AttributeLayout& layout) -> Scope<IVertexBuffer>
+    {
+        return CreateScope<VulkanVertexBuffer>(layout, *this);
+    }
+
+    auto VulkanRendererAPI::CreateElementBuffer() -> Scope<IElementBuffer>
+    {
+        return CreateScope<VulkanElementBuffer>(*this);
+    }
+
+    auto VulkanRendererAPI::CreateVertexArray() -> Scope<IVertexArray> { return CreateScope<VulkanVertexArray>(*this); }
+
+    auto VulkanRendererAPI::CreateShader(std::string_view debug_name,
+                                         std::string_view vertex_source,
+                                         std::string_view fragment_source) -> Scope<IShaderProgram>
+    {
+        return CreateScope<VulkanShaderProgram>(debug_name, vertex_source, fragment_source, *this);
+    }
+
+    auto VulkanRendererAPI::CreateTexture2D(const TextureDescription& description) -> Scope<ITexture2D>
+    {
+        return CreateScope<VulkanTexture2D>(description, *this);
+    }
+
+    auto VulkanRendererAPI::CreateTextureUploader(std::size_t frame_budget) -> Scope<ITextureUploader>
+    {
+        return CreateScope<VulkanTextureUploader>(frame_budget, *this);
+    }
+
+    auto VulkanRendererAPI::CreateFramebuffer(const FramebufferDescription& description) -> Scope<IFramebuffer>
+    {
+        return CreateScope<VulkanFramebuffer>(description, *this);
+    }
+
+    auto VulkanRendererAPI::InsertFence() -> FenceID
+    {
+        if (!m_Initialized || !SubmitPending()) {
+            return 0;
+        }
+
+        VkFenceCreateInfo fence_info{};
+        fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        VkFence fence = VK_NULL_HANDLE;
+        if (!VulkanSucceeded(vkCreateFence(m_Device.Handle(), &fence_info, nullptr, &fence), "vkCreateFence")) {
+            return 0;
+        }
+        if (!m_Device.Submit({}, fence)) {
+            vkDestroyFence(m_Device.Handle(), fence, nullptr);
+            return 0;
+        }
+
+        const auto ID = m_NextFenceID++;
+        m_Fences.emplace(ID, fence);
+        return ID;
+    }
+
+    auto VulkanRendererAPI::WaitFence(FenceID fence, std::uint64_t timeout_ns) -> bool
+    {
+        const auto FENCE = m_Fences.find(fence);
+        if (FENCE == m_Fences.end()) {
+            return false;
+        }
+
+        const auto RESULT = vkWaitForFences(m_Device.Handle(), 1, &FENCE->second, VK_TRUE, timeout_ns);
+        if (RESULT == VK_TIMEOUT) {
+            return false;
+        }
+        RetireSubmissions(false);
+        return VulkanSucceeded(RESULT, "vkWaitForFences");
+    }
+
+    void VulkanRendererAPI::DeleteFence(FenceID fence)
+    {
+        const auto FENCE = m_Fences.find(fence);
+        if (FENCE == m_Fences.end()) {
+            return;
+        }
+        vkDestroyFence(m_Device.Handle(), FENCE->second, nullptr);
+        m_Fences.erase(FENCE);
+    }
+
+    auto VulkanRendererAPI::Finish() -> bool
+    {
+        if (!m_Initialized) {
+            return false;
+        }
+
+        const bool SUBMITTED = SubmitPending();
+        const bool IDLE = m_Device.WaitIdle();
+        RetireSubmissions(true);
+        return SUBMITTED && IDLE;
+    }
+
+    void VulkanRendererAPI::EndFrame()
+    {
+        // Releases are tied to the fence of their submission, the finished ones are retired without waiting
+        RetireSubmissions(false);
+    }
+
+    auto VulkanRendererAPI::BeginTimerQuery() -> TimerQueryID { return 0; }
+
+    auto VulkanRendererAPI::EndTimerQuery([[maybe_unused]] TimerQueryID query) -> bool { return false; }
+
+    auto VulkanRendererAPI::TimerQueryResult([[maybe_unused]] TimerQueryID query) -> std::optional<std::uint64_t>
+    {
+        return std::nullopt;
+    }
+
+    void VulkanRendererAPI::DeleteTimerQuery([[maybe_unused]] TimerQueryID query) {}
+
+    // cppcheck-suppress unusedFunction
+    auto VulkanRendererAPI::ReadDefaultFramebuffer() -> Vector<std::byte>
+    {
+        constexpr std::size_t COLOR_CHANNELS = 4;
+
+        if (!m_Initialized) {
+            return {};
+        }
+
+        const auto& size = m_DefaultColor.Size;
+        auto staging =
+            AllocateStaging(static_cast<VkDeviceSize>(size.X) * static_cast<VkDeviceSize>(size.Y) * COLOR_CHANNELS);
+        EndRenderPass();
+        auto* commands = FrameCommands();
+        if (!staging || commands == VK_NULL_HANDLE) {
+            return {};
+        }
+
+        // Vulkan's first row is at y = -1 like OpenGL's, the rows are already in glReadPixels order
+        TransitionImage(commands,
+                        m_DefaultColor,
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        0,
+                        1);
+        VkBufferImageCopy region{};
+        region.bufferOffset = staging->Offset;
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageExtent = {static_cast<std::uint32_t>(size.X), static_cast<std::uint32_t>(size.Y), 1};
+        vkCmdCopyImageToBuffer(
+            commands, m_DefaultColor.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging->Buffer, 1, &region);
+        TransitionImage(commands,
+                        m_DefaultColor,
+                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        0,
+                        1);
+        GlobalBarrier(commands, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+
+        // The staging chunk goes back to the free list, but nothing can write it before the copy below
+        if (!Finish()) {
+            return {};
+        }
+        return {staging->Memory.begin(), staging->Memory.end()};
+    }
+
+    // cppcheck-suppress unusedFunction
+    auto VulkanRendererAPI::PipelineCacheData() const -> Vector<std::byte>
+    {
+        if (m_PipelineCache == VK_NULL_HANDLE) {
+            return {};
+        }
+
+        std::size_t size = 0;
+        vkGetPipelineCacheData(m_Device.Handle(), m_PipelineCache, &size, nullptr);
+        Vector<std::byte> data(size);
+        vkGetPipelineCacheData(m_Device.Handle(), m_PipelineCache, &size, data.data());
+        data.resize(size);
+        return data;
+    }
+
+    auto VulkanRendererAPI::BeginCommandBuffer() -> VkCommandBuffer
+    {
+        auto* commands = m_Device.AllocateCommandBuffer();
+        if (commands == VK_NULL_HANDLE) {
+            return VK_NULL_HANDLE;
+        }
+        m_Recording.CommandBuffers.push_back(commands);
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (!VulkanSucceeded(vkBeginCommandBuffer(commands, &begin_info), "vkBeginCommandBuffer")) {
+            return VK_NULL_HANDLE;
+        }
+        return commands;
+    }
+
+    auto VulkanRendererAPI::UploadCommands() -> VkCommandBuffer
+    {
+        if (m_UploadCommands == VK_NULL_HANDLE) {
+            m_UploadCommands = BeginCommandBuffer();
+        }
+        return m_UploadCommands;
+    }
+
+    auto VulkanRendererAPI::FrameCommands() -> VkCommandBuffer
+    {
+        if (m_FrameCommands == VK_NULL_HANDLE) {
+            m_FrameCommands = BeginCommandBuffer();
+        }
+        return m_FrameCommands;
+    }
+
+    auto VulkanRendererAPI::TextureCommands(const VulkanTexture2D& texture) -> VkCommandBuffer
+    {
+        // The upload command buffer runs in front of all draws of the submission
+        if (texture.LastUse() != m_SubmissionSerial) {
+            return UploadCommands();
+        }
+        EndRenderPass();
+        return FrameCommands();
+    }
+
+    auto VulkanRendererAPI::SubmitPending() -> bool
+    {
+        if (m_UploadCommands == VK_NULL_HANDLE && m_FrameCommands == VK_NULL_HANDLE) {
+            RetireSubmissions(false);
+            return true;
+        }
+
+        EndRenderPass();
+        Vector<VkCommandBuffer> command_buffers;
+        bool success = true;
+        if (m_UploadCommands != VK_NULL_HANDLE) {
+            // Uploads are visible to every draw of the submission
+            GlobalBarrier(m_UploadCommands,
+                          VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                          VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+            success = VulkanSucceeded(vkEndCommandBuffer(m_UploadCommands), "vkEndCommandBuffer");
+            command_buffers.push_back(m_UploadCommands);
+        }
+        if (m_FrameCommands != VK_NULL_HANDLE) {
+            success = VulkanSucceeded(vkEndCommandBuffer(m_FrameCommands), "vkEndCommandBuffer") && success;
+            command_buffers.push_back(m_FrameCommands);
+        }
+
+        VkFenceCreateInfo fence_info{};
+        fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        success = success
+                  && VulkanSucceeded(vkCreateFence(m_Device.Handle(), &fence_info, nullptr, &m_Recording.Fence),
+                                     "vkCreateFence")
+                  && m_Device.Submit(command_buffers, m_Recording.Fence);
+        if (success) {
+            m_InFlight.push_back(std::move(m_Recording));
+        } else {
+            m_Device.WaitIdle();
+            Retire(m_Recording);
+        }
+
+        m_Recording = {};
+        m_UploadCommands = VK_NULL_HANDLE;
+        m_FrameCommands = VK_NULL_HANDLE;
+        m_BoundPipeline = VK_NULL_HANDLE;
+        m_StagingOffset = 0;
+        ++m_SubmissionSerial;
+
+        RetireSubmissions(false);
+        return success;
+    }
+
+    void VulkanRendererAPI::Release(std::function<void()> release)
+    {
+        // Without recorded work the release only has to wait for the last submission
+        if (m_UploadCommands == VK_NULL_HANDLE && m_FrameCommands == VK_NULL_HANDLE) {
+            if (m_InFlight.empty()) {
+                release();
+            } else {
+                m_InFlight.back().Releases.push_back(std::move(release));
+            }
+            return;
+        }
+        m_Recording.Releases.push_back(std::move(release));
+    }
+
+    void VulkanRendererAPI::RetireSubmissions(bool wait)
+    {
+        while (!m_InFlight.empty()) {
+            auto& submission = m_InFlight.front();
+            const auto STATUS = wait ? vkWaitForFences(m_Device.Handle(),
+                                                       1,
+                                                       &submission.Fence,
+                                                       VK_TRUE,
+                                                       std::numeric_limits<std::uint64_t>::max())
+                                     : vkGetFenceStatus(m_Device.Handle(), submission.Fence);
+            if (STATUS != VK_SUCCESS) {
+                return;
+            }
+            Retire(submission);
+            m_InFlight.pop_front();
+        }
+    }
+
+    void VulkanRendererAPI::Retire(PendingSubmission& submission)
+    {
+        auto* device = m_Device.Handle();
+
+        vkDestroyFence(device, submission.Fence, nullptr);
+        for (auto* command_buffer : submission.CommandBuffers) {
+            m_Device.FreeCommandBuffer(command_buffer);
+        }
+        m_FreeStaging.insert(m_FreeStaging.end(), submission.Staging.begin(), submission.Staging.end());
+        for (const auto POOL : submission.DescriptorPools) {
+            vkResetDescriptorPool(device, POOL, 0);
+            m_FreeDescriptorPools.push_back(POOL);
+        }
+        for (auto& release : submission.Releases) {
+            release();
+        }
+        submission = {};
+    }
+
+    auto VulkanRendererAPI::AllocateStaging(VkDeviceSize size) -> std::optional<VulkanStaging>
+    {
+        if (m_Recording.Staging.empty() || m_StagingOffset + size > m_Recording.Staging.back().Size) {
+            // Retired chunks are reused before new ones are created, large uploads get a chunk of their own
+            const auto FREE =
+                std::ranges::find_if(m_FreeStaging, [size](const VulkanBuffer& chunk) { return chunk.Size >= size; });
+            if (FREE != m_FreeStaging.end()) {
+                m_Recording.Staging.push_back(*FREE);
+                m_FreeStaging.erase(FREE);
+            } else {
+                auto chunk = m_Device.CreateBuffer(std::max(size, STAGING_CHUNK_SIZE),
+                                                   VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                                                       | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+                if (!chunk) {
+                    return std::nullopt;
+                }
+                m_Recording.Staging.push_back(*chunk);
+            }
+            m_StagingOffset = 0;
+        }
+
+        const auto& chunk = m_Recording.Staging.back();
+        const VulkanStaging STAGING{chunk.Buffer, m_StagingOffset, {chunk.Mapped + m_StagingOffset, size}};
+        m_StagingOffset += (size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+        return STAGING;
+    }
+
+    auto VulkanRendererAPI::CreateBuffer(std::span<const std::byte> data, VkBufferUsageFlags usage)
+        -> std::optional<VulkanBuffer>
+    {
+        auto staging = AllocateStaging(data.size());
+        auto* commands = UploadCommands();
+        if (!staging || commands == VK_NULL_HANDLE) {
+            return std::nullopt;
+        }
+        std::memcpy(staging->Memory.data(), data.data(), data.size());
+
+        auto buffer = m_Device.CreateBuffer(
+            data.size(), usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (!buffer) {
+            return std::nullopt;
+        }
+
+        const VkBufferCopy REGION{staging->Offset, 0, data.size()};
+        vkCmdCopyBuffer(commands, staging->Buffer, buffer->Buffer, 1, &REGION);
+        return buffer;
+    }
+
+    auto VulkanRendererAPI::CreateImage(const Size2D& size,
+                                        VkFormat format,
+                                        std::uint32_t mip_levels,
+                                        VkImageUsageFlags usage) -> std::optional<VulkanImage>
+    {
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        if (IsDepthFormat(format)) {
+            aspect = HasStencil(format) ? VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT
+                                        : VK_IMAGE_ASPECT_DEPTH_BIT;
+        }
+
+        auto* commands = UploadCommands();
+        if (commands == VK_NULL_HANDLE) {
+            return std::nullopt;
+        }
+        auto image = m_Device.CreateImage(size, format, mip_levels, usage, aspect);
+        if (!image) {
+            return std::nullopt;
+        }
+
+        TransitionImage(commands, *image, VK_IMAGE_LAYOUT_UNDEFINED, ResidentLayout(*image), 0, mip_levels);
+        return image;
+    }
+
+    auto VulkanRendererAPI::CopyToImage(const VulkanStaging& staging,
+                                        VulkanTexture2D& texture,
+                                        std::uint32_t level,
+                                        const Size2D& offset,
+                                        const Size2D& extent) -> bool
+    {
+        const auto& image = texture.Image();
+        auto* commands = TextureCommands(texture);
+        if (commands == VK_NULL_HANDLE) {
+            return false;
+        }
+
+        TransitionImage(
+            commands, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, level, 1);
+        VkBufferImageCopy region{};
+        region.bufferOffset = staging.Offset;
+        region.imageSubresource = {image.Aspect, level, 0, 1};
+        region.imageOffset = {offset.X, offset.Y, 0};
+        region.imageExtent = {static_cast<std::uint32_t>(extent.X), static_cast<std::uint32_t>(extent.Y), 1};
+        vkCmdCopyBufferToImage(commands, staging.Buffer, image.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+        TransitionImage(
+            commands, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, level, 1);
+        return true;
+    }
+
+    auto VulkanRendererAPI::GenerateMipmaps(VulkanTexture2D& texture) -> bool
+    {
+        const auto& image = texture.Image();
+        if (image.Image == VK_NULL_HANDLE) {
+            return false;
+        }
+        if (image.MipLevels == 1) {
+            return true;
+        }
+
+        constexpr VkFormatFeatureFlags BLIT_FEATURES = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT
+                                                       | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        if ((m_Device.FormatProperties(image.Format).optimalTilingFeatures & BLIT_FEATURES) != BLIT_FEATURES) {
+            EngineLogger()->error("Vulkan can't generate mipmaps of texture format {}", static_cast<int>(image.Format));
+            return false;
+        }
+
+        auto* commands = TextureCommands(texture);
+        if (commands == VK_NULL_HANDLE) {
+            return false;
+        }
+
+        // Every level is downsampled from the one before it
+        for (std::uint32_t level = 1; level < image.MipLevels; ++level) {
+            const auto SOURCE_SIZE = MipLevelSize(image.Size, level - 1);
+            const auto SIZE = MipLevelSize(image.Size, level);
+
+            TransitionImage(commands,
+                            image,
+                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                            level - 1,
+                            1);
+            TransitionImage(commands,
+                            image,
+                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            level,
+                            1);
+
+            VkImageBlit blit{};
+            blit.srcSubresource = {image.Aspect, level - 1, 0, 1};
+            blit.srcOffsets[1] = {SOURCE_SIZE.X, SOURCE_SIZE.Y, 1};
+            blit.dstSubresource = {image.Aspect, level, 0, 1};
+            blit.dstOffsets[1] = {SIZE.X, SIZE.Y, 1};
+            vkCmdBlitImage(commands,
+                           image.Image,
+                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           image.Image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           1,
+                           &blit,
+                           VK_FILTER_LINEAR);
+
+            TransitionImage(commands,
+                            image,
+                            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                            level - 1,
+                            1);
+            TransitionImage(commands,
+                            image,
+                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                            level,
+                            1);
+        }
+        return true;
+    }
+
+    auto VulkanRendererAPI::Sampler(const SamplerState& state, std::uint32_t mip_levels) -> VkSampler
+    {
+        const bool MIPMAPPED = mip_levels > 1;
+        const SamplerKey KEY{state.MinFilter, state.MagFilter, state.MipFilter, state.WrapU, state.WrapV, MIPMAPPED};
+        const auto CACHED = m_Samplers.find(KEY);
+        if (CACHED != m_Samplers.end()) {
+            return CACHED->second;
+        }
+
+        VkSamplerCreateInfo sampler_info{};
+        sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        sampler_info.magFilter = ToVkFilter(state.MagFilter);
+        sampler_info.minFilter = ToVkFilter(state.MinFilter);
+        sampler_info.mipmapMode = state.MipFilter == TextureFilter::NEAREST ? VK_SAMPLER_MIPMAP_MODE_NEAREST
+                                                                             : VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        sampler_info.addressModeU = ToVkAddressMode(state.WrapU);
+        sampler_info.addressModeV = ToVkAddressMode(state.WrapV);
+        sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        sampler_info.maxLod = MIPMAPPED ? VK_LOD_CLAMP_NONE : 0.0f;
+
+        VkSampler sampler = VK_NULL_HANDLE;
+        if (!VulkanSucceeded(vkCreateSampler(m_Device.Handle(), &sampler_info, nullptr, &sampler), "vkCreateSampler")) {
+            return VK_NULL_HANDLE;
+        }
+        m_Samplers.emplace(KEY, sampler);
+        return sampler;
+    }
+
+    auto VulkanRendererAPI::CompileProgram(std::string_view debug_name,
+                                           std::string_view vertex_source,
+                                           std::string_view fragment_source) -> ProgramID
+    {
+        if (!m_Initialized) {
+            return 0;
+        }
+
+        const auto SPIRV_CODE = CompileSPIRV(debug_name, RemapDepth(vertex_source), fragment_source);
+        if (!SPIRV_CODE) {
+            return 0;
+        }
+
+        std::array<VkShaderModule, 2> modules{};
+        for (std::size_t stage = 0; stage < modules.size(); ++stage) {
+            VkShaderModuleCreateInfo module_info{};
+            module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            module_info.codeSize = (*SPIRV_CODE)[stage].size() * sizeof(std::uint32_t);
+            module_info.pCode = (*SPIRV_CODE)[stage].data();
+            if (!VulkanSucceeded(vkCreateShaderModule(m_Device.Handle(), &module_info, nullptr, &modules[stage]),
+                                 "vkCreateShaderModule")) {
+                vkDestroyShaderModule(m_Device.Handle(), modules[0], nullptr);
+                return 0;
+            }
+        }
+
+        const auto ID = m_NextProgramID++;
+        m_Programs.emplace(ID, Program{modules[0], modules[1]});
+        return ID;
+    }
+
+    void VulkanRendererAPI::DestroyProgram(ProgramID program_id)
+    {
+        const auto PROGRAM = m_Programs.find(program_id);
+        if (PROGRAM == m_Programs.end()) {
+            return;
+        }
+        if (m_BoundProgram == program_id) {
+            m_BoundProgram = 0;
+        }
+
+        // Recorded draws may still use the pipelines, the modules aren't needed once the pipelines exist
+        for (auto pipeline = m_Pipelines.begin(); pipeline != m_Pipelines.end();) {
+            if (std::get<0>(pipeline->first) != program_id) {
+                ++pipeline;
+                continue;
+            }
+            Release([device = m_Device.Handle(), handle = pipeline->second]()
+                    { vkDestroyPipeline(device, handle, nullptr); });
+            pipeline = m_Pipelines.erase(pipeline);
+        }
+        vkDestroyShaderModule(m_Device.Handle(), PROGRAM->second.Vertex, nullptr);
+        vkDestroyShaderModule(m_Device.Handle(), PROGRAM->second.Fragment, nullptr);
+        m_Programs.erase(PROGRAM);
+    }
+
+    auto VulkanRendererAPI::RegisterFramebuffer(Vector<VulkanTexture2D*> color_attachments, const VulkanImage* depth)
+        -> FramebufferID
+    {
+        if (!m_Initialized || (color_attachments.empty() && depth == nullptr)) {
+            return 0;
+        }
+
+        Vector<VkImageView> views;
+        Vector<VkFormat> formats;
+        for (const auto* texture : color_attachments) {
+            views.push_back(texture->Image().View);
+            formats.push_back(texture->Image().Format);
+        }
+        const auto& size = color_attachments.empty() ? depth->Size : color_attachments.front()->Size();
+
+        auto target = CreateRenderTarget(views, formats, depth, size);
+        if (!target) {
+            return 0;
+        }
+        target->ColorAttachments = std::move(color_attachments);
+
+        const auto ID = m_NextFramebufferID++;
+        m_RenderTargets.emplace(ID, std::move(*target));
+        return ID;
+    }
+
+    void VulkanRendererAPI::UnregisterFramebuffer(FramebufferID buffer_id)
+    {
+        const auto TARGET = m_RenderTargets.find(buffer_id);
+        if (buffer_id == 0 || TARGET == m_RenderTargets.end()) {
+            return;
+        }
+        if (m_BoundFramebuffer == buffer_id) {
+            BindFramebuffer(0);
+        }
+        DestroyRenderTarget(TARGET->second);
+        m_RenderTargets.erase(TARGET);
+    }
+
+    auto VulkanRendererAPI::RenderPass(const Vector<VkFormat>& color_formats, VkFormat depth_format) -> VkRenderPass
+    {
+        RenderPassKey key{color_formats, depth_format};
+        const auto CACHED = m_RenderPasses.find(key);
+        if (CACHED != m_RenderPasses.end()) {
+            return CACHED->second;
+        }
+
+        // Attachments keep their contents between passes, clears are recorded explicitly like in OpenGL
+        Vector<VkAttachmentDescription> attachments;
+        Vector<VkAttachmentReference> color_references;
+        for (const auto FORMAT : color_formats) {
+            VkAttachmentDescription attachment{};
+            attachment.format = FORMAT;
+            attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+            attachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            attachment.initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            attachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            color_references.push_back(
+                {static_cast<std::uint32_t>(attachments.size()), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+            attachments.push_back(attachment);
+        }
+
+        const VkAttachmentReference DEPTH_REFERENCE{static_cast<std::uint32_t>(attachments.size()),
+                                                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+        if (depth_format != VK_FORMAT_UNDEFINED) {
+            VkAttachmentDescription attachment{};
+            attachment.format = depth_format;
+            attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+            attachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+            attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
+            attachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            attachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            attachments.push_back(attachment);
+        }
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = static_cast<std::uint32_t>(color_references.size());
+        subpass.pColorAttachments = color_references.data();
+        subpass.pDepthStencilAttachment = depth_format != VK_FORMAT_UNDEFINED ? &DEPTH_REFERENCE : nullptr;
+
+        // Commands before and after the pass may sample what it renders
+        std::array<VkSubpassDependency, 2> dependencies{};
+        dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[0].dstSubpass = 0;
+        dependencies[0].srcStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        dependencies[0].dstStageMask = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT;
+        dependencies[0].srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        dependencies[0].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        dependencies[1].srcSubpass = 0;
+        dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[1].srcStageMask = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT;
+        dependencies[1].dstStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        dependencies[1].srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        dependencies[1].dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+        VkRenderPassCreateInfo render_pass_info{};
+        render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        render_pass_info.attachmentCount = static_cast<std::uint32_t>(attachments.size());
+        render_pass_info.pAttachments = attachments.data();
+        render_pass_info.subpassCount = 1;
+        render_pass_info.pSubpasses = &subpass;
+        render_pass_info.dependencyCount = static_cast<std::uint32_t>(dependencies.size());
+        render_pass_info.pDependencies = dependencies.data();
+
+        VkRenderPass render_pass = VK_NULL_HANDLE;
+        if (!VulkanSucceeded(vkCreateRenderPass(m_Device.Handle(), &render_pass_info, nullptr, &render_pass),
+                             "vkCreateRenderPass")) {
+            return VK_NULL_HANDLE;
+        }
+        m_RenderPasses.emplace(std::move(key), render_pass);
+        return render_pass;
+    }
+
+    auto VulkanRendererAPI::CreateRenderTarget(const Vector<VkImageView>& color_views,
+                                               const Vector<VkFormat>& color_formats,
+                                               const VulkanImage* depth,
+                                               const Size2D& size) -> std::optional<RenderTarget>
+    {
+        RenderTarget target;
+        target.Size = size;
+        target.ColorCount = static_cast<std::uint32_t>(color_views.size());
+        target.HasDepth = depth != nullptr;
+        target.RenderPass = RenderPass(color_formats, depth != nullptr ? depth->Format : VK_FORMAT_UNDEFINED);
+        if (target.RenderPass == VK_NULL_HANDLE) {
+            return std::nullopt;
+        }
+
+        auto views = color_views;
+        if (depth != nullptr) {
+            views.push_back(depth->View);
+        }
+
+        VkFramebufferCreateInfo framebuffer_info{};
+        framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebuffer_info.renderPass = target.RenderPass;
+        framebuffer_info.attachmentCount = static_cast<std::uint32_t>(views.size());
+        framebuffer_info.pAttachments = views.data();
+        framebuffer_info.width = static_cast<std::uint32_t>(size.X);
+        framebuffer_info.height = static_cast<std::uint32_t>(size.Y);
+        framebuffer_info.layers = 1;
+        if (!VulkanSucceeded(vkCreateFramebuffer(m_Device.Handle(), &framebuffer_info, nullptr, &target.Framebuffer),
+                             "vkCreateFramebuffer")) {
+            return std::nullopt;
+        }
+        return target;
+    }
+
+    void VulkanRendererAPI::DestroyRenderTarget(const RenderTarget& target)
+    {
+        Release([device = m_Device.Handle(), framebuffer = target.Framebuffer]()
+                { vkDestroyFramebuffer(device, framebuffer, nullptr); });
+    }
+
+    auto VulkanRendererAPI::Pipeline(const VulkanVertexArray& vertex_array, const RenderTarget& target) -> VkPipeline
+    {
+        // Targets without a depth stencil attachment pass both tests
+        auto state = m_RenderState;
+        if (!target.HasDepth) {
+            state.DepthStencil.DepthTest = false;
+            state.DepthStencil.StencilTest = false;
+        }
+        PipelineKey key{m_BoundProgram, vertex_array.LayoutSignature(), target.RenderPass, state};
+        const auto CACHED = m_Pipelines.find(key);
+        if (CACHED != m_Pipelines.end()) {
+            return CACHED->second;
+        }
+
+        const auto PROGRAM = m_Programs.find(m_BoundProgram);
+        if (PROGRAM == m_Programs.end()) {
+            EngineLogger()->error("Vulkan draw without a valid shader program");
+            return VK_NULL_HANDLE;
+        }
+
+        std::array<VkPipelineShaderStageCreateInfo, 2> stages{};
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = PROGRAM->second.Vertex;
+        stages[0].pName = "main";
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = PROGRAM->second.Fragment;
+        stages[1].pName = "main";
+
+        // Attribute locations continue from one buffer to the next like the OpenGL vertex arrays assign them
+        Vector<VkVertexInputBindingDescription> bindings;
+        Vector<VkVertexInputAttributeDescription> attributes;
+        for (std::uint32_t buffer = 0; buffer < vertex_array.Buffers().size(); ++buffer) {
+            const auto& layout = vertex_array.Buffers()[buffer]->Layout();
+            bindings.push_back({buffer, static_cast<std::uint32_t>(layout.Stride()), VK_VERTEX_INPUT_RATE_VERTEX});
+            for (const auto& attribute : layout) {
+                attributes.push_back({static_cast<std::uint32_t>(attributes.size()),
+                                      buffer,
+                                      AttributeFormat(attribute.ComponentCount),
+                                      static_cast<std::uint32_t>(attribute.Offset)});
+            }
+        }
+
+        VkPipelineVertexInputStateCreateInfo vertex_input{};
+        vertex_input.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertex_input.vertexBindingDescriptionCount = static_cast<std::uint32_t>(bindings.size());
+        vertex_input.pVertexBindingDescriptions = bindings.data();
+        vertex_input.vertexAttributeDescriptionCount = static_cast<std::uint32_t>(attributes.size());
+        vertex_input.pVertexAttributeDescriptions = attributes.data();
+
+        VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+        input_assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        VkPipelineViewportStateCreateInfo viewport{};
+        viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewport.viewportCount = 1;
+        viewport.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo rasterization{};
+        rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterization.cullMode = ToVkCullMode(state.Rasterizer.Cull);
+        rasterization.frontFace =
+            state.Rasterizer.FrontCounterClockwise ? VK_FRONT_FACE_COUNTER_CLOCKWISE : VK_FRONT_FACE_CLOCKWISE;
+        rasterization.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisample{};
+        multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+        depth_stencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        // Like in OpenGL, depth is only written while the depth test is enabled
+        const auto& depth = state.DepthStencil;
+        depth_stencil.depthTestEnable = depth.DepthTest ? VK_TRUE : VK_FALSE;
+        depth_stencil.depthWriteEnable = depth.DepthTest && depth.DepthWrite ? VK_TRUE : VK_FALSE;
+        depth_stencil.depthCompareOp = ToVkCompareOp(depth.DepthCompare);
+        depth_stencil.stencilTestEnable = depth.StencilTest ? VK_TRUE : VK_FALSE;
+        depth_stencil.front = {VK_STENCIL_OP_KEEP,
+                               depth.StencilWrite ? VK_STENCIL_OP_REPLACE : VK_STENCIL_OP_KEEP,
+                               VK_STENCIL_OP_KEEP,
+                               ToVkCompareOp(depth.StencilCompare),
+                               std::numeric_limits<std::uint8_t>::max(),
+                               std::numeric_limits<std::uint8_t>::max(),
+                               depth.StencilReference};
+        depth_stencil.back = depth_stencil.front;
+
+        // glBlendFunc blends color and alpha with the same factors
+        VkPipelineColorBlendAttachmentState blend_attachment{};
+        blend_attachment.blendEnable = state.Blend.Enabled ? VK_TRUE : VK_FALSE;
+        blend_attachment.srcColorBlendFactor = ToVkBlendFactor(state.Blend.Source);
+        blend_attachment.dstColorBlendFactor = ToVkBlendFactor(state.Blend.Destination);
+        blend_attachment.colorBlendOp = VK_BLEND_OP_ADD;
+        blend_attachment.srcAlphaBlendFactor = blend_attachment.srcColorBlendFactor;
+        blend_attachment.dstAlphaBlendFactor = blend_attachment.dstColorBlendFactor;
+        blend_attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
+                                          | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        const Vector<VkPipelineColorBlendAttachmentState> BLEND_ATTACHMENTS(target.ColorCount, blend_attachment);
+        VkPipelineColorBlendStateCreateInfo color_blend{};
+        color_blend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        color_blend.attachmentCount = target.ColorCount;
+        color_blend.pAttachments = BLEND_ATTACHMENTS.data();
+
+        // Viewport and scissor follow the render target, so pipelines don't depend on its size
+        constexpr std::array<VkDynamicState, 2> DYNAMIC_STATES{VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+        VkPipelineDynamicStateCreateInfo dynamic_state{};
+        dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamic_state.dynamicStateCount = static_cast<std::uint32_t>(DYNAMIC_STATES.size());
+        dynamic_state.pDynamicStates = DYNAMIC_STATES.data();
+
+        VkGraphicsPipelineCreateInfo pipeline_info{};
+        pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipeline_info.stageCount = static_cast<std::uint32_t>(stages.size());
+        pipeline_info.pStages = stages.data();
+        pipeline_info.pVertexInputState = &vertex_input;
+        pipeline_info.pInputAssemblyState = &input_assembly;
+        pipeline_info.pViewportState = &viewport;
+        pipeline_info.pRasterizationState = &rasterization;
+        pipeline_info.pMultisampleState = &multisample;
+        pipeline_info.pDepthStencilState = &depth_stencil;
+        pipeline_info.pColorBlendState = &color_blend;
+        pipeline_info.pDynamicState = &dynamic_state;
+        pipeline_info.layout = m_PipelineLayout;
+        pipeline_info.renderPass = target.RenderPass;
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        if (!VulkanSucceeded(
+                vkCreateGraphicsPipelines(m_Device.Handle(), m_PipelineCache, 1, &pipeline_info, nullptr, &pipeline),
+                "vkCreateGraphicsPipelines")) {
+            return VK_NULL_HANDLE;
+        }
+        m_Pipelines.emplace(std::move(key), pipeline);
+        return pipeline;
+    }
+
+    auto VulkanRendererAPI::AllocateDescriptorSet() -> VkDescriptorSet
+    {
+        const auto ALLOCATE = [this](VkDescriptorPool pool)
+        {
+            VkDescriptorSetAllocateInfo allocate_info{};
+            allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocate_info.descriptorPool = pool;
+            allocate_info.descriptorSetCount = 1;
+            allocate_info.pSetLayouts = &m_DescriptorSetLayout;
+
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            return vkAllocateDescriptorSets(m_Device.Handle(), &allocate_info, &set) == VK_SUCCESS ? set
+                                                                                                   : VK_NULL_HANDLE;
+        };
+
+        if (!m_Recording.DescriptorPools.empty()) {
+            const auto SET = ALLOCATE(m_Recording.DescriptorPools.back());
+            if (SET != VK_NULL_HANDLE) {
+                return SET;
+            }
+        }
+
+        // Sets are never freed one by one, pools are reset once their submission is done
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        if (!m_FreeDescriptorPools.empty()) {
+            pool = m_FreeDescriptorPools.back();
+            m_FreeDescriptorPools.pop_back();
+        } else {
+            const VkDescriptorPoolSize POOL_SIZE{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                                 DESCRIPTOR_POOL_SETS * MAX_TEXTURE_SLOTS};
+            VkDescriptorPoolCreateInfo pool_info{};
+            pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            pool_info.maxSets = DESCRIPTOR_POOL_SETS;
+            pool_info.poolSizeCount = 1;
+            pool_info.pPoolSizes = &POOL_SIZE;
+            if (!VulkanSucceeded(vkCreateDescriptorPool(m_Device.Handle(), &pool_info, nullptr, &pool),
+                                 "vkCreateDescriptorPool")) {
+                return VK_NULL_HANDLE;
+            }
+        }
+        m_Recording.DescriptorPools.push_back(pool);
+        return ALLOCATE(pool);
+    }
+
+    auto VulkanRendererAPI::BeginRenderPass() -> bool
+    {
+        if (m_RenderPassActive) {
+            return true;
+        }
+        auto* commands = FrameCommands();
+        if (commands == VK_NULL_HANDLE) {
+            return false;
+        }
+
+        const auto& target = m_RenderTargets.at(m_BoundFramebuffer);
+        for (auto* texture : target.ColorAttachments) {
+            texture->MarkUsed(m_SubmissionSerial);
+        }
+
+        const VkExtent2D EXTENT{static_cast<std::uint32_t>(target.Size.X), static_cast<std::uint32_t>(target.Size.Y)};
+        VkRenderPassBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        begin_info.renderPass = target.RenderPass;
+        begin_info.framebuffer = target.Framebuffer;
+        begin_info.renderArea = {{0, 0}, EXTENT};
+        vkCmdBeginRenderPass(commands, &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+
+        const VkViewport VIEWPORT{
+            0, 0, static_cast<float>(target.Size.X), static_cast<float>(target.Size.Y), 0, 1};
+        const VkRect2D SCISSOR{{0, 0}, EXTENT};
+        vkCmdSetViewport(commands, 0, 1, &VIEWPORT);
+        vkCmdSetScissor(commands, 0, 1, &SCISSOR);
+
+        m_RenderPassActive = true;
+        m_BoundPipeline = VK_NULL_HANDLE;
+        return true;
+    }
+
+    void VulkanRendererAPI::EndRenderPass()
+    {
+        if (!m_RenderPassActive) {
+            return;
+        }
+        vkCmdEndRenderPass(m_FrameCommands);
+        m_RenderPassActive = false;
+    }
+
+}  // namespace JE::detail
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include "Graphics/IRendererAPI.hpp"
+#include "Graphics/RenderState.hpp"
+#include "Graphics/Texture.hpp"
+#include "Graphics/VulkanDevice.hpp"
+#include "Memory.hpp"
+#include "Types.hpp"
+
+namespace JE
+{
+    struct RGBA;
+    class VulkanTexture2D;
+    class VulkanVertexArray;
+}  // namespace JE
+
+namespace JE::detail
+{
+
+    /// Range of the host visible staging memory, valid until the recorded uploads are submitted
+    struct VulkanStaging
+    {
+        VkBuffer Buffer = VK_NULL_HANDLE;
+        VkDeviceSize Offset = 0;
+        std::span<std::byte> Memory;
+    };
+
+    /// Headless Vulkan backend, draws go into offscreen images and the default framebuffer is read back instead of
+    /// presented. Uploads are recorded into a command buffer that is submitted in front of the draws, and pipelines
+    /// are created once per program, vertex layout, render pass and depth state
+    class VulkanRendererAPI final : public IRendererAPI
+    {
+      public:
+        static constexpr Size2D DEFAULT_FRAMEBUFFER_SIZE{1280, 720};
+        /// Fragment shaders sample slot N at binding N
+        static constexpr std::uint32_t MAX_TEXTURE_SLOTS = 8;
+        static constexpr VkDeviceSize STAGING_CHUNK_SIZE = VkDeviceSize{4} * 1024 * 1024;
+        static constexpr std::uint32_t DESCRIPTOR_POOL_SETS = 256;
+
+        VulkanRendererAPI(const VulkanRendererAPI& other) = delete;
+        VulkanRendererAPI(VulkanRendererAPI&& other) = delete;
+        auto operator=(const VulkanRendererAPI& other) -> VulkanRendererAPI& = delete;
+        auto operator=(VulkanRendererAPI&& other) -> VulkanRendererAPI& = delete;
+
+        /// pipeline_cache_data is what PipelineCacheData returned in an earlier run, it's ignored if the driver
+        /// changed since then
+        explicit VulkanRendererAPI(const Size2D& default_framebuffer_size = DEFAULT_FRAMEBUFFER_SIZE,
+                                   std::span<const std::byte> pipeline_cache_data = {});
+        ~VulkanRendererAPI() override;
+
+        auto Name() const -> std::string_view override;
+
+        auto SetClearColor(const RGBA& color) -> bool override;
+        auto ClearFramebuffer(AttachmentFlags flags) -> bool override;
+        auto BindFramebuffer(FramebufferID buffer_id) -> bool override;
+        auto DrawIndexed(Primitive primitive_type,
+                         std::uint32_t index_count,
+                         Type index_type,
+                         std::uint32_t first_index,
+                         std::int32_t base_vertex) -> bool override;
+        /// Pipelines are created for every render state they're drawn with
+        auto SetRenderState(const RenderState& state) -> bool override;
+
+        auto CreateVertexBuffer(const AttributeLayout& layout) -> Scope<IVertexBuffer> override;
+        auto CreateElementBuffer() -> Scope<IElementBuffer> override;
+        auto CreateVertexArray() -> Scope<IVertexArray> override;
+        auto CreateShader(std::string_view debug_name,
+                          std::string_view vertex_source,
+                          std::string_view fragment_source) -> Scope<IShaderProgram> override;
+        auto CreateTexture2D(const TextureDescription& description) -> Scope<ITexture2D> override;
+        auto CreateTextureUploader(std::size_t frame_budget) -> Scope<ITextureUploader> override;
+        auto CreateFramebuffer(const FramebufferDescription& description) -> Scope<IFramebuffer> override;
+
+        /// Submits the recorded work, the fence signals once everything submitted before it is done
+        auto InsertFence() -> FenceID override;
+        auto WaitFence(FenceID fence, std::uint64_t timeout_ns) -> bool override;
+        void DeleteFence(FenceID fence) override;
+        auto Finish() -> bool override;
+        void EndFrame() override;
+
+        /// Not implemented yet, BeginTimerQuery returns 0
+        auto BeginTimerQuery() -> TimerQueryID override;
+        auto EndTimerQuery(TimerQueryID query) -> bool override;
+        auto TimerQueryResult(TimerQueryID query) -> std::optional<std::uint64_t> override;
+        void DeleteTimerQuery(TimerQueryID query) override;
+
+        /// False when no Vulkan device is available, every call fails then
+        inline auto Initialized() const -> bool { return m_Initialized; }
+        inline auto Device() -> VulkanDevice& { return m_Device; }
+
+        /// Depth test is off by default like in the OpenGL backend
+        inline void SetDepthTest(bool enabled) { m_RenderState.DepthStencil.DepthTest = enabled; }
+
+        /// RGBA8 rows from bottom to top like glReadPixels returns them, waits for the GPU
+        auto ReadDefaultFramebuffer() -> Vector<std::byte>;
+        inline auto DefaultFramebufferSize() const -> const Size2D& { return m_DefaultColor.Size; }
+
+        inline auto PipelineCount() const -> std::size_t { return m_Pipelines.size(); }
+        /// Serialized pipeline cache to pass to the next run
+        auto PipelineCacheData() const -> Vector<std::byte>;
+
+        // Called by the Vulkan objects while they're bound, created or destroyed
+
+        /// Serial of the submission that is being recorded, objects remember when they were last drawn with
+        inline auto Submission() const -> std::uint64_t { return m_SubmissionSerial; }
+        auto SubmitPending() -> bool;
+        /// Runs once the GPU is done with everything recorded so far
+        void Release(std::function<void()> release);
+
+        auto AllocateStaging(VkDeviceSize size) -> std::optional<VulkanStaging>;
+        /// Device local buffer filled through the staging memory
+        auto CreateBuffer(std::span<const std::byte> data, VkBufferUsageFlags usage) -> std::optional<VulkanBuffer>;
+        /// Creates the image in the layout every draw and render pass expects it in
+        auto CreateImage(const Size2D& size, VkFormat format, std::uint32_t mip_levels, VkImageUsageFlags usage)
+            -> std::optional<VulkanImage>;
+        /// Textures that were drawn with in this submission are written after those draws instead of in front of them
+        auto CopyToImage(const VulkanStaging& staging,
+                         VulkanTexture2D& texture,
+                         std::uint32_t level,
+                         const Size2D& offset,
+                         const Size2D& extent) -> bool;
+        auto GenerateMipmaps(VulkanTexture2D& texture) -> bool;
+        auto Sampler(const SamplerState& state, std::uint32_t mip_levels) -> VkSampler;
+
+        auto CompileProgram(std::string_view debug_name,
+                            std::string_view vertex_source,
+                            std::string_view fragment_source) -> ProgramID;
+        void DestroyProgram(ProgramID program_id);
+        inline void BindProgram(ProgramID program_id) { m_BoundProgram = program_id; }
+        inline void BindVertexArray(VulkanVertexArray* vertex_array) { m_BoundVertexArray = vertex_array; }
+        inline void BindTexture(std::uint32_t slot, VulkanTexture2D* texture) { m_BoundTextures[slot] = texture; }
+        inline void UnbindTexture(const VulkanTexture2D* texture)
+        {
+            std::ranges::replace(m_BoundTextures, texture, nullptr);
+        }
+
+        auto RegisterFramebuffer(Vector<VulkanTexture2D*> color_attachments, const VulkanImage* depth)
+            -> FramebufferID;
+        void UnregisterFramebuffer(FramebufferID buffer_id);
+
+      private:
+        struct RenderTarget
+        {
+            Size2D Size;
+            VkRenderPass RenderPass = VK_NULL_HANDLE;
+            VkFramebuffer Framebuffer = VK_NULL_HANDLE;
+            Vector<VulkanTexture2D*> ColorAttachments;
+            std::uint32_t ColorCount = 0;
+            bool HasDepth = false;
+        };
+
+        struct Program
+        {
+            VkShaderModule Vertex = VK_NULL_HANDLE;
+            VkShaderModule Fragment = VK_NULL_HANDLE;
+        };
+
+        /// Everything the GPU may still use until the submission's fence signals
+        struct PendingSubmission
+        {
+            VkFence Fence = VK_NULL_HANDLE;
+            Vector<VkCommandBuffer> CommandBuffers;
+            Vector<VulkanBuffer> Staging;
+            Vector<VkDescriptorPool> DescriptorPools;
+            Vector<std::function<void()>> Releases;
+        };
+
+        using RenderPassKey = std::tuple<Vector<VkFormat>, VkFormat>;
+        using PipelineKey = std::tuple<ProgramID, Vector<std::uint32_t>, VkRenderPass, RenderState>;
+        using SamplerKey = std::tuple<TextureFilter, TextureFilter, TextureFilter, TextureWrap, TextureWrap, bool>;
+
+        auto CreateDefaultResources(const Size2D& default_framebuffer_size) -> bool;
+        auto RenderPass(const Vector<VkFormat>& color_formats, VkFormat depth_format) -> VkRenderPass;
+        auto CreateRenderTarget(const Vector<VkImageView>& color_views,
+                                const Vector<VkFormat>& color_formats,
+                                const VulkanImage* depth,
+                                const Size2D& size) -> std::optional<RenderTarget>;
+        void DestroyRenderTarget(const RenderTarget& target);
+        auto Pipeline(const VulkanVertexArray& vertex_array, const RenderTarget& target) -> VkPipeline;
+        auto AllocateDescriptorSet() -> VkDescriptorSet;
+
+        auto BeginCommandBuffer() -> VkCommandBuffer;
+        auto UploadCommands() -> VkCommandBuffer;
+        auto FrameCommands() -> VkCommandBuffer;
+        auto TextureCommands(const VulkanTexture2D& texture) -> VkCommandBuffer;
+        auto BeginRenderPass() -> bool;
+        void EndRenderPass();
+        void RetireSubmissions(bool wait);
+        void Retire(PendingSubmission& submission);
+
+        VulkanDevice m_Device;
+        bool m_Initialized = false;
+        VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
+        VkDescriptorSetLayout m_DescriptorSetLayout = VK_NULL_HANDLE;
+        VkPipelineLayout m_PipelineLayout = VK_NULL_HANDLE;
+
+        std::map<RenderPassKey, VkRenderPass> m_RenderPasses;
+        std::map<PipelineKey, VkPipeline> m_Pipelines;
+        std::map<SamplerKey, VkSampler> m_Samplers;
+        std::unordered_map<ProgramID, Program> m_Programs;
+        ProgramID m_NextProgramID = 1;
+
+        VulkanImage m_DefaultColor;
+        VulkanImage m_DefaultDepth;
+        VulkanImage m_WhiteTexture;
+        VkSampler m_DefaultSampler = VK_NULL_HANDLE;
+        std::unordered_map<FramebufferID, RenderTarget> m_RenderTargets;
+        FramebufferID m_NextFramebufferID = 1;
+        FramebufferID m_BoundFramebuffer = 0;
+
+        VkClearColorValue m_ClearColor{{0, 0, 0, 1}};
+        RenderState m_RenderState;
+        ProgramID m_BoundProgram = 0;
+        VulkanVertexArray* m_BoundVertexArray = nullptr;
+        std::array<VulkanTexture2D*, MAX_TEXTURE_SLOTS> m_BoundTextures{};
+
+        // Recording state of the submission that isn't submitted yet
+        VkCommandBuffer m_UploadCommands = VK_NULL_HANDLE;
+        VkCommandBuffer m_FrameCommands = VK_NULL_HANDLE;
+        bool m_RenderPassActive = false;
+        VkPipeline m_BoundPipeline = VK_NULL_HANDLE;
+        VkDeviceSize m_StagingOffset = 0;
+        PendingSubmission m_Recording;
+        std::uint64_t m_SubmissionSerial = 1;
+
+        std::deque<PendingSubmission> m_InFlight;
+        Vector<VulkanBuffer> m_FreeStaging;
+        Vector<VkDescriptorPool> m_FreeDescriptorPools;
+
+        std::unordered_map<FenceID, VkFence> m_Fences;
+        FenceID m_NextFenceID = 1;
+    };
+
+}  // namespace JE::detail
@@ -6,8 +6,18 @@ endmacro()
 
 add_library(
   JEngine-Reformed_lib OBJECT
-  src/Platform.cpp src/Graphics/IRendererAPI.cpp
+  src/Platform.cpp src/FramePacer.cpp src/Graphics/IRendererAPI.cpp
   src/Graphics/OpenGLRendererAPI.cpp src/Graphics/Renderer.cpp
+  src/Graphics/Culling.cpp src/Graphics/BatchTransform.cpp
+  src/Graphics/Texture.cpp src/Graphics/OpenGLTexture.cpp
+  src/Graphics/TextureProcessing.cpp src/Graphics/TextureFile.cpp
+  src/Graphics/TextureAtlas.cpp src/Graphics/RenderGraph.cpp
+  src/Graphics/OcclusionCulling.cpp src/Graphics/MeshLOD.cpp
+  src/Graphics/FrameCapture.cpp src/Graphics/SoftwareRasterizer.cpp
+  src/Graphics/SoftwareRendererAPI.cpp src/Graphics/DynamicResolution.cpp
+  src/Graphics/ResourceTracker.cpp src/Graphics/OffsetAllocator.cpp
+  src/Graphics/GeometryPool.cpp src/Graphics/OpenGLObjectPool.cpp
+  src/Graphics/PipelineState.cpp
 
   # Audio
   src/Sound/ImpulseAudio.cpp
@@ -21,6 +31,8 @@ target_include_directories(
 
 target_compile_features(JEngine-Reformed_lib PUBLIC cxx_std_20)
 
+find_package(Threads REQUIRED)
+
 target_link_system_libraries(
   JEngine-Reformed_lib
   PUBLIC
@@ -29,7 +41,25 @@ target_link_system_libraries(
   SDL2::SDL2
   glm::glm
   Tracy::TracyClient
-  glad::glad)
+  glad::glad
+  Threads::Threads)
+
+default(JE_VULKAN_ENABLED_VALUE 0)
+
+if(JEngine-Reformed_ENABLE_VULKAN)
+  find_package(Vulkan REQUIRED)
+  target_sources(
+    JEngine-Reformed_lib PRIVATE src/Graphics/VulkanDevice.cpp
+                                 src/Graphics/VulkanRendererAPI.cpp)
+  target_link_system_libraries(
+    JEngine-Reformed_lib
+    PUBLIC
+    Vulkan::Vulkan
+    glslang
+    SPIRV
+    glslang-default-resource-limits)
+  set(JE_VULKAN_ENABLED_VALUE 1)
+endif()
 
 default(JE_PLATFORM_WINDOWS_VALUE 0)
 default(JE_PLATFORM_UNIX_VALUE 0)
@@ -69,6 +99,9 @@ target_compile_definitions(
   JEngine-Reformed_lib
   PUBLIC JE_PLATFORM_CLANG_ENV_VALUE=${JE_PLATFORM_CLANG_ENV_VALUE})
 
+target_compile_definitions(
+  JEngine-Reformed_lib PUBLIC JE_VULKAN_ENABLED_VALUE=${JE_VULKAN_ENABLED_VALUE})
+
 target_compile_definitions(
   JEngine-Reformed_lib
   PUBLIC
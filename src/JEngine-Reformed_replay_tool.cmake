@@ -0,0 +1,11 @@
+add_executable(JEngine-Reformed_replay_tool src/ReplayTool.cpp)
+add_executable(JEngine-Reformed::replay_tool ALIAS
+               JEngine-Reformed_replay_tool)
+
+set_property(TARGET JEngine-Reformed_replay_tool
+             PROPERTY OUTPUT_NAME JEngine-ReplayTool)
+
+target_compile_features(JEngine-Reformed_replay_tool PRIVATE cxx_std_20)
+
+target_link_libraries(JEngine-Reformed_replay_tool
+                      PRIVATE JEngine-Reformed::lib)
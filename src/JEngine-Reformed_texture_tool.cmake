@@ -0,0 +1,12 @@
+add_executable(JEngine-Reformed_texture_tool src/TextureTool.cpp)
+add_executable(JEngine-Reformed::texture_tool ALIAS
+               JEngine-Reformed_texture_tool)
+
+set_property(TARGET JEngine-Reformed_texture_tool
+             PROPERTY OUTPUT_NAME JEngine-TextureTool)
+
+target_compile_features(JEngine-Reformed_texture_tool PRIVATE cxx_std_20)
+
+target_link_system_libraries(JEngine-Reformed_texture_tool PRIVATE stb::stb)
+target_link_libraries(JEngine-Reformed_texture_tool
+                      PRIVATE JEngine-Reformed::lib)
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "Assert.hpp"
+#include "Memory.hpp"
+
+namespace JE
+{
+
+    /// Bounded lock-free queue any number of threads can push into and a single thread pops from. Every cell carries
+    /// a sequence number telling producers and the consumer whose turn it is, pushing never blocks or allocates
+    template<typename T>
+    class MPSCQueue
+    {
+      public:
+        /// Keeps the producer and consumer positions on separate cache lines
+        static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+        MPSCQueue(const MPSCQueue& other) = delete;
+        MPSCQueue(MPSCQueue&& other) = delete;
+        auto operator=(const MPSCQueue& other) -> MPSCQueue& = delete;
+        auto operator=(MPSCQueue&& other) -> MPSCQueue& = delete;
+
+        /// The capacity has to be a power of two
+        explicit MPSCQueue(std::size_t capacity)
+            : m_Cells(CreateScope<Cell[]>(capacity))
+            , m_Mask(capacity - 1)
+        {
+            ASSERT(std::has_single_bit(capacity));
+
+            for (std::size_t i = 0; i < capacity; ++i) {
+                m_Cells[i].Sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+        ~MPSCQueue() = default;
+
+        /// Safe from any thread, false if the queue is full
+        auto TryPush(T value) -> bool
+        {
+            auto position = m_PushPosition.load(std::memory_order_relaxed);
+            for (;;) {
+                auto& cell = m_Cells[position & m_Mask];
+                const auto SEQUENCE = cell.Sequence.load(std::memory_order_acquire);
+                const auto DIFFERENCE = static_cast<std::intptr_t>(SEQUENCE) - static_cast<std::intptr_t>(position);
+                if (DIFFERENCE == 0) {
+                    // The cell is free, claim it by moving the push position past it
+                    if (m_PushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        cell.Value = std::move(value);
+                        cell.Sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (DIFFERENCE < 0) {
+                    // The consumer hasn't popped the value pushed one lap earlier
+                    return false;
+                } else {
+                    position = m_PushPosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /// Only the consumer thread may pop, false if no value was pushed completely yet
+        auto TryPop(T& value) -> bool
+        {
+            auto& cell = m_Cells[m_PopPosition & m_Mask];
+            if (cell.Sequence.load(std::memory_order_acquire) != m_PopPosition + 1) {
+                return false;
+            }
+
+            value = std::move(cell.Value);
+            // Hands the cell to the producer of the next lap
+            cell.Sequence.store(m_PopPosition + m_Mask + 1, std::memory_order_release);
+            ++m_PopPosition;
+            return true;
+        }
+
+        inline auto Capacity() const -> std::size_t { return m_Mask + 1; }
+
+      private:
+        struct Cell
+        {
+            std::atomic<std::size_t> Sequence{0};
+            T Value{};
+        };
+
+        Scope<Cell[]> m_Cells;
+        std::size_t m_Mask;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_PushPosition{0};
+        alignas(CACHE_LINE_SIZE) std::size_t m_PopPosition = 0;
+    };
+
+}  // namespace JE
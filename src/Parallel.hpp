@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+
+#include "Memory.hpp"
+
+namespace JE
+{
+
+    /// 0 means one worker per hardware thread
+    inline auto ResolveWorkerCount(std::uint32_t worker_count) -> std::uint32_t
+    {
+        if (worker_count != 0) {
+            return worker_count;
+        }
+        return std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    /// Runs func for every index in [0, count), indices are handed out to the workers one at a time. The threads are
+    /// spawned on every call, work that runs every frame uses a WorkerPool instead
+    template<typename Func>
+    void ParallelFor(std::size_t count, std::uint32_t worker_count, Func&& func)
+    {
+        const auto THREAD_COUNT = std::min<std::size_t>(ResolveWorkerCount(worker_count), count);
+        if (THREAD_COUNT <= 1) {
+            for (std::size_t i = 0; i < count; ++i) {
+                func(i);
+            }
+            return;
+        }
+
+        std::atomic<std::size_t> next_index{0};
+        auto worker = [&]()
+        {
+            for (auto i = next_index.fetch_add(1); i < count; i = next_index.fetch_add(1)) {
+                func(i);
+            }
+        };
+
+        Vector<std::jthread> threads;
+        threads.reserve(THREAD_COUNT - 1);
+        for (std::size_t i = 1; i < THREAD_COUNT; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+    }
+
+    /// Threads kept alive between ParallelFor calls, the calling thread works alongside them. Only one thread may call
+    /// ParallelFor at a time
+    class WorkerPool
+    {
+      public:
+        WorkerPool(const WorkerPool& other) = delete;
+        WorkerPool(WorkerPool&& other) = delete;
+        auto operator=(const WorkerPool& other) -> WorkerPool& = delete;
+        auto operator=(WorkerPool&& other) -> WorkerPool& = delete;
+
+        /// 0 means one worker per hardware thread
+        explicit WorkerPool(std::uint32_t worker_count = 0)
+            : m_WorkerCount(ResolveWorkerCount(worker_count))
+        {
+            m_Threads.reserve(m_WorkerCount - 1);
+            for (std::uint32_t i = 1; i < m_WorkerCount; ++i) {
+                m_Threads.emplace_back([this](const std::stop_token& stop) { WorkerLoop(stop); });
+            }
+        }
+        ~WorkerPool() = default;
+
+        [[nodiscard]] inline auto WorkerCount() const -> std::uint32_t { return m_WorkerCount; }
+
+        /// Runs func for every index in [0, count) and returns once all of them are done
+        template<typename Func>
+        void ParallelFor(std::size_t count, Func&& func)
+        {
+            if (count <= 1 || m_Threads.empty()) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    func(i);
+                }
+                return;
+            }
+
+            using FuncType = std::remove_reference_t<Func>;
+            Run(count,
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+                const_cast<void*>(static_cast<const void*>(std::addressof(func))),
+                [](void* context, std::size_t index) { (*static_cast<FuncType*>(context))(index); });
+        }
+
+      private:
+        using CallFunction = void (*)(void* context, std::size_t index);
+
+        inline void Run(std::size_t count, void* context, CallFunction call)
+        {
+            {
+                const std::scoped_lock LOCK(m_Mutex);
+                m_Count = count;
+                m_Context = context;
+                m_Call = call;
+                m_NextIndex.store(0, std::memory_order_relaxed);
+                m_BusyThreads = m_Threads.size();
+                ++m_Generation;
+            }
+            m_WorkReady.notify_all();
+
+            Work();
+
+            // func lives on the caller's stack, every thread has to be done with it before returning
+            std::unique_lock lock(m_Mutex);
+            m_WorkDone.wait(lock, [this]() { return m_BusyThreads == 0; });
+        }
+
+        inline void Work()
+        {
+            for (auto i = m_NextIndex.fetch_add(1); i < m_Count; i = m_NextIndex.fetch_add(1)) {
+                m_Call(m_Context, i);
+            }
+        }
+
+        inline void WorkerLoop(const std::stop_token& stop)
+        {
+            std::uint64_t generation = 0;
+            while (true) {
+                {
+                    std::unique_lock lock(m_Mutex);
+                    if (!m_WorkReady.wait(lock, stop, [&]() { return m_Generation != generation; })) {
+                        return;
+                    }
+                    generation = m_Generation;
+                }
+
+                Work();
+
+                const std::scoped_lock LOCK(m_Mutex);
+                if (--m_BusyThreads == 0) {
+                    m_WorkDone.notify_one();
+                }
+            }
+        }
+
+        std::uint32_t m_WorkerCount;
+
+        std::mutex m_Mutex;
+        std::condition_variable_any m_WorkReady;
+        std::condition_variable m_WorkDone;
+        std::uint64_t m_Generation = 0;
+        std::size_t m_BusyThreads = 0;
+
+        std::size_t m_Count = 0;
+        void* m_Context = nullptr;
+        CallFunction m_Call = nullptr;
+        std::atomic<std::size_t> m_NextIndex{0};
+
+        // Declared last so the threads are stopped and joined before the state they use is destroyed
+        Vector<std::jthread> m_Threads;
+    };
+
+}  // namespace JE
@@ -46,4 +46,12 @@ namespace JE
         return EnginePlatform().CreateWindow(title, size);
     }
 
+    // cppcheck-suppress unusedFunction
+    auto SwapWindows(std::span<IWindow* const> windows) -> bool
+    {
+        ASSERT(EnginePlatform().Initialized());
+
+        return EnginePlatform().SwapWindows(windows);
+    }
+
 }  // namespace JE
\ No newline at end of file
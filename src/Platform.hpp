@@ -1,19 +1,30 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
 #include <string_view>
 #include <utility>
 
+#include "Events.hpp"
 #include "Graphics/Renderer.hpp"
 #include "Memory.hpp"
 #include "Types.hpp"
 
 namespace JE
 {
-    class IEventProcessor;
 
     class IGraphicsContext
     {
       public:
+        enum class SwapInterval
+        {
+            IMMEDIATE,
+            VSYNC,
+            ADAPTIVE_VSYNC
+        };
+
         IGraphicsContext(const IGraphicsContext& other) = delete;
         IGraphicsContext(IGraphicsContext&& other) = delete;
         auto operator=(const IGraphicsContext& other) -> IGraphicsContext& = delete;
@@ -24,6 +35,13 @@ namespace JE
 
         virtual auto Created() const -> bool = 0;
         virtual auto SwapBuffers() -> bool = 0;
+        virtual auto SetSwapInterval(SwapInterval interval) -> bool = 0;
+
+        /// Makes the context current on the drawable of its window
+        virtual auto MakeCurrent() -> bool = 0;
+        /// Swaps without making the context current or resetting the framebuffer binding, the context has to be
+        /// current on this window, see IPlatform::SwapWindows
+        virtual auto Present() -> bool = 0;
     };
 
     class IWindow : public IRenderTarget
@@ -48,6 +66,8 @@ namespace JE
 
         virtual auto Created() const -> bool = 0;
         virtual auto GraphicsContext() -> IGraphicsContext& = 0;
+        /// Size of the back buffer in pixels, differs from the window size on high DPI displays
+        virtual auto Size() const -> Size2D = 0;
 
         virtual auto SetWindowMode(WindowMode mode) -> bool = 0;
     };
@@ -56,8 +76,12 @@ namespace JE
     {
         friend class App;
         friend auto CreateWindow(std::string_view title, const Size2D& size) -> IWindow*;
+        friend auto SwapWindows(std::span<IWindow* const> windows) -> bool;
 
       public:
+        /// Events translated per PollEvents call, App drains the queue in batches of this size
+        static constexpr std::size_t EVENT_BATCH_SIZE = 256;
+
         IPlatform(const IPlatform& other) = delete;
         IPlatform(IPlatform&& other) = delete;
         auto operator=(const IPlatform& other) -> IPlatform& = delete;
@@ -70,10 +94,33 @@ namespace JE
         virtual auto Initialized() const -> bool = 0;
         virtual auto GetLastError() const -> std::string_view = 0;
 
+        virtual auto PerformanceCounter() const -> std::uint64_t = 0;
+        virtual auto PerformanceFrequency() const -> std::uint64_t = 0;
+
       private:
         virtual auto Initialize() -> bool = 0;
-        virtual auto PollEvents(IEventProcessor& event_processor) -> bool = 0;
+        /// Writes up to events.size() pending events in queue order and returns how many, fewer than requested means
+        /// the queue was drained
+        virtual auto PollEvents(std::span<Event> events) -> std::size_t = 0;
         virtual auto CreateWindow(std::string_view title, const Size2D& size) -> IWindow* = 0;
+
+        /// Presents every window rendered this frame. The framebuffer binding is reset once, windows share their
+        /// context's state. Swapping in reverse render order starts with the window that is still current, every
+        /// other window is made current right before its own swap
+        virtual auto SwapWindows(std::span<IWindow* const> windows) -> bool
+        {
+            if (windows.empty()) {
+                return true;
+            }
+
+            bool success = windows.back()->GraphicsContext().MakeCurrent();
+            success = RendererAPI().BindFramebuffer(0) && success;
+            for (auto* window : std::views::reverse(windows)) {
+                auto& context = window->GraphicsContext();
+                success = context.MakeCurrent() && context.Present() && success;
+            }
+            return success;
+        }
     };
 
     namespace detail  // NOLINT(readability-identifier-naming)
@@ -92,5 +139,6 @@ namespace JE
 
     auto EnginePlatform() -> IPlatform&;
     auto CreateWindow(std::string_view title, const Size2D& size = IWindow::DEFAULT_WINDOW_SIZE) -> IWindow*;
+    auto SwapWindows(std::span<IWindow* const> windows) -> bool;
 
 }  // namespace JE
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "Application.hpp"
+#include "Graphics/FrameCapture.hpp"
+#include "Logger.hpp"
+
+namespace
+{
+
+    constexpr std::string_view USAGE =
+        "Usage: JEngine-ReplayTool <capture file> [options]\n"
+        "  --frames <count>  Times the capture is replayed (default 100)";
+
+    struct Arguments
+    {
+        std::string_view Capture;
+        std::uint32_t Frames = 100;
+    };
+
+    auto ParseArguments(std::span<char*> args) -> std::optional<Arguments>
+    {
+        constexpr std::size_t REQUIRED_ARGUMENTS = 2;
+        if (args.size() < REQUIRED_ARGUMENTS) {
+            return std::nullopt;
+        }
+
+        Arguments arguments;
+        arguments.Capture = args[1];
+        for (std::size_t i = REQUIRED_ARGUMENTS; i < args.size(); ++i) {
+            const std::string_view OPTION = args[i];
+            if (OPTION != "--frames" || i + 1 >= args.size()) {
+                return std::nullopt;
+            }
+            const std::string_view VALUE = args[++i];
+            const auto [END, ERROR_CODE] =
+                std::from_chars(VALUE.data(), VALUE.data() + VALUE.size(), arguments.Frames);
+            if (ERROR_CODE != std::errc{} || END != VALUE.data() + VALUE.size() || arguments.Frames == 0) {
+                return std::nullopt;
+            }
+        }
+        return arguments;
+    }
+
+}  // namespace
+
+auto main(int argc, char** argv) -> std::int32_t
+{
+    const auto ARGUMENTS = ParseArguments({argv, static_cast<std::size_t>(argc)});
+    if (!ARGUMENTS) {
+        JE::AppLogger()->error("{}", USAGE);
+        return -1;
+    }
+
+    if (!JE::Application().Initialized()) {
+        return -1;
+    }
+
+    auto capture = JE::FrameCapture::Read(ARGUMENTS->Capture);
+    if (!capture) {
+        return -1;
+    }
+
+    JE::FrameReplay replay{std::move(*capture)};
+    JE::AppLogger()->info("Replaying {} commands, {} meshes, {} shaders, {} textures",
+                          replay.Capture().Commands().size(),
+                          replay.Capture().Meshes().size(),
+                          replay.Capture().Shaders().size(),
+                          replay.Capture().Textures().size());
+
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    Milliseconds total{0};
+    Milliseconds fastest{std::numeric_limits<double>::max()};
+    Milliseconds slowest{0};
+    for (std::uint32_t frame = 0; frame < ARGUMENTS->Frames; ++frame) {
+        JE::ResourceTracker().BeginFrame();
+        const auto START = std::chrono::steady_clock::now();
+
+        // Finish so the timing covers the GPU work instead of only the submission
+        if (!replay.Replay(JE::Application().Renderer(), JE::Application().MainWindow())
+            || !JE::RendererAPI().Finish()) {
+            JE::AppLogger()->error("Replay of frame {} failed", frame);
+            return -1;
+        }
+
+        const auto ELAPSED = Milliseconds(std::chrono::steady_clock::now() - START);
+        total += ELAPSED;
+        fastest = std::min(fastest, ELAPSED);
+        slowest = std::max(slowest, ELAPSED);
+
+        JE::Application().MainWindow().GraphicsContext().SwapBuffers();
+        // Objects the replay released are only deleted once the frames using them are done
+        JE::RendererAPI().EndFrame();
+    }
+
+    JE::AppLogger()->info("{} frames - min {:.3f} ms, avg {:.3f} ms, max {:.3f} ms",
+                          ARGUMENTS->Frames,
+                          fastest.count(),
+                          total.count() / ARGUMENTS->Frames,
+                          slowest.count());
+
+    const auto STATISTICS = JE::ResourceTracker().Statistics();
+    JE::AppLogger()->info("Uploads per frame - last {} bytes, peak {} bytes",
+                          STATISTICS.FrameUploadBytes,
+                          STATISTICS.PeakFrameUploadBytes);
+    return 0;
+}
@@ -1,4 +1,13 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string_view>
+
 #include <glad/gl.h>
 
 #define SDL_MAIN_HANDLED
@@ -6,6 +15,7 @@
 #include <SDL2/SDL_error.h>
 #include <SDL2/SDL_events.h>
 #include <SDL2/SDL_main.h>
+#include <SDL2/SDL_timer.h>
 #include <SDL2/SDL_video.h>
 
 #include "Assert.hpp"
@@ -39,10 +49,18 @@ namespace JE::detail
 
         SDLOpenGLGraphicsContext() { InitializeOpenGLParameters(); }
 
+        /// Every window renders with the same context, GL objects like vertex arrays and framebuffers aren't shared
+        /// between contexts and switching between windows only changes the drawable
         inline void Initialize(SDL_Window* window)
         {
             m_Window = window;
 
+            if (sSharedContext != nullptr) {
+                m_Context = sSharedContext;
+                ++sContextUsers;
+                return;
+            }
+
             auto* previous_window = SDL_GL_GetCurrentWindow();
             auto* previous_context = SDL_GL_GetCurrentContext();
 
@@ -51,6 +69,8 @@ namespace JE::detail
                 EngineLogger()->error("Failed to create SDL OpenGL context: {}", SDL_GetError());
                 return;
             }
+            sSharedContext = m_Context;
+            ++sContextUsers;
 
             if (SDL_GL_MakeCurrent(window, m_Context) != 0) {
                 EngineLogger()->error("Failed to make SDL OpenGL context current: {}", SDL_GetError());
@@ -95,9 +115,52 @@ namespace JE::detail
             const bool OPENGL_SUCCESS = RendererAPI().BindFramebuffer(0);
             SDL_GL_SwapWindow(m_Window);
 
+            return OPENGL_SUCCESS;
+        }
+
+        inline auto MakeCurrent() -> bool override
+        {
+            if (SDL_GL_GetCurrentWindow() == m_Window && SDL_GL_GetCurrentContext() == m_Context) {
+                return true;
+            }
+            if (SDL_GL_MakeCurrent(m_Window, m_Context) != 0) {
+                EngineLogger()->error("Failed to make SDL OpenGL context current: {}", SDL_GetError());
+                return false;
+            }
+            return true;
+        }
+
+        inline auto Present() -> bool override
+        {
+            // SDL 2 doesn't return the result of the swap, a failed swap (e.g. of a window that isn't current) only
+            // sets the error
+            SDL_ClearError();
+            SDL_GL_SwapWindow(m_Window);
+            const std::string_view ERROR = SDL_GetError();
+            if (!ERROR.empty()) {
+                EngineLogger()->error("Failed to swap SDL window: {}", ERROR);
+                return false;
+            }
+            return true;
+        }
+
+        inline auto SetSwapInterval(SwapInterval interval) -> bool override
+        {
+            MakeContextCurrent();
+
+            bool success = SDL_GL_SetSwapInterval(SwapIntervalToSDLSwapInterval(interval)) == 0;
+            if (!success && interval == SwapInterval::ADAPTIVE_VSYNC) {
+                EngineLogger()->warn("Adaptive vsync is not supported, falling back to vsync: {}", SDL_GetError());
+                success = SDL_GL_SetSwapInterval(SwapIntervalToSDLSwapInterval(SwapInterval::VSYNC)) == 0;
+            }
+
+            if (!success) {
+                EngineLogger()->error("Failed to set SDL OpenGL swap interval: {}", SDL_GetError());
+            }
+
             RestorePreviousContext();
 
-            return OPENGL_SUCCESS;
+            return success;
         }
 
         inline void MakeContextCurrent()
@@ -105,14 +168,19 @@ namespace JE::detail
             m_PreviousWindow = SDL_GL_GetCurrentWindow();
             m_PreviousContext = SDL_GL_GetCurrentContext();
 
-            SDL_GL_MakeCurrent(m_Window, m_Context);
+            // Rendering every window in a row would otherwise make the same window current over and over
+            if (m_PreviousWindow != m_Window || m_PreviousContext != m_Context) {
+                SDL_GL_MakeCurrent(m_Window, m_Context);
+            }
         }
 
         inline void RestorePreviousContext()
         {
-            if ((m_PreviousWindow == nullptr || m_PreviousContext == nullptr)
-                && (m_PreviousWindow == m_Window || m_PreviousContext == m_Context))
+            if (m_PreviousWindow == nullptr || m_PreviousContext == nullptr
+                || (m_PreviousWindow == m_Window && m_PreviousContext == m_Context))
             {
+                m_PreviousWindow = nullptr;
+                m_PreviousContext = nullptr;
                 return;
             }
 
@@ -123,12 +191,26 @@ namespace JE::detail
 
         ~SDLOpenGLGraphicsContext() override
         {
-            if (m_Context != nullptr) {
+            if (m_Context != nullptr && --sContextUsers == 0) {
                 SDL_GL_DeleteContext(m_Context);
+                sSharedContext = nullptr;
             }
         }
 
       private:
+        static constexpr auto SwapIntervalToSDLSwapInterval(SwapInterval interval) -> std::int32_t
+        {
+            switch (interval) {
+                case SwapInterval::VSYNC:
+                    return 1;
+                case SwapInterval::ADAPTIVE_VSYNC:
+                    return -1;
+                case SwapInterval::IMMEDIATE:
+                default:
+                    return 0;
+            }
+        }
+
         static inline void InitializeOpenGLParameters()
         {
             std::uint32_t flags = SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG;
@@ -147,7 +229,6 @@ namespace JE::detail
             SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, DEPTH_BUFFER_BITS);
             SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, BITS_PER_COLOR);
             SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
-            SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
         }
 
         SDL_Window* m_Window = nullptr;
@@ -157,6 +238,8 @@ namespace JE::detail
         SDL_GLContext m_PreviousContext = nullptr;
 
         static inline bool sGladInitialized = false;
+        static inline SDL_GLContext sSharedContext = nullptr;
+        static inline std::size_t sContextUsers = 0;
     };
 
     class SDLWindow final : public IWindow
@@ -187,9 +270,17 @@ namespace JE::detail
 
         inline auto GraphicsContext() -> IGraphicsContext& override { return *m_GraphicsContext; }
 
+        inline auto Size() const -> Size2D override
+        {
+            Size2D size;
+            SDL_GL_GetDrawableSize(m_Window, &size.X, &size.Y);
+            return size;
+        }
+
         inline void Bind() override { m_GraphicsContext->MakeContextCurrent(); }
 
-        inline void Unbind() override { m_GraphicsContext->RestorePreviousContext(); }
+        /// The context stays current, every window shares it so the next Bind only switches the drawable
+        inline void Unbind() override {}
 
         inline auto SetWindowMode(WindowMode mode) -> bool override
         {
@@ -217,6 +308,102 @@ namespace JE::detail
         SDL_Window* m_Window = nullptr;
     };
 
+    struct SDLEventTranslation
+    {
+        using Translator = auto (*)(const SDL_Event& event) -> Event;
+
+        std::uint32_t SDLType;
+        Translator Translate;
+    };
+
+    /// Every SDL event type the engine has an event for, SDL keycodes are the values of KeyCode
+    inline constexpr std::array SDL_EVENT_TRANSLATIONS{
+        SDLEventTranslation{SDL_QUIT, []([[maybe_unused]] const SDL_Event& event) -> Event { return QuitEvent{}; }},
+        SDLEventTranslation{SDL_WINDOWEVENT,
+                            [](const SDL_Event& event) -> Event
+                            {
+                                // Size changed is sent for every resize, resized only for the ones from outside
+                                switch (event.window.event) {
+                                    case SDL_WINDOWEVENT_SIZE_CHANGED:
+                                        return WindowResizeEvent{{event.window.data1, event.window.data2}};
+                                    case SDL_WINDOWEVENT_CLOSE:
+                                        return WindowCloseEvent{};
+                                    default:
+                                        return UnknownEvent{};
+                                }
+                            }},
+        SDLEventTranslation{SDL_KEYDOWN,
+                            [](const SDL_Event& event) -> Event {
+                                return KeyDownEvent{static_cast<KeyCode>(event.key.keysym.sym),
+                                                    event.key.state == SDL_PRESSED};
+                            }},
+        SDLEventTranslation{SDL_KEYUP,
+                            [](const SDL_Event& event) -> Event {
+                                return KeyUpEvent{static_cast<KeyCode>(event.key.keysym.sym),
+                                                  event.key.state == SDL_PRESSED};
+                            }},
+        SDLEventTranslation{SDL_TEXTINPUT,
+                            [](const SDL_Event& event) -> Event {
+                                return TextInputEvent{std::string_view{static_cast<const char*>(event.text.text)}};
+                            }},
+        SDLEventTranslation{SDL_MOUSEMOTION,
+                            [](const SDL_Event& event) -> Event {
+                                return MouseMoveEvent{glm::vec2{event.motion.xrel, event.motion.yrel},
+                                                      glm::vec2{event.motion.x, event.motion.y}};
+                            }},
+        SDLEventTranslation{SDL_MOUSEBUTTONDOWN,
+                            [](const SDL_Event& event) -> Event {
+                                return MouseButtonDownEvent{static_cast<MouseButton>(event.button.button),
+                                                            glm::vec2{event.button.x, event.button.y}};
+                            }},
+        SDLEventTranslation{SDL_MOUSEBUTTONUP,
+                            [](const SDL_Event& event) -> Event {
+                                return MouseButtonUpEvent{static_cast<MouseButton>(event.button.button),
+                                                          glm::vec2{event.button.x, event.button.y}};
+                            }},
+        SDLEventTranslation{SDL_MOUSEWHEEL,
+                            [](const SDL_Event& event) -> Event
+                            {
+                                const auto SIGN = event.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -1.f : 1.f;
+                                return MouseWheelEvent{SIGN * glm::vec2{event.wheel.x, event.wheel.y}};
+                            }}};
+
+    /// SDL numbers its event types in blocks of 0x100 per category, the first types of each block index the table
+    inline constexpr std::uint32_t SDL_EVENT_BLOCK_SHIFT = 8;
+    inline constexpr std::uint32_t SDL_EVENT_BLOCK_SLOTS = 8;
+    inline constexpr std::uint32_t SDL_EVENT_BLOCK_COUNT = (SDL_MOUSEMOTION >> SDL_EVENT_BLOCK_SHIFT) + 1;
+
+    constexpr auto SDLEventSlot(std::uint32_t sdl_type) -> std::optional<std::size_t>
+    {
+        const auto BLOCK = sdl_type >> SDL_EVENT_BLOCK_SHIFT;
+        const auto OFFSET = sdl_type & ((1U << SDL_EVENT_BLOCK_SHIFT) - 1);
+        if (BLOCK >= SDL_EVENT_BLOCK_COUNT || OFFSET >= SDL_EVENT_BLOCK_SLOTS) {
+            return std::nullopt;
+        }
+        return std::size_t{BLOCK} * SDL_EVENT_BLOCK_SLOTS + OFFSET;
+    }
+
+    /// SDL_EVENT_TRANSLATIONS indexed by SDLEventSlot, a type that doesn't fit a slot fails to compile
+    inline constexpr auto SDL_EVENT_TRANSLATORS = []()
+    {
+        std::array<SDLEventTranslation::Translator, std::size_t{SDL_EVENT_BLOCK_COUNT} * SDL_EVENT_BLOCK_SLOTS>
+            translators{};
+        for (const auto& translation : SDL_EVENT_TRANSLATIONS) {
+            translators[SDLEventSlot(translation.SDLType).value()] = translation.Translate;
+        }
+        return translators;
+    }();
+
+    /// Each SDL event becomes exactly one engine event, types missing from the table become an UnknownEvent
+    inline auto TranslateSDLEvent(const SDL_Event& event) -> Event
+    {
+        const auto SLOT = SDLEventSlot(event.type);
+        if (!SLOT || SDL_EVENT_TRANSLATORS[*SLOT] == nullptr) {
+            return UnknownEvent{};
+        }
+        return SDL_EVENT_TRANSLATORS[*SLOT](event);
+    }
+
     class SDLPlatform final : public IPlatform
     {
       public:
@@ -233,6 +420,9 @@ namespace JE::detail
 
         inline auto GetLastError() const -> std::string_view override { return SDL_GetError(); }
 
+        inline auto PerformanceCounter() const -> std::uint64_t override { return SDL_GetPerformanceCounter(); }
+        inline auto PerformanceFrequency() const -> std::uint64_t override { return SDL_GetPerformanceFrequency(); }
+
         ~SDLPlatform() override
         {
             if (m_PlatformInitialized) {
@@ -257,36 +447,23 @@ namespace JE::detail
             return m_PlatformInitialized;
         }
 
-        inline auto PollEvents(IEventProcessor& event_processor) -> bool override
+        inline auto PollEvents(std::span<Event> events) -> std::size_t override
         {
             ASSERT(m_PlatformInitialized);
 
-            SDL_Event event;
-            const bool EVENTS_PENDING = SDL_PollEvent(&event) == 1;
-            if (EVENTS_PENDING) {
-                if (event.type == SDL_QUIT) {
-                    QuitEvent evnt{};
-                    event_processor.ProcessEvent(evnt);
-                }
-                if (event.type == SDL_KEYDOWN) {
-                    KeyDownEvent evnt{static_cast<KeyCode>(event.key.keysym.sym), static_cast<bool>(event.key.state)};
-                    event_processor.ProcessEvent(evnt);
-                }
-                if (event.type == SDL_KEYUP) {
-                    KeyUpEvent evnt{static_cast<KeyCode>(event.key.keysym.sym), static_cast<bool>(event.key.state)};
-                    event_processor.ProcessEvent(evnt);
-                }
-                if (event.type == SDL_MOUSEMOTION) {
-                    MouseMoveEvent evnt{glm::vec2{event.motion.xrel, event.motion.yrel},
-                                        glm::vec2{event.motion.x, event.motion.y}};
-                    event_processor.ProcessEvent(evnt);
-                } else {
-                    UnknownEvent evnt{};
-                    event_processor.ProcessEvent(evnt);
-                }
+            // One pump and one locked queue access per batch instead of per event
+            SDL_PumpEvents();
+            const auto MAX_COUNT = static_cast<int>(std::min(events.size(), m_SDLEvents.size()));
+            const auto COUNT =
+                SDL_PeepEvents(m_SDLEvents.data(), MAX_COUNT, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+            if (COUNT < 0) {
+                EngineLogger()->error("Failed to poll events: {}", SDL_GetError());
+                return 0;
             }
 
-            return EVENTS_PENDING;
+            const auto SDL_EVENTS = std::span{m_SDLEvents}.first(static_cast<std::size_t>(COUNT));
+            std::ranges::transform(SDL_EVENTS, events.begin(), TranslateSDLEvent);
+            return SDL_EVENTS.size();
         }
 
         inline auto CreateWindow(std::string_view title, const Size2D& size) -> IWindow* override
@@ -296,6 +473,7 @@ namespace JE::detail
 
         bool m_PlatformInitialized = false;
         Vector<Scope<SDLWindow>> m_Windows;
+        std::array<SDL_Event, EVENT_BATCH_SIZE> m_SDLEvents{};
     };
 
 }  // namespace JE::detail
\ No newline at end of file
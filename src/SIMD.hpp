@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#    define JE_SIMD_X86 1
+#    include <immintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#    endif
+#else
+#    define JE_SIMD_X86 0
+#endif
+
+// Functions using instructions beyond the baseline are compiled for them individually and only called after the
+// runtime check, MSVC allows the intrinsics anywhere
+#if JE_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#    define JE_TARGET_AVX2 __attribute__((target("avx2,fma")))  // NOLINT(cppcoreguidelines-macro-usage)
+#else
+#    define JE_TARGET_AVX2  // NOLINT(cppcoreguidelines-macro-usage)
+#endif
+
+namespace JE
+{
+
+    enum class SIMDLevel
+    {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    namespace detail  // NOLINT(readability-identifier-naming)
+    {
+
+        inline auto DetectSIMDLevel() -> SIMDLevel
+        {
+#if JE_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                return SIMDLevel::AVX2;
+            }
+            return __builtin_cpu_supports("sse2") ? SIMDLevel::SSE2 : SIMDLevel::SCALAR;
+#elif JE_SIMD_X86 && defined(_MSC_VER)
+            static constexpr int EXTENDED_FEATURES_LEAF = 7;
+            static constexpr int AVX2_BIT = 5;
+            static constexpr int FMA_BIT = 12;
+            static constexpr int OSXSAVE_BIT = 27;
+            static constexpr int SSE2_BIT = 26;
+            static constexpr unsigned long long AVX_STATE_MASK = 0x6;
+
+            std::array<int, 4> registers{};  // EAX, EBX, ECX, EDX
+            __cpuid(registers.data(), 1);
+            const bool SSE2 = (registers[3] & (1 << SSE2_BIT)) != 0;
+            const bool FMA = (registers[2] & (1 << FMA_BIT)) != 0;
+            // The OS also has to save the AVX registers on context switches
+            const bool AVX_STATE = (registers[2] & (1 << OSXSAVE_BIT)) != 0
+                && (_xgetbv(0) & AVX_STATE_MASK) == AVX_STATE_MASK;
+
+            __cpuidex(registers.data(), EXTENDED_FEATURES_LEAF, 0);
+            const bool AVX2 = (registers[1] & (1 << AVX2_BIT)) != 0;
+
+            if (AVX2 && FMA && AVX_STATE) {
+                return SIMDLevel::AVX2;
+            }
+            return SSE2 ? SIMDLevel::SSE2 : SIMDLevel::SCALAR;
+#else
+            return SIMDLevel::SCALAR;
+#endif
+        }
+
+    }  // namespace detail
+
+    /// Highest instruction set supported by the CPU the engine is running on, detected once
+    inline auto HostSIMDLevel() -> SIMDLevel
+    {
+        static const SIMDLevel s_Level = detail::DetectSIMDLevel();
+        return s_Level;
+    }
+
+}  // namespace JE
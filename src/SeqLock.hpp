@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace JE
+{
+
+    /// Value written by a single thread and copied out by any number of threads without locking. A sequence number
+    /// is odd while a write is in progress, readers retry if it changed during their copy. The value is held in
+    /// atomic words so a copy overlapping a write is never a data race, it's only thrown away
+    template<typename T>
+    class SeqLock
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        static_assert(sizeof(T) % sizeof(std::uint64_t) == 0);
+
+      public:
+        static constexpr std::size_t WORD_COUNT = sizeof(T) / sizeof(std::uint64_t);
+
+        SeqLock(const SeqLock& other) = delete;
+        SeqLock(SeqLock&& other) = delete;
+        auto operator=(const SeqLock& other) -> SeqLock& = delete;
+        auto operator=(SeqLock&& other) -> SeqLock& = delete;
+
+        explicit SeqLock(const T& value = {}) { Store(value); }
+        ~SeqLock() = default;
+
+        /// Only one thread may store
+        void Store(const T& value)
+        {
+            const auto WORDS = std::bit_cast<Words>(value);
+
+            const auto SEQUENCE = m_Sequence.load(std::memory_order_relaxed);
+            m_Sequence.store(SEQUENCE + 1, std::memory_order_relaxed);
+            // Readers seeing any of the new words also see the odd sequence number
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+                m_Words[i].store(WORDS[i], std::memory_order_relaxed);
+            }
+            m_Sequence.store(SEQUENCE + 2, std::memory_order_release);
+        }
+
+        /// Safe from any thread, false if a store overlapped the copy and value was left unchanged
+        auto TryLoad(T& value) const -> bool
+        {
+            const auto BEFORE = m_Sequence.load(std::memory_order_acquire);
+            if ((BEFORE & 1U) != 0) {
+                return false;
+            }
+
+            Words words{};
+            for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+                words[i] = m_Words[i].load(std::memory_order_relaxed);
+            }
+            // The words have to be read before the sequence number is checked again
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_Sequence.load(std::memory_order_relaxed) != BEFORE) {
+                return false;
+            }
+
+            value = std::bit_cast<T>(words);
+            return true;
+        }
+
+        /// Safe from any thread, retries until a copy didn't overlap a store
+        auto Load() const -> T
+        {
+            T value{};
+            while (!TryLoad(value)) {
+            }
+            return value;
+        }
+
+      private:
+        using Words = std::array<std::uint64_t, WORD_COUNT>;
+
+        std::atomic<std::uint64_t> m_Sequence{0};
+        std::array<std::atomic<std::uint64_t>, WORD_COUNT> m_Words{};
+    };
+
+}  // namespace JE
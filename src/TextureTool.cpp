@@ -0,0 +1,286 @@
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include "Graphics/TextureAtlas.hpp"
+#include "Graphics/TextureFile.hpp"
+#include "Graphics/TextureProcessing.hpp"
+#include "Logger.hpp"
+#include "Memory.hpp"
+
+namespace
+{
+
+    constexpr std::string_view USAGE =
+        "Usage: JEngine-TextureTool <input image> <output.dds> [options]\n"
+        "       JEngine-TextureTool --atlas <output name> <input images...> [options]\n"
+        "  --format <bc1|bc1-srgb|bc3|bc3-srgb|rgba8|srgba8>  Output format (default bc3-srgb)\n"
+        "  --filter <box|lanczos|kaiser>                      Mip filter (default kaiser)\n"
+        "  --wrap <repeat|mirror|clamp>                       Edge addressing while filtering (default repeat)\n"
+        "  --no-mips                                          Only store the top level\n"
+        "  --threads <count>                                  Worker threads, 0 uses every core (default 0)\n"
+        "  --page-size <pixels>                               Atlas page width and height (default 2048)\n"
+        "  --padding <pixels>                                 Extruded border around atlas images (default 1)";
+
+    template<typename T>
+    struct NamedValue
+    {
+        std::string_view Name;
+        T Value;
+    };
+
+    constexpr std::array FORMATS = {
+        NamedValue<JE::TextureFormat>{"bc1", JE::TextureFormat::BC1_RGBA},
+        NamedValue<JE::TextureFormat>{"bc1-srgb", JE::TextureFormat::BC1_SRGB_ALPHA},
+        NamedValue<JE::TextureFormat>{"bc3", JE::TextureFormat::BC3_RGBA},
+        NamedValue<JE::TextureFormat>{"bc3-srgb", JE::TextureFormat::BC3_SRGB_ALPHA},
+        NamedValue<JE::TextureFormat>{"rgba8", JE::TextureFormat::RGBA8},
+        NamedValue<JE::TextureFormat>{"srgba8", JE::TextureFormat::SRGB8_ALPHA8},
+    };
+
+    constexpr std::array FILTERS = {
+        NamedValue<JE::MipFilter>{"box", JE::MipFilter::BOX},
+        NamedValue<JE::MipFilter>{"lanczos", JE::MipFilter::LANCZOS3},
+        NamedValue<JE::MipFilter>{"kaiser", JE::MipFilter::KAISER},
+    };
+
+    constexpr std::array WRAPS = {
+        NamedValue<JE::TextureWrap>{"repeat", JE::TextureWrap::REPEAT},
+        NamedValue<JE::TextureWrap>{"mirror", JE::TextureWrap::MIRRORED_REPEAT},
+        NamedValue<JE::TextureWrap>{"clamp", JE::TextureWrap::CLAMP_TO_EDGE},
+    };
+
+    template<typename T, std::size_t SIZE>
+    auto FindValue(const std::array<NamedValue<T>, SIZE>& values, std::string_view name) -> std::optional<T>
+    {
+        for (const auto& value : values) {
+            if (value.Name == name) {
+                return value.Value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    struct Arguments
+    {
+        JE::Vector<std::string_view> Inputs;
+        std::string_view Output;
+        JE::TextureProcessingOptions Options{JE::TextureFormat::BC3_SRGB_ALPHA};
+        /// Inputs are packed into atlas pages written as <Output>_<page>.dds plus an <Output>.atlas region list
+        bool Atlas = false;
+        JE::AtlasOptions AtlasOptions;
+    };
+
+    template<typename T>
+    auto ParseNumber(std::string_view text, T& value) -> bool
+    {
+        const auto [END, ERROR_CODE] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return ERROR_CODE == std::errc{} && END == text.data() + text.size();
+    }
+
+    auto ParseArguments(std::span<char*> args) -> std::optional<Arguments>
+    {
+        constexpr std::size_t REQUIRED_ARGUMENTS = 3;
+        if (args.size() < REQUIRED_ARGUMENTS) {
+            return std::nullopt;
+        }
+
+        Arguments arguments;
+        std::size_t first_option = REQUIRED_ARGUMENTS;
+        if (std::string_view{args[1]} == "--atlas") {
+            arguments.Atlas = true;
+            arguments.Output = args[2];
+            for (; first_option < args.size() && !std::string_view{args[first_option]}.starts_with("--");
+                 ++first_option) {
+                arguments.Inputs.emplace_back(args[first_option]);
+            }
+            if (arguments.Inputs.empty()) {
+                return std::nullopt;
+            }
+        } else {
+            arguments.Inputs.emplace_back(args[1]);
+            arguments.Output = args[2];
+        }
+
+        for (std::size_t i = first_option; i < args.size(); ++i) {
+            const std::string_view OPTION = args[i];
+            if (OPTION == "--no-mips") {
+                arguments.Options.GenerateMipmaps = false;
+                continue;
+            }
+
+            if (i + 1 >= args.size()) {
+                return std::nullopt;
+            }
+            const std::string_view VALUE = args[++i];
+
+            if (OPTION == "--format") {
+                const auto FORMAT = FindValue(FORMATS, VALUE);
+                if (!FORMAT) {
+                    return std::nullopt;
+                }
+                arguments.Options.Format = *FORMAT;
+            } else if (OPTION == "--filter") {
+                const auto FILTER = FindValue(FILTERS, VALUE);
+                if (!FILTER) {
+                    return std::nullopt;
+                }
+                arguments.Options.Filter = *FILTER;
+            } else if (OPTION == "--wrap") {
+                const auto WRAP = FindValue(WRAPS, VALUE);
+                if (!WRAP) {
+                    return std::nullopt;
+                }
+                arguments.Options.Wrap = *WRAP;
+            } else if (OPTION == "--threads") {
+                if (!ParseNumber(VALUE, arguments.Options.WorkerCount)) {
+                    return std::nullopt;
+                }
+            } else if (OPTION == "--page-size") {
+                std::int32_t page_size = 0;
+                if (!ParseNumber(VALUE, page_size) || page_size <= 0) {
+                    return std::nullopt;
+                }
+                arguments.AtlasOptions.PageSize = {page_size, page_size};
+            } else if (OPTION == "--padding") {
+                if (!ParseNumber(VALUE, arguments.AtlasOptions.Padding) || arguments.AtlasOptions.Padding < 0) {
+                    return std::nullopt;
+                }
+            } else {
+                return std::nullopt;
+            }
+        }
+
+        return arguments;
+    }
+
+    constexpr int RGBA_CHANNELS = 4;
+
+    auto LoadSourceImage(std::string_view path) -> std::optional<JE::Image>
+    {
+        JE::Size2D size;
+        int channels = 0;
+        auto* pixels = stbi_load(std::string{path}.c_str(), &size.X, &size.Y, &channels, RGBA_CHANNELS);
+        if (pixels == nullptr) {
+            JE::AppLogger()->error("Failed to load {} - {}", path, stbi_failure_reason());
+            return std::nullopt;
+        }
+
+        const auto PIXEL_COUNT = static_cast<std::size_t>(size.X) * static_cast<std::size_t>(size.Y);
+        auto image = JE::ImageFromRGBA8(size, {pixels, PIXEL_COUNT * RGBA_CHANNELS});
+        stbi_image_free(pixels);
+        return image;
+    }
+
+    auto WriteTexture(const JE::Image& image, const JE::TextureProcessingOptions& options, const std::string& output)
+        -> bool
+    {
+        const auto START = std::chrono::steady_clock::now();
+        const auto DATA = JE::ProcessTexture(image, options);
+        const auto ELAPSED = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - START);
+
+        if (!JE::WriteTextureFile(std::filesystem::path{output}, DATA)) {
+            return false;
+        }
+
+        std::size_t output_bytes = 0;
+        std::size_t rgba8_bytes = 0;
+        for (std::uint32_t level = 0; level < DATA.Description.MipLevels; ++level) {
+            const auto LEVEL_SIZE = JE::MipLevelSize(image.Size, level);
+            output_bytes += DATA.Levels[level].size();
+            rgba8_bytes +=
+                static_cast<std::size_t>(LEVEL_SIZE.X) * static_cast<std::size_t>(LEVEL_SIZE.Y) * RGBA_CHANNELS;
+        }
+        JE::AppLogger()->info("{}x{} ({} levels) -> {} in {:.1f} ms, {} bytes ({:.2f}x smaller than RGBA8)",
+                              image.Size.X,
+                              image.Size.Y,
+                              DATA.Description.MipLevels,
+                              output,
+                              ELAPSED.count(),
+                              output_bytes,
+                              static_cast<double>(rgba8_bytes) / static_cast<double>(output_bytes));
+        return true;
+    }
+
+    auto WriteAtlas(const Arguments& arguments) -> bool
+    {
+        JE::Vector<JE::Image> images;
+        for (const auto INPUT : arguments.Inputs) {
+            auto image = LoadSourceImage(INPUT);
+            if (!image) {
+                return false;
+            }
+            images.push_back(std::move(*image));
+        }
+
+        // Keep every image on its own blocks so compression never mixes neighbours
+        auto atlas_options = arguments.AtlasOptions;
+        if (JE::IsCompressedFormat(arguments.Options.Format)) {
+            const auto INFO = JE::GetTextureFormatInfo(arguments.Options.Format);
+            atlas_options.Alignment = static_cast<std::int32_t>(INFO.BlockWidth);
+        }
+
+        const auto BUILD = JE::BuildAtlas(images, atlas_options);
+        if (!BUILD) {
+            return false;
+        }
+
+        // Mips of an atlas page would blend neighbouring images
+        auto page_options = arguments.Options;
+        page_options.GenerateMipmaps = false;
+        for (std::size_t page = 0; page < BUILD->Pages.size(); ++page) {
+            if (!WriteTexture(BUILD->Pages[page], page_options, fmt::format("{}_{}.dds", arguments.Output, page))) {
+                return false;
+            }
+        }
+
+        const auto REGIONS_PATH = fmt::format("{}.atlas", arguments.Output);
+        std::ofstream regions{REGIONS_PATH};
+        for (std::size_t i = 0; i < BUILD->Regions.size(); ++i) {
+            const auto& region = BUILD->Regions[i];
+            regions << fmt::format("{} {} {} {} {} {}\n",
+                                   arguments.Inputs[i],
+                                   region.Page,
+                                   region.Rect.X,
+                                   region.Rect.Y,
+                                   region.Rect.Width,
+                                   region.Rect.Height);
+        }
+
+        JE::AppLogger()->info("Packed {} images into {} pages, regions written to {}",
+                              images.size(),
+                              BUILD->Pages.size(),
+                              REGIONS_PATH);
+        return regions.good();
+    }
+
+}  // namespace
+
+auto main(int argc, char** argv) -> std::int32_t
+{
+    const auto ARGUMENTS = ParseArguments({argv, static_cast<std::size_t>(argc)});
+    if (!ARGUMENTS) {
+        JE::AppLogger()->error("{}", USAGE);
+        return -1;
+    }
+
+    if (ARGUMENTS->Atlas) {
+        return WriteAtlas(*ARGUMENTS) ? 0 : -1;
+    }
+
+    const auto IMAGE = LoadSourceImage(ARGUMENTS->Inputs.front());
+    if (!IMAGE) {
+        return -1;
+    }
+
+    return WriteTexture(*IMAGE, ARGUMENTS->Options, std::string{ARGUMENTS->Output}) ? 0 : -1;
+}
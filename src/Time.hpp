@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+#include "Assert.hpp"
+#include "Platform.hpp"
+
+namespace JE
+{
+
+    /// std::chrono compatible clock built on the platform high resolution performance counter
+    struct PerformanceClock
+    {
+        using rep = std::int64_t;  // NOLINT(readability-identifier-naming)
+        using period = std::nano;  // NOLINT(readability-identifier-naming)
+        using duration = std::chrono::duration<rep, period>;  // NOLINT(readability-identifier-naming)
+        using time_point = std::chrono::time_point<PerformanceClock>;  // NOLINT(readability-identifier-naming)
+
+        static constexpr bool is_steady = true;  // NOLINT(readability-identifier-naming)
+
+        static inline auto now() -> time_point  // NOLINT(readability-identifier-naming)
+        {
+            static constexpr auto NANOSECONDS_PER_SECOND = std::uint64_t{std::nano::den};
+
+            const auto COUNTER = EnginePlatform().PerformanceCounter();
+            const auto FREQUENCY = EnginePlatform().PerformanceFrequency();
+
+            // Split into whole seconds and remainder so the multiplication can't overflow
+            const auto SECONDS = COUNTER / FREQUENCY;
+            const auto REMAINDER = COUNTER % FREQUENCY;
+            const auto NANOSECONDS = SECONDS * NANOSECONDS_PER_SECOND + REMAINDER * NANOSECONDS_PER_SECOND / FREQUENCY;
+
+            return time_point{duration{static_cast<rep>(NANOSECONDS)}};
+        }
+    };
+
+    /// Accumulator for running simulation at a fixed rate independent of the render rate
+    class FixedTimestep
+    {
+      public:
+        using Duration = PerformanceClock::duration;
+
+        static constexpr std::uint32_t DEFAULT_UPDATE_RATE = 60;
+        static constexpr std::uint32_t DEFAULT_MAX_SUBSTEPS = 8;
+
+        explicit FixedTimestep(std::uint32_t update_rate = DEFAULT_UPDATE_RATE,
+                               std::uint32_t max_substeps = DEFAULT_MAX_SUBSTEPS)
+        {
+            SetUpdateRate(update_rate);
+            SetMaxSubsteps(max_substeps);
+        }
+
+        inline void SetUpdateRate(std::uint32_t update_rate)
+        {
+            ASSERT(update_rate != 0);
+
+            m_UpdateRate = std::max(update_rate, 1u);
+            m_StepDuration = std::chrono::duration_cast<Duration>(std::chrono::seconds{1}) / m_UpdateRate;
+        }
+
+        inline void SetMaxSubsteps(std::uint32_t max_substeps)
+        {
+            ASSERT(max_substeps != 0);
+            m_MaxSubsteps = std::max(max_substeps, 1u);
+        }
+
+        /// Adds elapsed frame time, anything beyond MaxSubsteps worth of steps is dropped to avoid a death spiral
+        inline void Advance(Duration frame_time)
+        {
+            m_Accumulator += frame_time;
+
+            const auto MAX_ACCUMULATED = m_StepDuration * m_MaxSubsteps;
+            if (m_Accumulator > MAX_ACCUMULATED) {
+                m_DroppedTime += m_Accumulator - MAX_ACCUMULATED;
+                m_Accumulator = MAX_ACCUMULATED;
+            }
+        }
+
+        /// Consumes one fixed step from the accumulator, returns false once there isn't a whole step left
+        inline auto Step() -> bool
+        {
+            if (m_Accumulator < m_StepDuration) {
+                return false;
+            }
+
+            m_Accumulator -= m_StepDuration;
+            ++m_StepCount;
+
+            return true;
+        }
+
+        inline auto UpdateRate() const -> std::uint32_t { return m_UpdateRate; }
+        inline auto MaxSubsteps() const -> std::uint32_t { return m_MaxSubsteps; }
+        inline auto StepDuration() const -> Duration { return m_StepDuration; }
+        inline auto DeltaTime() const -> double { return std::chrono::duration<double>{m_StepDuration}.count(); }
+
+        /// How far between the previous and the next simulation step the rendered frame is [0, 1)
+        inline auto Alpha() const -> double
+        {
+            return std::chrono::duration<double>{m_Accumulator} / std::chrono::duration<double>{m_StepDuration};
+        }
+
+        inline auto StepCount() const -> std::uint64_t { return m_StepCount; }
+        inline auto DroppedTime() const -> Duration { return m_DroppedTime; }
+
+      private:
+        std::uint32_t m_UpdateRate = DEFAULT_UPDATE_RATE;
+        std::uint32_t m_MaxSubsteps = DEFAULT_MAX_SUBSTEPS;
+        Duration m_StepDuration{};
+
+        Duration m_Accumulator{};
+        Duration m_DroppedTime{};
+        std::uint64_t m_StepCount = 0;
+    };
+
+}  // namespace JE
\ No newline at end of file
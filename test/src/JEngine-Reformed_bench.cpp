@@ -0,0 +1,236 @@
+#include <nanobench.h>
+
+////////////////////////////////////////
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <span>
+
+#include <spdlog/sinks/sink.h>
+
+#include "Application.hpp"
+#include "Events.hpp"
+#include "Graphics/Renderer.hpp"
+#include "Logger.hpp"
+#include "Memory.hpp"
+#include "Sound/AudioBuffer.hpp"
+
+#include "TestBackends.hpp"
+
+namespace
+{
+
+    constexpr std::size_t MESH_COUNT = 1000;
+    constexpr std::size_t QUAD_COUNT = 1000;
+    constexpr std::size_t GRID_SIZE = 64;
+    constexpr std::size_t EVENT_COUNT = 256;
+    constexpr std::size_t SAMPLE_COUNT = 4096;
+
+    inline void RunFrame()
+    {
+        // Loop runs until the loop count reaches the argument, not for that many frames
+        JE::Application().Loop(JE::Application().LoopCount() + 1);
+    }
+
+    void BenchRenderer()
+    {
+        auto& renderer = JE::Application().Renderer();
+        auto mesh = JE::CreateTriangleMesh();
+
+        ankerl::nanobench::Bench bench;
+        bench.title("Renderer").relative(true);
+
+        bench.run("Empty frame", [] { RunFrame(); });
+
+        const auto SUBMIT_MESHES = [&]()
+        {
+            renderer.Begin(&JE::Application().MainWindow(), JE::RGBA{0.f, 0.f, 0.f, 1.f});
+            for (std::size_t i = 0; i < MESH_COUNT; ++i) {
+                renderer.DrawMesh(mesh);
+            }
+            renderer.End();
+            RunFrame();
+        };
+        bench.batch(MESH_COUNT).unit("mesh").run("Submit and process meshes", SUBMIT_MESHES);
+
+        const auto SUBMIT_QUADS = [&]()
+        {
+            renderer.Begin(&JE::Application().MainWindow(), JE::RGBA{0.f, 0.f, 0.f, 1.f});
+            for (std::size_t i = 0; i < QUAD_COUNT; ++i) {
+                renderer.DrawQuad(
+                    {1.f, 1.f, 1.f, 1.f}, {static_cast<float>(i), 0.f}, {0.f, 0.f, 0.f}, {1.f, 1.f, 1.f});
+            }
+            renderer.End();
+            RunFrame();
+        };
+        bench.batch(QUAD_COUNT).unit("quad").run("Submit and process quads", SUBMIT_QUADS);
+    }
+
+    void BenchResources()
+    {
+        JE::Vector<JE::VertexType> vertices;
+        JE::Vector<JE::IndexType> indices;
+        for (std::size_t y = 0; y < GRID_SIZE; ++y) {
+            for (std::size_t x = 0; x < GRID_SIZE; ++x) {
+                vertices.emplace_back(static_cast<float>(x), static_cast<float>(y), 0.f);
+                if (x + 1 < GRID_SIZE && y + 1 < GRID_SIZE) {
+                    const auto CORNER = static_cast<JE::IndexType>(y * GRID_SIZE + x);
+                    const auto BELOW = static_cast<JE::IndexType>(CORNER + GRID_SIZE);
+                    indices.insert(indices.end(), {CORNER, CORNER + 1, BELOW, CORNER + 1, BELOW + 1, BELOW});
+                }
+            }
+        }
+
+        ankerl::nanobench::Bench bench;
+        bench.title("Resources");
+
+        bench.run("AttributeLayout construction",
+                  []
+                  {
+                      const JE::AttributeLayout LAYOUT{{"Position", JE::IRendererAPI::Type::FLOAT, 3},
+                                                       {"Color", JE::IRendererAPI::Type::FLOAT, 4},
+                                                       {"TexCoord", JE::IRendererAPI::Type::FLOAT, 2}};
+                      ankerl::nanobench::doNotOptimizeAway(LAYOUT);
+                  });
+
+        const auto UPLOAD_MESH = [&]()
+        {
+            const JE::Mesh MESH{std::span<const JE::VertexType>{vertices}, std::span<const JE::IndexType>{indices}};
+            ankerl::nanobench::doNotOptimizeAway(MESH);
+        };
+        bench.batch(vertices.size()).unit("vertex").run("Mesh upload", UPLOAD_MESH);
+    }
+
+    void BenchEvents()
+    {
+        JE::InputController input_controller;
+
+        ankerl::nanobench::Bench bench;
+        bench.title("Events").batch(EVENT_COUNT).unit("event");
+
+        bench.run("EventDispatcher dispatch",
+                  []
+                  {
+                      std::uint32_t handled = 0;
+                      for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+                          JE::KeyDownEvent event{static_cast<JE::KeyCode>('a' + i % 26), true};
+                          JE::EventDispatcher dispatcher{event};
+                          dispatcher.Dispatch<JE::KeyUpEvent>([](const JE::KeyUpEvent&) { return true; });
+                          dispatcher.Dispatch<JE::KeyDownEvent>(
+                              [&handled](const JE::KeyDownEvent&)
+                              {
+                                  ++handled;
+                                  return true;
+                              });
+                      }
+                      ankerl::nanobench::doNotOptimizeAway(handled);
+                  });
+
+        bench.run("Event variant visit",
+                  []
+                  {
+                      std::uint32_t handled = 0;
+                      const auto HANDLERS = JE::EventHandlers{[](const JE::KeyUpEvent&) { return true; },
+                                                              [&handled](const JE::KeyDownEvent&)
+                                                              {
+                                                                  ++handled;
+                                                                  return true;
+                                                              }};
+                      for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+                          JE::Event event = JE::KeyDownEvent{static_cast<JE::KeyCode>('a' + i % 26), true};
+                          JE::EventDispatcher::Visit(event, HANDLERS);
+                      }
+                      ankerl::nanobench::doNotOptimizeAway(handled);
+                  });
+
+        bench.run("InputController key events",
+                  [&]
+                  {
+                      input_controller.NewFrame();
+                      for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+                          JE::KeyDownEvent event{static_cast<JE::KeyCode>('a' + i % 26), true};
+                          input_controller.ProcessEvent(event);
+                      }
+                  });
+
+        bench.run("InputController key lookups",
+                  [&]
+                  {
+                      std::uint32_t pressed = 0;
+                      for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+                          const auto KEY = static_cast<JE::KeyCode>('a' + i % 26);
+                          pressed += input_controller.KeyPressed(KEY) ? 1U : 0U;
+                          pressed += input_controller.KeyPressedOnce(KEY) ? 1U : 0U;
+                      }
+                      ankerl::nanobench::doNotOptimizeAway(pressed);
+                  });
+    }
+
+    void BenchLogger()
+    {
+        // Only the file sink is measured, console output would dominate and flood the results
+        auto& console_sink = JE::AppLogger()->sinks().front();
+        const auto CONSOLE_LEVEL = console_sink->level();
+        console_sink->set_level(spdlog::level::off);
+
+        ankerl::nanobench::Bench bench;
+        bench.title("Logger");
+
+        bench.run("Formatted message", [] { JE::AppLogger()->trace("Benchmark message {} {:.2f}", 42, 3.14f); });
+
+        JE::AppLogger()->set_level(spdlog::level::info);
+        bench.run("Filtered message", [] { JE::AppLogger()->trace("Benchmark message {} {:.2f}", 42, 3.14f); });
+        JE::AppLogger()->set_level(spdlog::level::trace);
+
+        console_sink->set_level(CONSOLE_LEVEL);
+    }
+
+    void BenchAudio()
+    {
+        std::array<float, SAMPLE_COUNT> samples{};
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            samples[i] = std::sin(static_cast<float>(i) * 2.f * std::numbers::pi_v<float> / SAMPLE_COUNT);
+        }
+        std::array<float, SAMPLE_COUNT> float_output{};
+        std::array<std::int16_t, SAMPLE_COUNT> int_output{};
+        JE::AudioBufferView<float> view{samples};
+
+        ankerl::nanobench::Bench bench;
+        bench.title("Audio").batch(SAMPLE_COUNT).unit("sample");
+
+        bench.run("AudioBufferView::WriteTo float",
+                  [&]
+                  {
+                      view.WriteTo(std::span<float>{float_output}, 0.5f);
+                      ankerl::nanobench::doNotOptimizeAway(float_output);
+                  });
+
+        bench.run("AudioBufferView::WriteTo int16",
+                  [&]
+                  {
+                      constexpr float INT16_SCALE = 32767.f;
+                      view.WriteTo(std::span<std::int16_t>{int_output}, INT16_SCALE);
+                      ankerl::nanobench::doNotOptimizeAway(int_output);
+                  });
+    }
+
+}  // namespace
+
+auto main() -> int
+{
+    JE::detail::InjectCustomEnginePlatform<TestPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    if (!JE::Application().Initialized()) {
+        return -1;
+    }
+
+    BenchRenderer();
+    BenchResources();
+    BenchEvents();
+    BenchLogger();
+    BenchAudio();
+}
@@ -2,10 +2,24 @@
 
 ////////////////////////////////////////
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
+#include <variant>
 
+#include <glm/gtc/matrix_transform.hpp>
 #include <spdlog/fmt/bundled/core.h>
 
 #include "Graphics/IRendererAPI.hpp"
@@ -16,65 +30,40 @@
 #include "Assert.hpp"
 #include "Base.hpp"
 #include "Events.hpp"
+#include "FramePacer.hpp"
+#include "Graphics/BatchTransform.hpp"
+#include "Graphics/BoundingVolumeHierarchy.hpp"
+#include "Graphics/Culling.hpp"
+#include "Graphics/DynamicResolution.hpp"
+#include "Graphics/FrameCapture.hpp"
+#include "Graphics/GeometryPool.hpp"
+#include "Graphics/MeshLOD.hpp"
+#include "Graphics/OffsetAllocator.hpp"
+#include "Graphics/OcclusionCulling.hpp"
+#include "Graphics/OpenGLObjectPool.hpp"
+#include "Graphics/PipelineState.hpp"
+#include "Graphics/RenderGraph.hpp"
 #include "Graphics/Renderer.hpp"
+#include "Graphics/ResourceTracker.hpp"
+#include "Graphics/SoftwareRasterizer.hpp"
+#include "Graphics/SoftwareRendererAPI.hpp"
+#include "Graphics/Texture.hpp"
+#include "Graphics/TextureAtlas.hpp"
+#include "Graphics/TextureFile.hpp"
+#include "Graphics/TextureProcessing.hpp"
+#if JE_VULKAN_ENABLED_VALUE
+#include "Graphics/VulkanRendererAPI.hpp"
+#endif
 #include "Logger.hpp"
+#include "MPSCQueue.hpp"
 #include "Memory.hpp"
+#include "Parallel.hpp"
 #include "Platform.hpp"
+#include "SDL/SDLPlatform.hpp"
+#include "SIMD.hpp"
+#include "Time.hpp"
 
-struct TestGraphicsContext : JE::IGraphicsContext
-{
-    inline auto Created() const -> bool override { return true; }
-    inline auto SwapBuffers() -> bool override { return true; }
-};
-
-struct TestWindow : JE::IWindow
-{
-    inline auto Created() const -> bool override { return true; }
-    inline auto GraphicsContext() -> JE::IGraphicsContext& override { return Context; }
-
-    // cppcheck-suppress unusedFunction
-    inline void Bind() override {}
-    // cppcheck-suppress unusedFunction
-    inline void Unbind() override {}
-    // cppcheck-suppress unusedFunction
-    inline auto SetWindowMode([[maybe_unused]] WindowMode mode) -> bool override { return true; }
-
-    TestGraphicsContext Context;
-};
-
-struct TestPlatform : JE::IPlatform
-{
-    inline auto Name() const -> std::string_view override { return "TestPlatform"; }
-
-    inline auto Initialize() -> bool override { return true; }
-    inline auto Initialized() const -> bool override { return true; }
-    inline auto GetLastError() const -> std::string_view override { return ""; }
-
-    inline auto PollEvents([[maybe_unused]] JE::IEventProcessor& event_processor) -> bool override { return false; }
-
-    inline auto CreateWindow([[maybe_unused]] std::string_view title, [[maybe_unused]] const JE::Size2D& size)
-        -> JE::IWindow* override
-    {
-        return Windows.emplace_back(JE::CreateScope<TestWindow>()).get();
-    }
-
-    JE::Vector<JE::Scope<TestWindow>> Windows;
-};
-
-struct TestRendererAPI : JE::IRendererAPI
-{
-    inline auto Name() const -> std::string_view override { return "TestRendererAPI"; }
-
-    inline auto SetClearColor([[maybe_unused]] const JE::RGBA& color) -> bool override { return true; }
-    inline auto ClearFramebuffer([[maybe_unused]] AttachmentFlags flags) -> bool override { return true; }
-    inline auto BindFramebuffer([[maybe_unused]] FramebufferID buffer_id) -> bool override { return true; }
-    inline auto DrawIndexed([[maybe_unused]] Primitive primitive_type,
-                            [[maybe_unused]] std::uint32_t index_count,
-                            [[maybe_unused]] Type index_type) -> bool override
-    {
-        return true;
-    }
-};
+#include "TestBackends.hpp"
 
 TEST_CASE("Test Base macros", "[Base]")
 {
@@ -222,6 +211,297 @@ TEST_CASE("Test EventDispatcher and Event handling", "[Events]")
     REQUIRE(!dispatched);
 }
 
+TEST_CASE("Test value event visiting and Application processing", "[Events]")
+{
+    JE::Event event = JE::KeyDownEvent{JE::KeyCode::A, true};
+    REQUIRE(JE::EventTypeOf(event) == JE::IEvent::EventType::KEY_DOWN);
+
+    // Event types without a handler overload are not dispatched
+    std::uint32_t key_downs = 0;
+    const auto HANDLERS = JE::EventHandlers{[&key_downs]([[maybe_unused]] const JE::KeyDownEvent& evnt)
+                                            {
+                                                ++key_downs;
+                                                return true;
+                                            },
+                                            []([[maybe_unused]] const JE::QuitEvent& evnt) { return true; }};
+    JE::Event mouse_move = JE::MouseMoveEvent{glm::vec2{1.f, 2.f}, glm::vec2{3.f, 4.f}};
+    REQUIRE_FALSE(JE::EventDispatcher::Visit(mouse_move, HANDLERS));
+
+    REQUIRE(JE::EventDispatcher::Visit(event, HANDLERS));
+    REQUIRE(std::get<JE::KeyDownEvent>(event).Handled());
+    REQUIRE_FALSE(JE::EventDispatcher::Visit(event, HANDLERS));
+    REQUIRE(key_downs == 1);
+
+    // Hotkeys see the key without handling it, the InputController records it afterwards
+    bool toggled = false;
+    JE::Application().HotkeyRegister().RegisterAction(JE::KeyCode::B, [&toggled](bool toggle) { toggled = toggle; });
+    JE::Event key_down = JE::KeyDownEvent{JE::KeyCode::B, true};
+    JE::Application().ProcessEvent(key_down);
+    JE::Application().ProcessEvent(mouse_move);
+    REQUIRE(toggled);
+    REQUIRE(JE::Input().KeyPressed(JE::KeyCode::B));
+    REQUIRE(JE::Input().MousePos() == glm::vec2{3.f, 4.f});
+}
+
+TEST_CASE("Test InputController key edges across frames", "[Events]")
+{
+    REQUIRE(JE::KeyIndex(JE::KeyCode::A) == 'a');
+    REQUIRE(JE::KeyIndex(JE::KeyCode::F1) == JE::CHARACTER_KEY_COUNT + static_cast<std::size_t>(JE::ScanCode::F1));
+    REQUIRE(JE::KeyIndex(static_cast<JE::KeyCode>(0xE9)) == JE::INVALID_KEY_INDEX);
+
+    JE::InputController input;
+    input.Handle(JE::KeyDownEvent{JE::KeyCode::A, true});
+    input.Handle(JE::KeyDownEvent{JE::KeyCode::F1, true});
+    input.Handle(JE::MouseMoveEvent{glm::vec2{1.f, 1.f}, glm::vec2{5.f, 6.f}});
+    REQUIRE(input.KeyPressedOnce(JE::KeyCode::A));
+    REQUIRE(input.KeyPressed(JE::KeyCode::F1));
+    REQUIRE_FALSE(input.KeyPressed(JE::KeyCode::B));
+
+    // Held keys and the mouse position carry over, the motion starts over
+    input.NewFrame();
+    REQUIRE(input.KeyPressed(JE::KeyCode::A));
+    REQUIRE_FALSE(input.KeyPressedOnce(JE::KeyCode::A));
+    REQUIRE(input.MousePos() == glm::vec2{5.f, 6.f});
+    REQUIRE(input.MouseFrameMotion() == glm::vec2{0.f, 0.f});
+    REQUIRE(input.PreviousSnapshot().MouseFrameMotion == glm::vec2{1.f, 1.f});
+
+    input.Handle(JE::KeyUpEvent{JE::KeyCode::A, false});
+    REQUIRE(input.KeyReleasedOnce(JE::KeyCode::A));
+
+    // A released key is not pressed once in the following frames
+    input.NewFrame();
+    REQUIRE(input.KeyReleased(JE::KeyCode::A));
+    REQUIRE_FALSE(input.KeyPressedOnce(JE::KeyCode::A));
+    REQUIRE_FALSE(input.KeyReleasedOnce(JE::KeyCode::A));
+}
+
+TEST_CASE("Test published input snapshots read from another thread", "[Events]")
+{
+    JE::InputController input;
+    REQUIRE(input.PublishedSnapshot().Frame == 0);
+
+    input.Handle(JE::KeyDownEvent{JE::KeyCode::W, true});
+    input.Handle(JE::MouseMoveEvent{glm::vec2{2.f, 0.f}, glm::vec2{7.f, 8.f}});
+    input.Publish();
+    const auto FIRST = input.PublishedSnapshot();
+
+    // Changes after publishing stay invisible until the next publish
+    input.NewFrame();
+    input.Handle(JE::KeyUpEvent{JE::KeyCode::W, false});
+
+    JE::InputSnapshot read;
+    std::thread reader{[&input, &read]() { REQUIRE(input.TryReadSnapshot(read)); }};
+    reader.join();
+    REQUIRE(read.Frame == 1);
+    REQUIRE(read.KeyPressed(JE::KeyCode::W));
+    REQUIRE(read.MousePosition == glm::vec2{7.f, 8.f});
+    REQUIRE(read.MouseFrameMotion == glm::vec2{2.f, 0.f});
+
+    // Readers own their copies, later publishes don't touch them
+    input.Publish();
+    REQUIRE(input.PublishedSnapshot().Frame == 2);
+    REQUIRE_FALSE(input.PublishedSnapshot().KeyPressed(JE::KeyCode::W));
+    REQUIRE(FIRST.Frame == 1);
+    REQUIRE(FIRST.KeyPressed(JE::KeyCode::W));
+
+    // The application publishes once per processed frame
+    const auto FRAME = JE::InputState().Frame;
+    JE::Application().Loop(1);
+    REQUIRE(JE::InputState().Frame == FRAME + 1);
+}
+
+TEST_CASE("Test published input snapshots are never torn for slow readers", "[Events]")
+{
+    constexpr std::uint64_t PUBLISH_COUNT = 20000;
+
+    // Every published snapshot has the mouse at (frame, frame) and W pressed on odd frames, a torn copy breaks that
+    const auto CONSISTENT = [](const JE::InputSnapshot& snapshot)
+    {
+        const auto FRAME = static_cast<float>(snapshot.Frame);
+        return snapshot.MousePosition == glm::vec2{FRAME, FRAME}
+               && snapshot.KeyPressed(JE::KeyCode::W) == (snapshot.Frame % 2 == 1);
+    };
+
+    JE::InputController input;
+    std::atomic<bool> publishing = true;
+    std::atomic<bool> torn = false;
+    std::atomic<std::size_t> reads = 0;
+    JE::Vector<std::jthread> readers;
+    // A fast reader copying as often as it can and a slow one holding its copy across many publishes
+    for (const auto DELAY : {std::chrono::microseconds{0}, std::chrono::microseconds{500}}) {
+        readers.emplace_back(
+            [&, DELAY]()
+            {
+                std::uint64_t last_frame = 0;
+                while (publishing) {
+                    JE::InputSnapshot snapshot;
+                    if (!input.TryReadSnapshot(snapshot)) {
+                        continue;
+                    }
+                    std::this_thread::sleep_for(DELAY);
+                    if (!CONSISTENT(snapshot) || snapshot.Frame < last_frame) {
+                        torn = true;
+                    }
+                    last_frame = snapshot.Frame;
+                    ++reads;
+                }
+            });
+    }
+
+    for (std::uint64_t frame = 1; frame <= PUBLISH_COUNT; ++frame) {
+        input.NewFrame();
+        const auto POSITION = static_cast<float>(frame);
+        input.Handle(JE::MouseMoveEvent{glm::vec2{0.f}, glm::vec2{POSITION, POSITION}});
+        input.Handle(JE::KeyDownEvent{JE::KeyCode::W, frame % 2 == 1});
+        input.Publish();
+    }
+    publishing = false;
+    readers.clear();
+
+    REQUIRE_FALSE(torn);
+    REQUIRE(reads > 0);
+    REQUIRE(input.PublishedSnapshot().Frame == PUBLISH_COUNT);
+}
+
+TEST_CASE("Test MPSC event queue with concurrent producers", "[Events]")
+{
+    constexpr std::size_t PRODUCER_COUNT = 4;
+    constexpr std::size_t EVENTS_PER_PRODUCER = 1000;
+
+    // Full queues reject pushes instead of overwriting
+    JE::MPSCQueue<JE::Event> small_queue{2};
+    REQUIRE(small_queue.TryPush(JE::QuitEvent{}));
+    REQUIRE(small_queue.TryPush(JE::QuitEvent{}));
+    REQUIRE_FALSE(small_queue.TryPush(JE::QuitEvent{}));
+
+    JE::MPSCQueue<JE::Event> queue{256};
+    JE::Vector<std::jthread> producers;
+    for (std::size_t producer = 0; producer < PRODUCER_COUNT; ++producer) {
+        producers.emplace_back(
+            [&queue]()
+            {
+                for (std::size_t i = 0; i < EVENTS_PER_PRODUCER; ++i) {
+                    while (!queue.TryPush(JE::MouseMoveEvent{glm::vec2{1.f, 0.f}, glm::vec2{0.f, 0.f}})) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    // Every pushed event is popped exactly once
+    float motion = 0.f;
+    std::size_t popped = 0;
+    JE::Event event;
+    while (popped < PRODUCER_COUNT * EVENTS_PER_PRODUCER) {
+        if (queue.TryPop(event)) {
+            motion += std::get<JE::MouseMoveEvent>(event).Motion().x;
+            ++popped;
+        }
+    }
+    REQUIRE(motion == static_cast<float>(PRODUCER_COUNT * EVENTS_PER_PRODUCER));
+    REQUIRE_FALSE(queue.TryPop(event));
+
+    // Events posted from other threads are processed by the main loop, at most the limit per frame
+    JE::Application().SetMaxPostedEventsPerFrame(1);
+    std::thread{[]()
+                {
+                    JE::PostEvent(JE::KeyDownEvent{JE::KeyCode::A, true});
+                    JE::PostEvent(JE::KeyDownEvent{JE::KeyCode::C, true});
+                }}
+        .join();
+    JE::Application().Loop(1);
+    REQUIRE(JE::Input().KeyPressed(JE::KeyCode::A));
+    REQUIRE_FALSE(JE::Input().KeyPressed(JE::KeyCode::C));
+    JE::Application().Loop(2);
+    REQUIRE(JE::Input().KeyPressed(JE::KeyCode::C));
+
+    // Leave the shared App and InputController as the other tests expect them
+    JE::Application().SetMaxPostedEventsPerFrame(JE::App::DEFAULT_MAX_POSTED_EVENTS_PER_FRAME);
+    JE::PostEvent(JE::KeyUpEvent{JE::KeyCode::A, false});
+    JE::PostEvent(JE::KeyUpEvent{JE::KeyCode::C, false});
+    JE::Application().Loop(3);
+    REQUIRE_FALSE(JE::Input().KeyPressed(JE::KeyCode::A));
+    REQUIRE_FALSE(JE::Input().KeyPressed(JE::KeyCode::C));
+}
+
+TEST_CASE("Test WorkerPool runs every index once and is reused between calls", "[Parallel]")
+{
+    static constexpr std::uint32_t WORKER_COUNT = 4;
+    static constexpr std::size_t INDEX_COUNT = 1000;
+    static constexpr auto CALL_COUNT = 8;
+
+    JE::WorkerPool pool(WORKER_COUNT);
+    REQUIRE(pool.WorkerCount() == WORKER_COUNT);
+
+    std::array<std::atomic<std::uint32_t>, INDEX_COUNT> visits{};
+    for (auto call = 0; call < CALL_COUNT; ++call) {
+        pool.ParallelFor(INDEX_COUNT, [&visits](std::size_t index) { visits[index].fetch_add(1); });
+    }
+    REQUIRE(std::ranges::all_of(visits, [](const auto& visit) { return visit.load() == CALL_COUNT; }));
+
+    // Nothing to do never wakes the workers
+    pool.ParallelFor(0, [](std::size_t) { FAIL("No index to run"); });
+}
+
+TEST_CASE("Test SDL event translation", "[Platform][Events]")
+{
+    // A key event translates to exactly one engine event
+    SDL_Event key{};
+    key.type = SDL_KEYDOWN;
+    key.key.state = SDL_PRESSED;
+    key.key.keysym.sym = static_cast<SDL_Keycode>(JE::KeyCode::W);
+    const auto KEY_DOWN = JE::detail::TranslateSDLEvent(key);
+    REQUIRE(std::holds_alternative<JE::KeyDownEvent>(KEY_DOWN));
+    REQUIRE(std::get<JE::KeyDownEvent>(KEY_DOWN).Code() == JE::KeyCode::W);
+    REQUIRE(std::get<JE::KeyDownEvent>(KEY_DOWN).Pressed());
+
+    SDL_Event motion{};
+    motion.type = SDL_MOUSEMOTION;
+    motion.motion.x = 10;
+    motion.motion.xrel = 2;
+    const auto MOUSE_MOVE = JE::detail::TranslateSDLEvent(motion);
+    REQUIRE(std::get<JE::MouseMoveEvent>(MOUSE_MOVE).Motion() == glm::vec2{2.f, 0.f});
+    REQUIRE(std::get<JE::MouseMoveEvent>(MOUSE_MOVE).Position() == glm::vec2{10.f, 0.f});
+
+    SDL_Event button{};
+    button.type = SDL_MOUSEBUTTONUP;
+    button.button.button = 3;
+    button.button.x = 4;
+    button.button.y = 5;
+    const auto BUTTON_UP = JE::detail::TranslateSDLEvent(button);
+    REQUIRE(std::get<JE::MouseButtonUpEvent>(BUTTON_UP).Button() == JE::MouseButton::RIGHT);
+    REQUIRE(std::get<JE::MouseButtonUpEvent>(BUTTON_UP).Position() == glm::vec2{4.f, 5.f});
+
+    // Flipped wheels report the direction the content moves, the engine event always has the physical direction
+    SDL_Event wheel{};
+    wheel.type = SDL_MOUSEWHEEL;
+    wheel.wheel.y = 1;
+    wheel.wheel.direction = SDL_MOUSEWHEEL_FLIPPED;
+    REQUIRE(std::get<JE::MouseWheelEvent>(JE::detail::TranslateSDLEvent(wheel)).Scroll() == glm::vec2{0.f, -1.f});
+
+    SDL_Event text{};
+    text.type = SDL_TEXTINPUT;
+    std::ranges::copy(std::string_view{"\xC3\xA4!"}, std::begin(text.text.text));
+    REQUIRE(std::get<JE::TextInputEvent>(JE::detail::TranslateSDLEvent(text)).Text() == "\xC3\xA4!");
+
+    SDL_Event window{};
+    window.type = SDL_WINDOWEVENT;
+    REQUIRE(JE::EventTypeOf(JE::detail::TranslateSDLEvent(window)) == JE::IEvent::EventType::UNKNOWN);
+    window.window.event = SDL_WINDOWEVENT_SIZE_CHANGED;
+    window.window.data1 = 640;
+    window.window.data2 = 480;
+    const auto RESIZE = JE::detail::TranslateSDLEvent(window);
+    REQUIRE(std::get<JE::WindowResizeEvent>(RESIZE).Size().X == 640);
+    REQUIRE(std::get<JE::WindowResizeEvent>(RESIZE).Size().Y == 480);
+    window.window.event = SDL_WINDOWEVENT_CLOSE;
+    REQUIRE(JE::EventTypeOf(JE::detail::TranslateSDLEvent(window)) == JE::IEvent::EventType::WINDOW_CLOSE);
+
+    // Types outside of the indexed blocks
+    SDL_Event unknown{};
+    unknown.type = SDL_LASTEVENT;
+    REQUIRE(JE::EventTypeOf(JE::detail::TranslateSDLEvent(unknown)) == JE::IEvent::EventType::UNKNOWN);
+}
+
 TEST_CASE("Test Application initialization failure (Initialization failure)", "[Application]")
 {
     struct InitFailPlatform : TestPlatform
@@ -261,17 +541,16 @@ TEST_CASE("Test Application QuitEvent handling", "[Application][Events]")
 
     struct QuitEventPlatform : TestPlatform
     {
-        inline auto PollEvents(JE::IEventProcessor& event_processor) -> bool override
+        inline auto PollEvents(std::span<JE::Event> events) -> std::size_t override
         {
             if (!EventProcessed) {
-                JE::QuitEvent event;
-                event_processor.ProcessEvent(event);
+                events.front() = JE::QuitEvent{};
 
                 EventProcessed = true;
-                return true;
+                return 1;
             }
 
-            return false;
+            return 0;
         }
 
         bool EventProcessed = false;
@@ -299,4 +578,1563 @@ TEST_CASE("Test Application Renderer command queue processing", "[Application][R
     JE::Application().Loop(1);
 
     REQUIRE(JE::Application().Renderer().CommandQueue().empty());
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test Application multi-window rendering and batched swaps", "[Application][Platform]")
+{
+    static constexpr auto VIEWPORT_COUNT = 3;
+    static constexpr auto LOOP_COUNT = 2;
+
+    struct BatchSwapPlatform : TestPlatform
+    {
+        inline auto SwapWindows(std::span<JE::IWindow* const> windows) -> bool override
+        {
+            ++SwapBatches;
+            SwappedWindows += windows.size();
+            return true;
+        }
+
+        std::size_t SwapBatches = 0;
+        std::size_t SwappedWindows = 0;
+    };
+
+    JE::detail::InjectCustomEnginePlatform<BatchSwapPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+    REQUIRE(JE::Application().Initialized());
+
+    auto renders = 0;
+    for (auto viewport = 0; viewport < VIEWPORT_COUNT; ++viewport) {
+        REQUIRE(JE::Application().CreateViewportWindow(
+                    "Viewport",
+                    [&renders]([[maybe_unused]] JE::IWindow& window, [[maybe_unused]] JE::Renderer& renderer)
+                    { ++renders; })
+                != nullptr);
+    }
+    REQUIRE(JE::Application().Windows().size() == VIEWPORT_COUNT + 1);
+    REQUIRE(JE::Application().Windows().front() == &JE::Application().MainWindow());
+
+    JE::Application().Loop(LOOP_COUNT);
+
+    const auto& platform = static_cast<BatchSwapPlatform&>(JE::EnginePlatform());
+    REQUIRE(renders == VIEWPORT_COUNT * LOOP_COUNT);
+    REQUIRE(platform.SwapBatches == LOOP_COUNT);
+    REQUIRE(platform.SwappedWindows == (VIEWPORT_COUNT + 1) * LOOP_COUNT);
+    // Objects destroyed during the frames are released once per frame after the swap
+    REQUIRE(TestRendererAPI::FramesEnded == LOOP_COUNT);
+}
+
+TEST_CASE("Test batched window swaps make every window current before its swap", "[Application][Platform]")
+{
+    static constexpr auto VIEWPORT_COUNT = 2;
+    static constexpr auto LOOP_COUNT = 3;
+
+    JE::detail::InjectCustomEnginePlatform<TestPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+    REQUIRE(JE::Application().Initialized());
+
+    for (auto viewport = 0; viewport < VIEWPORT_COUNT; ++viewport) {
+        REQUIRE(JE::Application().CreateViewportWindow(
+                    "Viewport",
+                    []([[maybe_unused]] JE::IWindow& window, [[maybe_unused]] JE::Renderer& renderer) {})
+                != nullptr);
+    }
+
+    JE::Application().Loop(LOOP_COUNT);
+
+    // Swapping a window that isn't current fails on real drivers, every window has to be presented every frame
+    REQUIRE(TestGraphicsContext::FailedPresents == 0);
+    for (const auto& window : static_cast<TestPlatform&>(JE::EnginePlatform()).Windows) {
+        REQUIRE(window->Context.Presents == LOOP_COUNT);
+    }
+}
+
+TEST_CASE("Test dynamic resolution PI controller convergence and anti-windup", "[DynamicResolution]")
+{
+    static constexpr auto FRAME_COUNT = 300;
+    static constexpr auto TARGET = std::chrono::milliseconds{10};
+
+    JE::DynamicResolutionSettings settings;
+    settings.TargetFrameTime = TARGET;
+    JE::DynamicResolutionController controller{settings};
+
+    // GPU time grows with the pixel count, at full resolution the scene takes twice the target
+    const auto GPU_TIME = [](std::chrono::milliseconds full_resolution_time, float scale)
+    {
+        return std::chrono::duration_cast<JE::PerformanceClock::duration>(full_resolution_time * scale * scale);
+    };
+
+    for (auto frame = 0; frame < FRAME_COUNT; ++frame) {
+        controller.Update(GPU_TIME(TARGET * 2, controller.Scale()), {});
+    }
+    REQUIRE(std::abs(controller.Scale() - std::sqrt(0.5f)) < 0.01f);
+    REQUIRE(std::abs(controller.SteppedScale() - 0.7f) < 0.001f);
+
+    // Long stretches of headroom don't wind up the integral, the scale comes back down right away
+    for (auto frame = 0; frame < FRAME_COUNT; ++frame) {
+        controller.Update(GPU_TIME(TARGET / 2, controller.Scale()), {});
+    }
+    REQUIRE(controller.Scale() == settings.MaxScale);
+    controller.Update(GPU_TIME(TARGET * 2, controller.Scale()), {});
+    REQUIRE(controller.Scale() < settings.MaxScale);
+
+    // Scenes that can't hit the target at the minimum scale stay there
+    for (auto frame = 0; frame < FRAME_COUNT; ++frame) {
+        controller.Update(GPU_TIME(TARGET * 10, controller.Scale()), {});
+    }
+    REQUIRE(controller.SteppedScale() == settings.MinScale);
+
+    // Without GPU timings the CPU time drives it
+    controller.SetSettings(settings);
+    controller.Update(std::nullopt, TARGET * 2);
+    REQUIRE(controller.Scale() < settings.MaxScale);
+}
+
+TEST_CASE("Test Application dynamic resolution rendering", "[Application][DynamicResolution]")
+{
+    static constexpr auto LOOP_COUNT = 100;
+    static constexpr auto TARGET = std::chrono::milliseconds{10};
+
+    JE::detail::InjectCustomEnginePlatform<TestPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+    REQUIRE(JE::Application().Initialized());
+
+    JE::DynamicResolutionSettings settings;
+    settings.TargetFrameTime = TARGET;
+    JE::Application().SetDynamicResolution(settings);
+    REQUIRE(JE::Application().DynamicResolution() != nullptr);
+
+    TestRendererAPI::TimerQueryNanoseconds = std::chrono::nanoseconds{TARGET * 3}.count();
+    JE::Application().Loop(LOOP_COUNT);
+
+    const auto& dynamic_resolution = *JE::Application().DynamicResolution();
+    const auto WINDOW_SIZE = JE::Application().MainWindow().Size();
+    REQUIRE(TestRendererAPI::TimerQueriesBegun == LOOP_COUNT);
+    REQUIRE(dynamic_resolution.LastGPUTime() == TARGET * 3);
+    REQUIRE(dynamic_resolution.Framebuffer()->Size().X == dynamic_resolution.RenderSize().X);
+    REQUIRE(dynamic_resolution.RenderSize().X < WINDOW_SIZE.X);
+    REQUIRE(dynamic_resolution.RenderSize().Y < WINDOW_SIZE.Y);
+    // The upscale pass is the last draw of a frame and needs a program, core profiles draw nothing without one
+    REQUIRE(TestRendererAPI::LastDrawProgram == JE::Renderer::QUAD_SHADER_NAME);
+
+    TestRendererAPI::TimerQueryNanoseconds = std::chrono::nanoseconds{TARGET / 2}.count();
+    JE::Application().Loop(LOOP_COUNT * 2);
+    REQUIRE(dynamic_resolution.RenderSize().X == WINDOW_SIZE.X);
+    REQUIRE(dynamic_resolution.RenderSize().Y == WINDOW_SIZE.Y);
+
+    JE::Application().SetDynamicResolution(std::nullopt);
+    REQUIRE(JE::Application().DynamicResolution() == nullptr);
+}
+
+TEST_CASE("Test FramePacer frame limiter and frames in flight", "[FramePacer]")
+{
+    static constexpr auto TARGET_FRAME_RATE = 100u;
+    static constexpr auto MAX_FRAMES_IN_FLIGHT = 2u;
+    static constexpr auto FRAME_COUNT = 5;
+
+    JE::detail::InjectCustomEnginePlatform<TestPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    JE::FramePacer pacer;
+    pacer.SetSettings({TARGET_FRAME_RATE, false, MAX_FRAMES_IN_FLIGHT});
+
+    const auto START = JE::FramePacer::Clock::now();
+    for (auto i = 0; i < FRAME_COUNT; ++i) {
+        pacer.BeginFrame();
+        // The first frame has nothing to measure from, the following ones are at least a period apart
+        if (i == 0) {
+            REQUIRE(pacer.FrameTime() == JE::FramePacer::Clock::duration::zero());
+        } else {
+            REQUIRE(pacer.FrameTime() >= std::chrono::milliseconds{1000 / TARGET_FRAME_RATE / 2});
+        }
+        pacer.EndFrame();
+    }
+    const auto ELAPSED = JE::FramePacer::Clock::now() - START;
+
+    // The first frame starts right away, every following frame waits for the next period
+    REQUIRE(ELAPSED >= std::chrono::milliseconds{(FRAME_COUNT - 1) * 1000 / TARGET_FRAME_RATE});
+    REQUIRE(TestRendererAPI::FencesInserted == FRAME_COUNT);
+    REQUIRE(TestRendererAPI::FencesWaited == FRAME_COUNT - MAX_FRAMES_IN_FLIGHT);
+}
+
+TEST_CASE("Test FixedTimestep accumulation, interpolation alpha and substep clamping", "[Time]")
+{
+    static constexpr auto UPDATE_RATE = 100u;
+    static constexpr auto MAX_SUBSTEPS = 4u;
+    static constexpr auto STEP = std::chrono::milliseconds{10};
+    static constexpr auto HALF_STEP = std::chrono::milliseconds{5};
+    static constexpr auto ALPHA_EPSILON = 1e-6;
+
+    JE::FixedTimestep timestep{UPDATE_RATE, MAX_SUBSTEPS};
+    REQUIRE(timestep.StepDuration() == STEP);
+
+    auto steps = 0;
+    timestep.Advance(STEP * 3 + HALF_STEP);
+    while (timestep.Step()) {
+        ++steps;
+    }
+
+    REQUIRE(steps == 3);
+    REQUIRE(std::abs(timestep.Alpha() - 0.5) < ALPHA_EPSILON);
+
+    // A long hitch only runs MAX_SUBSTEPS steps, the rest of the time is dropped
+    steps = 0;
+    timestep.Advance(std::chrono::seconds{1});
+    while (timestep.Step()) {
+        ++steps;
+    }
+
+    REQUIRE(steps == MAX_SUBSTEPS);
+    REQUIRE(timestep.Alpha() < 1.0);
+    REQUIRE(timestep.DroppedTime() > std::chrono::milliseconds{0});
+    REQUIRE(timestep.StepCount() == 3 + MAX_SUBSTEPS);
+}
+
+TEST_CASE("Test mesh bounds and frustum classification", "[Culling]")
+{
+    static constexpr auto EPSILON = 1e-5f;
+
+    const std::array<glm::vec3, 3> VERTICES = {
+        glm::vec3{-1.f, 0.f, 0.f}, glm::vec3{1.f, 2.f, 0.f}, glm::vec3{0.f, 0.f, 4.f}};
+    const auto BOUNDS = JE::ComputeBounds(VERTICES);
+
+    REQUIRE(BOUNDS.Box.Min == glm::vec3{-1.f, 0.f, 0.f});
+    REQUIRE(BOUNDS.Box.Max == glm::vec3{1.f, 2.f, 4.f});
+    REQUIRE(BOUNDS.Sphere.Center == glm::vec3{0.f, 1.f, 2.f});
+    for (const auto& vertex : VERTICES) {
+        REQUIRE(glm::length(vertex - BOUNDS.Sphere.Center) <= BOUNDS.Sphere.Radius + EPSILON);
+    }
+
+    // Identity view projection is the [-1, 1] clip cube
+    const JE::Frustum FRUSTUM{glm::mat4{1.0f}};
+
+    REQUIRE(FRUSTUM.Classify(JE::AABB{glm::vec3{-0.5f}, glm::vec3{0.5f}}) == JE::Frustum::Intersection::INSIDE);
+    REQUIRE(FRUSTUM.Classify(JE::AABB{glm::vec3{0.5f}, glm::vec3{1.5f}}) == JE::Frustum::Intersection::INTERSECTING);
+    REQUIRE(FRUSTUM.Classify(JE::AABB{glm::vec3{2.f}, glm::vec3{3.f}}) == JE::Frustum::Intersection::OUTSIDE);
+    REQUIRE(FRUSTUM.Classify(JE::BoundingSphere{glm::vec3{0.f}, 0.5f}) == JE::Frustum::Intersection::INSIDE);
+    REQUIRE(FRUSTUM.Classify(JE::BoundingSphere{glm::vec3{1.2f, 0.f, 0.f}, 0.5f})
+            == JE::Frustum::Intersection::INTERSECTING);
+    REQUIRE(FRUSTUM.Classify(JE::BoundingSphere{glm::vec3{3.f, 0.f, 0.f}, 0.5f})
+            == JE::Frustum::Intersection::OUTSIDE);
+}
+
+TEST_CASE("Test SIMD AABB culling matches the scalar path", "[Culling]")
+{
+    static constexpr auto BOX_COUNT = 103;
+    static constexpr auto SPACING = 0.25f;
+    static constexpr auto HALF_SIZE = 0.1f;
+
+    JE::AABBBatch boxes;
+    for (auto i = 0; i < BOX_COUNT; ++i) {
+        // Walk diagonally out of the clip cube so there is a mix of visible, intersecting and culled boxes
+        const auto CENTER = glm::vec3{static_cast<float>(i) * SPACING - 2.f, 0.f, static_cast<float>(i % 3) - 1.f};
+        boxes.Add(JE::AABB{CENTER - HALF_SIZE, CENTER + HALF_SIZE});
+    }
+
+    const JE::Frustum FRUSTUM{glm::mat4{1.0f}};
+
+    JE::Vector<std::uint8_t> visibility(BOX_COUNT);
+    JE::Vector<std::uint8_t> scalar_visibility(BOX_COUNT);
+    const auto VISIBLE = JE::CullAABBs(FRUSTUM, boxes, visibility);
+    const auto SCALAR_VISIBLE = JE::detail::CullAABBsScalar(FRUSTUM, boxes, scalar_visibility);
+
+    REQUIRE(VISIBLE == SCALAR_VISIBLE);
+    REQUIRE(VISIBLE > 0);
+    REQUIRE(VISIBLE < BOX_COUNT);
+    REQUIRE(visibility == scalar_visibility);
+}
+
+TEST_CASE("Test BoundingVolumeHierarchy insertion, refit and frustum query", "[Culling]")
+{
+    static constexpr auto GRID_SIZE = 16;
+    static constexpr auto MAX_HEIGHT = 2 * 8 + 1;  // 2 * log2(GRID_SIZE * GRID_SIZE) + 1
+
+    JE::BoundingVolumeHierarchy<int> bvh;
+    JE::Vector<JE::BoundingVolumeHierarchy<int>::NodeID> nodes;
+
+    // Grid of unit boxes spanning [-8, 8], a quarter of them overlap the clip cube
+    for (auto y = 0; y < GRID_SIZE; ++y) {
+        for (auto x = 0; x < GRID_SIZE; ++x) {
+            const auto MIN =
+                glm::vec3{static_cast<float>(x - GRID_SIZE / 2), static_cast<float>(y - GRID_SIZE / 2), 0.f};
+            nodes.push_back(bvh.Insert(JE::AABB{MIN, MIN + 1.f}, y * GRID_SIZE + x));
+        }
+    }
+
+    REQUIRE(bvh.Size() == GRID_SIZE * GRID_SIZE);
+    REQUIRE(bvh.Height() <= MAX_HEIGHT);
+
+    const JE::Frustum FRUSTUM{glm::mat4{1.0f}};
+    const auto COUNT_VISIBLE = [&bvh, &FRUSTUM]()
+    {
+        std::size_t count = 0;
+        bvh.Query(FRUSTUM, [&count]([[maybe_unused]] int value) { ++count; });
+        return count;
+    };
+
+    // Boxes from -2 to 1 touch the [-1, 1] cube on each axis
+    REQUIRE(COUNT_VISIBLE() == 4 * 4);
+
+    // Moving a box far away refits its ancestors and removes it from the query
+    bvh.Update(nodes[(GRID_SIZE / 2) * GRID_SIZE + GRID_SIZE / 2], JE::AABB{glm::vec3{100.f}, glm::vec3{101.f}});
+    REQUIRE(COUNT_VISIBLE() == 4 * 4 - 1);
+    REQUIRE(bvh.Bounds(bvh.Root()).Max == glm::vec3{101.f});
+
+    bvh.Remove(nodes[(GRID_SIZE / 2 - 1) * GRID_SIZE + GRID_SIZE / 2 - 1]);
+    REQUIRE(bvh.Size() == GRID_SIZE * GRID_SIZE - 1);
+    REQUIRE(COUNT_VISIBLE() == 4 * 4 - 2);
+}
+
+TEST_CASE("Test SIMD batch transforms match the scalar path", "[BatchTransform]")
+{
+    static constexpr auto TRANSFORM_COUNT = 37;
+    static constexpr auto EPSILON = 1e-5f;
+
+    JE::TransformBatch transforms;
+    for (auto i = 0; i < TRANSFORM_COUNT; ++i) {
+        const auto VALUE = static_cast<float>(i);
+        // Rotations cover every quadrant, both signs and a few full turns
+        transforms.Add(glm::vec3{VALUE, -VALUE * 0.5f, VALUE * 0.1f},
+                       (VALUE - TRANSFORM_COUNT / 2) * 0.7f,
+                       glm::vec3{1.f + VALUE * 0.25f, 2.f - VALUE * 0.05f, 1.f});
+    }
+
+    const auto APPROX_EQUAL = [](const auto& lhs, const auto& rhs)
+    {
+        return glm::length(lhs - rhs) <= EPSILON * std::max(1.f, glm::length(rhs));
+    };
+
+    JE::Vector<glm::mat4> expected_matrices(TRANSFORM_COUNT);
+    JE::Vector<glm::vec3> expected_corners(TRANSFORM_COUNT * JE::TransformBatch::QUAD_CORNER_COUNT);
+    JE::BuildTransforms(transforms, expected_matrices, JE::SIMDLevel::SCALAR);
+    JE::BuildQuadCorners(transforms, expected_corners, JE::SIMDLevel::SCALAR);
+
+    // The corners are the unit quad transformed by the matrix
+    const auto CORNER = expected_matrices[3] * glm::vec4{-0.5f, 0.5f, 0.f, 1.f};
+    REQUIRE(APPROX_EQUAL(glm::vec3{CORNER.x, CORNER.y, CORNER.z}, expected_corners[3 * 4]));
+
+    for (const auto LEVEL : {JE::SIMDLevel::SSE2, JE::SIMDLevel::AVX2}) {
+        if (JE::EnumToInt(LEVEL) > JE::EnumToInt(JE::HostSIMDLevel())) {
+            continue;
+        }
+
+        JE::Vector<glm::mat4> matrices(TRANSFORM_COUNT);
+        JE::Vector<glm::vec3> corners(TRANSFORM_COUNT * JE::TransformBatch::QUAD_CORNER_COUNT);
+        JE::BuildTransforms(transforms, matrices, LEVEL);
+        JE::BuildQuadCorners(transforms, corners, LEVEL);
+
+        for (std::size_t i = 0; i < matrices.size(); ++i) {
+            for (glm::length_t column = 0; column < 4; ++column) {
+                REQUIRE(APPROX_EQUAL(matrices[i][column], expected_matrices[i][column]));
+            }
+        }
+        for (std::size_t i = 0; i < corners.size(); ++i) {
+            REQUIRE(APPROX_EQUAL(corners[i], expected_corners[i]));
+        }
+    }
+}
+
+TEST_CASE("Test Renderer mesh culling and quad batching", "[Application][Renderer][Culling]")
+{
+    JE::detail::InjectCustomEnginePlatform<TestPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    auto visible_mesh = JE::CreateTriangleMesh();
+    auto culled_mesh = JE::Mesh{{{5.f, 5.f, 0.f}, {6.f, 5.f, 0.f}, {5.f, 6.f, 0.f}}, {0, 1, 2}};
+
+    auto& renderer = JE::Application().Renderer();
+    renderer.Begin(&JE::Application().MainWindow(), JE::RGBA{1.f, 1.f, 1.f, 1.f});
+    renderer.DrawMesh(visible_mesh);
+    renderer.DrawMesh(culled_mesh);
+    for (auto i = 0; i < 3; ++i) {
+        renderer.DrawQuad({1.f, 1.f, 1.f, 1.f}, {static_cast<float>(i), 0.f}, {0.f, 0.f, 0.f}, {1.f, 1.f, 1.f});
+    }
+    renderer.End();
+
+    REQUIRE(renderer.SubmittedMeshCount() == 2);
+    REQUIRE(renderer.CulledMeshCount() == 1);
+
+    JE::Application().Loop(1);
+
+    // The visible mesh, one batch for the three quads and one for the quad the loop draws itself
+    REQUIRE(TestRendererAPI::DrawCalls == 3);
+    REQUIRE(renderer.CulledMeshCount() == 0);
+}
+
+TEST_CASE("Test software occlusion buffer and Renderer occlusion culling", "[Culling][Renderer]")
+{
+    const auto VIEW_PROJECTION = glm::perspective(glm::radians(90.f), 2.f, 0.1f, 100.f)
+                                 * glm::lookAt(glm::vec3{0.f}, glm::vec3{0.f, 0.f, -1.f}, glm::vec3{0.f, 1.f, 0.f});
+
+    // A wall in front of the camera, wound clockwise and counter clockwise
+    const JE::Vector<glm::vec3> WALL = {{-2.f, -2.f, -5.f}, {2.f, -2.f, -5.f}, {2.f, 2.f, -5.f}, {-2.f, 2.f, -5.f}};
+    const JE::Vector<std::uint32_t> WALL_INDICES = {0, 1, 2, 0, 3, 2};
+
+    JE::OcclusionBuffer scalar_buffer{JE::OcclusionBuffer::DEFAULT_SIZE, 1};
+    scalar_buffer.Begin(VIEW_PROJECTION);
+    scalar_buffer.AddOccluder(WALL, WALL_INDICES);
+    // Behind the camera, can't be rasterized without clipping
+    scalar_buffer.AddOccluder(JE::Vector<glm::vec3>{{-1.f, -1.f, 1.f}, {1.f, -1.f, 1.f}, {0.f, 1.f, -1.f}},
+                              JE::Vector<std::uint32_t>{0, 1, 2});
+    REQUIRE(scalar_buffer.TriangleCount() == 2);
+    scalar_buffer.Rasterize(JE::SIMDLevel::SCALAR);
+
+    const auto HIDDEN = JE::AABB{{-0.5f, -0.5f, -10.f}, {0.5f, 0.5f, -9.f}};
+    const auto IN_FRONT = JE::AABB{{-0.5f, -0.5f, -3.f}, {0.5f, 0.5f, -2.f}};
+    const auto BESIDE = JE::AABB{{6.f, -0.5f, -10.f}, {7.f, 0.5f, -9.f}};
+    const auto NEAR_PLANE = JE::AABB{{-0.5f, -0.5f, -10.f}, {0.5f, 0.5f, 1.f}};
+    REQUIRE_FALSE(scalar_buffer.TestAABB(HIDDEN));
+    REQUIRE(scalar_buffer.TestAABB(IN_FRONT));
+    REQUIRE(scalar_buffer.TestAABB(BESIDE));
+    REQUIRE(scalar_buffer.TestAABB(NEAR_PLANE));
+
+    // The top of the pyramid is the farthest depth of the whole buffer, the wall doesn't cover all of it
+    REQUIRE(scalar_buffer.LevelSize(scalar_buffer.LevelCount() - 1).X == 1);
+    REQUIRE(scalar_buffer.Level(scalar_buffer.LevelCount() - 1)[0] == 1.f);
+
+    for (const auto LEVEL : {JE::SIMDLevel::SSE2, JE::SIMDLevel::AVX2}) {
+        if (JE::EnumToInt(LEVEL) > JE::EnumToInt(JE::HostSIMDLevel())) {
+            continue;
+        }
+
+        JE::OcclusionBuffer buffer{JE::OcclusionBuffer::DEFAULT_SIZE, 4};
+        buffer.Begin(VIEW_PROJECTION);
+        buffer.AddOccluder(WALL, WALL_INDICES);
+        buffer.Rasterize(LEVEL);
+        REQUIRE(std::equal(buffer.Depth().begin(), buffer.Depth().end(), scalar_buffer.Depth().begin()));
+    }
+
+    JE::detail::InjectCustomEnginePlatform<TestPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    auto hidden_mesh = JE::Mesh{{{-0.5f, -0.5f, -10.f}, {0.5f, -0.5f, -9.f}, {0.f, 0.5f, -9.5f}}, {0, 1, 2}};
+    auto visible_mesh = JE::Mesh{{{6.f, -0.5f, -10.f}, {7.f, -0.5f, -9.f}, {6.5f, 0.5f, -9.5f}}, {0, 1, 2}};
+
+    auto& renderer = JE::Application().Renderer();
+    renderer.SetViewProjection(VIEW_PROJECTION);
+    renderer.SetOcclusionBuffer(&scalar_buffer);
+    renderer.Begin(&JE::Application().MainWindow(), JE::RGBA{1.f, 1.f, 1.f, 1.f});
+    renderer.DrawMesh(hidden_mesh);
+    renderer.DrawMesh(visible_mesh);
+    renderer.End();
+
+    REQUIRE(renderer.SubmittedMeshCount() == 2);
+    REQUIRE(renderer.CulledMeshCount() == 0);
+    REQUIRE(renderer.OccludedMeshCount() == 1);
+
+    renderer.SetOcclusionBuffer(nullptr);
+    renderer.SetViewProjection(glm::mat4{1.f});
+    JE::Application().Loop(1);
+    REQUIRE(renderer.OccludedMeshCount() == 0);
+}
+
+TEST_CASE("Test mesh simplification, LOD generation and selection with hysteresis", "[MeshLOD][Renderer]")
+{
+    static constexpr std::uint32_t GRID_SIZE = 17;
+
+    // Grid in the xy plane, the height adds bumps which the coarser levels have to approximate
+    const auto GRID = [](float bump_height)
+    {
+        JE::Vector<glm::vec3> vertices;
+        JE::Vector<std::uint32_t> indices;
+        for (std::uint32_t y = 0; y < GRID_SIZE; ++y) {
+            for (std::uint32_t x = 0; x < GRID_SIZE; ++x) {
+                const auto FX = static_cast<float>(x);
+                const auto FY = static_cast<float>(y);
+                vertices.emplace_back(FX, FY, bump_height * std::sin(FX * 0.5f) * std::cos(FY * 0.5f));
+            }
+        }
+        for (std::uint32_t y = 0; y + 1 < GRID_SIZE; ++y) {
+            for (std::uint32_t x = 0; x + 1 < GRID_SIZE; ++x) {
+                const auto CORNER = y * GRID_SIZE + x;
+                indices.insert(indices.end(), {CORNER, CORNER + 1, CORNER + GRID_SIZE + 1});
+                indices.insert(indices.end(), {CORNER, CORNER + GRID_SIZE + 1, CORNER + GRID_SIZE});
+            }
+        }
+        return std::pair{vertices, indices};
+    };
+
+    const auto AREA = [](std::span<const glm::vec3> vertices, std::span<const std::uint32_t> indices)
+    {
+        float area = 0;
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            const auto& a = vertices[indices[i]];
+            area += glm::length(glm::cross(vertices[indices[i + 1]] - a, vertices[indices[i + 2]] - a)) * 0.5f;
+        }
+        return area;
+    };
+
+    // A flat grid collapses without error and keeps its border
+    const auto [PLANE_VERTICES, PLANE_INDICES] = GRID(0.f);
+    const auto PLANE = JE::SimplifyMesh(PLANE_VERTICES, PLANE_INDICES, 6);
+    REQUIRE(PLANE.Indices.size() <= 6);
+    REQUIRE(PLANE.Error < 1e-3f);
+    REQUIRE(std::abs(AREA(PLANE_VERTICES, PLANE.Indices) - AREA(PLANE_VERTICES, PLANE_INDICES)) < 1e-2f);
+    REQUIRE(std::ranges::all_of(PLANE.Indices, [](std::uint32_t index) { return index < GRID_SIZE * GRID_SIZE; }));
+
+    // Nothing is collapsed once the error bound is hit
+    const auto [BUMPY_VERTICES, BUMPY_INDICES] = GRID(1.f);
+    REQUIRE(JE::SimplifyMesh(BUMPY_VERTICES, BUMPY_INDICES, 0, 0.f).Indices.size() == BUMPY_INDICES.size());
+
+    const auto LODS = JE::GenerateLODs(BUMPY_VERTICES, BUMPY_INDICES, 3);
+    REQUIRE(LODS.size() == 3);
+    for (std::size_t i = 0; i < LODS.size(); ++i) {
+        const auto PREVIOUS_COUNT = i == 0 ? BUMPY_INDICES.size() : LODS[i - 1].Indices.size();
+        REQUIRE(LODS[i].Indices.size() <= PREVIOUS_COUNT / 2);
+        REQUIRE(LODS[i].Error > 0.f);
+        REQUIRE((i == 0 || LODS[i].Error >= LODS[i - 1].Error));
+    }
+
+    // Switching to a coarser level needs the error 25% below the threshold, switching back 25% above it
+    const JE::Vector<JE::MeshLOD> LEVELS = {{0, 6, 0.f}, {6, 3, 0.01f}};
+    const JE::LODSettings SETTINGS{0.001f, 0.25f, true};
+    REQUIRE(JE::SelectLOD(LEVELS, 0.08f, 0, SETTINGS) == 0);
+    REQUIRE(JE::SelectLOD(LEVELS, 0.07f, 0, SETTINGS) == 1);
+    REQUIRE(JE::SelectLOD(LEVELS, 0.12f, 1, SETTINGS) == 1);
+    REQUIRE(JE::SelectLOD(LEVELS, 0.13f, 1, SETTINGS) == 0);
+    REQUIRE(JE::SelectLOD(LEVELS, 0.f, 1, JE::LODSettings{0.001f, 0.25f, false}) == 0);
+
+    JE::detail::InjectCustomEnginePlatform<TestPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    auto mesh = JE::Mesh{BUMPY_VERTICES, BUMPY_INDICES};
+    mesh.GenerateLODs(2);
+    REQUIRE(mesh.LODs().size() == 3);
+    REQUIRE(mesh.Indices().size() == BUMPY_INDICES.size());
+    REQUIRE(mesh.LODIndices(2).size() == LODS[1].Indices.size());
+
+    // The mesh covers the whole screen up close and a fraction of a pixel far away
+    const auto DRAW_FROM = [&mesh](float distance)
+    {
+        auto& renderer = JE::Application().Renderer();
+        renderer.SetViewProjection(glm::perspective(glm::radians(60.f), 1.f, 0.1f, 100000.f)
+                                   * glm::lookAt(glm::vec3{8.f, 8.f, distance},
+                                                 glm::vec3{8.f, 8.f, 0.f},
+                                                 glm::vec3{0.f, 1.f, 0.f}));
+        renderer.Begin(&JE::Application().MainWindow(), JE::RGBA{1.f, 1.f, 1.f, 1.f});
+        renderer.DrawMesh(mesh);
+        renderer.End();
+        for (const auto& command : renderer.CommandQueue()) {
+            command();
+        }
+        const auto FIRST_INDEX = TestRendererAPI::LastFirstIndex;
+
+        renderer.SetViewProjection(glm::mat4{1.f});
+        JE::Application().Loop(1);
+        return FIRST_INDEX;
+    };
+
+    // Levels are index ranges inside the mesh's range of the geometry pool
+    const auto FIRST_INDEX = mesh.Geometry().Range().FirstIndex;
+    REQUIRE(DRAW_FROM(20.f) == FIRST_INDEX);
+    REQUIRE(mesh.CurrentLOD() == 0);
+    REQUIRE(DRAW_FROM(50000.f) == FIRST_INDEX + mesh.LODs()[2].FirstIndex);
+    REQUIRE(mesh.CurrentLOD() == 2);
+}
+
+TEST_CASE("Test frame capture round trip and replay", "[FrameCapture][Renderer]")
+{
+    JE::detail::InjectCustomEnginePlatform<TestPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    auto mesh = JE::CreateTriangleMesh();
+    auto shader_program = JE::CreateShader("Capture shader", "vertex source", "fragment source");
+    auto texture = JE::CreateTexture2D({{4, 4}, JE::TextureFormat::RGBA8, 1});
+
+    JE::FrameCapture capture;
+    auto& renderer = JE::Application().Renderer();
+    renderer.SetFrameCapture(&capture);
+    renderer.Begin(&JE::Application().MainWindow(), JE::RGBA{0.f, 0.5f, 1.f, 1.f});
+    renderer.DrawMesh(mesh, *shader_program);
+    renderer.DrawMesh(mesh, *shader_program);
+    renderer.DrawQuad(
+        JE::Sprite{texture.get()}, {1.f, 0.5f, 0.25f, 1.f}, {0.f, 0.f}, {0.f, 0.f, 0.f}, {1.f, 1.f, 1.f});
+    renderer.End();
+    renderer.SetFrameCapture(nullptr);
+    JE::Application().Loop(1);
+
+    // Both draws share the copied mesh and shader
+    REQUIRE(capture.Commands().size() == 5);
+    REQUIRE(capture.Meshes().size() == 1);
+    REQUIRE(capture.Shaders().size() == 1);
+    REQUIRE(capture.Textures().size() == 1);
+    REQUIRE(capture.QuadCorners().size() == 4);
+    REQUIRE(capture.QuadColors()[3] == glm::vec4{1.f, 0.5f, 0.25f, 1.f});
+    REQUIRE(capture.Commands()[0].ClearColor.G() == 0.5f);
+    REQUIRE(capture.Commands()[1].Count == mesh.Indices().size());
+    REQUIRE(capture.Shaders()[0].FragmentSource == "fragment source");
+
+    const auto PATH = std::filesystem::temp_directory_path() / "JEngine-Reformed_capture_test.jefc";
+    REQUIRE(capture.Write(PATH));
+    auto read = JE::FrameCapture::Read(PATH);
+    std::filesystem::remove(PATH);
+    REQUIRE(read.has_value());
+    REQUIRE(read->Commands().size() == capture.Commands().size());
+    REQUIRE(read->Meshes()[0].Indices == capture.Meshes()[0].Indices);
+    REQUIRE(read->Shaders()[0].DebugName == "Capture shader");
+    REQUIRE(read->Textures()[0].Size.X == 4);
+    REQUIRE(read->QuadTexCoords() == capture.QuadTexCoords());
+    REQUIRE(read->QuadColors() == capture.QuadColors());
+
+    JE::FrameReplay replay{std::move(*read)};
+    const auto DRAW_CALLS = TestRendererAPI::DrawCalls;
+    REQUIRE(replay.Replay(renderer, JE::Application().MainWindow()));
+    REQUIRE(TestRendererAPI::DrawCalls - DRAW_CALLS == 3);
+
+    REQUIRE_FALSE(JE::FrameCapture::Read(PATH).has_value());
+}
+
+TEST_CASE("Test Texture mip chain and budgeted streaming uploads", "[Texture]")
+{
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    constexpr std::size_t ROW_BYTES = 64 * 4;
+    constexpr std::size_t LEVEL_BYTES = ROW_BYTES * 64;
+
+    const auto TEXTURE = JE::Ref<JE::ITexture2D>{
+        JE::CreateTexture2D({{64, 64}, JE::TextureFormat::RGBA8, JE::TextureDescription::FULL_MIP_CHAIN})};
+    REQUIRE(TEXTURE->MipLevels() == 7);
+    REQUIRE(TEXTURE->LevelSize(6).X == 1);
+    REQUIRE(TEXTURE->LevelSize(6).Y == 1);
+    REQUIRE(TEXTURE->LevelByteSize(0) == LEVEL_BYTES);
+    REQUIRE(TEXTURE->LevelByteSize(1) == LEVEL_BYTES / 4);
+
+    JE::Vector<std::byte> pixels(LEVEL_BYTES);
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+        pixels[i] = static_cast<std::byte>(i % 251);
+    }
+
+    auto uploader = JE::CreateTextureUploader(LEVEL_BYTES / 4);
+    uploader->Upload(TEXTURE, 0, pixels);
+    REQUIRE_FALSE(TEXTURE->Ready());
+    REQUIRE(uploader->PendingBytes() == LEVEL_BYTES);
+
+    for (auto frame = 1; frame <= 4; ++frame) {
+        REQUIRE(uploader->Process() == LEVEL_BYTES / 4);
+        REQUIRE(uploader->PendingBytes() == LEVEL_BYTES - static_cast<std::size_t>(frame) * (LEVEL_BYTES / 4));
+        REQUIRE(TEXTURE->Ready() == (frame == 4));
+    }
+    REQUIRE(uploader->Idle());
+    REQUIRE(uploader->Process() == 0);
+    REQUIRE(static_cast<TestTexture2D&>(*TEXTURE).Levels[0] == pixels);
+
+    // A budget smaller than a single row still uploads one row per frame
+    uploader->SetFrameBudget(ROW_BYTES / 2);
+    uploader->Upload(TEXTURE, 0, pixels);
+    REQUIRE(uploader->Process() == ROW_BYTES);
+    REQUIRE(uploader->PendingBytes() == LEVEL_BYTES - ROW_BYTES);
+    REQUIRE_FALSE(TEXTURE->Ready());
+
+    // Rows of a failed submit stay queued and are staged again
+    static_cast<TestTextureUploader&>(*uploader).FailSubmits = true;
+    REQUIRE(uploader->Process() == 0);
+    REQUIRE(uploader->PendingBytes() == LEVEL_BYTES - ROW_BYTES);
+    static_cast<TestTextureUploader&>(*uploader).FailSubmits = false;
+    REQUIRE(uploader->Process() == ROW_BYTES);
+    REQUIRE(uploader->PendingBytes() == LEVEL_BYTES - 2 * ROW_BYTES);
+}
+
+TEST_CASE("Test GPU resource accounting, upload statistics and memory budgets", "[ResourceTracker]")
+{
+    using JE::ResourceType;
+
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    auto& tracker = JE::ResourceTracker();
+    const auto BASELINE = tracker.Statistics();
+    const auto BYTES = [&tracker](ResourceType type) { return tracker.Statistics()[type].Bytes; };
+    const auto COUNT = [&tracker](ResourceType type) { return tracker.Statistics()[type].Count; };
+
+    constexpr std::size_t VERTEX_BYTES = 3 * sizeof(JE::VertexType);
+    constexpr std::size_t INDEX_BYTES = 3 * sizeof(JE::IndexType);
+    constexpr std::size_t PAGE_VERTEX_BYTES =
+        JE::GeometryPoolSettings::DEFAULT_PAGE_VERTEX_COUNT * sizeof(JE::VertexType);
+    constexpr std::size_t PAGE_INDEX_BYTES = JE::GeometryPoolSettings::DEFAULT_PAGE_INDEX_COUNT * sizeof(JE::IndexType);
+    {
+        // The first mesh allocates a page of the geometry pool and uploads only its own data into it
+        auto mesh = JE::CreateTriangleMesh();
+        REQUIRE(COUNT(ResourceType::VERTEX_BUFFER) == BASELINE[ResourceType::VERTEX_BUFFER].Count + 1);
+        REQUIRE(COUNT(ResourceType::ELEMENT_BUFFER) == BASELINE[ResourceType::ELEMENT_BUFFER].Count + 1);
+        REQUIRE(COUNT(ResourceType::VERTEX_ARRAY) == BASELINE[ResourceType::VERTEX_ARRAY].Count + 1);
+        REQUIRE(BYTES(ResourceType::VERTEX_BUFFER) == BASELINE[ResourceType::VERTEX_BUFFER].Bytes + PAGE_VERTEX_BYTES);
+        REQUIRE(BYTES(ResourceType::ELEMENT_BUFFER) == BASELINE[ResourceType::ELEMENT_BUFFER].Bytes + PAGE_INDEX_BYTES);
+        REQUIRE(tracker.Statistics().FrameUploadBytes == BASELINE.FrameUploadBytes + VERTEX_BYTES + INDEX_BYTES);
+
+        // Later meshes and regenerated levels reuse the page
+        const auto QUAD = JE::CreateQuadMesh();
+        mesh.GenerateLODs(1);
+        REQUIRE(COUNT(ResourceType::VERTEX_BUFFER) == BASELINE[ResourceType::VERTEX_BUFFER].Count + 1);
+        REQUIRE(BYTES(ResourceType::ELEMENT_BUFFER) == BASELINE[ResourceType::ELEMENT_BUFFER].Bytes + PAGE_INDEX_BYTES);
+    }
+    REQUIRE(COUNT(ResourceType::VERTEX_BUFFER) == BASELINE[ResourceType::VERTEX_BUFFER].Count);
+    REQUIRE(COUNT(ResourceType::VERTEX_ARRAY) == BASELINE[ResourceType::VERTEX_ARRAY].Count);
+    REQUIRE(tracker.Statistics().Bytes == BASELINE.Bytes);
+    REQUIRE(tracker.Statistics()[ResourceType::VERTEX_BUFFER].PeakCount > BASELINE[ResourceType::VERTEX_BUFFER].Count);
+    REQUIRE(tracker.Statistics().PeakBytes >= BASELINE.Bytes + VERTEX_BYTES + INDEX_BYTES);
+
+    const auto UPLOADED = tracker.Statistics().FrameUploadBytes;
+    tracker.BeginFrame();
+    REQUIRE(tracker.Statistics().FrameUploadBytes == 0);
+    REQUIRE(tracker.Statistics().LastFrameUploadBytes == UPLOADED);
+    REQUIRE(tracker.Statistics().PeakFrameUploadBytes >= UPLOADED);
+
+    // Textures hold every mip level, framebuffers track their color attachments as textures
+    constexpr std::size_t TEXTURE_BYTES = 4 * 4 * 4 + 2 * 2 * 4 + 4;
+    {
+        const auto TEXTURE = JE::CreateTexture2D({{4, 4}, JE::TextureFormat::RGBA8, 0});
+        REQUIRE(BYTES(ResourceType::TEXTURE) == BASELINE[ResourceType::TEXTURE].Bytes + TEXTURE_BYTES);
+
+        const auto FRAMEBUFFER = JE::CreateFramebuffer({{8, 8}});
+        REQUIRE(COUNT(ResourceType::FRAMEBUFFER) == BASELINE[ResourceType::FRAMEBUFFER].Count + 1);
+        REQUIRE(COUNT(ResourceType::TEXTURE) == BASELINE[ResourceType::TEXTURE].Count + 2);
+        REQUIRE(BYTES(ResourceType::TEXTURE) == BASELINE[ResourceType::TEXTURE].Bytes + TEXTURE_BYTES + 8 * 8 * 4);
+    }
+    REQUIRE(tracker.Statistics().Bytes == BASELINE.Bytes);
+
+    // Over a logging budget allocations still succeed
+    tracker.SetBudget(JE::MemoryBudget{BASELINE.Bytes + VERTEX_BYTES, JE::BudgetPolicy::LOG});
+    {
+        const auto TEXTURE = JE::CreateTexture2D({{4, 4}, JE::TextureFormat::RGBA8, 0});
+        REQUIRE(BYTES(ResourceType::TEXTURE) == BASELINE[ResourceType::TEXTURE].Bytes + TEXTURE_BYTES);
+        REQUIRE(tracker.Statistics().RejectedAllocations == BASELINE.RejectedAllocations);
+    }
+
+    // Over a rejecting budget they fail and keep the storage they had, shrinking always succeeds
+    tracker.SetBudget(JE::MemoryBudget{BASELINE.Bytes + VERTEX_BYTES, JE::BudgetPolicy::REJECT});
+    {
+        const std::array<std::byte, VERTEX_BYTES * 2> VERTICES{};
+        auto vertex_buffer =
+            JE::CreateVertexBuffer(JE::AttributeLayout{{"a_VertexPos", JE::IRendererAPI::Type::FLOAT, 3}});
+        REQUIRE(vertex_buffer->SetData(std::span{VERTICES}.first(VERTEX_BYTES)));
+        REQUIRE_FALSE(vertex_buffer->SetData(VERTICES));
+        REQUIRE(BYTES(ResourceType::VERTEX_BUFFER) == BASELINE[ResourceType::VERTEX_BUFFER].Bytes + VERTEX_BYTES);
+        REQUIRE(tracker.Statistics().RejectedAllocations == BASELINE.RejectedAllocations + 1);
+
+        const auto TEXTURE = JE::CreateTexture2D({{4, 4}, JE::TextureFormat::RGBA8, 0});
+        REQUIRE(static_cast<TestTexture2D&>(*TEXTURE).Levels.empty());
+        REQUIRE(BYTES(ResourceType::TEXTURE) == BASELINE[ResourceType::TEXTURE].Bytes);
+        REQUIRE(tracker.Statistics().RejectedAllocations == BASELINE.RejectedAllocations + 2);
+
+        REQUIRE(vertex_buffer->SetData(std::span{VERTICES}.first(VERTEX_BYTES / 3)));
+        REQUIRE(BYTES(ResourceType::VERTEX_BUFFER) == BASELINE[ResourceType::VERTEX_BUFFER].Bytes + VERTEX_BYTES / 3);
+    }
+    tracker.SetBudget(std::nullopt);
+}
+
+TEST_CASE("Test OpenGL object pool frame lag, name recycling and trimming", "[OpenGLObjectPool]")
+{
+    // Records the GL calls instead of making them
+    struct RecordingObjectPool : JE::OpenGLObjectPool
+    {
+        using OpenGLObjectPool::OpenGLObjectPool;
+
+        void GenerateNames([[maybe_unused]] ObjectType type, std::span<std::uint32_t> names) override
+        {
+            ++GenerateCalls;
+            for (auto& name : names) {
+                name = ++LastName;
+            }
+        }
+        void ReleaseObject(ObjectType type, std::uint32_t name, [[maybe_unused]] std::uint32_t attribute_count) override
+        {
+            (type == ObjectType::PROGRAM ? DeletedPrograms : ReleasedNames).push_back(name);
+        }
+        void DeleteNames([[maybe_unused]] ObjectType type, std::span<const std::uint32_t> names) override
+        {
+            DeletedNames.insert(DeletedNames.end(), names.begin(), names.end());
+        }
+
+        std::uint32_t LastName = 0;
+        std::size_t GenerateCalls = 0;
+        JE::Vector<std::uint32_t> ReleasedNames;
+        JE::Vector<std::uint32_t> DeletedPrograms;
+        JE::Vector<std::uint32_t> DeletedNames;
+    };
+    using Pool = JE::OpenGLObjectPool;
+
+    RecordingObjectPool pool;
+    REQUIRE(pool.FrameLag() == JE::FramePacer::MAX_FRAMES_IN_FLIGHT_LIMIT);
+
+    // Names are generated a batch at a time and handed out in generation order
+    for (std::uint32_t i = 1; i <= Pool::NAME_BATCH_SIZE; ++i) {
+        REQUIRE(pool.CreateBuffer() == i);
+    }
+    REQUIRE(pool.GenerateCalls == 1);
+    const auto BUFFER = pool.CreateBuffer();
+    REQUIRE(pool.GenerateCalls == 2);
+    REQUIRE(pool.Statistics().GeneratedBuffers == 2 * Pool::NAME_BATCH_SIZE);
+
+    // Destroyed objects are released once the frames that may still use them ended
+    pool.DestroyBuffer(BUFFER);
+    pool.DestroyProgram(7);
+    for (std::uint32_t frame = 1; frame < pool.FrameLag(); ++frame) {
+        pool.EndFrame();
+        REQUIRE(pool.ReleasedNames.empty());
+        REQUIRE(pool.Statistics().PendingDeletions == 2);
+    }
+    pool.EndFrame();
+    REQUIRE(pool.ReleasedNames == JE::Vector<std::uint32_t>{BUFFER});
+    REQUIRE(pool.DeletedPrograms == JE::Vector<std::uint32_t>{7});
+    REQUIRE(pool.Statistics().PendingDeletions == 0);
+    REQUIRE(pool.Statistics().RecycledBuffers == 1);
+
+    // The recycled name is handed out before the rest of the batch
+    REQUIRE(pool.CreateBuffer() == BUFFER);
+    REQUIRE(pool.GenerateCalls == 2);
+
+    // Free names past the limit are deleted in one go
+    constexpr std::size_t OVER_LIMIT = 100;
+    JE::Vector<JE::IRendererAPI::BufferID> buffers;
+    for (std::size_t i = 0; i < Pool::DEFAULT_MAX_FREE_NAMES + OVER_LIMIT; ++i) {
+        buffers.push_back(pool.CreateBuffer());
+    }
+    for (const auto NAME : buffers) {
+        pool.DestroyBuffer(NAME);
+    }
+    REQUIRE(pool.DeletedNames.empty());
+    for (std::uint32_t frame = 0; frame < pool.FrameLag(); ++frame) {
+        pool.EndFrame();
+    }
+    const auto FREE_NAMES = Pool::DEFAULT_MAX_FREE_NAMES + OVER_LIMIT + pool.LastName - buffers.back();
+    REQUIRE(pool.DeletedNames.size() == FREE_NAMES - Pool::DEFAULT_MAX_FREE_NAMES);
+}
+
+TEST_CASE("Test offset allocator coalescing and geometry pool sub-allocation", "[GeometryPool][Renderer]")
+{
+    JE::detail::InjectCustomEnginePlatform<TestPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    // Freed regions merge with their free neighbours
+    JE::OffsetAllocator allocator{100, 3};
+    const auto FIRST = allocator.Allocate(10);
+    const auto SECOND = allocator.Allocate(20);
+    const auto THIRD = allocator.Allocate(30);
+    REQUIRE((FIRST.Offset == 0 && SECOND.Offset == 10 && THIRD.Offset == 30));
+    REQUIRE_FALSE(allocator.Allocate(1).Valid());
+    allocator.Free(SECOND);
+    REQUIRE(allocator.FreeSpace() == 60);
+    REQUIRE(allocator.LargestFreeRegion() == 40);
+    REQUIRE_FALSE(allocator.Allocate(50).Valid());
+    allocator.Free(FIRST);
+    REQUIRE(allocator.LargestFreeRegion() == 40);
+    REQUIRE(allocator.Allocate(30).Offset == 0);
+    allocator.Reset();
+    REQUIRE(allocator.LargestFreeRegion() == 100);
+    REQUIRE(allocator.Allocate(100).Offset == 0);
+
+    JE::GeometryPool pool{JE::AttributeLayout{{"a_VertexPos", JE::IRendererAPI::Type::FLOAT, 3}}, {16, 32, 8}};
+    constexpr std::array<float, 9> TRIANGLE_A{0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f};
+    constexpr std::array<float, 9> TRIANGLE_B{2.f, 0.f, 0.f, 3.f, 0.f, 0.f, 2.f, 1.f, 0.f};
+    constexpr std::array<JE::IndexType, 3> INDICES{0, 1, 2};
+    const auto A = pool.Allocate(std::as_bytes(std::span{TRIANGLE_A}), INDICES);
+    const auto B = pool.Allocate(std::as_bytes(std::span{TRIANGLE_B}), INDICES);
+    REQUIRE(pool.Range(A).Page == pool.Range(B).Page);
+    REQUIRE(pool.Range(B).BaseVertex == 3);
+    REQUIRE(pool.Range(B).FirstIndex == 3);
+    REQUIRE(pool.Allocate({}, INDICES) == JE::INVALID_GEOMETRY);
+
+    // Geometry larger than a page gets a page of its own
+    const std::array<float, 17 * 3> LARGE{};
+    const auto C = pool.Allocate(std::as_bytes(std::span{LARGE}), INDICES);
+    REQUIRE(C != JE::INVALID_GEOMETRY);
+    REQUIRE(pool.Range(C).Page != pool.Range(A).Page);
+    REQUIRE(pool.Statistics().PageCount == 2);
+    pool.Free(C);
+    REQUIRE(pool.Statistics().PageCount == 1);
+
+    // Outgrown indices move within the page, the vertices stay
+    constexpr std::array<JE::IndexType, 6> QUAD_INDICES{0, 1, 2, 2, 1, 0};
+    REQUIRE(pool.SetIndices(A, QUAD_INDICES));
+    REQUIRE(pool.Range(A).BaseVertex == 0);
+    REQUIRE(pool.Range(A).IndexCount == 6);
+    REQUIRE(pool.Range(A).FirstIndex == 6);
+
+    // Defragmenting packs the remaining range to the start of its page along with its data
+    pool.Free(A);
+    REQUIRE(pool.Defragment());
+    REQUIRE(pool.Range(B).BaseVertex == 0);
+    REQUIRE(pool.Range(B).FirstIndex == 0);
+    auto& vertex_array = pool.VertexArray(pool.Range(B).Page);
+    const auto& vertex_data = static_cast<const TestVertexBuffer&>(*vertex_array.Buffers().front()).Data;
+    const auto& index_data = static_cast<const TestElementBuffer&>(vertex_array.IndexBuffer()).Data;
+    REQUIRE(std::ranges::equal(std::span{vertex_data}.first(sizeof(TRIANGLE_B)), std::as_bytes(std::span{TRIANGLE_B})));
+    REQUIRE(std::ranges::equal(std::span{index_data}.first(sizeof(INDICES)), std::as_bytes(std::span{INDICES})));
+    REQUIRE(pool.Statistics().FreeVertices == 13);
+
+    // Meshes share a page and are drawn with their base vertex
+    auto first_mesh = JE::CreateTriangleMesh();
+    auto second_mesh = JE::CreateTriangleMesh();
+    REQUIRE(&first_mesh.VAO() == &second_mesh.VAO());
+    REQUIRE(second_mesh.Geometry().Range().BaseVertex == 3);
+
+    auto& renderer = JE::Application().Renderer();
+    const auto DRAW_CALLS = TestRendererAPI::DrawCalls;
+    renderer.Begin(&JE::Application().MainWindow(), JE::RGBA{1.f, 1.f, 1.f, 1.f});
+    renderer.DrawMesh(first_mesh);
+    renderer.DrawMesh(second_mesh);
+    renderer.End();
+    for (const auto& command : renderer.CommandQueue()) {
+        command();
+    }
+    REQUIRE(TestRendererAPI::DrawCalls == DRAW_CALLS + 2);
+    REQUIRE(TestRendererAPI::LastBaseVertex == 3);
+}
+
+TEST_CASE("Test pipeline state deduplication and diffed application", "[PipelineState][Renderer]")
+{
+    JE::detail::InjectCustomEnginePlatform<TestPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    auto shader = JE::CreateShader("Pipeline", "", "");
+    const auto& layout = JE::MeshGeometryPool().Layout();
+    JE::RenderState blended;
+    blended.Blend = JE::ALPHA_BLENDING;
+
+    // Equal states share an ID, any difference creates a new pipeline
+    auto& pipelines = JE::RendererAPI().Pipelines();
+    const auto OPAQUE = pipelines.Create(JE::PipelineState{shader.get(), layout});
+    REQUIRE(OPAQUE != JE::DEFAULT_PIPELINE);
+    REQUIRE(pipelines.Create(JE::PipelineState{shader.get(), layout}) == OPAQUE);
+    const auto BLENDED = pipelines.Create(JE::PipelineState{shader.get(), layout, blended});
+    REQUIRE(BLENDED != OPAQUE);
+    const JE::AttributeLayout OTHER_LAYOUT_DESCRIPTION{{"a_Other", JE::IRendererAPI::Type::FLOAT, 3}};
+    const auto OTHER_LAYOUT = pipelines.Create(JE::PipelineState{shader.get(), OTHER_LAYOUT_DESCRIPTION});
+    REQUIRE(OTHER_LAYOUT != OPAQUE);
+    REQUIRE(pipelines.Pipeline(BLENDED).State() == blended);
+
+    // Only pipelines with a different render state reach the backend
+    const auto STATE_CHANGES = TestRendererAPI::RenderStateChanges;
+    REQUIRE(pipelines.Apply(OPAQUE));
+    REQUIRE(pipelines.Apply(OTHER_LAYOUT));
+    REQUIRE(pipelines.Apply(BLENDED));
+    REQUIRE(pipelines.Apply(BLENDED));
+    pipelines.Release();
+    REQUIRE(TestRendererAPI::RenderStateChanges == STATE_CHANGES + 2);
+    REQUIRE(TestRendererAPI::LastRenderState.Blend == JE::ALPHA_BLENDING);
+
+    // Consecutive draws with the same pipeline don't switch state, drawing with the shader reuses OPAQUE
+    auto first_mesh = JE::CreateTriangleMesh();
+    auto second_mesh = JE::CreateTriangleMesh();
+    auto& renderer = JE::Application().Renderer();
+    renderer.Begin(&JE::Application().MainWindow(), JE::RGBA{1.f, 1.f, 1.f, 1.f});
+    renderer.DrawMesh(first_mesh, OPAQUE);
+    renderer.DrawMesh(second_mesh, OPAQUE);
+    renderer.DrawMesh(first_mesh, BLENDED);
+    renderer.DrawMesh(second_mesh, *shader);
+    renderer.End();
+    const auto DRAW_CALLS = TestRendererAPI::DrawCalls;
+    for (const auto& command : renderer.CommandQueue()) {
+        command();
+    }
+    REQUIRE(TestRendererAPI::DrawCalls == DRAW_CALLS + 4);
+    REQUIRE(TestRendererAPI::RenderStateChanges == STATE_CHANGES + 5);
+    REQUIRE(TestRendererAPI::LastRenderState == JE::RenderState{});
+
+    // Destroying a program evicts its pipelines, their IDs are reused and never resolve to the dead program
+    const auto SIZE = pipelines.Size();
+    auto short_lived = JE::CreateShader("Short lived", "", "");
+    const auto SHORT_LIVED = pipelines.Create(JE::PipelineState{short_lived.get(), layout});
+    REQUIRE(pipelines.Apply(SHORT_LIVED));
+    short_lived.reset();
+    auto replacement = JE::CreateShader("Replacement", "", "");
+    const auto REPLACEMENT = pipelines.Create(JE::PipelineState{replacement.get(), layout});
+    REQUIRE(REPLACEMENT == SHORT_LIVED);
+    REQUIRE(pipelines.Pipeline(REPLACEMENT).ShaderProgram() == replacement.get());
+    REQUIRE(pipelines.Size() == SIZE + 1);
+    REQUIRE(pipelines.Apply(REPLACEMENT));
+    pipelines.Release();
+}
+
+TEST_CASE("Test BC1 and BC3 block encoding round trip", "[TextureProcessing]")
+{
+    constexpr float TOLERANCE = 0.03f;
+
+    // Colors on the 4 entry palette between two endpoints and alphas on the 8 entry palette decode (almost) exactly
+    JE::BlockPixels pixels;
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+        const auto COLOR_STEP = static_cast<float>(i % 4) / 3.f;
+        const auto ALPHA_STEP = static_cast<float>(i % 8) / 7.f;
+        pixels[i] = glm::vec4{1.f - COLOR_STEP, 0.5f, COLOR_STEP, 1.f - ALPHA_STEP};
+    }
+
+    const auto BC3_DECODED = JE::DecodeBC3Block(JE::EncodeBC3Block(pixels));
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+        REQUIRE(glm::length(BC3_DECODED[i] - pixels[i]) < TOLERANCE);
+    }
+
+    auto opaque = pixels;
+    for (auto& pixel : opaque) {
+        pixel.a = 1.f;
+    }
+    const auto BC1_DECODED = JE::DecodeBC1Block(JE::EncodeBC1Block(opaque));
+    for (std::size_t i = 0; i < opaque.size(); ++i) {
+        REQUIRE(glm::length(BC1_DECODED[i] - opaque[i]) < TOLERANCE);
+    }
+
+    // BC1 has a single transparent palette entry for pixels below half alpha
+    const auto CUTOUT_DECODED = JE::DecodeBC1Block(JE::EncodeBC1Block(pixels));
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+        REQUIRE((CUTOUT_DECODED[i].a > 0.5f) == (pixels[i].a >= 0.5f));
+    }
+
+    JE::BlockPixels solid;
+    solid.fill(glm::vec4{1.f, 0.f, 0.f, 1.f});
+    for (const auto& pixel : JE::DecodeBC1Block(JE::EncodeBC1Block(solid))) {
+        REQUIRE(glm::length(pixel - solid[0]) < TOLERANCE);
+    }
+}
+
+TEST_CASE("Test texture processing mip chain and texture file round trip", "[TextureProcessing]")
+{
+    constexpr std::int32_t WIDTH = 16;
+    constexpr std::int32_t HEIGHT = 8;
+
+    JE::Image image{{WIDTH, HEIGHT}, JE::Vector<glm::vec4>(WIDTH * HEIGHT, glm::vec4{0.25f, 0.5f, 0.75f, 1.f})};
+
+    // Filters are normalized, a constant image stays constant on every level
+    for (const auto FILTER : {JE::MipFilter::BOX, JE::MipFilter::LANCZOS3, JE::MipFilter::KAISER}) {
+        const auto LEVELS = JE::GenerateMipChain(image, FILTER, JE::TextureWrap::REPEAT, 2);
+        REQUIRE(LEVELS.size() == 5);
+        REQUIRE(LEVELS.back().Size.X == 1);
+        REQUIRE(LEVELS.back().Size.Y == 1);
+        for (const auto& pixel : LEVELS[2].Pixels) {
+            REQUIRE(glm::length(pixel - image.Pixels[0]) < 1e-4f);
+        }
+    }
+
+    // A box filtered 2x2 checker is the average
+    const JE::Image CHECKER{{2, 2}, {glm::vec4{1.f}, glm::vec4{0.f}, glm::vec4{0.f}, glm::vec4{1.f}}};
+    const auto AVERAGE = JE::DownsampleImage(CHECKER, {1, 1}, JE::MipFilter::BOX, JE::TextureWrap::CLAMP_TO_EDGE);
+    REQUIRE(glm::length(AVERAGE.Pixels[0] - glm::vec4{0.5f}) < 1e-5f);
+
+    const auto DATA = JE::ProcessTexture(image, {JE::TextureFormat::BC1_RGBA});
+    REQUIRE(DATA.Description.MipLevels == 5);
+    REQUIRE(DATA.Levels.size() == 5);
+    REQUIRE(DATA.Levels[0].size() == (WIDTH / 4) * (HEIGHT / 4) * JE::BC1_BLOCK_BYTES);
+    REQUIRE(DATA.Levels[4].size() == JE::BC1_BLOCK_BYTES);
+
+    const auto PATH = std::filesystem::temp_directory_path() / "JEngine-Reformed_texture_test.dds";
+    REQUIRE(JE::WriteTextureFile(PATH, DATA));
+
+    const auto READ = JE::ReadTextureFile(PATH);
+    std::filesystem::remove(PATH);
+    REQUIRE(READ.has_value());
+    REQUIRE(READ->Description.Format == JE::TextureFormat::BC1_RGBA);
+    REQUIRE(READ->Description.MipLevels == 5);
+    REQUIRE(READ->Levels == DATA.Levels);
+}
+
+TEST_CASE("Test texture file reading rejects malformed headers", "[TextureProcessing]")
+{
+    // Byte offsets of the DDS header fields, after the 4 byte magic
+    constexpr std::streamoff HEIGHT_OFFSET = 12;
+    constexpr std::streamoff WIDTH_OFFSET = 16;
+    constexpr std::streamoff LINEAR_SIZE_OFFSET = 20;
+    constexpr std::streamoff MIP_COUNT_OFFSET = 28;
+
+    JE::TextureData data;
+    data.Description = {{16, 8}, JE::TextureFormat::BC1_RGBA, 5};
+    for (std::uint32_t level = 0; level < data.Description.MipLevels; ++level) {
+        const auto SIZE = JE::MipLevelSize(data.Description.Size, level);
+        const auto BLOCKS = static_cast<std::size_t>((SIZE.X + 3) / 4) * static_cast<std::size_t>((SIZE.Y + 3) / 4);
+        data.Levels.emplace_back(BLOCKS * JE::BC1_BLOCK_BYTES, std::byte{0x5A});
+    }
+
+    const auto PATH = std::filesystem::temp_directory_path() / "JEngine-Reformed_malformed_texture_test.dds";
+    const auto READ_PATCHED = [&PATH, &data](std::streamoff offset, std::uint32_t value)
+    {
+        REQUIRE(JE::WriteTextureFile(PATH, data));
+        {
+            std::fstream file{PATH, std::ios::binary | std::ios::in | std::ios::out};
+            file.seekp(offset);
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));  // NOLINT
+        }
+        auto read = JE::ReadTextureFile(PATH);
+        std::filesystem::remove(PATH);
+        return read;
+    };
+
+    REQUIRE(READ_PATCHED(MIP_COUNT_OFFSET, 5).has_value());
+
+    REQUIRE_FALSE(READ_PATCHED(WIDTH_OFFSET, 0).has_value());
+    REQUIRE_FALSE(READ_PATCHED(HEIGHT_OFFSET, 0).has_value());
+    REQUIRE_FALSE(READ_PATCHED(WIDTH_OFFSET, 0x80000000U).has_value());
+    // A size larger than the payload is rejected before the levels are allocated
+    REQUIRE_FALSE(READ_PATCHED(HEIGHT_OFFSET, 0x7FFFFFFFU).has_value());
+    // 16x8 has at most 5 levels, fewer levels leave bytes over
+    REQUIRE_FALSE(READ_PATCHED(MIP_COUNT_OFFSET, 6).has_value());
+    REQUIRE_FALSE(READ_PATCHED(MIP_COUNT_OFFSET, 4).has_value());
+    REQUIRE_FALSE(READ_PATCHED(LINEAR_SIZE_OFFSET, 1).has_value());
+
+    // Truncated levels
+    REQUIRE(JE::WriteTextureFile(PATH, data));
+    std::filesystem::resize_file(PATH, std::filesystem::file_size(PATH) - 1);
+    REQUIRE_FALSE(JE::ReadTextureFile(PATH).has_value());
+    std::filesystem::remove(PATH);
+}
+
+TEST_CASE("Test skyline packing, atlas padding and sprite batching", "[TextureAtlas][Renderer]")
+{
+    JE::detail::InjectCustomEnginePlatform<TestPlatform>();
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    JE::SkylinePacker packer{{32, 32}};
+    JE::Vector<JE::AtlasRect> rects;
+    while (auto rect = packer.Insert({5, 7})) {
+        rects.push_back(*rect);
+    }
+    // 6 columns of 4 rows fit, the last column and rows are too small
+    REQUIRE(rects.size() == 24);
+    REQUIRE(packer.UsedArea() == 24 * 5 * 7);
+    for (std::size_t i = 0; i < rects.size(); ++i) {
+        REQUIRE(rects[i].X + rects[i].Width <= 32);
+        REQUIRE(rects[i].Y + rects[i].Height <= 32);
+        for (std::size_t j = i + 1; j < rects.size(); ++j) {
+            const bool SEPARATE = rects[i].X + rects[i].Width <= rects[j].X || rects[j].X + rects[j].Width <= rects[i].X
+                                  || rects[i].Y + rects[i].Height <= rects[j].Y
+                                  || rects[j].Y + rects[j].Height <= rects[i].Y;
+            REQUIRE(SEPARATE);
+        }
+    }
+
+    JE::AtlasOptions options;
+    options.PageSize = {64, 64};
+    JE::TextureAtlas atlas{options};
+
+    // Every column of the image has its own value so the extruded padding can be checked
+    JE::Vector<std::byte> pixels(8 * 8 * 4);
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+        pixels[i] = static_cast<std::byte>(1 + (i / 4) % 8);
+    }
+
+    JE::Vector<JE::AtlasRegion> regions;
+    for (auto i = 0; i < 3; ++i) {
+        regions.push_back(atlas.Add({8, 8}, pixels).value());
+    }
+    regions.push_back(atlas.Add({60, 60}, JE::Vector<std::byte>(60 * 60 * 4, std::byte{9})).value());
+    REQUIRE_FALSE(atlas.Add({64, 64}, JE::Vector<std::byte>(64 * 64 * 4)).has_value());
+
+    REQUIRE(atlas.PageCount() == 2);
+    REQUIRE(regions[2].Page == 0);
+    REQUIRE(regions[3].Page == 1);
+    REQUIRE(regions[0].Rect.X == 1);
+    REQUIRE(regions[1].Rect.X == 11);
+    REQUIRE(regions[1].UVMin.x == 11.f / 64.f);
+    REQUIRE(regions[1].UVMax.y == 9.f / 64.f);
+
+    // The padding left of the first image repeats its first column, the one right of it its last column
+    const auto PAGE = atlas.PagePixels(0);
+    const auto PIXEL_AT = [&](std::int32_t x, std::int32_t y)
+    {
+        return PAGE[static_cast<std::size_t>(y * 64 + x) * 4];
+    };
+    REQUIRE(PIXEL_AT(0, 0) == std::byte{1});
+    REQUIRE(PIXEL_AT(1, 1) == std::byte{1});
+    REQUIRE(PIXEL_AT(9, 9) == std::byte{8});
+    // The second image's padding starts right after, the rest of the row is unused
+    REQUIRE(PIXEL_AT(10, 0) == std::byte{1});
+    REQUIRE(PIXEL_AT(30, 0) == std::byte{0});
+
+    REQUIRE(atlas.Commit());
+    REQUIRE(static_cast<TestTexture2D&>(*atlas.Page(0)).Levels[0] == JE::Vector<std::byte>(PAGE.begin(), PAGE.end()));
+
+    auto& renderer = JE::Application().Renderer();
+    const auto DRAW_CALLS = TestRendererAPI::DrawCalls;
+    renderer.Begin(&JE::Application().MainWindow(), JE::RGBA{1.f, 1.f, 1.f, 1.f});
+    for (const auto& region : regions) {
+        renderer.DrawQuad(
+            atlas.GetSprite(region), {1.f, 1.f, 1.f, 1.f}, {0.f, 0.f}, {0.f, 0.f, 0.f}, {1.f, 1.f, 1.f});
+    }
+    renderer.End();
+    JE::Application().Loop(1);
+
+    // One batch per atlas page and one for the untextured quad the loop draws itself
+    REQUIRE(TestRendererAPI::DrawCalls - DRAW_CALLS == 3);
+
+    const std::array IMAGES = {JE::Image{{3, 2}, JE::Vector<glm::vec4>(6, glm::vec4{1.f})},
+                               JE::Image{{2, 5}, JE::Vector<glm::vec4>(10, glm::vec4{0.5f})}};
+    options.PageSize = {16, 16};
+    options.Alignment = 4;
+    const auto BUILD = JE::BuildAtlas(IMAGES, options);
+    REQUIRE(BUILD.has_value());
+    REQUIRE(BUILD->Pages.size() == 1);
+    // The taller image is placed first, rectangles (plus padding) start on block boundaries
+    REQUIRE(BUILD->Regions[1].Rect.X == 1);
+    REQUIRE(BUILD->Regions[0].Rect.X == 5);
+    REQUIRE(BUILD->Regions[0].Rect.Width == 3);
+    REQUIRE(BUILD->Pages[0].At(4, 0) == glm::vec4{1.f});
+    REQUIRE(BUILD->Pages[0].At(0, 6) == glm::vec4{0.5f});
+}
+
+TEST_CASE("Test RenderGraph culling, ordering and transient aliasing", "[RenderGraph]")
+{
+    JE::detail::InjectCustomRendererAPI<TestRendererAPI>();
+
+    TestWindow window;
+    const JE::FramebufferDescription DESCRIPTION{{64, 64}};
+
+    JE::RenderGraph graph;
+    JE::Vector<std::string> executed;
+    const JE::ITexture2D* gbuffer_texture = nullptr;
+    const auto BUILD_GRAPH = [&]()
+    {
+        const auto BACKBUFFER = graph.Import("Backbuffer", window);
+        const auto GBUFFER = graph.CreateTransient("GBuffer", DESCRIPTION);
+        const auto LIT = graph.CreateTransient("Lit", DESCRIPTION);
+        const auto BLOOM = graph.CreateTransient("Bloom", DESCRIPTION);
+        const auto DEBUG = graph.CreateTransient("Debug", DESCRIPTION);
+
+        // Added consumers first, the graph orders them after their producers
+        graph.AddPass(
+            "Present",
+            [&](JE::RenderPassBuilder& builder)
+            {
+                builder.Read(BLOOM);
+                builder.Write(BACKBUFFER);
+            },
+            [&, BLOOM](const JE::RenderPassContext& context)
+            {
+                // Bloom starts after the GBuffer's last use, both share one framebuffer
+                REQUIRE(&context.Texture(BLOOM) == gbuffer_texture);
+                executed.emplace_back("Present");
+            });
+        graph.AddPass(
+            "Bloom",
+            [&](JE::RenderPassBuilder& builder)
+            {
+                builder.Read(LIT);
+                builder.Write(BLOOM);
+            },
+            [&]([[maybe_unused]] const JE::RenderPassContext& context) { executed.emplace_back("Bloom"); });
+        graph.AddPass(
+            "Lighting",
+            [&](JE::RenderPassBuilder& builder)
+            {
+                builder.Read(GBUFFER);
+                builder.Write(LIT);
+            },
+            [&, GBUFFER, LIT](const JE::RenderPassContext& context)
+            {
+                REQUIRE(&context.Texture(GBUFFER) != &context.Texture(LIT));
+                executed.emplace_back("Lighting");
+            });
+        graph.AddPass(
+            "GBuffer",
+            [&](JE::RenderPassBuilder& builder) { builder.Write(GBUFFER); },
+            [&, GBUFFER](const JE::RenderPassContext& context)
+            {
+                gbuffer_texture = &context.Texture(GBUFFER);
+                executed.emplace_back("GBuffer");
+            });
+        // Nothing reads the debug output, the pass is culled
+        graph.AddPass(
+            "Debug",
+            [&](JE::RenderPassBuilder& builder) { builder.Write(DEBUG); },
+            [&]([[maybe_unused]] const JE::RenderPassContext& context) { executed.emplace_back("Debug"); });
+    };
+
+    BUILD_GRAPH();
+    const auto CREATED = TestFramebuffer::Created;
+    REQUIRE(graph.Compile());
+    REQUIRE(graph.PassCount() == 5);
+    REQUIRE(graph.CulledPassCount() == 1);
+    REQUIRE(graph.FramebufferCount() == 2);
+    REQUIRE(TestFramebuffer::Created - CREATED == 2);
+    REQUIRE(graph.AllocatedBytes() * 3 == graph.TransientBytes() * 2);
+
+    graph.Execute();
+    REQUIRE(executed == JE::Vector<std::string>{"GBuffer", "Lighting", "Bloom", "Present"});
+
+    // The next frame's graph reuses the pooled framebuffers
+    graph.Reset();
+    executed.clear();
+    BUILD_GRAPH();
+    REQUIRE(graph.Compile());
+    graph.Execute();
+    REQUIRE(executed.size() == 4);
+    REQUIRE(TestFramebuffer::Created - CREATED == 2);
+
+    // A smaller graph needs one framebuffer, the other one is only destroyed once the frame's commands ran
+    graph.Reset();
+    const auto DESTROYED = TestFramebuffer::Destroyed;
+    const auto SINGLE = graph.CreateTransient("Single", DESCRIPTION);
+    const auto SINGLE_BACKBUFFER = graph.Import("Backbuffer", window);
+    const auto SKIP_EXECUTE = []([[maybe_unused]] const JE::RenderPassContext& context) {};
+    graph.AddPass("Single", [&](JE::RenderPassBuilder& builder) { builder.Write(SINGLE); }, SKIP_EXECUTE);
+    graph.AddPass(
+        "Present single",
+        [&](JE::RenderPassBuilder& builder)
+        {
+            builder.Read(SINGLE);
+            builder.Write(SINGLE_BACKBUFFER);
+        },
+        SKIP_EXECUTE);
+    REQUIRE(graph.Compile());
+    REQUIRE(graph.FramebufferCount() == 1);
+    REQUIRE(TestFramebuffer::Destroyed == DESTROYED);
+    graph.Reset();
+    REQUIRE(TestFramebuffer::Destroyed - DESTROYED == 1);
+
+    // Transient resources have a single writer and passes can't depend on each other
+    graph.Reset();
+    const auto FIRST = graph.CreateTransient("First", DESCRIPTION);
+    const auto SECOND = graph.CreateTransient("Second", DESCRIPTION);
+    const auto BACKBUFFER = graph.Import("Backbuffer", window);
+    const auto NO_EXECUTE = []([[maybe_unused]] const JE::RenderPassContext& context) {};
+    graph.AddPass(
+        "A",
+        [&](JE::RenderPassBuilder& builder)
+        {
+            builder.Read(SECOND);
+            builder.Write(FIRST);
+            builder.Write(BACKBUFFER);
+        },
+        NO_EXECUTE);
+    graph.AddPass(
+        "B",
+        [&](JE::RenderPassBuilder& builder)
+        {
+            builder.Read(FIRST);
+            builder.Write(SECOND);
+        },
+        NO_EXECUTE);
+    REQUIRE_FALSE(graph.Compile());
+}
+
+TEST_CASE("Test software renderer golden images, depth test and SIMD rasterization", "[SoftwareRenderer]")
+{
+    static constexpr auto SIZE = 16;
+    static constexpr auto TRIANGLE_COUNT = 200;
+    static constexpr auto RED = JE::RGBA{1.f, 0.f, 0.f, 1.f};
+
+    JE::detail::SoftwareRendererAPI api{{SIZE, SIZE}, 2};
+
+    const auto PIXEL = [&api](std::int32_t x, std::int32_t y)
+    {
+        const auto PIXELS = api.DefaultFramebufferPixels();
+        const auto OFFSET = static_cast<std::size_t>(y * SIZE + x) * 4;
+        return JE::RGBA{static_cast<std::uint32_t>(PIXELS[OFFSET]),
+                        static_cast<std::uint32_t>(PIXELS[OFFSET + 1]),
+                        static_cast<std::uint32_t>(PIXELS[OFFSET + 2]),
+                        static_cast<std::uint32_t>(PIXELS[OFFSET + 3])}
+            .ToUint32();
+    };
+
+    // Buffer 0 holds the positions, buffer 1 texture coordinates or colors
+    const auto CREATE_VAO = [&api](std::span<const glm::vec3> positions,
+                                   std::span<const glm::vec4> attributes,
+                                   std::span<const std::uint32_t> indices)
+    {
+        auto vao = api.CreateVertexArray();
+        auto position_buffer =
+            api.CreateVertexBuffer(JE::AttributeLayout{{"a_VertexPos", JE::IRendererAPI::Type::FLOAT, 3}});
+        position_buffer->SetData(std::as_bytes(positions));
+        auto attribute_buffer =
+            api.CreateVertexBuffer(JE::AttributeLayout{{"a_Attribute", JE::IRendererAPI::Type::FLOAT, 4}});
+        attribute_buffer->SetData(std::as_bytes(attributes));
+        auto index_buffer = api.CreateElementBuffer();
+        index_buffer->SetData(std::as_bytes(indices));
+        vao->AddBuffer(std::move(position_buffer));
+        vao->AddBuffer(std::move(attribute_buffer));
+        vao->SetIndexBuffer(std::move(index_buffer));
+        REQUIRE(vao->Build());
+        return vao;
+    };
+
+    const auto CLEAR = [&api]()
+    {
+        REQUIRE(api.SetClearColor(JE::RGBA{0.f, 0.f, 0.f, 1.f}));
+        REQUIRE(api.ClearFramebuffer(JE::Renderer::DEFAULT_ATTACHMENT_FLAGS));
+    };
+
+    const auto DRAW = [&api](JE::IVertexArray& vao, std::size_t index_count)
+    {
+        vao.Bind();
+        REQUIRE(api.DrawIndexed(JE::IRendererAPI::Primitive::TRIANGLES,
+                                static_cast<std::uint32_t>(index_count),
+                                JE::IRendererAPI::Type::UNSIGNED_INT,
+                                0,
+                                0));
+        vao.Unbind();
+    };
+
+    // Two triangles sharing a diagonal cover exactly the pixel centers inside the quad, none twice or never
+    const std::array<glm::vec3, 4> QUAD_POSITIONS = {glm::vec3{-0.5f, -0.5f, 0.f},
+                                                     glm::vec3{0.5f, -0.5f, 0.f},
+                                                     glm::vec3{0.5f, 0.5f, 0.f},
+                                                     glm::vec3{-0.5f, 0.5f, 0.f}};
+    const std::array<glm::vec4, 4> QUAD_TEX_COORDS = {glm::vec4{0.f, 0.f, 0.f, 0.f},
+                                                      glm::vec4{1.f, 0.f, 0.f, 0.f},
+                                                      glm::vec4{1.f, 1.f, 0.f, 0.f},
+                                                      glm::vec4{0.f, 1.f, 0.f, 0.f}};
+    const std::array<std::uint32_t, 6> QUAD_INDICES = {0, 1, 2, 2, 3, 0};
+    auto quad = CREATE_VAO(QUAD_POSITIONS, QUAD_TEX_COORDS, QUAD_INDICES);
+
+    CLEAR();
+    DRAW(*quad, QUAD_INDICES.size());
+    const auto WHITE = JE::RGBA{1.f, 1.f, 1.f, 1.f}.ToUint32();
+    const auto BLACK = JE::RGBA{0.f, 0.f, 0.f, 1.f}.ToUint32();
+    for (auto y = 0; y < SIZE; ++y) {
+        for (auto x = 0; x < SIZE; ++x) {
+            const bool INSIDE = x >= SIZE / 4 && x < SIZE * 3 / 4 && y >= SIZE / 4 && y < SIZE * 3 / 4;
+            REQUIRE(PIXEL(x, y) == (INSIDE ? WHITE : BLACK));
+        }
+    }
+
+    // The default shader samples slot 0 at attribute 1, a 2x2 nearest texture lands on the quad's quarters
+    auto texture = api.CreateTexture2D({{2, 2}, JE::TextureFormat::RGBA8, 1});
+    const std::array<std::uint8_t, 16> TEXELS = {
+        255, 0, 0, 255, 0, 255, 0, 255, 0, 0, 255, 255, 255, 255, 255, 255};
+    REQUIRE(texture->SetSampler({JE::TextureFilter::NEAREST, JE::TextureFilter::NEAREST}));
+    REQUIRE(texture->SetData(0, std::as_bytes(std::span{TEXELS})));
+    CLEAR();
+    texture->Bind(0);
+    DRAW(*quad, QUAD_INDICES.size());
+    texture->Unbind(0);
+    REQUIRE(PIXEL(5, 5) == RED.ToUint32());
+    REQUIRE(PIXEL(10, 5) == JE::RGBA{0.f, 1.f, 0.f, 1.f}.ToUint32());
+    REQUIRE(PIXEL(5, 10) == JE::RGBA{0.f, 0.f, 1.f, 1.f}.ToUint32());
+    REQUIRE(PIXEL(10, 10) == WHITE);
+
+    // The far quad is drawn last, with the depth test the near one stays in front
+    JE::SoftwareShader color_shader;
+    color_shader.Vertex =
+        [](const JE::SoftwareShader::Attributes& attributes, JE::SoftwareShader::Varyings& varyings)
+    {
+        varyings[0] = attributes[1];
+        return attributes[0];
+    };
+    color_shader.Fragment = [](const JE::SoftwareShader::Varyings& varyings,
+                               [[maybe_unused]] const JE::SoftwareSamplers& samplers) { return varyings[0]; };
+    color_shader.VaryingCount = 1;
+    api.RegisterShader("Color", color_shader);
+    auto shader = api.CreateShader("Color", "", "");
+    REQUIRE(shader->Valid());
+
+    const std::array<glm::vec3, 8> LAYER_POSITIONS = {glm::vec3{-1.f, -1.f, -0.5f},
+                                                      glm::vec3{1.f, -1.f, -0.5f},
+                                                      glm::vec3{1.f, 1.f, -0.5f},
+                                                      glm::vec3{-1.f, 1.f, -0.5f},
+                                                      glm::vec3{-1.f, -1.f, 0.5f},
+                                                      glm::vec3{1.f, -1.f, 0.5f},
+                                                      glm::vec3{1.f, 1.f, 0.5f},
+                                                      glm::vec3{-1.f, 1.f, 0.5f}};
+    const std::array<glm::vec4, 8> LAYER_COLORS = {RED.Color, RED.Color, RED.Color, RED.Color,
+                                                   glm::vec4{0.f, 0.f, 1.f, 1.f}, glm::vec4{0.f, 0.f, 1.f, 1.f},
+                                                   glm::vec4{0.f, 0.f, 1.f, 1.f}, glm::vec4{0.f, 0.f, 1.f, 1.f}};
+    const std::array<std::uint32_t, 12> LAYER_INDICES = {0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4};
+    auto layers = CREATE_VAO(LAYER_POSITIONS, LAYER_COLORS, LAYER_INDICES);
+
+    shader->Bind();
+    CLEAR();
+    DRAW(*layers, LAYER_INDICES.size());
+    REQUIRE(PIXEL(SIZE / 2, SIZE / 2) == JE::RGBA{0.f, 0.f, 1.f, 1.f}.ToUint32());
+    api.SetDepthTest(true);
+    CLEAR();
+    DRAW(*layers, LAYER_INDICES.size());
+    REQUIRE(PIXEL(SIZE / 2, SIZE / 2) == RED.ToUint32());
+    REQUIRE(PIXEL(0, 0) == RED.ToUint32());
+
+    // Overlapping triangles with interpolated colors and perspective come out the same with and without SIMD
+    JE::Vector<glm::vec3> positions;
+    JE::Vector<glm::vec4> colors;
+    JE::Vector<std::uint32_t> indices;
+    for (auto i = 0; i < TRIANGLE_COUNT * 3; ++i) {
+        const auto VALUE = static_cast<float>(i);
+        positions.emplace_back(std::sin(VALUE * 1.7f) * 1.3f, std::cos(VALUE * 2.3f) * 1.3f, std::sin(VALUE) * 0.9f);
+        colors.emplace_back(
+            std::fmod(VALUE * 0.37f, 1.f), std::fmod(VALUE * 0.61f, 1.f), std::fmod(VALUE * 0.13f, 1.f), 1.f);
+        indices.push_back(static_cast<std::uint32_t>(i));
+    }
+    auto triangles = CREATE_VAO(positions, colors, indices);
+
+    JE::Vector<std::byte> scalar_image;
+    for (const auto LEVEL : {JE::SIMDLevel::SCALAR, JE::HostSIMDLevel()}) {
+        api.SetSIMDLevel(LEVEL);
+        CLEAR();
+        DRAW(*triangles, indices.size());
+        const auto PIXELS = api.DefaultFramebufferPixels();
+        if (LEVEL == JE::SIMDLevel::SCALAR) {
+            scalar_image.assign(PIXELS.begin(), PIXELS.end());
+        } else {
+            REQUIRE(std::ranges::equal(PIXELS, scalar_image));
+        }
+    }
+    shader->Unbind();
+}
+
+#if JE_VULKAN_ENABLED_VALUE
+TEST_CASE("Test Vulkan renderer headless draw, pipeline reuse and per-thread command pools", "[VulkanRenderer]")
+{
+    static constexpr auto SIZE = 16;
+    static constexpr auto FRAGMENT_SOURCE = R"(
+                                                #version 330 core
+                                                out vec4 out_FragColor;
+                                                void main()
+                                                {
+                                                    out_FragColor = vec4(1.0f, 0.0f, 0.0f, 1.0f);
+                                                }
+                                                )";
+
+    JE::detail::VulkanRendererAPI api{{SIZE, SIZE}};
+    if (!api.Initialized()) { SKIP("No Vulkan device available"); }
+
+    const auto PIXEL = [&api](std::int32_t x, std::int32_t y)
+    {
+        const auto PIXELS = api.ReadDefaultFramebuffer();
+        const auto OFFSET = static_cast<std::size_t>(y * SIZE + x) * 4;
+        return JE::RGBA{static_cast<std::uint32_t>(PIXELS[OFFSET]),
+                        static_cast<std::uint32_t>(PIXELS[OFFSET + 1]),
+                        static_cast<std::uint32_t>(PIXELS[OFFSET + 2]),
+                        static_cast<std::uint32_t>(PIXELS[OFFSET + 3])}
+            .ToUint32();
+    };
+
+    const std::array<glm::vec3, 4> QUAD_POSITIONS = {glm::vec3{-0.5f, -0.5f, 0.f},
+                                                     glm::vec3{0.5f, -0.5f, 0.f},
+                                                     glm::vec3{0.5f, 0.5f, 0.f},
+                                                     glm::vec3{-0.5f, 0.5f, 0.f}};
+    const std::array<std::uint32_t, 6> QUAD_INDICES = {0, 1, 2, 2, 3, 0};
+    auto quad = api.CreateVertexArray();
+    auto position_buffer =
+        api.CreateVertexBuffer(JE::AttributeLayout{{"a_VertexPos", JE::IRendererAPI::Type::FLOAT, 3}});
+    position_buffer->SetData(std::as_bytes(std::span{QUAD_POSITIONS}));
+    auto index_buffer = api.CreateElementBuffer();
+    index_buffer->SetData(std::as_bytes(std::span{QUAD_INDICES}));
+    quad->AddBuffer(std::move(position_buffer));
+    quad->SetIndexBuffer(std::move(index_buffer));
+    REQUIRE(quad->Build());
+
+    auto shader = api.CreateShader("Red", JE::VERTEX_SOURCE, FRAGMENT_SOURCE);
+    REQUIRE(shader->Valid());
+
+    const auto DRAW = [&]()
+    {
+        REQUIRE(api.SetClearColor(JE::RGBA{0.f, 0.f, 0.f, 1.f}));
+        REQUIRE(api.ClearFramebuffer(JE::Renderer::DEFAULT_ATTACHMENT_FLAGS));
+        shader->Bind();
+        quad->Bind();
+        REQUIRE(api.DrawIndexed(JE::IRendererAPI::Primitive::TRIANGLES,
+                                static_cast<std::uint32_t>(QUAD_INDICES.size()),
+                                JE::IRendererAPI::Type::UNSIGNED_INT,
+                                0,
+                                0));
+        quad->Unbind();
+        shader->Unbind();
+    };
+
+    DRAW();
+    REQUIRE(PIXEL(SIZE / 2, SIZE / 2) == JE::RGBA{1.f, 0.f, 0.f, 1.f}.ToUint32());
+    REQUIRE(PIXEL(0, 0) == JE::RGBA{0.f, 0.f, 0.f, 1.f}.ToUint32());
+
+    // Same program, vertex layout and render pass, the pipeline is reused
+    const auto PIPELINES = api.PipelineCount();
+    DRAW();
+    REQUIRE(api.PipelineCount() == PIPELINES);
+    REQUIRE(PIXEL(SIZE / 2, SIZE / 2) == JE::RGBA{1.f, 0.f, 0.f, 1.f}.ToUint32());
+
+    VkCommandPool other_pool = VK_NULL_HANDLE;
+    std::thread([&]() { other_pool = api.Device().ThreadCommandPool(); }).join();
+    REQUIRE(other_pool != VK_NULL_HANDLE);
+    REQUIRE(other_pool != api.Device().ThreadCommandPool());
+}
+#endif
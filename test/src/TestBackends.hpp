@@ -0,0 +1,403 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "Graphics/IRendererAPI.hpp"
+#include "Graphics/RenderState.hpp"
+#include "Graphics/Renderer.hpp"
+#include "Graphics/Texture.hpp"
+#include "Memory.hpp"
+#include "Platform.hpp"
+#include "Types.hpp"
+
+/// Headless backends injected by the tests and benchmarks, every call succeeds without touching a GPU or window
+
+struct TestGraphicsContext : JE::IGraphicsContext
+{
+    inline auto Created() const -> bool override { return true; }
+    inline auto SwapBuffers() -> bool override
+    {
+        Current = this;
+        return Present();
+    }
+    inline auto SetSwapInterval([[maybe_unused]] SwapInterval interval) -> bool override { return true; }
+    inline auto MakeCurrent() -> bool override
+    {
+        Current = this;
+        return true;
+    }
+    /// Fails like a real swap of a window whose context isn't current
+    inline auto Present() -> bool override
+    {
+        if (Current != this) {
+            ++FailedPresents;
+            return false;
+        }
+        ++Presents;
+        return true;
+    }
+
+    std::size_t Presents = 0;
+    static inline const TestGraphicsContext* Current = nullptr;
+    static inline std::size_t FailedPresents = 0;
+};
+
+struct TestWindow : JE::IWindow
+{
+    inline auto Created() const -> bool override { return true; }
+    inline auto GraphicsContext() -> JE::IGraphicsContext& override { return Context; }
+    inline auto Size() const -> JE::Size2D override { return DEFAULT_WINDOW_SIZE; }
+
+    // cppcheck-suppress unusedFunction
+    inline void Bind() override {}
+    // cppcheck-suppress unusedFunction
+    inline void Unbind() override {}
+    // cppcheck-suppress unusedFunction
+    inline auto SetWindowMode([[maybe_unused]] WindowMode mode) -> bool override { return true; }
+
+    TestGraphicsContext Context;
+};
+
+struct TestPlatform : JE::IPlatform
+{
+    inline auto Name() const -> std::string_view override { return "TestPlatform"; }
+
+    inline auto Initialize() -> bool override { return true; }
+    inline auto Initialized() const -> bool override { return true; }
+    inline auto GetLastError() const -> std::string_view override { return ""; }
+
+    inline auto PerformanceCounter() const -> std::uint64_t override
+    {
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+    inline auto PerformanceFrequency() const -> std::uint64_t override
+    {
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::period::den);
+    }
+
+    inline auto PollEvents([[maybe_unused]] std::span<JE::Event> events) -> std::size_t override { return 0; }
+
+    inline auto CreateWindow([[maybe_unused]] std::string_view title, [[maybe_unused]] const JE::Size2D& size)
+        -> JE::IWindow* override
+    {
+        return Windows.emplace_back(JE::CreateScope<TestWindow>()).get();
+    }
+
+    JE::Vector<JE::Scope<TestWindow>> Windows;
+};
+
+struct TestVertexBuffer : JE::IVertexBuffer
+{
+    explicit TestVertexBuffer(JE::AttributeLayout layout)
+        : IVertexBuffer(std::move(layout))
+    {
+    }
+
+    inline auto Bind() -> bool override { return true; }
+    inline auto Unbind() -> bool override { return true; }
+    inline auto SetData(std::span<const std::byte> data) -> bool override
+    {
+        if (!m_Resource.Allocate(data.size())) {
+            return false;
+        }
+        Data.assign(data.begin(), data.end());
+        m_Resource.Uploaded(data.size());
+        return true;
+    }
+    inline auto AllocateStorage(std::size_t size) -> bool override
+    {
+        if (!m_Resource.Allocate(size)) {
+            return false;
+        }
+        Data.assign(size, std::byte{0});
+        return true;
+    }
+    inline auto SetSubData(std::size_t offset, std::span<const std::byte> data) -> bool override
+    {
+        if (offset + data.size() > Data.size()) {
+            return false;
+        }
+        std::ranges::copy(data, Data.begin() + static_cast<std::ptrdiff_t>(offset));
+        m_Resource.Uploaded(data.size());
+        return true;
+    }
+    inline auto CopySubData(const JE::IVertexBuffer& source,
+                            std::size_t source_offset,
+                            std::size_t offset,
+                            std::size_t size) -> bool override
+    {
+        const auto& source_data = static_cast<const TestVertexBuffer&>(source).Data;
+        if (source_offset + size > source_data.size() || offset + size > Data.size()) {
+            return false;
+        }
+        std::copy_n(source_data.begin() + static_cast<std::ptrdiff_t>(source_offset),
+                    size,
+                    Data.begin() + static_cast<std::ptrdiff_t>(offset));
+        return true;
+    }
+    inline auto UploadLayout([[maybe_unused]] std::uint32_t first_location) -> bool override { return true; }
+
+    JE::Vector<std::byte> Data;
+};
+
+struct TestElementBuffer : JE::IElementBuffer
+{
+    inline auto Bind() -> bool override { return true; }
+    inline auto Unbind() -> bool override { return true; }
+    inline auto SetData(std::span<const std::byte> data) -> bool override
+    {
+        if (!m_Resource.Allocate(data.size())) {
+            return false;
+        }
+        Data.assign(data.begin(), data.end());
+        m_Resource.Uploaded(data.size());
+        return true;
+    }
+    inline auto AllocateStorage(std::size_t size) -> bool override
+    {
+        if (!m_Resource.Allocate(size)) {
+            return false;
+        }
+        Data.assign(size, std::byte{0});
+        return true;
+    }
+    inline auto SetSubData(std::size_t offset, std::span<const std::byte> data) -> bool override
+    {
+        if (offset + data.size() > Data.size()) {
+            return false;
+        }
+        std::ranges::copy(data, Data.begin() + static_cast<std::ptrdiff_t>(offset));
+        m_Resource.Uploaded(data.size());
+        return true;
+    }
+    inline auto CopySubData(const JE::IElementBuffer& source,
+                            std::size_t source_offset,
+                            std::size_t offset,
+                            std::size_t size) -> bool override
+    {
+        const auto& source_data = static_cast<const TestElementBuffer&>(source).Data;
+        if (source_offset + size > source_data.size() || offset + size > Data.size()) {
+            return false;
+        }
+        std::copy_n(source_data.begin() + static_cast<std::ptrdiff_t>(source_offset),
+                    size,
+                    Data.begin() + static_cast<std::ptrdiff_t>(offset));
+        return true;
+    }
+
+    JE::Vector<std::byte> Data;
+};
+
+struct TestVertexArray : JE::IVertexArray
+{
+    inline auto Build() -> bool override { return true; }
+    inline auto Bind() -> bool override { return true; }
+    inline auto Unbind() -> bool override { return true; }
+};
+
+struct TestShaderProgram : JE::IShaderProgram
+{
+    explicit TestShaderProgram(std::string_view debug_name)
+        : IShaderProgram(debug_name)
+    {
+        m_Valid = true;
+    }
+
+    inline auto Bind() -> bool override
+    {
+        Bound = DebugName();
+        return true;
+    }
+    inline auto Unbind() -> bool override
+    {
+        Bound.clear();
+        return true;
+    }
+
+    /// Debug name of the bound program, empty while none is bound
+    static inline std::string Bound;
+};
+
+struct TestTexture2D : JE::ITexture2D
+{
+    explicit TestTexture2D(const JE::TextureDescription& description)
+        : ITexture2D(description)
+    {
+        if (!m_Resource.Allocate(ByteSize())) {
+            return;
+        }
+        for (std::uint32_t level = 0; level < MipLevels(); ++level) {
+            Levels.emplace_back(LevelByteSize(level));
+        }
+    }
+
+    inline auto Bind([[maybe_unused]] std::uint32_t slot) -> bool override { return true; }
+    inline auto Unbind([[maybe_unused]] std::uint32_t slot) -> bool override { return true; }
+    inline auto SetSampler(const JE::SamplerState& sampler) -> bool override
+    {
+        m_Sampler = sampler;
+        return true;
+    }
+    inline auto SetData(std::uint32_t level, std::span<const std::byte> data) -> bool override
+    {
+        std::ranges::copy(data, Levels[level].begin());
+        return true;
+    }
+    inline auto SetRows(std::uint32_t level, std::uint32_t first_row, std::span<const std::byte> data)
+        -> bool override
+    {
+        const auto OFFSET = first_row * LevelRowBytes(level);
+        std::ranges::copy(data, Levels[level].begin() + static_cast<std::ptrdiff_t>(OFFSET));
+        return true;
+    }
+    inline auto GenerateMipmaps() -> bool override { return true; }
+
+    JE::Vector<JE::Vector<std::byte>> Levels;
+};
+
+struct TestTextureUploader : JE::ITextureUploader
+{
+    explicit TestTextureUploader(std::size_t frame_budget)
+        : ITextureUploader(frame_budget)
+    {
+    }
+
+    inline auto MapStaging(std::size_t size) -> std::span<std::byte> override
+    {
+        Staging.resize(size);
+        return Staging;
+    }
+
+    inline auto SubmitStaging(std::span<const StagedRegion> regions) -> bool override
+    {
+        if (FailSubmits) {
+            return false;
+        }
+        for (const auto& region : regions) {
+            auto& texture = static_cast<TestTexture2D&>(*region.Texture);
+            const auto OFFSET = region.FirstRow * texture.LevelRowBytes(region.Level);
+            std::ranges::copy(std::span{Staging}.subspan(region.StagingOffset, region.ByteSize),
+                              texture.Levels[region.Level].begin() + static_cast<std::ptrdiff_t>(OFFSET));
+        }
+        return true;
+    }
+
+    JE::Vector<std::byte> Staging;
+    bool FailSubmits = false;
+};
+
+struct TestFramebuffer : JE::IFramebuffer
+{
+    explicit TestFramebuffer(const JE::FramebufferDescription& description)
+        : IFramebuffer(description)
+    {
+        ++Created;
+    }
+    ~TestFramebuffer() override { ++Destroyed; }
+
+    inline void Bind() override {}
+    inline void Unbind() override {}
+
+    static inline std::uint32_t Created = 0;
+    static inline std::uint32_t Destroyed = 0;
+};
+
+struct TestRendererAPI : JE::IRendererAPI
+{
+    inline auto Name() const -> std::string_view override { return "TestRendererAPI"; }
+
+    inline auto SetClearColor([[maybe_unused]] const JE::RGBA& color) -> bool override { return true; }
+    inline auto ClearFramebuffer([[maybe_unused]] AttachmentFlags flags) -> bool override { return true; }
+    inline auto BindFramebuffer([[maybe_unused]] FramebufferID buffer_id) -> bool override { return true; }
+    inline auto DrawIndexed([[maybe_unused]] Primitive primitive_type,
+                            [[maybe_unused]] std::uint32_t index_count,
+                            [[maybe_unused]] Type index_type,
+                            std::uint32_t first_index,
+                            std::int32_t base_vertex) -> bool override
+    {
+        ++DrawCalls;
+        LastDrawProgram = TestShaderProgram::Bound;
+        LastFirstIndex = first_index;
+        LastBaseVertex = base_vertex;
+        return true;
+    }
+    inline auto SetRenderState(const JE::RenderState& state) -> bool override
+    {
+        ++RenderStateChanges;
+        LastRenderState = state;
+        return true;
+    }
+
+    inline auto CreateVertexBuffer(const JE::AttributeLayout& layout) -> JE::Scope<JE::IVertexBuffer> override
+    {
+        return JE::CreateScope<TestVertexBuffer>(layout);
+    }
+    inline auto CreateElementBuffer() -> JE::Scope<JE::IElementBuffer> override
+    {
+        return JE::CreateScope<TestElementBuffer>();
+    }
+    inline auto CreateVertexArray() -> JE::Scope<JE::IVertexArray> override
+    {
+        return JE::CreateScope<TestVertexArray>();
+    }
+    inline auto CreateShader(std::string_view debug_name,
+                             [[maybe_unused]] std::string_view vertex_source,
+                             [[maybe_unused]] std::string_view fragment_source)
+        -> JE::Scope<JE::IShaderProgram> override
+    {
+        return JE::CreateScope<TestShaderProgram>(debug_name);
+    }
+    inline auto CreateTexture2D(const JE::TextureDescription& description) -> JE::Scope<JE::ITexture2D> override
+    {
+        return JE::CreateScope<TestTexture2D>(description);
+    }
+    inline auto CreateTextureUploader(std::size_t frame_budget) -> JE::Scope<JE::ITextureUploader> override
+    {
+        return JE::CreateScope<TestTextureUploader>(frame_budget);
+    }
+    inline auto CreateFramebuffer(const JE::FramebufferDescription& description)
+        -> JE::Scope<JE::IFramebuffer> override
+    {
+        return JE::CreateScope<TestFramebuffer>(description);
+    }
+
+    inline auto InsertFence() -> FenceID override { return ++FencesInserted; }
+    inline auto WaitFence([[maybe_unused]] FenceID fence, [[maybe_unused]] std::uint64_t timeout_ns) -> bool override
+    {
+        ++FencesWaited;
+        return true;
+    }
+    inline void DeleteFence([[maybe_unused]] FenceID fence) override {}
+    inline auto Finish() -> bool override { return true; }
+    inline void EndFrame() override { ++FramesEnded; }
+
+    inline auto BeginTimerQuery() -> TimerQueryID override { return ++TimerQueriesBegun; }
+    inline auto EndTimerQuery([[maybe_unused]] TimerQueryID query) -> bool override { return true; }
+    /// Every query reports TimerQueryNanoseconds as soon as it was begun
+    inline auto TimerQueryResult([[maybe_unused]] TimerQueryID query) -> std::optional<std::uint64_t> override
+    {
+        return TimerQueryNanoseconds;
+    }
+    inline void DeleteTimerQuery([[maybe_unused]] TimerQueryID query) override {}
+
+    static inline std::uint32_t DrawCalls = 0;
+    static inline std::uint32_t LastFirstIndex = 0;
+    static inline std::int32_t LastBaseVertex = 0;
+    /// Debug name of the program bound during the last draw, empty if there was none
+    static inline std::string LastDrawProgram;
+    static inline std::uint32_t RenderStateChanges = 0;
+    static inline JE::RenderState LastRenderState;
+    static inline FenceID FencesInserted = 0;
+    static inline FenceID FencesWaited = 0;
+    static inline std::uint32_t FramesEnded = 0;
+    static inline TimerQueryID TimerQueriesBegun = 0;
+    static inline std::uint64_t TimerQueryNanoseconds = 0;
+};